@@ -0,0 +1,487 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "AlertBenchmarks.h"
+
+// dsa app headers
+#include "DistanceJoin.h"
+#include "Geodesy.h"
+#include "GeometryQuadtree.h"
+#include "GraphicsOverlayAlertTarget.h"
+#include "LegacyGeometryQuadtree.h"
+#include "PreparedPolygon.h"
+
+// C++ API headers
+#include "Envelope.h"
+#include "GeometryEngine.h"
+#include "Graphic.h"
+#include "GraphicListModel.h"
+#include "GraphicsOverlay.h"
+#include "SpatialReference.h"
+
+// Qt headers
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPair>
+#include <QPointF>
+#include <QTextStream>
+#include <QVector>
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <random>
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+namespace
+{
+// the number of graphics kept in the overlay while removals are measured
+constexpr int overlayGraphicCount = 10000;
+
+// the number of removals measured at each position in the overlay
+constexpr int measuredRemovalCount = 1000;
+
+// the number of queries, and of moves, measured for each quadtree
+constexpr int measuredQueryCount = 1000;
+
+// the size in degrees of the square areas used to query the quadtrees
+constexpr double queryAreaSize = 0.01;
+
+// the maximum depth of the quadtrees, as used by the alert targets
+constexpr int quadtreeLevels = 8;
+
+// the number of sources and targets of the distance join, and the join distance in meters
+constexpr int joinSourceCount = 2000;
+constexpr int joinTargetCount = 10000;
+constexpr double joinRadius = 500.0;
+
+// the number of the sources and targets of the distance join which are placed near the north pole
+constexpr int joinPolarCount = 10;
+
+// the number of random locations tested against each polygon, within its extent and around it
+constexpr int polygonRandomPointCount = 10000;
+
+// a polygon for the point in polygon comparison, with locations known to be in its holes and in its parts
+struct PolygonCase
+{
+  QString name;
+  QVector<QVector<QPointF>> rings;
+  QVector<QPointF> holeLocations;
+  QVector<QPointF> partLocations;
+};
+
+Point randomPoint(std::mt19937& generator)
+{
+  std::uniform_real_distribution<double> longitude(-117.5, -116.5);
+  std::uniform_real_distribution<double> latitude(33.5, 34.5);
+  return Point(longitude(generator), latitude(generator), SpatialReference::wgs84());
+}
+
+Graphic* randomGraphic(std::mt19937& generator, QObject* parent)
+{
+  return new Graphic(randomPoint(generator), parent);
+}
+
+Envelope randomArea(std::mt19937& generator)
+{
+  const Point corner = randomPoint(generator);
+  return Envelope(corner.x(), corner.y(), corner.x() + queryAreaSize, corner.y() + queryAreaSize, SpatialReference::wgs84());
+}
+
+void reportTimes(QTextStream& out, const QString& label, QVector<qint64> nanoseconds)
+{
+  if (nanoseconds.isEmpty())
+    return;
+
+  std::sort(nanoseconds.begin(), nanoseconds.end());
+  double total = 0.0;
+  for (qint64 time : nanoseconds)
+    total += time;
+
+  const int percentileIndex = std::max(0, static_cast<int>(std::ceil(nanoseconds.size() * 0.99)) - 1);
+  out << label << ": mean " << (total / nanoseconds.size()) / 1000.0 << " us, p99 "
+      << nanoseconds[percentileIndex] / 1000.0 << " us" << endl;
+}
+
+Geometry polygonFromRings(const QVector<QVector<QPointF>>& rings)
+{
+  QJsonArray ringsJson;
+  for (const QVector<QPointF>& ring : rings)
+  {
+    QJsonArray ringJson;
+    for (const QPointF& vertex : ring)
+      ringJson.append(QJsonArray{vertex.x(), vertex.y()});
+
+    ringsJson.append(ringJson);
+  }
+
+  QJsonObject polygonJson;
+  polygonJson.insert(QStringLiteral("rings"), ringsJson);
+  polygonJson.insert(QStringLiteral("spatialReference"), QJsonObject{{QStringLiteral("wkid"), 4326}});
+  return Geometry::fromJson(QString::fromUtf8(QJsonDocument(polygonJson).toJson(QJsonDocument::Compact)));
+}
+
+// Write the number of the locations for which the PreparedPolygon and the GeometryEngine disagree.
+void reportDisagreements(QTextStream& out, const QString& label, const PreparedPolygon& prepared,
+                         const Geometry& polygon, const QVector<QPointF>& locations)
+{
+  int disagreements = 0;
+  for (const QPointF& location : locations)
+  {
+    const bool preparedResult = prepared.intersects(location.x(), location.y());
+    const bool engineResult = GeometryEngine::intersects(polygon, Point(location.x(), location.y(), SpatialReference::wgs84()));
+    if (preparedResult != engineResult)
+      ++disagreements;
+  }
+
+  out << label << ": " << disagreements << " of " << locations.size() << " disagree" << endl;
+}
+
+// Build a quadtree of type Tree over the graphics, then time queries against it and
+// moves of the graphics (each followed by a query, as an alert condition would make).
+// Moves are timed up to and including the event loop turn in which they are applied.
+template <typename Tree>
+void measureQuadtree(QTextStream& out, const QString& label, const QList<Graphic*>& graphics)
+{
+  std::mt19937 generator(7);
+  QList<GeoElement*> elements;
+  elements.reserve(graphics.size());
+  for (Graphic* graphic : graphics)
+    elements.append(graphic);
+
+  const Envelope extent(-117.5, 33.5, -116.5, 34.5, SpatialReference::wgs84());
+
+  QElapsedTimer timer;
+  timer.start();
+  Tree tree(extent, elements, quadtreeLevels);
+  out << label << endl << "  build: " << timer.nsecsElapsed() / 1000.0 << " us" << endl;
+
+  QVector<qint64> queryNanoseconds;
+  queryNanoseconds.reserve(measuredQueryCount);
+  int candidateCount = 0;
+  for (int i = 0; i < measuredQueryCount; ++i)
+  {
+    const Envelope area = randomArea(generator);
+    timer.start();
+    candidateCount += tree.candidateIntersections(area).size();
+    queryNanoseconds.append(timer.nsecsElapsed());
+  }
+  reportTimes(out, QStringLiteral("  query"), queryNanoseconds);
+  out << "  mean candidates: " << static_cast<double>(candidateCount) / measuredQueryCount << endl;
+
+  QVector<qint64> moveNanoseconds;
+  moveNanoseconds.reserve(measuredQueryCount);
+  std::uniform_int_distribution<int> index(0, graphics.size() - 1);
+  for (int i = 0; i < measuredQueryCount; ++i)
+  {
+    Graphic* graphic = graphics.at(index(generator));
+    const Point location = randomPoint(generator);
+    const Envelope area = randomArea(generator);
+    timer.start();
+    graphic->setGeometry(location);
+
+    // deliver any move which the tree deferred to the event loop before querying it
+    QCoreApplication::processEvents();
+    tree.candidateIntersections(area);
+    moveNanoseconds.append(timer.nsecsElapsed());
+  }
+  reportTimes(out, QStringLiteral("  move and query"), moveNanoseconds);
+}
+}
+
+/*!
+  \class Dsa::AlertBenchmarks
+  \inmodule Dsa
+  \brief Measurements of the cost of maintaining the alert targets.
+  */
+
+/*!
+  \brief Writes the steady cost of removing a graphic from a \l GraphicsOverlayAlertTarget
+  to \a out.
+
+  The overlay is kept at 10,000 graphics: each measured removal is followed by the
+  (unmeasured) addition of a new graphic. Removals are measured from the start, the
+  middle and the end of the overlay, so that any cost which depends on the position
+  of the graphic shows up as a difference between the three.
+ */
+void AlertBenchmarks::graphicsOverlayRemoval(QTextStream& out)
+{
+  std::mt19937 generator(42);
+  GraphicsOverlay overlay;
+  GraphicListModel* graphics = overlay.graphics();
+  for (int i = 0; i < overlayGraphicCount; ++i)
+    graphics->append(randomGraphic(generator, &overlay));
+
+  GraphicsOverlayAlertTarget target(&overlay);
+
+  out << "GraphicsOverlayAlertTarget removal with " << overlayGraphicCount << " graphics" << endl;
+
+  const QVector<QPair<QString, int>> positions
+  {
+    qMakePair(QStringLiteral("  first"), 0),
+    qMakePair(QStringLiteral("  middle"), overlayGraphicCount / 2),
+    qMakePair(QStringLiteral("  last"), overlayGraphicCount - 1)
+  };
+
+  QElapsedTimer timer;
+  for (const auto& position : positions)
+  {
+    QVector<qint64> nanoseconds;
+    nanoseconds.reserve(measuredRemovalCount);
+    for (int i = 0; i < measuredRemovalCount; ++i)
+    {
+      Graphic* graphic = graphics->at(position.second);
+
+      timer.start();
+      graphics->removeAt(position.second);
+      nanoseconds.append(timer.nsecsElapsed());
+
+      delete graphic;
+      graphics->append(randomGraphic(generator, &overlay));
+    }
+
+    reportTimes(out, position.first, nanoseconds);
+  }
+}
+
+/*!
+  \brief Writes a comparison of the original quadtree (\l LegacyGeometryQuadtree) and the
+  current \l GeometryQuadtree to \a out.
+
+  Both trees are built over the same 10,000 point graphics and given the same sequence of
+  queries and of moves. Each move is timed together with the query which follows it and the
+  turn of the event loop between them, in which the current tree applies deferred moves.
+ */
+void AlertBenchmarks::quadtreeComparison(QTextStream& out)
+{
+  std::mt19937 generator(42);
+  GraphicsOverlay overlay;
+  QList<Graphic*> graphics;
+  graphics.reserve(overlayGraphicCount);
+  for (int i = 0; i < overlayGraphicCount; ++i)
+    graphics.append(randomGraphic(generator, &overlay));
+
+  // each tree moves the graphics, so both start from the same locations
+  QList<Geometry> locations;
+  locations.reserve(graphics.size());
+  for (Graphic* graphic : qAsConst(graphics))
+    locations.append(graphic->geometry());
+
+  out << "Quadtree comparison with " << overlayGraphicCount << " graphics" << endl;
+  measureQuadtree<LegacyGeometryQuadtree>(out, QStringLiteral(" old tree"), graphics);
+
+  for (int i = 0; i < graphics.size(); ++i)
+    graphics.at(i)->setGeometry(locations.at(i));
+
+  measureQuadtree<GeometryQuadtree>(out, QStringLiteral(" new tree"), graphics);
+}
+
+/*!
+  \brief Writes a comparison of \l DistanceJoin against testing every source and target
+  pair to \a out.
+
+  2,000 sources and 10,000 targets are placed at random in the same area as the other
+  benchmarks, with 10 of each near the north pole so that the cells of the polar rows are
+  widened. Both joins find the pairs within 500 meters. The time taken by each is reported,
+  along with the number of pairs found by one but not the other, which should be \c 0.
+ */
+void AlertBenchmarks::distanceJoinComparison(QTextStream& out)
+{
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> polarLongitude(-180.0, 180.0);
+  std::uniform_real_distribution<double> polarLatitude(89.5, 89.99);
+  auto randomLocations = [&generator, &polarLongitude, &polarLatitude](int count, QVector<double>& x, QVector<double>& y)
+  {
+    x.reserve(count);
+    y.reserve(count);
+    for (int i = 0; i < count - joinPolarCount; ++i)
+    {
+      const Point point = randomPoint(generator);
+      x.append(point.x());
+      y.append(point.y());
+    }
+
+    for (int i = 0; i < joinPolarCount; ++i)
+    {
+      x.append(polarLongitude(generator));
+      y.append(polarLatitude(generator));
+    }
+  };
+
+  QVector<double> sourceX;
+  QVector<double> sourceY;
+  QVector<double> targetX;
+  QVector<double> targetY;
+  randomLocations(joinSourceCount, sourceX, sourceY);
+  randomLocations(joinTargetCount, targetX, targetY);
+
+  out << "Distance join of " << joinSourceCount << " sources and " << joinTargetCount
+      << " targets within " << joinRadius << " m" << endl;
+
+  QElapsedTimer timer;
+  timer.start();
+  DistanceJoin join;
+  join.join(sourceX, sourceY, targetX, targetY, joinRadius);
+  const qint64 gridNanoseconds = timer.nsecsElapsed();
+
+  QVector<QPair<int, int>> gridPairs;
+  gridPairs.reserve(join.pairs().size());
+  for (const DistanceJoinPair& pair : join.pairs())
+    gridPairs.append(qMakePair(pair.sourceIndex, pair.targetIndex));
+
+  timer.start();
+  QVector<QPair<int, int>> bruteForcePairs;
+  for (int source = 0; source < joinSourceCount; ++source)
+  {
+    for (int target = 0; target < joinTargetCount; ++target)
+    {
+      if (Geodesy::distance(sourceX.at(source), sourceY.at(source), targetX.at(target), targetY.at(target)) <= joinRadius)
+        bruteForcePairs.append(qMakePair(source, target));
+    }
+  }
+  const qint64 bruteForceNanoseconds = timer.nsecsElapsed();
+
+  std::sort(gridPairs.begin(), gridPairs.end());
+  QVector<QPair<int, int>> differences;
+  std::set_symmetric_difference(gridPairs.cbegin(), gridPairs.cend(), bruteForcePairs.cbegin(), bruteForcePairs.cend(),
+                                std::back_inserter(differences));
+
+  out << "  grid: " << gridNanoseconds / 1000000.0 << " ms, " << gridPairs.size() << " pairs" << endl;
+  out << "  brute force: " << bruteForceNanoseconds / 1000000.0 << " ms, " << bruteForcePairs.size() << " pairs" << endl;
+  out << "  pairs found by only one: " << differences.size() << endl;
+}
+
+/*!
+  \brief Writes a comparison of \l PreparedPolygon::intersects against
+  \l Esri::ArcGISRuntime::GeometryEngine::intersects to \a out.
+
+  Two polygons are tested: a square with a square hole, and a multipart polygon made of
+  a concave part and a diamond whose edges are not axis aligned. Each is tested at every
+  vertex, at points along every edge, at locations inside its holes and inside each of
+  its parts, and at 10,000 random locations in and around its extent. The number of
+  locations at which the two disagree is reported for each of those, and should be \c 0,
+  along with the time taken by each to test the random locations.
+ */
+void AlertBenchmarks::preparedPolygonComparison(QTextStream& out)
+{
+  const QVector<PolygonCase> cases
+  {
+    {
+      QStringLiteral("square with a hole"),
+      {
+        {{-117.0, 34.0}, {-117.0, 34.2}, {-116.8, 34.2}, {-116.8, 34.0}, {-117.0, 34.0}},
+        {{-116.95, 34.05}, {-116.85, 34.05}, {-116.85, 34.15}, {-116.95, 34.15}, {-116.95, 34.05}}
+      },
+      {{-116.9, 34.1}, {-116.94, 34.06}, {-116.86, 34.14}},
+      {{-116.98, 34.1}, {-116.9, 34.18}, {-116.82, 34.02}}
+    },
+    {
+      QStringLiteral("multipart"),
+      {
+        {{-117.3, 33.8}, {-117.3, 34.0}, {-117.2, 34.0}, {-117.2, 33.9}, {-117.1, 33.9}, {-117.1, 33.8}, {-117.3, 33.8}},
+        {{-116.7, 33.7}, {-116.75, 33.8}, {-116.7, 33.9}, {-116.65, 33.8}, {-116.7, 33.7}}
+      },
+      {},
+      {{-117.25, 33.95}, {-117.15, 33.85}, {-116.7, 33.8}, {-116.72, 33.75}}
+    }
+  };
+
+  std::mt19937 generator(42);
+  out << "PreparedPolygon against GeometryEngine::intersects" << endl;
+
+  for (const PolygonCase& polygonCase : cases)
+  {
+    const Geometry polygon = polygonFromRings(polygonCase.rings);
+
+    QElapsedTimer timer;
+    timer.start();
+    const PreparedPolygon prepared(polygon);
+    out << " " << polygonCase.name << endl << "  prepare: " << timer.nsecsElapsed() / 1000.0 << " us" << endl;
+
+    QVector<QPointF> vertices;
+    QVector<QPointF> edgeLocations;
+    for (const QVector<QPointF>& ring : polygonCase.rings)
+    {
+      for (int i = 0; i < ring.size(); ++i)
+      {
+        vertices.append(ring.at(i));
+        if (i == 0)
+          continue;
+
+        const QPointF& start = ring.at(i - 1);
+        const QPointF& end = ring.at(i);
+        for (double t : {0.25, 0.5, 0.75})
+          edgeLocations.append(start + t * (end - start));
+      }
+    }
+
+    reportDisagreements(out, QStringLiteral("  vertices"), prepared, polygon, vertices);
+    reportDisagreements(out, QStringLiteral("  edges"), prepared, polygon, edgeLocations);
+    if (!polygonCase.holeLocations.isEmpty())
+      reportDisagreements(out, QStringLiteral("  holes"), prepared, polygon, polygonCase.holeLocations);
+    reportDisagreements(out, QStringLiteral("  parts"), prepared, polygon, polygonCase.partLocations);
+
+    // random locations in an area twice the size of the extent, so that about a quarter fall inside it
+    const double width = prepared.xMax() - prepared.xMin();
+    const double height = prepared.yMax() - prepared.yMin();
+    std::uniform_real_distribution<double> x(prepared.xMin() - width / 2.0, prepared.xMax() + width / 2.0);
+    std::uniform_real_distribution<double> y(prepared.yMin() - height / 2.0, prepared.yMax() + height / 2.0);
+    QVector<QPointF> randomLocations;
+    QVector<Point> randomPoints;
+    randomLocations.reserve(polygonRandomPointCount);
+    randomPoints.reserve(polygonRandomPointCount);
+    for (int i = 0; i < polygonRandomPointCount; ++i)
+    {
+      randomLocations.append(QPointF(x(generator), y(generator)));
+      randomPoints.append(Point(randomLocations.last().x(), randomLocations.last().y(), SpatialReference::wgs84()));
+    }
+
+    reportDisagreements(out, QStringLiteral("  random"), prepared, polygon, randomLocations);
+
+    int preparedCount = 0;
+    timer.start();
+    for (const Point& point : randomPoints)
+    {
+      if (prepared.intersects(point))
+        ++preparedCount;
+    }
+    const qint64 preparedNanoseconds = timer.nsecsElapsed();
+
+    int engineCount = 0;
+    timer.start();
+    for (const Point& point : randomPoints)
+    {
+      if (GeometryEngine::intersects(polygon, point))
+        ++engineCount;
+    }
+    const qint64 engineNanoseconds = timer.nsecsElapsed();
+
+    out << "  PreparedPolygon: " << preparedNanoseconds / 1000000.0 << " ms, " << preparedCount << " intersect" << endl;
+    out << "  GeometryEngine: " << engineNanoseconds / 1000000.0 << " ms, " << engineCount << " intersect" << endl;
+  }
+}
+
+} // Dsa
@@ -0,0 +1,35 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef ALERTBENCHMARKS_H
+#define ALERTBENCHMARKS_H
+
+class QTextStream;
+
+namespace Dsa {
+
+class AlertBenchmarks
+{
+public:
+  static void graphicsOverlayRemoval(QTextStream& out);
+  static void quadtreeComparison(QTextStream& out);
+  static void distanceJoinComparison(QTextStream& out);
+  static void preparedPolygonComparison(QTextStream& out);
+};
+
+} // Dsa
+
+#endif // ALERTBENCHMARKS_H
@@ -0,0 +1,82 @@
+################################################################################
+#  Copyright 2012-2018 Esri
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#  http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+################################################################################
+
+TARGET = DSA_Benchmarks_Qt
+TEMPLATE = app
+
+QT += core gui opengl network positioning sensors qml quick xml
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+ARCGIS_RUNTIME_VERSION = 100.10
+include($$PWD/../Shared/build/arcgisruntime.pri)
+
+INCLUDEPATH += $$PWD/../Shared/ \
+    $$PWD/../Shared/alerts \
+    $$PWD/../Shared/analysis \
+    $$PWD/../Shared/messages \
+    $$PWD/../Shared/packages \
+    $$PWD/../Shared/utilities \
+    $$PWD/../Shared/markup
+
+HEADERS += \
+    AlertBenchmarks.h \
+    LegacyGeometryQuadtree.h \
+    TerrainProfileBenchmarks.h \
+    ViewshedBenchmarks.h \
+    $$files($$PWD/../Shared/*.h) \
+    $$files($$PWD/../Shared/alerts/*.h) \
+    $$files($$PWD/../Shared/analysis/*.h) \
+    $$files($$PWD/../Shared/messages/*.h) \
+    $$files($$PWD/../Shared/packages/*.h) \
+    $$files($$PWD/../Shared/utilities/*.h) \
+    $$files($$PWD/../Shared/markup/*.h)
+
+SOURCES += \
+    main.cpp \
+    AlertBenchmarks.cpp \
+    LegacyGeometryQuadtree.cpp \
+    TerrainProfileBenchmarks.cpp \
+    ViewshedBenchmarks.cpp \
+    $$files($$PWD/../Shared/*.cpp) \
+    $$files($$PWD/../Shared/alerts/*.cpp) \
+    $$files($$PWD/../Shared/analysis/*.cpp) \
+    $$files($$PWD/../Shared/messages/*.cpp) \
+    $$files($$PWD/../Shared/packages/*.cpp) \
+    $$files($$PWD/../Shared/utilities/*.cpp) \
+    $$files($$PWD/../Shared/markup/*.cpp)
+
+PRECOMPILED_HEADER = $$PWD/../Shared/pch.hpp
+CONFIG += precompile_header
+
+#-------------------------------------------------------------------------------
+
+include($$PWD/../../arcgis-runtime-toolkit-qt/uitools/toolkitcpp.pri)
+
+contains(QMAKE_HOST.os, Windows):{
+  iniPath = $$(ALLUSERSPROFILE)\EsriRuntimeQt\ArcGIS Runtime SDK for Qt $${ARCGIS_RUNTIME_VERSION}.ini
+}
+else {
+  userHome = $$system(echo $HOME)
+  iniPath = $${userHome}/.config/EsriRuntimeQt/ArcGIS Runtime SDK for Qt $${ARCGIS_RUNTIME_VERSION}.ini
+}
+iniLine = $$cat($${iniPath}, "lines")
+dirPath = $$find(iniLine, "InstallDir")
+cleanDirPath = $$replace(dirPath, "InstallDir=", "")
+priLocation = $$replace(cleanDirPath, '"', "")
+!include($$priLocation/sdk/ideintegration/arcgis_runtime_qml_cpp.pri) {
+  message("Error. Cannot locate ArcGIS Runtime PRI file")
+}
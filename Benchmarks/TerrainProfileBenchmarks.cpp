@@ -0,0 +1,139 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "TerrainProfileBenchmarks.h"
+
+// dsa app headers
+#include "ElevationRaster.h"
+#include "ElevationSampler.h"
+#include "TerrainProfileEngine.h"
+
+// Qt headers
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+// STL headers
+#include <algorithm>
+#include <limits>
+#include <random>
+
+namespace Dsa {
+
+namespace
+{
+// the number of points in the measured intervisibility matrix
+constexpr int intervisibilityPointCount = 200;
+
+// the size in degrees of the square, centered on the first raster, in which the points are placed
+constexpr double intervisibilityAreaSize = 0.1;
+
+// the height in meters of the points above the surface
+constexpr double intervisibilityHeight = 2.0;
+
+// the number of times the matrix is computed for each thread count
+constexpr int measuredMatrixCount = 5;
+
+// Compute the matrix for the points with the engine measuredMatrixCount times and report
+// the mean and fastest times, with the number of visible pairs.
+void measureMatrix(QTextStream& out, const QString& label, const TerrainProfileEngine& engine,
+                   const QVector<IntervisibilityPoint>& points)
+{
+  QElapsedTimer timer;
+  QVector<LineOfSightVisibility> matrix;
+  qint64 total = 0;
+  qint64 fastest = std::numeric_limits<qint64>::max();
+  for (int i = 0; i < measuredMatrixCount; ++i)
+  {
+    timer.start();
+    matrix = engine.intervisibility(points);
+    const qint64 elapsed = timer.elapsed();
+    total += elapsed;
+    fastest = std::min(fastest, elapsed);
+  }
+
+  // each pair is counted in both directions, and each point is visible from itself
+  const int visibleCount = static_cast<int>(std::count(matrix.cbegin(), matrix.cend(), LineOfSightVisibility::Visible));
+  const int visiblePairs = std::max(0, visibleCount - points.size()) / 2;
+
+  out << "  " << label << ": " << visiblePairs << " visible pairs, mean "
+      << static_cast<double>(total) / measuredMatrixCount << " ms, fastest " << fastest << " ms" << endl;
+}
+}
+
+/*!
+  \class Dsa::TerrainProfileBenchmarks
+  \inmodule Dsa
+  \brief Measurements of the cost of computing terrain profiles and intervisibility on the CPU.
+  */
+
+/*!
+  \brief Writes the time taken by \l TerrainProfileEngine to compute the intervisibility
+  matrix of 200 points to \a out.
+
+  The surface is read from the DTED or uncompressed GeoTIFF files in \a elevationPaths and
+  the points are placed at random, 2 meters above the surface, within 0.1 degrees of the
+  center of the first of them. The matrix is computed 5 times on one thread and 5 times on
+  all cores, without a result cache, and the mean and fastest times are reported.
+ */
+void TerrainProfileBenchmarks::intervisibilityMatrix(QTextStream& out, const QStringList& elevationPaths)
+{
+  if (elevationPaths.isEmpty())
+  {
+    out << "Intervisibility skipped: no elevation given with --elevation=<path>" << endl;
+    return;
+  }
+
+  QSharedPointer<ElevationRaster> firstRaster(new ElevationRaster());
+  if (!firstRaster->load(elevationPaths.first()))
+  {
+    out << "Intervisibility skipped: " << firstRaster->errorMessage() << endl;
+    return;
+  }
+
+  QSharedPointer<ElevationSampler> sampler(new ElevationSampler());
+  sampler->addRaster(firstRaster);
+  sampler->addRasters(elevationPaths.mid(1));
+
+  const double centerX = (firstRaster->xMin() + firstRaster->xMax()) * 0.5;
+  const double centerY = (firstRaster->yMin() + firstRaster->yMax()) * 0.5;
+
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> offset(-intervisibilityAreaSize * 0.5, intervisibilityAreaSize * 0.5);
+  QVector<IntervisibilityPoint> points(intervisibilityPointCount);
+  for (IntervisibilityPoint& point : points)
+  {
+    point.m_x = centerX + offset(generator);
+    point.m_y = centerY + offset(generator);
+    point.m_height = intervisibilityHeight;
+  }
+
+  out << "Intervisibility of " << intervisibilityPointCount << " points around " << centerX << ", " << centerY
+      << " (" << intervisibilityPointCount * (intervisibilityPointCount - 1) / 2 << " sightlines)" << endl;
+
+  TerrainProfileEngine engine(sampler);
+  engine.setThreadCount(1);
+  measureMatrix(out, QStringLiteral("1 thread"), engine, points);
+
+  engine.setThreadCount(0);
+  measureMatrix(out, QStringLiteral("all cores"), engine, points);
+}
+
+} // Dsa
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "ViewshedBenchmarks.h"
+
+// dsa app headers
+#include "ElevationRaster.h"
+#include "ElevationSampler.h"
+#include "ViewshedEngine.h"
+
+// Qt headers
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+// STL headers
+#include <algorithm>
+#include <limits>
+
+namespace Dsa {
+
+namespace
+{
+// the radii in meters of the measured viewsheds
+const QVector<double> viewshedRadii{1000.0, 2500.0, 5000.0, 10000.0, 20000.0};
+
+// the number of times the viewshed is computed at each radius
+constexpr int measuredViewshedCount = 5;
+}
+
+/*!
+  \class Dsa::ViewshedBenchmarks
+  \inmodule Dsa
+  \brief Measurements of the cost of computing viewsheds on the CPU.
+  */
+
+/*!
+  \brief Writes the time taken by \l ViewshedEngine to compute a 360 degree viewshed at
+  radii from 1 to 20 km to \a out.
+
+  The surface is read from the DTED or uncompressed GeoTIFF files in \a elevationPaths and
+  the observer is placed at the center of the first of them. Each viewshed is computed
+  5 times, without a result cache, and the mean and fastest times are reported along with
+  the size of the grid.
+ */
+void ViewshedBenchmarks::radii(QTextStream& out, const QStringList& elevationPaths)
+{
+  if (elevationPaths.isEmpty())
+  {
+    out << "Viewshed skipped: no elevation given with --elevation=<path>" << endl;
+    return;
+  }
+
+  QSharedPointer<ElevationRaster> firstRaster(new ElevationRaster());
+  if (!firstRaster->load(elevationPaths.first()))
+  {
+    out << "Viewshed skipped: " << firstRaster->errorMessage() << endl;
+    return;
+  }
+
+  QSharedPointer<ElevationSampler> sampler(new ElevationSampler());
+  sampler->addRaster(firstRaster);
+  sampler->addRasters(elevationPaths.mid(1));
+
+  ViewshedParameters parameters;
+  parameters.m_observerX = (firstRaster->xMin() + firstRaster->xMax()) * 0.5;
+  parameters.m_observerY = (firstRaster->yMin() + firstRaster->yMax()) * 0.5;
+
+  const ViewshedEngine engine(sampler);
+  out << "Viewshed from " << parameters.m_observerX << ", " << parameters.m_observerY << endl;
+
+  QElapsedTimer timer;
+  for (double radius : viewshedRadii)
+  {
+    parameters.m_radius = radius;
+
+    ViewshedRaster raster;
+    qint64 total = 0;
+    qint64 fastest = std::numeric_limits<qint64>::max();
+    for (int i = 0; i < measuredViewshedCount; ++i)
+    {
+      timer.start();
+      raster = engine.compute(parameters);
+      const qint64 elapsed = timer.elapsed();
+      total += elapsed;
+      fastest = std::min(fastest, elapsed);
+    }
+
+    out << "  radius " << radius << " m, " << raster.m_columns << " x " << raster.m_rows << " cells, "
+        << raster.visibleCount() << " visible: mean " << static_cast<double>(total) / measuredViewshedCount
+        << " ms, fastest " << fastest << " ms" << endl;
+  }
+}
+
+} // Dsa
@@ -0,0 +1,109 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// dsa app headers
+#include "AlertBenchmarks.h"
+#include "TerrainProfileBenchmarks.h"
+#include "ViewshedBenchmarks.h"
+
+// Qt headers
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+
+using namespace Dsa;
+
+void printHelp()
+{
+  QTextStream out(stdout);
+  out << "Usage: DSA_Benchmarks_Qt [--elevation=<path>...] [benchmark...]" << endl;
+  out << "Runs each named benchmark, or all of them when none is named." << endl;
+  out << "The viewshed and intervisibility benchmarks read the surface from the DTED or GeoTIFF files given with --elevation." << endl;
+  out << "Available benchmarks:" << endl;
+  out << "  distance-join          The grid distance join against testing every pair" << endl;
+  out << "  graphics-removal       Removing graphics from a GraphicsOverlayAlertTarget" << endl;
+  out << "  intervisibility        The intervisibility matrix of 200 points" << endl;
+  out << "  prepared-polygon       PreparedPolygon against GeometryEngine::intersects" << endl;
+  out << "  quadtree               The original quadtree against the current one" << endl;
+  out << "  viewshed               CPU viewsheds at several radii" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  const QStringList available
+  {
+    QStringLiteral("distance-join"),
+    QStringLiteral("graphics-removal"),
+    QStringLiteral("intervisibility"),
+    QStringLiteral("prepared-polygon"),
+    QStringLiteral("quadtree"),
+    QStringLiteral("viewshed")
+  };
+
+  const QString elevationOption = QStringLiteral("--elevation=");
+  QStringList elevationPaths;
+  QStringList benchmarks;
+  for (const QString& argument : app.arguments().mid(1))
+  {
+    if (argument.startsWith(elevationOption))
+      elevationPaths.append(argument.mid(elevationOption.size()));
+    else
+      benchmarks.append(argument);
+  }
+
+  if (benchmarks.contains("-h"))
+  {
+    printHelp();
+    return 0;
+  }
+
+  for (const QString& benchmark : benchmarks)
+  {
+    if (!available.contains(benchmark))
+    {
+      QTextStream(stdout) << "Unknown benchmark: " << benchmark << endl;
+      printHelp();
+      return 1;
+    }
+  }
+
+  if (benchmarks.isEmpty())
+    benchmarks = available;
+
+  QTextStream out(stdout);
+
+  if (benchmarks.contains("graphics-removal"))
+    AlertBenchmarks::graphicsOverlayRemoval(out);
+
+  if (benchmarks.contains("quadtree"))
+    AlertBenchmarks::quadtreeComparison(out);
+
+  if (benchmarks.contains("distance-join"))
+    AlertBenchmarks::distanceJoinComparison(out);
+
+  if (benchmarks.contains("prepared-polygon"))
+    AlertBenchmarks::preparedPolygonComparison(out);
+
+  if (benchmarks.contains("viewshed"))
+    ViewshedBenchmarks::radii(out, elevationPaths);
+
+  if (benchmarks.contains("intervisibility"))
+    TerrainProfileBenchmarks::intervisibilityMatrix(out, elevationPaths);
+
+  return 0;
+}
@@ -28,5 +28,6 @@ SUBDIRS += \
 
 !android:!ios {
 SUBDIRS += \
-  MessageSimulator
+  MessageSimulator \
+  Benchmarks
 }
@@ -42,6 +42,7 @@
 #include "OptionsController.h"
 #include "RuntimePermissionRequest.h"
 #include "TableOfContentsController.h"
+#include "TerrainProfileController.h"
 #include "ViewedAlertsController.h"
 #include "ViewshedController.h"
 #include "PackageImageProvider.h"
@@ -142,6 +143,7 @@ int main(int argc, char *argv[])
   qmlRegisterType<Dsa::LocationTextController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "LocationTextController");
   qmlRegisterType<Dsa::AlertConditionsController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "AlertConditionsController");
   qmlRegisterType<Dsa::LineOfSightController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "LineOfSightController");
+  qmlRegisterType<Dsa::TerrainProfileController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "TerrainProfileController");
   qmlRegisterType<Dsa::ContextMenuController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "ContextMenuController");
   qmlRegisterType<Dsa::AnalysisListController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "AnalysisListController");
   qmlRegisterType<Dsa::ObservationReportController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "ObservationReportController");
@@ -330,6 +330,16 @@ Handheld {
             visible: false
         }
 
+        TerrainProfileTool {
+            id: terrainProfileTool
+            width: drawer.width
+            anchors {
+                right: parent.right
+                top: parent.top
+            }
+            visible: false
+        }
+
         AnalysisList {
             id: analysisListTool
             anchors {
@@ -0,0 +1,252 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "GeometryProjectionCache.h"
+
+// dsa app headers
+#include "GeoElementUtils.h"
+
+// C++ API headers
+#include "GeoElement.h"
+#include "GeometryEngine.h"
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::GeometryProjectionCache
+  \inmodule Dsa
+  \inherits QObject
+  \brief A cache of the WGS84 geometry and extent of
+  \l Esri::ArcGISRuntime::GeoElement objects.
+
+  Alert targets and the \l GeometryQuadtree work in WGS84 and repeatedly need the
+  projected geometry of the same elements. This cache projects each geometry once
+  and re-uses the result until the geometry of the element changes. Geometry which
+  is already in WGS84 is not projected at all.
+
+  The cache owns a single \l GeoElementSignaler per element which is shared by
+  all users. Since the cache is connected to the signaler first, the cached
+  geometry is always invalidated before any other user is notified of a
+  change. Entries are removed when the element is destroyed.
+
+  Each call to \l signaler must be balanced by a call to \l release once the
+  signaler is no longer used. Elements which are not QObjects cannot notify the
+  cache when they are destroyed, so their signaler is owned by the cache and their
+  entry is removed when the last user releases it.
+
+  The number of lookups which found an up-to-date geometry, and the number which had to
+  project it, are counted by \l hitCount and \l missCount.
+ */
+
+/*!
+  \brief Returns the shared instance of the cache.
+ */
+GeometryProjectionCache* GeometryProjectionCache::instance()
+{
+  static GeometryProjectionCache s_instance;
+
+  return &s_instance;
+}
+
+/*!
+  \internal
+ */
+GeometryProjectionCache::GeometryProjectionCache(QObject* parent):
+  QObject(parent)
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+GeometryProjectionCache::~GeometryProjectionCache()
+{
+}
+
+/*!
+  \brief Returns the shared \l GeoElementSignaler for \a geoElement.
+
+  Connect to this signaler, rather than creating a new one, to be notified
+  after the cached geometry has been invalidated. Call \l release once the
+  signaler is no longer used.
+ */
+GeoElementSignaler* GeometryProjectionCache::signaler(GeoElement* geoElement)
+{
+  if (!geoElement)
+    return nullptr;
+
+  Entry& cached = entry(geoElement);
+  ++cached.userCount;
+  return cached.signaler;
+}
+
+/*!
+  \brief Releases a signaler for \a geoElement obtained from \l signaler.
+
+  When the last user of an element which is not a QObject releases it, the entry
+  for the element is removed and its signaler is deleted.
+ */
+void GeometryProjectionCache::release(GeoElement* geoElement)
+{
+  auto findIt = m_entries.find(geoElement);
+  if (findIt == m_entries.end())
+    return;
+
+  Entry& cached = findIt.value();
+  if (cached.userCount > 0)
+    --cached.userCount;
+
+  // signalers parented to an element are deleted, and their entry removed, along with the element
+  if (cached.userCount > 0 || cached.signaler->parent() != this)
+    return;
+
+  // disconnect first, so that the deferred destruction does not remove a newer entry for the element
+  disconnect(cached.signaler, nullptr, this, nullptr);
+  cached.signaler->deleteLater();
+  m_entries.erase(findIt);
+}
+
+/*!
+  \brief Returns the geometry of \a geoElement in WGS84.
+ */
+Geometry GeometryProjectionCache::wgs84Geometry(GeoElement* geoElement)
+{
+  if (!geoElement)
+    return Geometry();
+
+  return upToDateEntry(geoElement).wgs84Geometry;
+}
+
+/*!
+  \brief Returns the extent of the geometry of \a geoElement in WGS84.
+ */
+Envelope GeometryProjectionCache::wgs84Extent(GeoElement* geoElement)
+{
+  if (!geoElement)
+    return Envelope();
+
+  return upToDateEntry(geoElement).wgs84Extent;
+}
+
+/*!
+  \brief Returns the version of the geometry of \a geoElement.
+
+  The version changes whenever the geometry of the element changes. Versions are never
+  re-used, so they can also be used to detect that an element has been replaced.
+ */
+quint64 GeometryProjectionCache::geometryVersion(GeoElement* geoElement)
+{
+  if (!geoElement)
+    return 0;
+
+  return entry(geoElement).version;
+}
+
+/*!
+  \brief Returns \a geometry projected to WGS84.
+
+  If the geometry is empty or already in WGS84 it is returned unchanged.
+ */
+Geometry GeometryProjectionCache::projectToWgs84(const Geometry& geometry)
+{
+  if (geometry.isEmpty() || geometry.spatialReference() == SpatialReference::wgs84())
+    return geometry;
+
+  return GeometryEngine::project(geometry, SpatialReference::wgs84());
+}
+
+/*!
+  \internal
+
+  Returns the entry for \a geoElement, creating it and connecting to changes if required.
+ */
+GeometryProjectionCache::Entry& GeometryProjectionCache::entry(GeoElement* geoElement)
+{
+  auto findIt = m_entries.find(geoElement);
+  if (findIt != m_entries.end())
+    return findIt.value();
+
+  // parent the signaler to the element (if possible) so that it is destroyed along with it
+  QObject* elementObject = GeoElementUtils::toQObject(geoElement);
+
+  Entry newEntry;
+  newEntry.signaler = new GeoElementSignaler(geoElement, elementObject ? elementObject : this);
+  newEntry.version = ++m_nextVersion;
+
+  // this is the first connection to the signaler, so it is called before any other users are notified
+  connect(newEntry.signaler, &GeoElementSignaler::geometryChanged, this, [this, geoElement]()
+  {
+    auto it = m_entries.find(geoElement);
+    if (it == m_entries.end())
+      return;
+
+    it.value().upToDate = false;
+    it.value().version = ++m_nextVersion;
+  });
+
+  connect(newEntry.signaler, &GeoElementSignaler::destroyed, this, [this, geoElement]()
+  {
+    m_entries.remove(geoElement);
+  });
+
+  return m_entries.insert(geoElement, newEntry).value();
+}
+
+/*!
+  \brief Returns the number of lookups which found an up-to-date geometry.
+ */
+quint64 GeometryProjectionCache::hitCount() const
+{
+  return m_hits;
+}
+
+/*!
+  \brief Returns the number of lookups which had to project the geometry.
+ */
+quint64 GeometryProjectionCache::missCount() const
+{
+  return m_misses;
+}
+
+/*!
+  \internal
+
+  Returns the entry for \a geoElement, projecting the geometry if it has changed.
+ */
+GeometryProjectionCache::Entry& GeometryProjectionCache::upToDateEntry(GeoElement* geoElement)
+{
+  Entry& cached = entry(geoElement);
+  if (cached.upToDate)
+  {
+    ++m_hits;
+  }
+  else
+  {
+    ++m_misses;
+    cached.wgs84Geometry = projectToWgs84(geoElement->geometry());
+    cached.wgs84Extent = cached.wgs84Geometry.extent();
+    cached.upToDate = true;
+  }
+
+  return cached;
+}
+
+} // Dsa
@@ -0,0 +1,83 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef GEOMETRYPROJECTIONCACHE_H
+#define GEOMETRYPROJECTIONCACHE_H
+
+// C++ API headers
+#include "Envelope.h"
+#include "Geometry.h"
+
+// Qt headers
+#include <QHash>
+#include <QObject>
+
+namespace Esri {
+namespace ArcGISRuntime {
+class GeoElement;
+}
+}
+
+namespace Dsa {
+
+class GeoElementSignaler;
+
+class GeometryProjectionCache : public QObject
+{
+  Q_OBJECT
+
+public:
+  static GeometryProjectionCache* instance();
+
+  ~GeometryProjectionCache();
+
+  GeoElementSignaler* signaler(Esri::ArcGISRuntime::GeoElement* geoElement);
+  void release(Esri::ArcGISRuntime::GeoElement* geoElement);
+
+  Esri::ArcGISRuntime::Geometry wgs84Geometry(Esri::ArcGISRuntime::GeoElement* geoElement);
+  Esri::ArcGISRuntime::Envelope wgs84Extent(Esri::ArcGISRuntime::GeoElement* geoElement);
+  quint64 geometryVersion(Esri::ArcGISRuntime::GeoElement* geoElement);
+
+  quint64 hitCount() const;
+  quint64 missCount() const;
+
+  static Esri::ArcGISRuntime::Geometry projectToWgs84(const Esri::ArcGISRuntime::Geometry& geometry);
+
+private:
+  explicit GeometryProjectionCache(QObject* parent = nullptr);
+
+  struct Entry
+  {
+    GeoElementSignaler* signaler = nullptr;
+    Esri::ArcGISRuntime::Geometry wgs84Geometry;
+    Esri::ArcGISRuntime::Envelope wgs84Extent;
+    quint64 version = 0;
+    int userCount = 0;
+    bool upToDate = false;
+  };
+
+  Entry& entry(Esri::ArcGISRuntime::GeoElement* geoElement);
+  Entry& upToDateEntry(Esri::ArcGISRuntime::GeoElement* geoElement);
+
+  QHash<Esri::ArcGISRuntime::GeoElement*, Entry> m_entries;
+  quint64 m_nextVersion = 0;
+  quint64 m_hits = 0;
+  quint64 m_misses = 0;
+};
+
+} // Dsa
+
+#endif // GEOMETRYPROJECTIONCACHE_H
@@ -1,4 +1,3 @@
-
 /*******************************************************************************
  *  Copyright 2012-2018 Esri
  *
@@ -20,6 +19,7 @@
 
 #include "GeometryQuadtree.h"
 #include "GeoElementUtils.h"
+#include "GeometryProjectionCache.h"
 
 // C++ API headers
 #include "Envelope.h"
@@ -28,45 +28,21 @@
 #include "Point.h"
 
 // Qt headers
-#include <QSet>
+#include <QTimer>
+
+// STL headers
+#include <algorithm>
+#include <cmath>
 
 using namespace Esri::ArcGISRuntime;
 
 namespace Dsa {
 
-struct GeometryQuadtree::QuadTree
+namespace
 {
-  explicit QuadTree(int level, double xMin, double xMax, double yMin, double yMax);
-  ~QuadTree();
-
-  QuadTree* createTopLeft(int maxLevels);
-  QuadTree* createTopRight(int maxLevels);
-  QuadTree* createBottomLeft(int maxLevels);
-  QuadTree* createBottomRight(int maxLevels);
-
-  bool assign(const Envelope& extent, int geomId, int maxLevels);
-  void prune();
-
-  QSet<int> intersectingIds(const Envelope& extent) const;
-  QSet<int> intersectingIds(const Point& location) const;
-
-  bool contains(const Envelope& extent) const;
-  bool intersects(const Envelope& extent) const;
-  bool intersects(const Point& location) const;
-
-  void removeId(int geomId);
-
-  int m_level = 0;
-  double m_xMin = 0.0;
-  double m_xMax = 0.0;
-  double m_yMin = 0.0;
-  double m_yMax = 0.0;
-  QuadTree* m_tl = nullptr; // top left
-  QuadTree* m_tr = nullptr; // top right
-  QuadTree* m_bl = nullptr; // bottom left
-  QuadTree* m_br = nullptr; // bottom right
-  QSet<int> m_geometryIds;
-};
+// the smallest root cell used for a degenerate extent (e.g. a single point), in degrees
+constexpr double minimumRootHalfSize = 0.001;
+}
 
 /*!
   \class Dsa::GeometryQuadtree
@@ -77,11 +53,31 @@ struct GeometryQuadtree::QuadTree
 
   The tree then allows geometric tests for candidate intersections against
   query geometries.
+
+  This is a loose quadtree: each node covers a square cell but accepts any element
+  whose center lies in the cell and whose extent fits within twice the cell's size.
+  Every element is therefore stored in exactly one node, chosen from the size and
+  center of its extent. When an element moves, it is only re-assigned if it no longer
+  fits its node, and elements outside the tree cause the root to grow rather than the
+  tree to be rebuilt.
+
+  Nodes are held in a contiguous array and re-used once they become empty.
+
+  Geometry changes are batched: each change only marks the element as pending and
+  all pending elements are moved in a single pass on the next turn of the event loop
+  (or by \l updateGeoElements). Queries never modify the tree; until then, they test
+  pending elements against their current extent instead of their node.
+
+  The WGS84 extent of each element is obtained from the shared
+  \l GeometryProjectionCache, so elements are only projected when their
+  geometry changes.
  */
 
 /*!
   \brief Constructor taking the \a extent of the quadtree, the list of \a geoElements
   which the tree should include, the \a maxLevels for the tree and an optional \a parent.
+
+  The \a maxLevels sets the smallest cell size in the tree, relative to the \a extent.
  */
 GeometryQuadtree::GeometryQuadtree(const Envelope& extent,
                                    const QList<GeoElement*>& geoElements,
@@ -102,12 +98,15 @@ GeometryQuadtree::GeometryQuadtree(const Envelope& extent,
  */
 GeometryQuadtree::~GeometryQuadtree()
 {
+  GeometryProjectionCache* projectionCache = GeometryProjectionCache::instance();
+  for (const Element& element : qAsConst(m_elementStorage))
+    projectionCache->release(element.m_geoElement);
 }
 
 /*!
   \brief Adds the \a newGeoElement into the quadtree.
 
-  \note The tree will be re-built.
+  \note Only the node which will contain the element is updated.
  */
 void GeometryQuadtree::appendGeoElment(GeoElement* newGeoElement)
 {
@@ -118,6 +117,39 @@ void GeometryQuadtree::appendGeoElment(GeoElement* newGeoElement)
   handleGeometryChange(newKey);
 }
 
+/*!
+  \brief Removes the \a geoElement from the quadtree.
+
+  Only the node which contains the element is visited, so the cost of the removal
+  does not depend on the number of other elements in the tree.
+ */
+void GeometryQuadtree::removeGeoElement(GeoElement* geoElement)
+{
+  const auto findIt = m_elementKeys.constFind(geoElement);
+  if (findIt == m_elementKeys.cend())
+    return;
+
+  removeKey(findIt.value());
+}
+
+/*!
+  \brief Updates the tree for the new geometry of all of the \a geoElements in a single pass.
+
+  Use this when many elements are known to have moved at once, for example when
+  processing a batch of messages.
+ */
+void GeometryQuadtree::updateGeoElements(const QList<GeoElement*>& geoElements)
+{
+  for (GeoElement* geoElement : geoElements)
+  {
+    const auto findIt = m_elementKeys.constFind(geoElement);
+    if (findIt != m_elementKeys.cend())
+      markGeometryChanged(findIt.value());
+  }
+
+  processPendingChanges();
+}
+
 /*!
   \brief Returns the list of \l Geometry objects which are in quadtree cells which intersect \a geometry
 
@@ -132,61 +164,87 @@ QList<Geometry> GeometryQuadtree::candidateIntersections(const Geometry& geometr
 /*!
   \brief Returns the list of \l Geometry objects which are in quadtree cells which intersect \a extent
 
+  The geometry is returned in WGS84.
+
   \note No intersection test is carried out between the supplied Envelope and the results. For exact results,
   you should perform the desired geometry tests on the list of \l Geometry objects returned.
  */
 QList<Geometry> GeometryQuadtree::candidateIntersections(const Envelope& extent) const
 {
-  // ensure the extent is in WGS84
-  const Envelope wgs84 = GeometryEngine::project(extent, SpatialReference::wgs84());
+  // collect the (cached) WGS84 Geometry of each candidate element
+  const QList<GeoElement*> elements = candidateElements(extent);
+  QList<Geometry> results;
+  results.reserve(elements.size());
+  for (GeoElement* element : elements)
+    results.push_back(GeometryProjectionCache::instance()->wgs84Geometry(element));
 
-  // obtain the indices of Geometry objects from quadtree nodes which intersect the extent
-  QSet<int> geomIds = m_tree->intersectingIds(wgs84);
+  return results;
+}
 
-  // collect the Geometry objects with an intersecting Id
-  QList<Geometry> results;
-  for(const int id: geomIds)
-  {
-    // attempt to find the element Id in the lookup. If the element has been removed it may not be found
-    auto findIt = m_elementStorage.find(id);
-    if (findIt != m_elementStorage.end())
-    {
-      GeoElementSignaler* element = findIt.value();
-      if (element)
-        results.push_back(element->geoElement()->geometry());
-    }
-  }
+/*!
+  \brief Returns the list of \l Esri::ArcGISRuntime::GeoElement objects which are in quadtree cells
+  which intersect \a extent
+
+  \note No intersection test is carried out between the supplied Envelope and the results. For exact results,
+  you should perform the desired geometry tests on the geometry of the elements returned.
+ */
+QList<GeoElement*> GeometryQuadtree::candidateElements(const Envelope& extent) const
+{
+  QVector<GeoElementCandidate> candidates;
+  candidateElements(extent, candidates);
+
+  QList<GeoElement*> results;
+  results.reserve(candidates.size());
+  for (const GeoElementCandidate& candidate : candidates)
+    results.push_back(candidate.geoElement);
 
   return results;
 }
 
+/*!
+  \brief Appends a \l GeoElementCandidate to \a candidates for each element whose cached
+  WGS84 extent intersects \a extent.
+
+  The \a candidates buffer is not cleared, so it can be re-used across queries without
+  allocating. Each candidate carries the id of the element in the tree and its WGS84 extent.
+
+  \note No intersection test is carried out between the supplied Envelope and the geometry
+  of the results.
+ */
+void GeometryQuadtree::candidateElements(const Envelope& extent, QVector<GeoElementCandidate>& candidates) const
+{
+  // ensure the extent is in WGS84
+  const Envelope wgs84 = GeometryProjectionCache::projectToWgs84(extent);
+  if (wgs84.isEmpty())
+    return;
+
+  appendCandidates(wgs84.xMin(), wgs84.xMax(), wgs84.yMin(), wgs84.yMax(), candidates);
+}
+
 /*!
   \brief Returns the list of \l Geometry objects which are in quadtree cells which intersect \a location
 
+  The geometry is returned in WGS84.
+
   \note No intersection test is carried out between the supplied point and the results. For exact results,
   you should perform the desired geometry tests on the list of \l Geometry objects returned.
  */
 QList<Geometry> GeometryQuadtree::candidateIntersections(const Point& location) const
 {
-  // ensure the extent is in WGS84
-  const Point wgs84 = GeometryEngine::project(location, SpatialReference::wgs84());
+  // ensure the location is in WGS84
+  const Point wgs84 = GeometryProjectionCache::projectToWgs84(location);
+  if (wgs84.isEmpty())
+    return QList<Geometry>();
 
-  // obtain the indices of Geometry objects from quadtree nodes which contain the location
-  QSet<int> geomIds = m_tree->intersectingIds(wgs84);
+  // obtain the elements whose extent contains the location
+  QVector<GeoElementCandidate> candidates;
+  appendCandidates(wgs84.x(), wgs84.x(), wgs84.y(), wgs84.y(), candidates);
 
-  // collect the Geometry objects with an intersecting Id
+  // collect the (cached) WGS84 Geometry of each candidate
   QList<Geometry> results;
-  for(const int id: geomIds)
-  {
-    // attempt to find the element Id in the lookup. If the element has been removed it may not be found
-    auto findIt = m_elementStorage.find(id);
-    if (findIt != m_elementStorage.end())
-    {
-      GeoElementSignaler* element = findIt.value();
-      if (element)
-        results.push_back(element->geoElement()->geometry());
-    }
-  }
+  results.reserve(candidates.size());
+  for (const GeoElementCandidate& candidate : candidates)
+    results.push_back(GeometryProjectionCache::instance()->wgs84Geometry(candidate.geoElement));
 
   return results;
 }
@@ -197,72 +255,131 @@ QList<Geometry> GeometryQuadtree::candidateIntersections(const Point& location)
 void GeometryQuadtree::buildTree(const Envelope& extent)
 {
   // ensure the tree's extent is in WGS84
-  const Envelope extentWgs84 = GeometryEngine::project(extent, SpatialReference::wgs84());
+  const Envelope extentWgs84 = GeometryProjectionCache::projectToWgs84(extent);
 
-  // build the (currently empty) tree to the desired depth
-  m_tree.reset(new QuadTree(0, extentWgs84.xMin(), extentWgs84.xMax(), extentWgs84.yMin(), extentWgs84.yMax()));
+  m_nodes.clear();
+  m_freeNodes.clear();
+  m_root = -1;
 
-  // assign the geometry of each element to the tree, along with its id in the lookup
-  auto it = m_elementStorage.cbegin();
-  auto itEnd = m_elementStorage.cend();
-  for (; it != itEnd; ++it)
+  // the root is the square cell covering the extent. Further elements outside of this will expand the root
+  double rootHalfSize = minimumRootHalfSize;
+  double rootX = 0.0;
+  double rootY = 0.0;
+  if (!extentWgs84.isEmpty())
   {
-    GeoElementSignaler* element = it.value();
-    if (!element)
-      continue;
+    rootHalfSize = std::max(rootHalfSize, 0.5 * std::max(extentWgs84.width(), extentWgs84.height()));
+    rootX = 0.5 * (extentWgs84.xMin() + extentWgs84.xMax());
+    rootY = 0.5 * (extentWgs84.yMin() + extentWgs84.yMax());
+  }
+
+  m_root = allocateNode(rootX, rootY, rootHalfSize, -1);
 
-    const Geometry wgs84 = GeometryEngine::project(element->geoElement()->geometry(), SpatialReference::wgs84());
-    m_tree->assign(wgs84.extent(), it.key(), m_maxLevels);
+  // the smallest cell is fixed by the initial extent, even if the root later expands
+  m_minHalfSize = std::ldexp(rootHalfSize, -std::max(0, m_maxLevels));
+
+  // assign the extent of each element to the tree, along with its key in the lookup
+  for (auto it = m_elementStorage.begin(); it != m_elementStorage.end(); ++it)
+  {
+    Element& element = it.value();
+    element.m_node = -1;
+    element.m_pending = false;
+    if (updateElementExtent(element))
+      insertElement(it.key(), element);
   }
 
-  // remove any nodes from the tree which contain no geometry
-  m_tree->prune();
+  m_pendingChanges.clear();
 
   emit treeChanged();
 }
 
 /*!
   \internal
+
+  Update the tree for the element with key \a changedId, moving it in place.
  */
 void GeometryQuadtree::handleGeometryChange(int changedId)
 {
-  const GeoElementSignaler* changedElement = m_elementStorage.value(changedId);
-  if (!changedElement)
+  auto findIt = m_elementStorage.find(changedId);
+  if (findIt == m_elementStorage.end())
     return;
 
-  const Geometry wgs84Geom = GeometryEngine::project(changedElement->geoElement()->geometry(), SpatialReference::wgs84());
-  const Envelope wgs84Extent = wgs84Geom.extent();
+  moveElement(changedId, findIt.value());
+  emit treeChanged();
+}
+
+/*!
+  \internal
+
+  Record that the geometry of the element with key \a changedId has changed.
+
+  The tree is updated for all changed elements at once, on the next turn of the event loop.
+ */
+void GeometryQuadtree::markGeometryChanged(int changedId)
+{
+  auto findIt = m_elementStorage.find(changedId);
+  if (findIt == m_elementStorage.end() || findIt.value().m_pending)
+    return;
+
+  if (m_pendingChanges.isEmpty())
+    QTimer::singleShot(0, this, &GeometryQuadtree::processPendingChanges);
+
+  findIt.value().m_pending = true;
+  m_pendingChanges.append(changedId);
+}
+
+/*!
+  \internal
 
-  // if the extent of the changed geom is the same or smaller than the existing tree, it can still be used
-  if (m_tree->m_xMin <= wgs84Extent.xMin() &&
-      m_tree->m_xMax >= wgs84Extent.xMax() &&
-      m_tree->m_yMin <= wgs84Extent.yMin() &&
-      m_tree->m_yMax >= wgs84Extent.yMax())
+  Move every element with a pending geometry change and notify once.
+ */
+void GeometryQuadtree::processPendingChanges()
+{
+  if (m_pendingChanges.isEmpty())
+    return;
+
+  const QVector<int> pendingChanges = m_pendingChanges;
+  m_pendingChanges.clear();
+
+  for (const int key : pendingChanges)
   {
-    m_tree->removeId(changedId);
-    m_tree->assign(wgs84Geom.extent(), changedId, m_maxLevels);
-    m_tree->prune();
-    emit treeChanged();
+    // the element may have been removed since the change was recorded
+    auto findIt = m_elementStorage.find(key);
+    if (findIt == m_elementStorage.end())
+      continue;
+
+    findIt.value().m_pending = false;
+    moveElement(key, findIt.value());
   }
-  // otherwise calculate the new extent and rebuild the tree
-  else
-  {
-    QList<Geometry> allGeom;
-    for(auto it = m_elementStorage.begin(); it != m_elementStorage.end(); ++it)
-    {
-      GeoElementSignaler* element = it.value();
-      if (!element)
-        continue;
 
-      if (element->geoElement()->geometry().isEmpty())
-        continue;
+  emit treeChanged();
+}
 
-      allGeom.append(GeometryEngine::project(element->geoElement()->geometry(), SpatialReference::wgs84()));
-    }
+/*!
+  \internal
+
+  Update the node of the \a element with \a key for its current extent, moving it in place
+  if it still fits its current node.
+ */
+void GeometryQuadtree::moveElement(int key, Element& element)
+{
+  const bool hasExtent = updateElementExtent(element);
 
-    const Geometry newExtent = GeometryEngine::combineExtents(allGeom);
-    buildTree(newExtent);
+  // if the element still fits its current node, only the stored extent needs to change
+  if (hasExtent && element.m_node != -1)
+  {
+    const double halfSize = 0.5 * std::max(element.m_xMax - element.m_xMin, element.m_yMax - element.m_yMin);
+    const double x = 0.5 * (element.m_xMin + element.m_xMax);
+    const double y = 0.5 * (element.m_yMin + element.m_yMax);
+    const Node& node = m_nodes[element.m_node];
+    const double childHalfSize = 0.5 * node.m_halfSize;
+    const bool couldDescend = childHalfSize >= m_minHalfSize && halfSize <= childHalfSize;
+    if (!couldDescend && fitsNode(element.m_node, x, y, halfSize))
+      return;
   }
+
+  detachElement(key, element);
+  if (hasExtent)
+    insertElement(key, element);
 }
 
 /*!
@@ -277,49 +394,31 @@ int GeometryQuadtree::handleNewGeoElement(GeoElement* geoElement)
   if (!geoElement)
     return -1;
 
-  GeoElementSignaler* signaler = new GeoElementSignaler(geoElement, GeoElementUtils::toQObject(geoElement));
+  // do not add the same element more than once
+  const auto existingIt = m_elementKeys.constFind(geoElement);
+  if (existingIt != m_elementKeys.cend())
+    return existingIt.value();
 
-  m_elementStorage.insert(m_nextKey, signaler);
+  // use the shared signaler, which is notified after the cached WGS84 geometry has been invalidated
+  GeoElementSignaler* signaler = GeometryProjectionCache::instance()->signaler(geoElement);
+
+  Element element;
+  element.m_geoElement = geoElement;
+  element.m_signaler = signaler;
+  m_elementStorage.insert(m_nextKey, element);
+  m_elementKeys.insert(geoElement, m_nextKey);
   const int insertedKey = m_nextKey;
   m_nextKey++;
 
-  connect(signaler, &GeoElementSignaler::geometryChanged, this, [this, signaler]()
+  // the key is captured so that no search is required when the element changes
+  connect(signaler, &GeoElementSignaler::geometryChanged, this, [this, insertedKey]()
   {
-    auto it = m_elementStorage.cbegin();
-    auto itEnd = m_elementStorage.cend();
-    for (; it != itEnd; ++it)
-    {
-      GeoElementSignaler* testElement = it.value();
-      if (!testElement)
-        continue;
-
-      if (testElement == signaler)
-      {
-        handleGeometryChange(it.key());
-        return;
-      }
-    }
+    markGeometryChanged(insertedKey);
   });
 
-  connect(signaler, &GeoElementSignaler::destroyed, this, [this, signaler]()
+  connect(signaler, &GeoElementSignaler::destroyed, this, [this, insertedKey]()
   {
-    auto it = m_elementStorage.cbegin();
-    auto itEnd = m_elementStorage.cend();
-    for (; it != itEnd; ++it)
-    {
-      GeoElementSignaler* testElement = it.value();
-      if (!testElement)
-        continue;
-
-      if (testElement == signaler)
-      {
-        m_tree->removeId(it.key());
-        m_tree->prune();
-        m_elementStorage.remove(it.key());
-        emit treeChanged();
-        return;
-      }
-    }
+    removeKey(insertedKey);
   });
 
   return insertedKey;
@@ -327,331 +426,300 @@ int GeometryQuadtree::handleNewGeoElement(GeoElement* geoElement)
 
 /*!
   \internal
- */
-GeometryQuadtree::QuadTree::QuadTree(int level, double xMin, double xMax, double yMin, double yMax):
-  m_level(level),
-  m_xMin(xMin),
-  m_xMax(xMax),
-  m_yMin(yMin),
-  m_yMax(yMax)
-{
-}
 
-/*!
-  \internal
+  Removes the element stored with \a key from the tree and stops listening to its changes.
  */
-GeometryQuadtree::QuadTree::~QuadTree()
+void GeometryQuadtree::removeKey(int key)
 {
-  if (m_tl)
-    delete m_tl;
-
-  if (m_tr)
-    delete m_tr;
-
-  if (m_bl)
-    delete m_bl;
-
-  if (m_br)
-    delete m_br;
-}
-
-GeometryQuadtree::QuadTree* GeometryQuadtree::QuadTree::createTopLeft(int maxLevels)
-{
-  // if we have not reached the max depth of the tree, add the child nodes
-  if (m_level > maxLevels)
-    return nullptr;
-
-  const double xMid = ((m_xMax - m_xMin) * 0.5) + m_xMin;
-  const double yMid = ((m_yMax - m_yMin) * 0.5) + m_yMin;
-
-  return new QuadTree(m_level +1, m_xMin, xMid, yMid, m_yMax);
-}
+  auto findIt = m_elementStorage.find(key);
+  if (findIt == m_elementStorage.end())
+    return;
 
-GeometryQuadtree::QuadTree* GeometryQuadtree::QuadTree::createTopRight(int maxLevels)
-{
-  // if we have not reached the max depth of the tree, add the child nodes
-  if (m_level > maxLevels)
-    return nullptr;
+  detachElement(key, findIt.value());
 
-  const double xMid = ((m_xMax - m_xMin) * 0.5) + m_xMin;
-  const double yMid = ((m_yMax - m_yMin) * 0.5) + m_yMin;
+  // the signaler is shared, so only remove the connections made by this tree
+  GeoElementSignaler* signaler = findIt.value().m_signaler;
+  disconnect(signaler, nullptr, this, nullptr);
+  GeometryProjectionCache::instance()->release(findIt.value().m_geoElement);
+  m_elementKeys.remove(findIt.value().m_geoElement);
+  m_elementStorage.erase(findIt);
 
-  return new QuadTree(m_level + 1, xMid, m_xMax, yMid, m_yMax);
+  emit treeChanged();
 }
 
-GeometryQuadtree::QuadTree* GeometryQuadtree::QuadTree::createBottomLeft(int maxLevels)
-{
-  // if we have not reached the max depth of the tree, add the child nodes
-  if (m_level > maxLevels)
-    return nullptr;
-
-  const double xMid = ((m_xMax - m_xMin) * 0.5) + m_xMin;
-  const double yMid = ((m_yMax - m_yMin) * 0.5) + m_yMin;
+/*!
+  \internal
 
-  return new QuadTree(m_level + 1, m_xMin, xMid, m_yMin, yMid);
-}
+  Store the current WGS84 extent of the \a element.
 
-GeometryQuadtree::QuadTree* GeometryQuadtree::QuadTree::createBottomRight(int maxLevels)
+  Returns \c false if the element has no geometry.
+ */
+bool GeometryQuadtree::updateElementExtent(Element& element)
 {
-  // if we have not reached the max depth of the tree, add the child nodes
-  if (m_level > maxLevels)
-    return nullptr;
+  if (!element.m_signaler)
+    return false;
 
-  const double xMid = ((m_xMax - m_xMin) * 0.5) + m_xMin;
-  const double yMid = ((m_yMax - m_yMin) * 0.5) + m_yMin;
+  const Envelope extent = GeometryProjectionCache::instance()->wgs84Extent(element.m_geoElement);
+  if (extent.isEmpty() ||
+      !std::isfinite(extent.xMin()) || !std::isfinite(extent.xMax()) ||
+      !std::isfinite(extent.yMin()) || !std::isfinite(extent.yMax()))
+  {
+    return false;
+  }
 
-  return new QuadTree(m_level + 1, xMid, m_xMax, m_yMin, yMid);
+  element.m_xMin = extent.xMin();
+  element.m_xMax = extent.xMax();
+  element.m_yMin = extent.yMin();
+  element.m_yMax = extent.yMax();
+  return true;
 }
 
 /*!
   \internal
+
+  Assign the \a element with \a key to the deepest node which will hold it, creating nodes as required.
  */
-bool GeometryQuadtree::QuadTree::assign(const Envelope& extent, int geomIndex, int maxLevels)
+void GeometryQuadtree::insertElement(int key, Element& element)
 {
-  // if the extent of the incoming geometry does not lie within this node, return
-  if (!intersects(extent))
-    return false;
+  const double halfSize = 0.5 * std::max(element.m_xMax - element.m_xMin, element.m_yMax - element.m_yMin);
+  const double x = 0.5 * (element.m_xMin + element.m_xMax);
+  const double y = 0.5 * (element.m_yMin + element.m_yMax);
 
-  // record this geometry index
-  m_geometryIds.insert(geomIndex);
+  expandRoot(x, y, halfSize);
 
-  // (recursively) attempt to assign the geomeytry to each child node
-  // if the node already exists, just assign
-  if (m_tl)
+  // descend towards the center of the element while its extent fits within a child's loose bounds
+  int nodeIndex = m_root;
+  while (true)
   {
-    m_tl->assign(extent, geomIndex, maxLevels);
-  }
-  // otherwise, create a temporary node and only keep it if it will contain this geometry
-  else
-  {
-    QuadTree* temp = createTopLeft(maxLevels);
-    if (temp && temp->assign(extent, geomIndex, maxLevels))
-      m_tl = temp;
-    else
-      delete temp;
-  }
-
-  if (m_tr)
-  {
-    m_tr->assign(extent, geomIndex, maxLevels);
-  }
-  else
-  {
-    QuadTree* temp = createTopRight(maxLevels);
-    if (temp && temp->assign(extent, geomIndex, maxLevels))
-      m_tr = temp;
-    else
-      delete temp;
-  }
+    const double childHalfSize = 0.5 * m_nodes[nodeIndex].m_halfSize;
+    if (childHalfSize < m_minHalfSize || halfSize > childHalfSize)
+      break;
+
+    const Node& node = m_nodes[nodeIndex];
+    const int quadrant = (x >= node.m_x ? 1 : 0) + (y >= node.m_y ? 2 : 0);
+    int childIndex = node.m_children[quadrant];
+    if (childIndex == -1)
+    {
+      const double childX = node.m_x + ((quadrant & 1) ? childHalfSize : -childHalfSize);
+      const double childY = node.m_y + ((quadrant & 2) ? childHalfSize : -childHalfSize);
+      childIndex = allocateNode(childX, childY, childHalfSize, nodeIndex);
 
-  if (m_bl)
-  {
-    m_bl->assign(extent, geomIndex, maxLevels);
-  }
-  else
-  {
-    QuadTree* temp = createBottomLeft(maxLevels);
-    if (temp && temp->assign(extent, geomIndex, maxLevels))
-      m_bl = temp;
-    else
-      delete temp;
-  }
+      // note that allocateNode may have moved the node storage
+      m_nodes[nodeIndex].m_children[quadrant] = childIndex;
+    }
 
-  if (m_br)
-  {
-    m_br->assign(extent, geomIndex, maxLevels);
-  }
-  else
-  {
-    QuadTree* temp = createBottomRight(maxLevels);
-    if (temp && temp->assign(extent, geomIndex, maxLevels))
-      m_br = temp;
-    else
-      delete temp;
+    nodeIndex = childIndex;
   }
 
-  return true;
+  m_nodes[nodeIndex].m_geometryIds.append(key);
+  element.m_node = nodeIndex;
 }
 
 /*!
   \internal
+
+  Remove the \a element with \a key from its node and release any nodes which are no longer used.
  */
-void GeometryQuadtree::QuadTree::prune()
+void GeometryQuadtree::detachElement(int key, Element& element)
 {
-  // for each existing child node remove the node (and any children if they are empty)
-  if (m_tl)
-  {
-    // remove the node (and all of it's children) if it is empty
-    if (m_tl->m_geometryIds.empty())
-    {
-      delete m_tl;
-      m_tl = nullptr;
-    }
-    // (recursively) call prune on the child
-    else
-    {
-      m_tl->prune();
-    }
-  }
-
-  if (m_tr)
-  {
-    if (m_tr->m_geometryIds.empty())
-    {
-      delete m_tr;
-      m_tr = nullptr;
-    }
-    else
-    {
-      m_tr->prune();
-    }
-  }
+  if (element.m_node == -1)
+    return;
 
-  if (m_bl)
+  QVarLengthArray<int, 4>& ids = m_nodes[element.m_node].m_geometryIds;
+  for (int i = 0; i < ids.size(); ++i)
   {
-    if (m_bl->m_geometryIds.empty())
-    {
-      delete m_bl;
-      m_bl = nullptr;
-    }
-    else
+    if (ids[i] == key)
     {
-      m_bl->prune();
+      ids[i] = ids[ids.size() - 1];
+      ids.removeLast();
+      break;
     }
   }
 
-  if (m_br)
-  {
-    if (m_br->m_geometryIds.empty())
-    {
-      delete m_br;
-      m_br = nullptr;
-    }
-    else
-    {
-      m_br->prune();
-    }
-  }
+  pruneNode(element.m_node);
+  element.m_node = -1;
 }
 
 /*!
   \internal
- */
-QSet<int> GeometryQuadtree::QuadTree::intersectingIds(const Envelope& extent) const
-{
-  // if this node contains no geometry indices there is no intersection
-  if (m_geometryIds.empty())
-    return QSet<int>();
-
-  // if this node does not intersect with the supplied extent, there is no intersection
-  if (!intersects(extent))
-    return QSet<int>();
-
-  // if this node intersects but has no children, it must be a leaf node: return all geometry indices
-  if (!m_tl && !m_tr && !m_bl && !m_br)
-    return m_geometryIds;
-
-  // for each existing child node, (recursively) build up the set of intersecting indices
-  QSet<int> result;
-  if (m_tl)
-    result += m_tl->intersectingIds(extent);
 
-  if (m_tr)
-    result += m_tr->intersectingIds(extent);
+  Grow the root until it holds an element centered on \a x, \a y with a \a halfSize.
 
-  if (m_bl)
-    result += m_bl->intersectingIds(extent);
-
-  if (m_br)
-    result += m_br->intersectingIds(extent);
-
-  return result;
+  Each step doubles the root, with the previous root becoming one of its children.
+ */
+void GeometryQuadtree::expandRoot(double x, double y, double halfSize)
+{
+  while (!fitsNode(m_root, x, y, halfSize))
+  {
+    const Node& oldRoot = m_nodes[m_root];
+    const double offsetX = x >= oldRoot.m_x ? oldRoot.m_halfSize : -oldRoot.m_halfSize;
+    const double offsetY = y >= oldRoot.m_y ? oldRoot.m_halfSize : -oldRoot.m_halfSize;
+    const int oldRootIndex = m_root;
+    const int newRoot = allocateNode(oldRoot.m_x + offsetX, oldRoot.m_y + offsetY, 2.0 * oldRoot.m_halfSize, -1);
+
+    // the old root is the quadrant of the new root which lies opposite to the element
+    const int quadrant = (offsetX < 0.0 ? 1 : 0) + (offsetY < 0.0 ? 2 : 0);
+    m_nodes[newRoot].m_children[quadrant] = oldRootIndex;
+    m_nodes[oldRootIndex].m_parent = newRoot;
+    m_root = newRoot;
+  }
 }
 
 /*!
   \internal
+
+  Returns whether an element centered on \a x, \a y with a \a halfSize fits the node at \a nodeIndex.
  */
-QSet<int> GeometryQuadtree::QuadTree::intersectingIds(const Point& location) const
+bool GeometryQuadtree::fitsNode(int nodeIndex, double x, double y, double halfSize) const
 {
-  // if this node contains no geometry indices, there is no intersection
-  if (m_geometryIds.empty())
-    return QSet<int>();
-
-  // if this node does not intersect with the supplied extent, there is no intersection
-  if (!intersects(location))
-    return QSet<int>();
-
-  // if this node intesects but has no children, it must be a leaf node: return all geometry indices
-  if (!m_tl && !m_tr && !m_bl && !m_br)
-    return m_geometryIds;
-
-  // for each existing child node, (recursively) build up the set of intersecting indices
-  QSet<int> result;
-  if (m_tl)
-    result += m_tl->intersectingIds(location);
-
-  if (m_tr)
-    result += m_tr->intersectingIds(location);
-
-  if (m_bl)
-    result += m_bl->intersectingIds(location);
-
-  if (m_br)
-    result += m_br->intersectingIds(location);
-
-  return result;
+  const Node& node = m_nodes[nodeIndex];
+  return halfSize <= node.m_halfSize &&
+      x >= node.m_x - node.m_halfSize &&
+      x <= node.m_x + node.m_halfSize &&
+      y >= node.m_y - node.m_halfSize &&
+      y <= node.m_y + node.m_halfSize;
 }
 
 /*!
   \internal
+
+  Returns the index of a new node, re-using a released node where possible.
  */
-bool GeometryQuadtree::QuadTree::contains(const Envelope& extent) const
+int GeometryQuadtree::allocateNode(double x, double y, double halfSize, int parent)
 {
-  return (extent.xMin() >= m_xMin &&
-          extent.xMax() <= m_xMax &&
-          extent.yMin() >= m_yMin &&
-          extent.yMax() <= m_yMax);
+  Node node;
+  node.m_x = x;
+  node.m_y = y;
+  node.m_halfSize = halfSize;
+  node.m_parent = parent;
+
+  if (!m_freeNodes.isEmpty())
+  {
+    const int index = m_freeNodes.takeLast();
+    m_nodes[index] = node;
+    return index;
+  }
+
+  m_nodes.push_back(node);
+  return static_cast<int>(m_nodes.size()) - 1;
 }
 
 /*!
   \internal
+
+  Release the node at \a nodeIndex, and then its parents, while they hold no elements and have no children.
  */
-bool GeometryQuadtree::QuadTree::intersects(const Envelope& extent) const
+void GeometryQuadtree::pruneNode(int nodeIndex)
 {
-  // return whether the supplied extent overlaps this cell
-  return (extent.xMin() < m_xMax &&
-          extent.xMax() > m_xMin &&
-          extent.yMin() < m_yMax &&
-          extent.yMax() > m_yMin);
+  while (nodeIndex != -1 && nodeIndex != m_root)
+  {
+    Node& node = m_nodes[nodeIndex];
+    if (!node.m_geometryIds.isEmpty())
+      return;
+
+    for (const int child : node.m_children)
+    {
+      if (child != -1)
+        return;
+    }
+
+    const int parent = node.m_parent;
+    Node& parentNode = m_nodes[parent];
+    for (int& child : parentNode.m_children)
+    {
+      if (child == nodeIndex)
+        child = -1;
+    }
+
+    node.m_parent = -1;
+    m_freeNodes.append(nodeIndex);
+    nodeIndex = parent;
+  }
 }
 
 /*!
   \internal
+
+  Appends to \a candidates the elements whose extent intersects the extent \a xMin, \a xMax, \a yMin, \a yMax.
+
+  Only nodes whose loose bounds (twice the size of the cell) intersect the extent are visited.
+  Elements whose geometry change has not been processed yet are skipped in the nodes and
+  tested against their current extent afterwards.
  */
-bool GeometryQuadtree::QuadTree::intersects(const Point& location) const
+void GeometryQuadtree::appendCandidates(double xMin, double xMax, double yMin, double yMax, QVector<GeoElementCandidate>& candidates) const
 {
-  // return whether the supplied location lies within this cell
-  return (location.x() <= m_xMax &&
-          location.x() >= m_xMin &&
-          location.y() <= m_yMax &&
-          location.y() >= m_yMin);
-}
+  if (m_root == -1)
+    return;
 
-void GeometryQuadtree::QuadTree::removeId(int index)
-{
-  if (m_geometryIds.remove(index))
+  QVarLengthArray<int, 64> stack;
+  stack.append(m_root);
+  while (!stack.isEmpty())
   {
-    if (m_tl)
-      m_tl->removeId(index);
+    const int nodeIndex = stack.last();
+    stack.removeLast();
 
-    if (m_tr)
-      m_tr->removeId(index);
+    const Node& node = m_nodes[nodeIndex];
+    const double looseHalfSize = 2.0 * node.m_halfSize;
+    if (xMin > node.m_x + looseHalfSize || xMax < node.m_x - looseHalfSize ||
+        yMin > node.m_y + looseHalfSize || yMax < node.m_y - looseHalfSize)
+    {
+      continue;
+    }
+
+    for (const int key : node.m_geometryIds)
+    {
+      const auto findIt = m_elementStorage.constFind(key);
+      if (findIt == m_elementStorage.cend() || !findIt.value().m_signaler)
+        continue;
 
-    if (m_bl)
-      m_bl->removeId(index);
+      const Element& element = findIt.value();
+      if (element.m_pending)
+        continue;
 
-    if (m_br)
-      m_br->removeId(index);
+      if (element.m_xMin <= xMax && element.m_xMax >= xMin &&
+          element.m_yMin <= yMax && element.m_yMax >= yMin)
+      {
+        GeoElementCandidate candidate;
+        candidate.geoElement = element.m_geoElement;
+        candidate.id = key;
+        candidate.xMin = element.m_xMin;
+        candidate.xMax = element.m_xMax;
+        candidate.yMin = element.m_yMin;
+        candidate.yMax = element.m_yMax;
+        candidates.append(candidate);
+      }
+    }
+
+    for (const int child : node.m_children)
+    {
+      if (child != -1)
+        stack.append(child);
+    }
+  }
+
+  for (const int key : m_pendingChanges)
+  {
+    const auto findIt = m_elementStorage.constFind(key);
+    if (findIt == m_elementStorage.cend() || !findIt.value().m_signaler)
+      continue;
+
+    GeoElement* geoElement = findIt.value().m_geoElement;
+    const Envelope extent = GeometryProjectionCache::instance()->wgs84Extent(geoElement);
+    if (extent.isEmpty() ||
+        extent.xMin() > xMax || extent.xMax() < xMin ||
+        extent.yMin() > yMax || extent.yMax() < yMin)
+    {
+      continue;
+    }
+
+    GeoElementCandidate candidate;
+    candidate.geoElement = geoElement;
+    candidate.id = key;
+    candidate.xMin = extent.xMin();
+    candidate.xMax = extent.xMax();
+    candidate.yMin = extent.yMin();
+    candidate.yMax = extent.yMax();
+    candidates.append(candidate);
   }
 }
 
@@ -662,4 +730,3 @@ void GeometryQuadtree::QuadTree::removeId(int index)
   \fn void GeometryQuadtree::treeChanged();
   \brief Signal emitted when the quad tree changes.
  */
-
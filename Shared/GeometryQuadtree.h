@@ -21,9 +21,11 @@
 #include <QHash>
 #include <QList>
 #include <QObject>
+#include <QVarLengthArray>
+#include <QVector>
 
 // STL headers
-#include <memory>
+#include <vector>
 
 namespace Esri {
 namespace ArcGISRuntime {
@@ -37,6 +39,7 @@ class Point;
 namespace Dsa {
 
 class GeoElementSignaler;
+struct GeoElementCandidate;
 
 class GeometryQuadtree : public QObject
 {
@@ -50,24 +53,68 @@ public:
   ~GeometryQuadtree();
 
   void appendGeoElment(Esri::ArcGISRuntime::GeoElement* newGeoElement);
+  void removeGeoElement(Esri::ArcGISRuntime::GeoElement* geoElement);
+  void updateGeoElements(const QList<Esri::ArcGISRuntime::GeoElement*>& geoElements);
 
   QList<Esri::ArcGISRuntime::Geometry> candidateIntersections(const Esri::ArcGISRuntime::Geometry& geometry) const;
   QList<Esri::ArcGISRuntime::Geometry> candidateIntersections(const Esri::ArcGISRuntime::Envelope& extent) const;
   QList<Esri::ArcGISRuntime::Geometry> candidateIntersections(const Esri::ArcGISRuntime::Point& location) const;
 
+  QList<Esri::ArcGISRuntime::GeoElement*> candidateElements(const Esri::ArcGISRuntime::Envelope& extent) const;
+  void candidateElements(const Esri::ArcGISRuntime::Envelope& extent, QVector<GeoElementCandidate>& candidates) const;
+
 signals:
   void treeChanged();
 
 private:
+  struct Node
+  {
+    double m_x = 0.0;
+    double m_y = 0.0;
+    double m_halfSize = 0.0;
+    int m_parent = -1;
+    int m_children[4] = {-1, -1, -1, -1};
+    QVarLengthArray<int, 4> m_geometryIds;
+  };
+
+  struct Element
+  {
+    // the element is kept here as well, as the signaler may already be destroyed when it is removed
+    Esri::ArcGISRuntime::GeoElement* m_geoElement = nullptr;
+    GeoElementSignaler* m_signaler = nullptr;
+    int m_node = -1;
+    double m_xMin = 0.0;
+    double m_xMax = 0.0;
+    double m_yMin = 0.0;
+    double m_yMax = 0.0;
+    bool m_pending = false;
+  };
+
   void buildTree(const Esri::ArcGISRuntime::Envelope& extent);
   void handleGeometryChange(int changedIndex);
+  void markGeometryChanged(int changedIndex);
+  void processPendingChanges();
+  void moveElement(int key, Element& element);
   int handleNewGeoElement(Esri::ArcGISRuntime::GeoElement* geoElement);
+  void removeKey(int key);
 
-  struct QuadTree;
+  bool updateElementExtent(Element& element);
+  void insertElement(int key, Element& element);
+  void detachElement(int key, Element& element);
+  void expandRoot(double x, double y, double halfSize);
+  bool fitsNode(int nodeIndex, double x, double y, double halfSize) const;
+  int allocateNode(double x, double y, double halfSize, int parent);
+  void pruneNode(int nodeIndex);
+  void appendCandidates(double xMin, double xMax, double yMin, double yMax, QVector<GeoElementCandidate>& candidates) const;
 
   int m_maxLevels;
-  std::unique_ptr<QuadTree> m_tree;
-  QHash<int, GeoElementSignaler*> m_elementStorage;
+  double m_minHalfSize = 0.0;
+  int m_root = -1;
+  std::vector<Node> m_nodes;
+  QVector<int> m_freeNodes;
+  QHash<int, Element> m_elementStorage;
+  QHash<Esri::ArcGISRuntime::GeoElement*, int> m_elementKeys;
+  QVector<int> m_pendingChanges;
   int m_nextKey = 0;
 };
 
@@ -22,6 +22,7 @@
 
 // dsa app headers
 #include "AddLocalDataController.h"
+#include "AnalysisResultCache.h"
 #include "OpenMobileScenePackageController.h"
 #include "MarkupLayer.h"
 
@@ -56,6 +57,8 @@ namespace Dsa {
 
 const QString LayerCacheManager::LAYERS_PROPERTYNAME = "Layers";
 const QString LayerCacheManager::ELEVATION_PROPERTYNAME = "DefaultElevationSource";
+const QString LayerCacheManager::ANALYSIS_CACHE_DIRECTORY_PROPERTYNAME = "AnalysisCacheDirectory";
+const QString LayerCacheManager::ANALYSIS_CACHE_SIZE_PROPERTYNAME = "AnalysisCacheSizeMB";
 const QString LayerCacheManager::layerPathKey = "path";
 const QString LayerCacheManager::layerVisibleKey = "visible";
 const QString LayerCacheManager::layerTypeKey = "type";
@@ -71,6 +74,11 @@ using namespace Esri::ArcGISRuntime;
   \inmodule Dsa
   \inherits AbstractTool
   \brief Tool controller responsible for managing the layers in the app.
+
+  It also sets up the \l AnalysisResultCache, so that results computed in an earlier
+  session are read back from disk rather than recomputed when the same analysis is run
+  again over the same elevation. The analyses themselves are not saved or re-created
+  when the app restarts.
  */
 
 /*!
@@ -129,6 +137,8 @@ QString LayerCacheManager::toolName() const
  */
 void LayerCacheManager::setProperties(const QVariantMap& properties)
 {
+  setAnalysisCache(properties);
+
   if (m_initialLoadCompleted || !m_localDataController)
     return;
 
@@ -352,6 +362,34 @@ void LayerCacheManager::addElevation(const QVariantMap& properties)
   }
 }
 
+/*!
+ \brief Sets the directory and size of the \l AnalysisResultCache from \a properties.
+
+ The cache uses the "AnalysisCache" folder of the root data directory unless
+ "AnalysisCacheDirectory" is set. "AnalysisCacheSizeMB" limits the size of the cache.
+ */
+void LayerCacheManager::setAnalysisCache(const QVariantMap& properties)
+{
+  QString directory = properties.value(ANALYSIS_CACHE_DIRECTORY_PROPERTYNAME).toString();
+  if (directory.isEmpty())
+  {
+    const QString rootDirectory = properties.value(QStringLiteral("RootDataDirectory")).toString();
+    if (rootDirectory.isEmpty())
+      return;
+
+    directory = QString("%1/AnalysisCache").arg(rootDirectory);
+  }
+
+  AnalysisResultCache* cache = AnalysisResultCache::instance();
+  if (cache->directory() != directory)
+    cache->setDirectory(directory);
+
+  bool ok = false;
+  const qint64 sizeMB = properties.value(ANALYSIS_CACHE_SIZE_PROPERTYNAME).toLongLong(&ok);
+  if (ok)
+    cache->setMaximumSize(sizeMB * 1024 * 1024);
+}
+
 void LayerCacheManager::addLayers(const QVariantMap& properties)
 {
   const QVariant layersData = properties.value(LAYERS_PROPERTYNAME);
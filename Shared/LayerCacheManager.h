@@ -54,6 +54,7 @@ public:
 
   void addElevation(const QVariantMap& properties);
   void addLayers(const QVariantMap& properties);
+  void setAnalysisCache(const QVariantMap& properties);
 
 signals:
   void layerJsonChanged();
@@ -67,6 +68,8 @@ private:
 
   static const QString LAYERS_PROPERTYNAME;
   static const QString ELEVATION_PROPERTYNAME;
+  static const QString ANALYSIS_CACHE_DIRECTORY_PROPERTYNAME;
+  static const QString ANALYSIS_CACHE_SIZE_PROPERTYNAME;
   static const QString layerPathKey;
   static const QString layerVisibleKey;
   static const QString layerTypeKey;
@@ -22,6 +22,7 @@
 
 // dsa app headers
 #include "GPXLocationSimulator.h"
+#include "LocalElevationCache.h"
 #include "LocationDisplay3d.h"
 
 // toolkit headers
@@ -66,6 +67,8 @@ LocationController::LocationController(QObject* parent) :
   m_locationDisplay3d(new LocationDisplay3d(this))
 {
   connect(this, &LocationController::locationChanged, ToolResourceProvider::instance(), &ToolResourceProvider::onLocationChanged);
+  connect(this, &LocationController::locationChanged, LocalElevationCache::instance(), &LocalElevationCache::onLocationChanged);
+  connect(this, &LocationController::headingChanged, LocalElevationCache::instance(), &LocalElevationCache::onHeadingChanged);
   connect(ToolResourceProvider::instance(), &ToolResourceProvider::geoViewChanged, this, &LocationController::updateGeoView);
 
   updateGeoView();
@@ -20,6 +20,10 @@
 
 #include "LocationTextController.h"
 
+// dsa app headers
+#include "GeometryProjectionCache.h"
+#include "LocalElevationCache.h"
+
 // toolkit headers
 #include "ToolManager.h"
 #include "ToolResourceProvider.h"
@@ -29,10 +33,22 @@
 #include "Scene.h"
 #include "Surface.h"
 
+// Qt headers
+#include <QTimer>
+
+// STL headers
+#include <cmath>
+
 using namespace Esri::ArcGISRuntime;
 
 namespace Dsa {
 
+namespace
+{
+// the text is formatted at most once per displayed frame
+constexpr int textUpdateInterval = 16;
+}
+
 // constant strings used for properties in the config file
 const QString LocationTextController::COORDINATE_FORMAT_PROPERTYNAME = QStringLiteral("CoordinateFormat");
 const QString LocationTextController::USE_GPS_PROPERTYNAME = QStringLiteral("UseGpsForElevation");
@@ -55,6 +71,13 @@ const QString LocationTextController::Feet = QStringLiteral("feet");
   \inmodule Dsa
   \inherits AbstractTool
   \brief Tool controller for displaying the current location.
+
+  The text is updated at most once per displayed frame, for the latest location only.
+
+  Unless \l useGpsForElevation is \c true, the elevation is sampled synchronously from the
+  local raster elevation of the scene (see \l LocalElevationCache). Where no local raster
+  covers the location, the elevation is requested from the scene's surface instead: a new
+  location cancels any request which has not completed, so stale elevations are never shown.
  */
 
 /*!
@@ -63,8 +86,13 @@ const QString LocationTextController::Feet = QStringLiteral("feet");
 LocationTextController::LocationTextController(QObject* parent) :
   AbstractTool(parent),
   m_coordinateFormat(DMS),
-  m_unitOfMeasurement(Meters)
+  m_unitOfMeasurement(Meters),
+  m_textTimer(new QTimer(this))
 {
+  m_textTimer->setSingleShot(true);
+  m_textTimer->setInterval(textUpdateInterval);
+  connect(m_textTimer, &QTimer::timeout, this, &LocationTextController::updateText);
+
   connect(ToolResourceProvider::instance(), &ToolResourceProvider::geoViewChanged,
           this, &LocationTextController::onGeoViewChanged);
 
@@ -110,30 +138,14 @@ QString LocationTextController::currentElevationText() const
 /*!
  \brief Slot for ToolResourceProvider::locationChanged.
 
- Uses the provided \a pt to update the location and elevation text.
+ Records \a pt and schedules an update of the location and elevation text.
  */
 void LocationTextController::onLocationChanged(const Point& pt)
 {
-  if (m_coordinateFormat.isEmpty())
-    return;
+  m_latestLocation = pt;
 
-  if (formatCoordinate == nullptr)
-    return;
-
-  // update location text
-  m_currentLocationText = QString("%1 (%2)").arg(formatCoordinate(pt), m_coordinateFormat);
-  emit currentLocationTextChanged();
-
-  // update the elevation text
-  if (m_useGpsForElevation)
-    formatElevationText(pt.z());
-  else
-  {
-    if (!m_surface)
-      return;
-
-    m_surface->locationToElevation(pt);
-  }
+  if (!m_textTimer->isActive())
+    m_textTimer->start();
 }
 
 /*!
@@ -142,17 +154,32 @@ void LocationTextController::onLocationChanged(const Point& pt)
 void LocationTextController::onGeoViewChanged()
 {
   Scene* scene = ToolResourceProvider::instance()->scene();
-  if (scene)
+  if (!scene || scene->baseSurface() == m_surface)
+    return;
+
+  cancelSurfaceElevation();
+  disconnect(m_surfaceConnection);
+  m_surface = scene->baseSurface();
+
+  // connect the Surface::locationToElevationCompleted signal
+  m_surfaceConnection = connect(m_surface, &Surface::locationToElevationCompleted, this, [this](QUuid taskId, double elevation)
   {
-    m_surface = scene->baseSurface();
+    // ignore the results of requests which have been cancelled
+    if (taskId != m_elevationTask.taskId())
+      return;
+
+    m_elevationTask = TaskWatcher();
 
-    // connect the Surface::locationToElevationCompleted signal
-    connect(m_surface, &Surface::locationToElevationCompleted, this, [this](QUuid, double elevation)
+    // format the elevation for display in QML
+    formatElevationText(elevation);
+
+    // request the elevation of the latest location, if it moved while this request was running
+    if (!m_pendingElevationLocation.isEmpty())
     {
-      // format the elevation for display in QML
-      formatElevationText(elevation);
-    });
-  }
+      const Point pendingLocation = m_pendingElevationLocation;
+      requestSurfaceElevation(pendingLocation);
+    }
+  });
 }
 
 /*!
@@ -289,6 +316,83 @@ void LocationTextController::formatElevationText(double elevation)
   emit currentElevationTextChanged();
 }
 
+/*!
+ \internal
+
+ Update the location and elevation text for the latest location.
+ */
+void LocationTextController::updateText()
+{
+  if (m_coordinateFormat.isEmpty())
+    return;
+
+  if (formatCoordinate == nullptr)
+    return;
+
+  const Point pt = m_latestLocation;
+  if (pt.isEmpty())
+    return;
+
+  // update location text
+  m_currentLocationText = QString("%1 (%2)").arg(formatCoordinate(pt), m_coordinateFormat);
+  emit currentLocationTextChanged();
+
+  // update the elevation text
+  if (m_useGpsForElevation)
+  {
+    cancelSurfaceElevation();
+    formatElevationText(pt.z());
+    return;
+  }
+
+  const Point wgs84Location = GeometryProjectionCache::projectToWgs84(pt);
+  const double elevation = LocalElevationCache::instance()->elevation(wgs84Location.x(), wgs84Location.y());
+  if (std::isnan(elevation))
+  {
+    requestSurfaceElevation(pt);
+    return;
+  }
+
+  cancelSurfaceElevation();
+  formatElevationText(elevation);
+}
+
+/*!
+ \internal
+
+ Request the elevation at \a pt from the scene's surface.
+
+ Only one request runs at a time. If one is running, \a pt replaces any location waiting
+ for it and is requested when it completes.
+ */
+void LocationTextController::requestSurfaceElevation(const Point& pt)
+{
+  if (!m_surface)
+    return;
+
+  if (m_elevationTask.isValid() && !m_elevationTask.isDone())
+  {
+    m_pendingElevationLocation = pt;
+    return;
+  }
+
+  m_pendingElevationLocation = Point();
+  m_elevationTask = m_surface->locationToElevation(pt);
+}
+
+/*!
+ \internal
+
+ Cancel the running request for elevation from the scene's surface, and any location waiting
+ for it, if there is one.
+ */
+void LocationTextController::cancelSurfaceElevation()
+{
+  m_elevationTask.cancel();
+  m_elevationTask = TaskWatcher();
+  m_pendingElevationLocation = Point();
+}
+
 /*!
  \brief Returns the current unit of measurement.
 */
@@ -20,9 +20,14 @@
 // toolkit headers
 #include "AbstractTool.h"
 
+// C++ API headers
+#include "Point.h"
+#include "TaskWatcher.h"
+
+class QTimer;
+
 namespace Esri {
 namespace ArcGISRuntime {
-class Point;
 class Surface;
 }
 }
@@ -66,6 +71,9 @@ private:
   QString currentLocationText() const;
   QString currentElevationText() const;
   void formatElevationText(double elevation);
+  void updateText();
+  void requestSurfaceElevation(const Esri::ArcGISRuntime::Point& pt);
+  void cancelSurfaceElevation();
 
   static const QString COORDINATE_FORMAT_PROPERTYNAME;
   static const QString USE_GPS_PROPERTYNAME;
@@ -82,6 +90,11 @@ private:
   static const QString Feet;
 
   Esri::ArcGISRuntime::Surface* m_surface = nullptr;
+  QMetaObject::Connection m_surfaceConnection;
+  Esri::ArcGISRuntime::TaskWatcher m_elevationTask;
+  Esri::ArcGISRuntime::Point m_pendingElevationLocation;
+  Esri::ArcGISRuntime::Point m_latestLocation;
+  QTimer* m_textTimer = nullptr;
   QString m_currentLocationText = "Location Unavailable";
   QString m_currentElevationText = "Elevation Unavailable";
   QString m_coordinateFormat;
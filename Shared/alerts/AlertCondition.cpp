@@ -21,10 +21,10 @@
 
 // dsa app headers
 #include "AlertConditionData.h"
-#include "GraphicAlertSource.h"
+#include "AlertConditionStore.h"
+#include "GraphicsOverlaySourceStore.h"
 
 // C++ API headers
-#include "GraphicListModel.h"
 #include "GraphicsOverlay.h"
 
 using namespace Esri::ArcGISRuntime;
@@ -41,7 +41,11 @@ namespace Dsa {
   An AlertCondition is made up of an \l AlertSource (generally some form of real-time feed)
   a query and an \l AlertTarget (a real time feed or an overlay).
 
-  The condition is applied to all source objects, creating an \l AlertConditionData for each.
+  The condition is applied to all source objects. For a single source, such as the current
+  location, an \l AlertConditionData is created to track it. For a feed of graphics, the
+  condition is tested against the columns of a \l GraphicsOverlaySourceStore by an
+  \l AlertConditionStore, which only creates an \l AlertConditionData for the graphics
+  which match the condition.
 
   When either the source or target is changed for a given data element, the condition can be
   re-tested using an \l AlertQuery to determine whether an elert should be triggered.
@@ -87,8 +91,8 @@ void AlertCondition::init(AlertSource* source, AlertTarget* target, const QStrin
 /*!
   \brief Initializes the condition with a \a sourceFeed, \a sourceDescription, a \a target and a \a targetDescription.
 
-  A new \l AlertConditionData will be created for each \l Esri::ArcGISRuntime::Graphic
-  in the source feed, to track changes to the source and target.
+  Each \l Esri::ArcGISRuntime::Graphic in the source feed is tested by an \l AlertConditionStore
+  and a new \l AlertConditionData will be created for each graphic which matches the condition.
  */
 void AlertCondition::init(GraphicsOverlay* sourceFeed, const QString& sourceDescription, AlertTarget* target, const QString& targetDescription)
 {
@@ -98,32 +102,13 @@ void AlertCondition::init(GraphicsOverlay* sourceFeed, const QString& sourceDesc
   m_sourceDescription = sourceDescription;
   m_targetDescription = targetDescription;
 
-  GraphicListModel* graphics = sourceFeed->graphics();
-  if (!graphics)
+  // the source store is shared by all conditions using the same overlay
+  GraphicsOverlaySourceStore* sources = GraphicsOverlaySourceStore::forOverlay(sourceFeed);
+  if (!sources)
     return;
 
-  // process a new graphic from the source feed to create a new AlertConditionData
-  auto handleGraphicAt = [this, graphics, target](int index)
-  {
-    if (!graphics)
-      return;
-
-    Graphic* newGraphic = graphics->at(index);
-    if (!newGraphic)
-      return;
-
-    GraphicAlertSource* source = new GraphicAlertSource(newGraphic);
-    AlertConditionData* newData = createData(source, target);
-    addData(newData);
-  };
-
-  // connect to the graphicAdded to add condition data for any new graphics
-  connect(graphics, &GraphicListModel::graphicAdded, this, handleGraphicAt);
-
-  // add condition data for all of the graphics which are in the overlay to begin with
-  const int count = graphics->rowCount();
-  for (int i = 0; i < count; ++i)
-    handleGraphicAt(i);
+  // the condition store is owned by this condition
+  new AlertConditionStore(this, sources, target);
 }
 
 /*!
@@ -178,13 +163,15 @@ void AlertCondition::setName(const QString& name)
   if (name == m_name)
     return;
 
+  // keep the suffix identifying the source of each data
+  const int oldNameLength = m_name.length();
   m_name = name;
 
-  for (int i = 0; i < m_data.count(); ++i)
+  for (auto it = m_data.cbegin(); it != m_data.cend(); ++it)
   {
-    AlertConditionData* data = m_data.at(i);
+    AlertConditionData* data = *it;
     if (data)
-      data->setName(m_name + QString(" (%1)").arg(QString::number(i)));
+      data->setName(m_name + data->name().mid(oldNameLength));
   }
 
   emit conditionChanged();
@@ -208,10 +195,37 @@ void AlertCondition::addData(AlertConditionData* newData)
   if (!newData)
     return;
 
+  newData->setHysteresis(m_hysteresis);
+  newData->setDwellTime(m_dwellTime);
+
+  connect(newData, &AlertConditionData::destroyed, this, [this, newData]()
+  {
+    m_data.removeOne(newData);
+  });
+
   m_data.append(newData);
   emit newConditionData(newData);
 }
 
+/*!
+  \fn bool AlertCondition::matchesSource(const GraphicsOverlaySourceStore* sources, int row, AlertTarget* target, int& candidateCount) const
+  \brief Returns whether the source at \a row of \a sources matches the condition query for \a target.
+
+  This is used to test sources which do not have an \l AlertConditionData, so no hysteresis
+  margin applies. \a candidateCount is set to the number of target candidates which were tested.
+ */
+
+/*!
+  \brief Returns whether every change to the result of this condition for a source feed is
+  reported by \l sourceRowsChanged.
+
+  If so, other changes to the sources, such as their location, are not tested. The default is \c false.
+ */
+bool AlertCondition::reportsSourceChanges() const
+{
+  return false;
+}
+
 /*!
   \brief Returns the name of the condition source.
  */
@@ -267,6 +281,74 @@ void AlertCondition::setConditionEnabled(bool enabled)
   emit conditionEnabledChanged();
 }
 
+/*!
+  \brief Returns the hysteresis margin for the condition in meters.
+
+  Once a condition data is active, spatial queries allow the source to move up to this
+  distance beyond the threshold before the alert is cleared.
+
+  The default is \c 0.0.
+ */
+double AlertCondition::hysteresis() const
+{
+  return m_hysteresis;
+}
+
+/*!
+  \brief Sets the hysteresis margin for the condition and associated data to \a hysteresis meters.
+ */
+void AlertCondition::setHysteresis(double hysteresis)
+{
+  hysteresis = qMax(0.0, hysteresis);
+  if (hysteresis == m_hysteresis)
+    return;
+
+  m_hysteresis = hysteresis;
+
+  for (auto it = m_data.cbegin(); it != m_data.cend(); ++it)
+  {
+    AlertConditionData* data = *it;
+    if (data)
+      data->setHysteresis(m_hysteresis);
+  }
+
+  emit conditionChanged();
+}
+
+/*!
+  \brief Returns the minimum dwell time for the condition in milliseconds.
+
+  A change in the result of the query must persist for at least this long before
+  an alert is raised or cleared.
+
+  The default is \c 0.
+ */
+int AlertCondition::dwellTime() const
+{
+  return m_dwellTime;
+}
+
+/*!
+  \brief Sets the minimum dwell time for the condition and associated data to \a dwellTime milliseconds.
+ */
+void AlertCondition::setDwellTime(int dwellTime)
+{
+  dwellTime = qMax(0, dwellTime);
+  if (dwellTime == m_dwellTime)
+    return;
+
+  m_dwellTime = dwellTime;
+
+  for (auto it = m_data.cbegin(); it != m_data.cend(); ++it)
+  {
+    AlertConditionData* data = *it;
+    if (data)
+      data->setDwellTime(m_dwellTime);
+  }
+
+  emit conditionChanged();
+}
+
 } // Dsa
 
 // Signal Documentation
@@ -289,3 +371,9 @@ void AlertCondition::setConditionEnabled(bool enabled)
   \fn void AlertCondition::conditionEnabledChanged();
   \brief Signal emitted when conditionEnabled property changes.
  */
+
+/*!
+  \fn void AlertCondition::sourceRowsChanged(const QVector<int>& rows);
+  \brief Signal emitted when the result of the condition for the source feed \a rows has changed
+  without any change to the sources themselves.
+ */
@@ -24,6 +24,7 @@
 #include <QList>
 #include <QObject>
 #include <QVariantMap>
+#include <QVector>
 
 namespace Esri
 {
@@ -38,6 +39,7 @@ namespace Dsa {
 class AlertConditionData;
 class AlertSource;
 class AlertTarget;
+class GraphicsOverlaySourceStore;
 
 class AlertCondition : public QObject
 {
@@ -66,6 +68,8 @@ public:
   virtual QString queryString() const = 0;
   virtual QVariantMap queryComponents() const = 0;
   virtual AlertConditionData* createData(AlertSource* source, AlertTarget* target) = 0;
+  virtual bool matchesSource(const GraphicsOverlaySourceStore* sources, int row, AlertTarget* target, int& candidateCount) const = 0;
+  virtual bool reportsSourceChanges() const;
 
   QString sourceDescription() const;
   QString targetDescription() const;
@@ -74,14 +78,23 @@ public:
   bool isConditionEnabled() const;
   void setConditionEnabled(bool enabled);
 
+  double hysteresis() const;
+  void setHysteresis(double hysteresis);
+
+  int dwellTime() const;
+  void setDwellTime(int dwellTime);
+
 signals:
   void noLongerValid();
   void newConditionData(Dsa::AlertConditionData* newConditionData);
   void conditionChanged();
   void conditionEnabledChanged();
+  void sourceRowsChanged(const QVector<int>& rows);
 
 private:
   bool m_enabled = true;
+  double m_hysteresis = 0.0;
+  int m_dwellTime = 0;
   AlertLevel m_level;
   QString m_name;
   QList<AlertConditionData*> m_data;
@@ -22,7 +22,13 @@
 // dsa app headers
 #include "AlertCondition.h"
 #include "AlertSource.h"
+#include "AlertStatisticsModel.h"
 #include "AlertTarget.h"
+#include "GeoElementUtils.h"
+
+// Qt headers
+#include <QElapsedTimer>
+#include <QTimer>
 
 using namespace Esri::ArcGISRuntime;
 
@@ -84,6 +90,11 @@ AlertConditionData::AlertConditionData(const QString& name,
     emit noLongerValid();
   });
   connect(m_target, &AlertTarget::dataChanged, this, &AlertConditionData::handleDataChanged);
+  connect(m_target, &AlertTarget::pendingCandidatesFetched, this, [this]()
+  {
+    if (m_queryPending)
+      handleDataChanged();
+  });
   connect(m_target, &AlertTarget::destroyed, this, [this]()
   {
     m_target = nullptr;
@@ -256,6 +267,68 @@ bool AlertConditionData::isQueryOutOfDate() const
   return m_queryOutOfDate;
 }
 
+/*!
+  \brief Returns whether the last query did not match while some candidates of the target
+  were still being fetched.
+
+  The active state is kept until the query is run again once they have been fetched.
+ */
+bool AlertConditionData::isQueryPending() const
+{
+  return m_queryPending;
+}
+
+/*!
+  \brief Re-runs the query, for conditions whose result can change without any change to the source or target.
+
+  For example, when a track has not been updated for a given time.
+ */
+void AlertConditionData::refreshQuery()
+{
+  handleDataChanged();
+}
+
+/*!
+  \brief Returns the element of the target which caused the last query to match.
+
+  Returns \c nullptr if the last query did not match, if the target is not made up
+  of \l Esri::ArcGISRuntime::GeoElement objects or if the matched element
+  has since been deleted.
+ */
+GeoElement* AlertConditionData::matchedElement() const
+{
+  if (m_matchedObject.isNull())
+    return nullptr;
+
+  return m_matchedElement;
+}
+
+/*!
+  \brief Records \a matchedElement as the element of the target which caused the current query to match.
+
+  Derived types should call this from \l matchesQuery when the match can be attributed to a
+  single element of the target.
+ */
+void AlertConditionData::setMatchedElement(GeoElement* matchedElement) const
+{
+  m_matchedElement = matchedElement;
+  m_matchedObject = matchedElement ? GeoElementUtils::toQObject(matchedElement) : nullptr;
+
+  // elements which cannot be tracked for deletion are not reported
+  if (m_matchedObject.isNull())
+    m_matchedElement = nullptr;
+}
+
+/*!
+  \brief Records that the current query tested \a candidateCount elements of the target.
+
+  The count is reported to the \l AlertStatisticsModel when it is enabled.
+ */
+void AlertConditionData::setCandidateCount(int candidateCount) const
+{
+  m_candidateCount = candidateCount;
+}
+
 /*!
   \brief Internal.
 
@@ -268,16 +341,94 @@ void AlertConditionData::handleDataChanged()
 
   // set the query flag to out-of-date to force a new query to be run
   m_queryOutOfDate = true;
-
-  // run the query and cache whether this condition has now been met
-  m_cachedQueryResult = matchesQuery();
+  setMatchedElement(nullptr);
+  setCandidateCount(0);
+  if (m_target)
+    m_target->takeCandidatesPending();
+
+  // run the query and cache whether this condition has now been met, recording how long it took
+  // when statistics are being collected
+  AlertStatisticsModel* statistics = AlertStatisticsModel::instance();
+  if (statistics->isEnabled())
+  {
+    QElapsedTimer queryTimer;
+    queryTimer.start();
+    m_cachedQueryResult = matchesQuery();
+    statistics->recordEvaluation(qobject_cast<AlertCondition*>(parent()), queryTimer.nsecsElapsed(), m_candidateCount);
+  }
+  else
+  {
+    m_cachedQueryResult = matchesQuery();
+  }
 
   // the query is now up-to-date
   m_queryOutOfDate = false;
 
+  // a query which could not test every candidate has not shown that the condition is no longer met
+  m_queryPending = m_target && m_target->takeCandidatesPending() && !m_cachedQueryResult;
+  if (m_queryPending)
+    m_cachedQueryResult = m_active;
+
   // if the active state still matches that returned by the query, no changes are required
   if (m_active == m_cachedQueryResult)
+  {
+    // the query has returned to the current state within the dwell time, so abandon any pending change
+    m_transitionPending = false;
     return;
+  }
+
+  // the new state must persist for the dwell time before the active state changes
+  if (m_dwellTime > 0)
+  {
+    if (!m_transitionPending)
+    {
+      m_transitionPending = true;
+      m_transitionTimer.start();
+
+      // apply the change when the dwell time elapses, even if there are no further updates
+      QTimer::singleShot(m_dwellTime, this, &AlertConditionData::handleDwellTimeElapsed);
+      return;
+    }
+
+    if (m_transitionTimer.elapsed() < m_dwellTime)
+      return;
+  }
+
+  updateActive();
+}
+
+/*!
+  \brief Internal.
+
+  Apply a pending change to the active state if the query result has not changed back
+  during the dwell time.
+ */
+void AlertConditionData::handleDwellTimeElapsed()
+{
+  if (!m_transitionPending || !isConditionEnabled())
+    return;
+
+  // a newer pending change will be handled by its own timer
+  if (m_transitionTimer.elapsed() < m_dwellTime)
+    return;
+
+  if (m_active == m_cachedQueryResult)
+  {
+    m_transitionPending = false;
+    return;
+  }
+
+  updateActive();
+}
+
+/*!
+  \internal
+
+  Change the active state to match the cached query result.
+ */
+void AlertConditionData::updateActive()
+{
+  m_transitionPending = false;
 
   // update the new active state
   setActive(m_cachedQueryResult);
@@ -318,13 +469,71 @@ void AlertConditionData::setConditionEnabled(bool enabled)
 
   // if the condition has been re-enabled, we need to re-apply the query to see if it should now become active
   if (enabled)
+  {
     handleDataChanged();
-  else // make sure we do not highlight inactive conditions
-     highlight(false);
+  }
+  else // make sure we do not highlight inactive conditions or apply pending changes
+  {
+    highlight(false);
+    m_transitionPending = false;
+  }
 
   emit dataChanged();
 }
 
+/*!
+  \brief Returns the hysteresis margin of this condition data in meters.
+
+  Once the condition data is active, spatial queries allow the source to move up to this
+  distance beyond the threshold before they stop matching. This stops sources which jitter
+  around the threshold from repeatedly raising and clearing the alert.
+
+  The default is \c 0.0.
+ */
+double AlertConditionData::hysteresis() const
+{
+  return m_hysteresis;
+}
+
+/*!
+  \brief Sets the hysteresis margin of this condition data to \a hysteresis meters.
+ */
+void AlertConditionData::setHysteresis(double hysteresis)
+{
+  m_hysteresis = qMax(0.0, hysteresis);
+}
+
+/*!
+  \brief Returns the dwell time of this condition data in milliseconds.
+
+  A change in the result of the query must persist for at least this long before
+  the active state changes. The default is \c 0, meaning the active state changes
+  as soon as the query result changes.
+ */
+int AlertConditionData::dwellTime() const
+{
+  return m_dwellTime;
+}
+
+/*!
+  \brief Sets the dwell time of this condition data to \a dwellTime milliseconds.
+ */
+void AlertConditionData::setDwellTime(int dwellTime)
+{
+  m_dwellTime = qMax(0, dwellTime);
+}
+
+/*!
+  \brief Returns the active state of this condition data without running the query.
+
+  Derived types can use this from \l matchesQuery to apply the \l hysteresis margin
+  when the condition data is already active.
+ */
+bool AlertConditionData::wasActive() const
+{
+  return m_active;
+}
+
 /*!
   \brief Returns the active state of this conditiom data.
   
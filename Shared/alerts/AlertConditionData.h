@@ -24,10 +24,20 @@
 #include "Point.h"
 
 // Qt headers
+#include <QElapsedTimer>
 #include <QObject>
+#include <QPointer>
 #include <QString>
 #include <QUuid>
 
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class GeoElement;
+}
+}
+
 namespace Dsa {
 
 class AlertSource;
@@ -66,10 +76,20 @@ public:
 
   bool cachedQueryResult() const;
   bool isQueryOutOfDate() const;
+  bool isQueryPending() const;
+  void refreshQuery();
+
+  Esri::ArcGISRuntime::GeoElement* matchedElement() const;
 
   bool isConditionEnabled() const;
   void setConditionEnabled(bool isConditionEnabled);
 
+  double hysteresis() const;
+  void setHysteresis(double hysteresis);
+
+  int dwellTime() const;
+  void setDwellTime(int dwellTime);
+
 signals:
   void statusChanged();
   void viewedChanged();
@@ -77,11 +97,18 @@ signals:
   void activeChanged();
   void noLongerValid();
 
+protected:
+  bool wasActive() const;
+  void setMatchedElement(Esri::ArcGISRuntime::GeoElement* matchedElement) const;
+  void setCandidateCount(int candidateCount) const;
+
 private slots:
   void handleDataChanged();
+  void handleDwellTimeElapsed();
 
 private:
   void setActive(bool active);
+  void updateActive();
 
   QString m_name;
   AlertLevel m_level = AlertLevel::Unknown;
@@ -92,7 +119,15 @@ private:
   bool m_viewed = false;
   bool m_active = false;
   bool m_queryOutOfDate = true;
+  bool m_queryPending = false;
   mutable bool m_cachedQueryResult = false;
+  mutable Esri::ArcGISRuntime::GeoElement* m_matchedElement = nullptr;
+  mutable QPointer<QObject> m_matchedObject;
+  mutable int m_candidateCount = 0;
+  double m_hysteresis = 0.0;
+  int m_dwellTime = 0;
+  bool m_transitionPending = false;
+  QElapsedTimer m_transitionTimer;
 };
 
 } // Dsa
@@ -53,6 +53,14 @@ namespace Dsa {
         \li conditionEnabled
         \li bool
         \li Whether the alert condition is enabled.
+    \row
+        \li hysteresis
+        \li double
+        \li The distance in meters a source may move beyond the threshold before an alert is cleared.
+    \row
+        \li dwellTime
+        \li int
+        \li The time in milliseconds a change must persist before an alert is raised or cleared.
   \endtable
   */
 
@@ -66,6 +74,8 @@ AlertConditionListModel::AlertConditionListModel(QObject* parent):
   m_roles[AlertConditionListRoles::Level] = "level";
   m_roles[AlertConditionListRoles::Description] = "description";
   m_roles[AlertConditionListRoles::ConditionEnabled] = "conditionEnabled";
+  m_roles[AlertConditionListRoles::Hysteresis] = "hysteresis";
+  m_roles[AlertConditionListRoles::DwellTime] = "dwellTime";
 }
 
 /*!
@@ -169,6 +179,10 @@ QVariant AlertConditionListModel::data(const QModelIndex& index, int role) const
     return condition->description();
   case AlertConditionListRoles::ConditionEnabled:
     return condition->isConditionEnabled();
+  case AlertConditionListRoles::Hysteresis:
+    return condition->hysteresis();
+  case AlertConditionListRoles::DwellTime:
+    return condition->dwellTime();
   default:
     break;
   }
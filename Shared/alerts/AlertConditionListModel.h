@@ -36,7 +36,9 @@ public:
     ConditionName = Qt::UserRole + 2,
     Level = Qt::UserRole + 3,
     Description = Qt::UserRole + 4,
-    ConditionEnabled = Qt::UserRole +5
+    ConditionEnabled = Qt::UserRole +5,
+    Hysteresis = Qt::UserRole + 6,
+    DwellTime = Qt::UserRole + 7
   };
 
   explicit AlertConditionListModel(QObject* parent = nullptr);
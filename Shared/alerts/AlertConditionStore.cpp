@@ -0,0 +1,376 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "AlertConditionStore.h"
+
+// dsa app headers
+#include "AlertCondition.h"
+#include "AlertConditionData.h"
+#include "AlertStatisticsModel.h"
+#include "AlertTarget.h"
+#include "GraphicAlertSource.h"
+#include "GraphicsOverlaySourceStore.h"
+
+// Qt headers
+#include <QElapsedTimer>
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::AlertConditionStore
+  \inmodule Dsa
+  \inherits QObject
+  \brief A column store of the state of an \l AlertCondition for each row of a
+  \l GraphicsOverlaySourceStore.
+
+  The condition is tested for each source row directly against the cached columns of the
+  source store, without creating any objects. The store subscribes once to the source
+  store, the \l AlertTarget and the condition rather than once per source object.
+
+  An \l AlertConditionData (and \l GraphicAlertSource) is only created for a row when the
+  condition query matches it, so only potential alerts are added to the \l AlertListModel.
+  While it exists the condition data tests itself, so that its hysteresis margin, dwell time,
+  level and viewed state apply as normal. Once the query no longer matches and the condition
+  data is inactive, it is released and the row is tested by the store again.
+
+  \sa AlertCondition::matchesSource
+ */
+
+/*!
+  \brief Constructor taking the \a condition (which will be the parent of the store), the
+  \a sources to test and the \a target for the condition.
+
+  The condition is tested for every row which is already in \a sources.
+ */
+AlertConditionStore::AlertConditionStore(AlertCondition* condition, GraphicsOverlaySourceStore* sources, AlertTarget* target):
+  QObject(condition),
+  m_condition(condition),
+  m_sources(sources),
+  m_target(target)
+{
+  connect(m_sources, &GraphicsOverlaySourceStore::rowsAdded, this, &AlertConditionStore::handleRowsAdded);
+  connect(m_sources, &GraphicsOverlaySourceStore::rowsChanged, this, &AlertConditionStore::handleRowsChanged);
+  connect(m_sources, &GraphicsOverlaySourceStore::rowAboutToBeRemoved, this, &AlertConditionStore::handleRowAboutToBeRemoved);
+  connect(m_target, &AlertTarget::dataChanged, this, &AlertConditionStore::evaluateAll);
+  connect(m_target, &AlertTarget::pendingCandidatesFetched, this, &AlertConditionStore::evaluatePending);
+  connect(m_condition, &AlertCondition::conditionEnabledChanged, this, &AlertConditionStore::handleConditionEnabledChanged);
+  connect(m_condition, &AlertCondition::sourceRowsChanged, this, &AlertConditionStore::handleConditionRowsChanged);
+
+  const int count = m_sources->size();
+  m_matches.fill(false, count);
+  m_pending.fill(false, count);
+  m_data.resize(count);
+  evaluateAll();
+}
+
+/*!
+  \brief Destructor.
+
+  The sources of any remaining condition data are deleted, which removes the condition data
+  from the \l AlertListModel.
+ */
+AlertConditionStore::~AlertConditionStore()
+{
+  for (const QPointer<AlertConditionData>& data : qAsConst(m_data))
+  {
+    if (data)
+      delete data->source();
+  }
+}
+
+/*!
+  \brief Returns the number of source rows in the store.
+ */
+int AlertConditionStore::size() const
+{
+  return m_matches.size();
+}
+
+/*!
+  \brief Returns whether the condition query matched the source at \a row when it was last tested.
+ */
+bool AlertConditionStore::matchesQuery(int row) const
+{
+  return m_matches.value(row, false);
+}
+
+/*!
+  \brief Returns the \l AlertConditionData for \a row, or \c nullptr if there is none.
+ */
+AlertConditionData* AlertConditionStore::data(int row) const
+{
+  return m_data.value(row);
+}
+
+/*!
+  \internal
+
+  Add columns for the new source rows \a first to \a last and test them.
+ */
+void AlertConditionStore::handleRowsAdded(int first, int last)
+{
+  const int count = last - first + 1;
+  m_matches.insert(first, count, false);
+  m_pending.insert(first, count, false);
+  m_data.insert(first, count, QPointer<AlertConditionData>());
+
+  for (int row = first; row <= last; ++row)
+    evaluateRow(row);
+}
+
+/*!
+  \internal
+
+  Test the changed source \a rows.
+ */
+void AlertConditionStore::handleRowsChanged(const QVector<int>& rows)
+{
+  // the condition reports its own changes, so these cannot change its result
+  if (m_condition->reportsSourceChanges())
+    return;
+
+  for (int row : rows)
+    evaluateRow(row);
+}
+
+/*!
+  \internal
+
+  Re-test the source \a rows whose result has changed over time, including any condition data.
+ */
+void AlertConditionStore::handleConditionRowsChanged(const QVector<int>& rows)
+{
+  for (int row : rows)
+  {
+    if (row < 0 || row >= m_data.size())
+      continue;
+
+    AlertConditionData* data = m_data.at(row);
+    if (data)
+      data->refreshQuery();
+
+    evaluateRow(row);
+  }
+}
+
+/*!
+  \internal
+
+  Release any condition data for \a row and remove it from the columns.
+
+  As in the source store, the last row moves into \a row.
+ */
+void AlertConditionStore::handleRowAboutToBeRemoved(int row)
+{
+  if (row < 0 || row >= m_data.size())
+    return;
+
+  release(row);
+
+  const int lastRow = m_data.size() - 1;
+  if (row != lastRow)
+  {
+    m_matches[row] = m_matches.at(lastRow);
+    m_pending[row] = m_pending.at(lastRow);
+    m_data[row] = m_data.at(lastRow);
+  }
+
+  m_matches.removeLast();
+  m_pending.removeLast();
+  m_data.removeLast();
+}
+
+/*!
+  \internal
+
+  Test all rows when the condition is enabled. When it is disabled, release all of
+  the condition data.
+ */
+void AlertConditionStore::handleConditionEnabledChanged()
+{
+  if (m_condition->isConditionEnabled())
+  {
+    evaluateAll();
+    return;
+  }
+
+  for (int row = 0; row < m_data.size(); ++row)
+    release(row);
+}
+
+/*!
+  \internal
+
+  Test every source row, for example when the target has changed.
+ */
+void AlertConditionStore::evaluateAll()
+{
+  const int count = m_data.size();
+  for (int row = 0; row < count; ++row)
+    evaluateRow(row);
+}
+
+/*!
+  \internal
+
+  Test again the rows whose last test did not match while some of the target's
+  candidates were still being fetched.
+ */
+void AlertConditionStore::evaluatePending()
+{
+  const int count = m_pending.size();
+  for (int row = 0; row < count; ++row)
+  {
+    if (m_pending.at(row))
+      evaluateRow(row);
+  }
+}
+
+/*!
+  \internal
+
+  Test the condition for the source at \a row, creating condition data if it matches.
+
+  If the test does not match but the target reported pending candidates, the row is
+  marked as pending and tested again when they have been fetched.
+ */
+void AlertConditionStore::evaluateRow(int row)
+{
+  if (!m_condition->isConditionEnabled())
+    return;
+
+  // condition data tests itself, so only check whether it can be released
+  if (m_data.at(row))
+  {
+    releaseIfInactive(row);
+    return;
+  }
+
+  m_target->takeCandidatesPending();
+
+  int candidateCount = 0;
+  bool matches = false;
+  AlertStatisticsModel* statistics = AlertStatisticsModel::instance();
+  if (statistics->isEnabled())
+  {
+    QElapsedTimer queryTimer;
+    queryTimer.start();
+    matches = m_condition->matchesSource(m_sources, row, m_target, candidateCount);
+    statistics->recordEvaluation(m_condition, queryTimer.nsecsElapsed(), candidateCount);
+  }
+  else
+  {
+    matches = m_condition->matchesSource(m_sources, row, m_target, candidateCount);
+  }
+
+  m_matches[row] = matches;
+  m_pending[row] = m_target->takeCandidatesPending() && !matches;
+  if (matches)
+    materialize(row);
+}
+
+/*!
+  \internal
+
+  Create the source and condition data for \a row and add it to the condition.
+ */
+void AlertConditionStore::materialize(int row)
+{
+  Graphic* graphic = m_sources->graphic(row);
+  if (!graphic)
+    return;
+
+  GraphicAlertSource* source = new GraphicAlertSource(graphic);
+  AlertConditionData* newData = m_condition->createData(source, m_target);
+  if (!newData)
+  {
+    delete source;
+    return;
+  }
+
+  // name the data after the source, which is stable as rows are released and created
+  newData->setName(QString("%1 (%2)").arg(m_condition->name(), QString::number(m_sources->sourceId(row))));
+  m_data[row] = newData;
+
+  // these are connected after the condition data, so it has already been re-tested
+  auto handleChanged = [this, graphic]()
+  {
+    const int changedRow = m_sources->row(graphic);
+    if (changedRow != -1)
+      releaseIfInactive(changedRow);
+  };
+
+  connect(source, &AlertSource::dataChanged, this, handleChanged);
+  connect(newData, &AlertConditionData::dataChanged, this, handleChanged);
+
+  m_condition->addData(newData);
+
+  // make sure the query has been run for the new condition data
+  newData->isActive();
+}
+
+/*!
+  \internal
+
+  Release the condition data for \a row if it is inactive and its query no longer matches.
+ */
+void AlertConditionStore::releaseIfInactive(int row)
+{
+  AlertConditionData* data = m_data.value(row);
+  if (!data || !data->isConditionEnabled())
+    return;
+
+  if (data->isActive() || data->cachedQueryResult() || data->isQueryPending())
+    return;
+
+  release(row);
+}
+
+/*!
+  \internal
+
+  Delete the condition data and source for \a row.
+
+  Deletion is deferred since this is generally called in response to a signal from them.
+ */
+void AlertConditionStore::release(int row)
+{
+  m_matches[row] = false;
+  m_pending[row] = false;
+
+  QPointer<AlertConditionData> data = m_data.at(row);
+  m_data[row] = nullptr;
+  if (!data)
+    return;
+
+  disconnect(data.data(), nullptr, this, nullptr);
+
+  AlertSource* source = data->source();
+  if (source)
+  {
+    disconnect(source, nullptr, this, nullptr);
+    source->deleteLater();
+  }
+
+  data->deleteLater();
+}
+
+} // Dsa
@@ -0,0 +1,74 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef ALERTCONDITIONSTORE_H
+#define ALERTCONDITIONSTORE_H
+
+// Qt headers
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+namespace Dsa {
+
+class AlertCondition;
+class AlertConditionData;
+class AlertTarget;
+class GraphicsOverlaySourceStore;
+
+class AlertConditionStore : public QObject
+{
+  Q_OBJECT
+
+public:
+  AlertConditionStore(AlertCondition* condition, GraphicsOverlaySourceStore* sources, AlertTarget* target);
+  ~AlertConditionStore();
+
+  int size() const;
+  int materializedCount() const;
+
+  bool matchesQuery(int row) const;
+  AlertConditionData* data(int row) const;
+
+private slots:
+  void handleRowsAdded(int first, int last);
+  void handleRowsChanged(const QVector<int>& rows);
+  void handleConditionRowsChanged(const QVector<int>& rows);
+  void handleRowAboutToBeRemoved(int row);
+  void handleConditionEnabledChanged();
+  void evaluateAll();
+  void evaluatePending();
+
+private:
+  void evaluateRow(int row);
+  void materialize(int row);
+  void releaseIfInactive(int row);
+  void release(int row);
+
+  AlertCondition* m_condition = nullptr;
+  GraphicsOverlaySourceStore* m_sources = nullptr;
+  AlertTarget* m_target = nullptr;
+  int m_materializedCount = 0;
+
+  // one entry per source row in each column
+  QVector<bool> m_matches;
+  QVector<bool> m_pending;
+  QVector<QPointer<AlertConditionData>> m_data;
+};
+
+} // Dsa
+
+#endif // ALERTCONDITIONSTORE_H
@@ -25,6 +25,7 @@
 #include "AlertConditionListModel.h"
 #include "AlertConstants.h"
 #include "AlertListModel.h"
+#include "AlertStatisticsModel.h"
 #include "AttributeEqualsAlertCondition.h"
 #include "FeatureLayerAlertTarget.h"
 #include "FixedValueAlertTarget.h"
@@ -35,8 +36,11 @@
 #include "LocationAlertSource.h"
 #include "LocationAlertTarget.h"
 #include "MessageFeedConstants.h"
+#include "NotUpdatedAlertCondition.h"
+#include "SpeedAboveAlertCondition.h"
 #include "WithinAreaAlertCondition.h"
 #include "WithinDistanceAlertCondition.h"
+#include "WithinDistanceJoinAlertCondition.h"
 
 // toolkit headers
 #include "ToolManager.h"
@@ -55,6 +59,7 @@
 #include <QEventLoop>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QScopeGuard>
 
 using namespace Esri::ArcGISRuntime;
 
@@ -76,6 +81,9 @@ namespace Dsa {
   \sa AlertConditionListModel
   \sa WithinAreaAlertCondition
   \sa WithinDistanceAlertCondition
+  \sa WithinDistanceJoinAlertCondition
+  \sa SpeedAboveAlertCondition
+  \sa NotUpdatedAlertCondition
  */
 
 /*!
@@ -125,10 +133,25 @@ QString AlertConditionsController::toolName() const
  * \list
  *  \li Conditions. A list of JSON objects describing alert conditions to be added to the map.
  *  \li MessageFeeds. A list of real-time feeds to be used as condition sources.
+ *  \li AlertStatisticsEnabled. Whether the \l statistics are collected. The default is \c false.
+ *  \li AlertStatisticsInterval. The time in milliseconds between updates of the \l statistics.
+ *  \li AlertStatisticsLogging. Whether each update of the \l statistics is written to the log.
  * \endlist
  */
 void AlertConditionsController::setProperties(const QVariantMap& properties)
 {
+  const auto statisticsEnabled = properties[AlertConstants::ALERT_STATISTICS_ENABLED_PROPERTYNAME];
+  if (statisticsEnabled.isValid())
+    AlertStatisticsModel::instance()->setEnabled(statisticsEnabled.toBool());
+
+  const auto statisticsInterval = properties[AlertConstants::ALERT_STATISTICS_INTERVAL_PROPERTYNAME];
+  if (statisticsInterval.isValid())
+    AlertStatisticsModel::instance()->setReportInterval(statisticsInterval.toInt());
+
+  const auto statisticsLogging = properties[AlertConstants::ALERT_STATISTICS_LOGGING_PROPERTYNAME];
+  if (statisticsLogging.isValid())
+    AlertStatisticsModel::instance()->setLoggingEnabled(statisticsLogging.toBool());
+
   const auto conditionsData = properties[AlertConstants::ALERT_CONDITIONS_PROPERTYNAME];
 
   const auto messageFeeds = properties[MessageFeedConstants::MESSAGE_FEEDS_PROPERTYNAME].toList();
@@ -280,6 +303,160 @@ bool AlertConditionsController::addWithinDistanceAlert(const QString& conditionN
   return m_conditions->addAlertCondition(condition);
 }
 
+/*!
+  \brief Adds a \l WithinDistanceJoinAlertCondition to the list of conditions.
+
+  \list
+    \li \a conditionName. The name for the condition.
+    \li \a levelIndex. The \l AlertLevel for the condition.
+    \li \a sourceFeedName. The name of the source feed (the name of a \l Esri::ArcGISRuntime::GraphicsOverlay).
+    \li \a distance. The threshold distance for this condition in meters.
+    \li \a targetFeedName. The name of the target feed (the name of a \l Esri::ArcGISRuntime::GraphicsOverlay).
+  \endlist
+
+  An alert is raised for each graphic in the source feed which is within \a distance of any
+  graphic in the target feed.
+
+  Returns \c true if the condition was successfully added.
+ */
+bool AlertConditionsController::addWithinDistanceJoinAlert(const QString& conditionName,
+                                                           int levelIndex,
+                                                           const QString& sourceFeedName,
+                                                           double distance,
+                                                           const QString& targetFeedName)
+{
+  if (levelIndex < 0 ||
+      sourceFeedName.isEmpty() ||
+      distance < 0.0 ||
+      targetFeedName.isEmpty())
+  {
+    emit toolErrorOccurred(QStringLiteral("Failed to create Condition"), QStringLiteral("Invalid inputs"));
+    return false;
+  }
+
+  AlertLevel level = static_cast<AlertLevel>(levelIndex);
+  if (level > AlertLevel::Critical)
+  {
+    emit toolErrorOccurred(QStringLiteral("Failed to create Condition"), QStringLiteral("Invalid Alert Level"));
+    return false;
+  }
+
+  GraphicsOverlay* sourceOverlay = graphicsOverlayFromName(sourceFeedName);
+  if (!sourceOverlay)
+  {
+    emit toolErrorOccurred(QStringLiteral("Failed to create Condition"), QString("Could not find source feed: %1").arg(sourceFeedName));
+    return false;
+  }
+
+  GraphicsOverlay* targetOverlay = graphicsOverlayFromName(targetFeedName);
+  if (!targetOverlay)
+  {
+    emit toolErrorOccurred(QStringLiteral("Failed to create Condition"), QString("Could not find target feed: %1").arg(targetFeedName));
+    return false;
+  }
+
+  WithinDistanceJoinAlertCondition* condition = new WithinDistanceJoinAlertCondition(level, conditionName, distance, this);
+  connect(condition, &WithinDistanceJoinAlertCondition::newConditionData, this, &AlertConditionsController::handleNewAlertConditionData);
+  condition->init(sourceOverlay, sourceFeedName, targetOverlay, targetFeedName);
+  return m_conditions->addAlertCondition(condition);
+}
+
+/*!
+  \brief Adds a \l SpeedAboveAlertCondition to the list of conditions.
+
+  \list
+    \li \a conditionName. The name for the condition.
+    \li \a levelIndex. The \l AlertLevel for the condition.
+    \li \a sourceFeedName. The name of the source feed (the name of a \l Esri::ArcGISRuntime::GraphicsOverlay).
+    \li \a speed. The threshold speed for this condition in meters per second.
+    \li \a duration. The time in seconds for which the speed must be exceeded.
+  \endlist
+
+  An alert is raised for each track in the source feed which has been faster than \a speed
+  for \a duration.
+
+  Returns \c true if the condition was successfully added.
+ */
+bool AlertConditionsController::addSpeedAboveAlert(const QString& conditionName,
+                                                   int levelIndex,
+                                                   const QString& sourceFeedName,
+                                                   double speed,
+                                                   double duration)
+{
+  if (levelIndex < 0 ||
+      sourceFeedName.isEmpty() ||
+      speed < 0.0 ||
+      duration < 0.0)
+  {
+    emit toolErrorOccurred(QStringLiteral("Failed to create Condition"), QStringLiteral("Invalid inputs"));
+    return false;
+  }
+
+  AlertLevel level = static_cast<AlertLevel>(levelIndex);
+  if (level > AlertLevel::Critical)
+  {
+    emit toolErrorOccurred(QStringLiteral("Failed to create Condition"), QStringLiteral("Invalid Alert Level"));
+    return false;
+  }
+
+  GraphicsOverlay* sourceOverlay = graphicsOverlayFromName(sourceFeedName);
+  if (!sourceOverlay)
+  {
+    emit toolErrorOccurred(QStringLiteral("Failed to create Condition"), QString("Could not find source feed: %1").arg(sourceFeedName));
+    return false;
+  }
+
+  SpeedAboveAlertCondition* condition = new SpeedAboveAlertCondition(level, conditionName, speed, duration, this);
+  connect(condition, &SpeedAboveAlertCondition::newConditionData, this, &AlertConditionsController::handleNewAlertConditionData);
+  condition->init(sourceOverlay, sourceFeedName);
+  return m_conditions->addAlertCondition(condition);
+}
+
+/*!
+  \brief Adds a \l NotUpdatedAlertCondition to the list of conditions.
+
+  \list
+    \li \a conditionName. The name for the condition.
+    \li \a levelIndex. The \l AlertLevel for the condition.
+    \li \a sourceFeedName. The name of the source feed (the name of a \l Esri::ArcGISRuntime::GraphicsOverlay).
+    \li \a duration. The time in seconds after which a track without updates raises an alert.
+  \endlist
+
+  Returns \c true if the condition was successfully added.
+ */
+bool AlertConditionsController::addNotUpdatedAlert(const QString& conditionName,
+                                                   int levelIndex,
+                                                   const QString& sourceFeedName,
+                                                   double duration)
+{
+  if (levelIndex < 0 ||
+      sourceFeedName.isEmpty() ||
+      duration < 0.0)
+  {
+    emit toolErrorOccurred(QStringLiteral("Failed to create Condition"), QStringLiteral("Invalid inputs"));
+    return false;
+  }
+
+  AlertLevel level = static_cast<AlertLevel>(levelIndex);
+  if (level > AlertLevel::Critical)
+  {
+    emit toolErrorOccurred(QStringLiteral("Failed to create Condition"), QStringLiteral("Invalid Alert Level"));
+    return false;
+  }
+
+  GraphicsOverlay* sourceOverlay = graphicsOverlayFromName(sourceFeedName);
+  if (!sourceOverlay)
+  {
+    emit toolErrorOccurred(QStringLiteral("Failed to create Condition"), QString("Could not find source feed: %1").arg(sourceFeedName));
+    return false;
+  }
+
+  NotUpdatedAlertCondition* condition = new NotUpdatedAlertCondition(level, conditionName, duration, this);
+  connect(condition, &NotUpdatedAlertCondition::newConditionData, this, &AlertConditionsController::handleNewAlertConditionData);
+  condition->init(sourceOverlay, sourceFeedName);
+  return m_conditions->addAlertCondition(condition);
+}
+
 /*!
   \brief Adds a \l WithinAreaAlertCondition to the list of conditions.
 
@@ -474,6 +651,30 @@ void AlertConditionsController::updateConditionLevel(int rowIndex, int level)
   alertCondition->setLevel(alertLevel);
 }
 
+/*
+ \brief Updates the hysteresis margin of the given \a rowIndex to \a hysteresis meters.
+*/
+void AlertConditionsController::updateConditionHysteresis(int rowIndex, double hysteresis)
+{
+  auto alertCondition = m_conditions->conditionAt(rowIndex);
+  if (!alertCondition)
+    return;
+
+  alertCondition->setHysteresis(hysteresis);
+}
+
+/*
+ \brief Updates the minimum dwell time of the given \a rowIndex to \a dwellTime milliseconds.
+*/
+void AlertConditionsController::updateConditionDwellTime(int rowIndex, int dwellTime)
+{
+  auto alertCondition = m_conditions->conditionAt(rowIndex);
+  if (!alertCondition)
+    return;
+
+  alertCondition->setDwellTime(dwellTime);
+}
+
 /*!
   \property AlertConditionsController::sourceNames
   \brief Returns a QAbstractItemModel containing the list of
@@ -522,6 +723,15 @@ QAbstractItemModel* AlertConditionsController::conditionsList() const
   return m_conditions;
 }
 
+/*!
+  \property AlertConditionsController::statistics
+  \brief Returns the \l AlertStatisticsModel describing the cost of each condition.
+ */
+QAbstractItemModel* AlertConditionsController::statistics() const
+{
+  return AlertStatisticsModel::instance();
+}
+
 /*!
   \property AlertConditionsController::pickMode
   \brief Returns whether the tool is in pick mode or not.
@@ -903,6 +1113,13 @@ QJsonObject AlertConditionsController::conditionToJson(AlertCondition* condition
   conditionJson.insert( AlertConstants::CONDITION_QUERY, queryObject);
   conditionJson.insert( AlertConstants::CONDITION_TARGET, condition->targetDescription());
 
+  // only write the transition settings when they differ from the defaults
+  if (condition->hysteresis() > 0.0)
+    conditionJson.insert( AlertConstants::CONDITION_HYSTERESIS, condition->hysteresis());
+
+  if (condition->dwellTime() > 0)
+    conditionJson.insert( AlertConstants::CONDITION_DWELL_TIME, condition->dwellTime());
+
   return conditionJson;
 }
 
@@ -934,8 +1151,11 @@ bool AlertConditionsController::addConditionFromJson(const QJsonObject& json)
   const bool isAttributeEquals = conditionType == AlertConstants::attributeEqualsAlertConditionType();
   const bool isWithinArea = conditionType == AlertConstants::withinAreaAlertConditionType();
   const bool isWithinDistance = conditionType == AlertConstants::withinDistanceAlertConditionType();
+  const bool isWithinDistanceJoin = conditionType == AlertConstants::withinDistanceJoinAlertConditionType();
+  const bool isSpeedAbove = conditionType == AlertConstants::speedAboveAlertConditionType();
+  const bool isNotUpdated = conditionType == AlertConstants::notUpdatedAlertConditionType();
 
-  if (!isAttributeEquals && !isWithinArea && !isWithinDistance)
+  if (!isAttributeEquals && !isWithinArea && !isWithinDistance && !isWithinDistanceJoin && !isSpeedAbove && !isNotUpdated)
     return false;
 
   auto levelIt = json.constFind(AlertConstants::CONDITION_LEVEL);
@@ -959,13 +1179,54 @@ bool AlertConditionsController::addConditionFromJson(const QJsonObject& json)
   QJsonObject queryObject = json.value(AlertConstants::CONDITION_QUERY).toObject();
   const QVariantMap queryComponents = queryObject.toVariantMap();
 
+  // remember the condition created below, so that its transition settings can be applied
+  AlertCondition* addedCondition = nullptr;
+  const QMetaObject::Connection addedConnection = connect(m_conditions, &AlertConditionListModel::rowsInserted, this,
+                                                          [this, &addedCondition](const QModelIndex&, int first, int)
+  {
+    addedCondition = m_conditions->conditionAt(first);
+  });
+  const auto disconnectAdded = qScopeGuard([&addedConnection]()
+  {
+    QObject::disconnect(addedConnection);
+  });
+
+  bool added = false;
+
   if (isAttributeEquals)
   {
     const QString attributeName = AttributeEqualsAlertCondition::attributeNameFromQueryComponents(queryComponents);
     if (attributeName.isEmpty())
       return false;
 
-    return addAttributeEqualsAlert(conditionName, level, sourceString, attributeName, targetString );
+    added = addAttributeEqualsAlert(conditionName, level, sourceString, attributeName, targetString );
+  }
+  else if (isWithinDistanceJoin)
+  {
+    const double distance = WithinDistanceAlertCondition::getDistanceFromQueryComponents(queryComponents);
+    if (distance == -1.0)
+      return false;
+
+    // both the source and the target are feeds
+    added = addWithinDistanceJoinAlert(conditionName, level, sourceString, distance, targetString);
+  }
+  else if (isSpeedAbove)
+  {
+    // the target only describes the duration, which is also in the query
+    const double speed = SpeedAboveAlertCondition::getSpeedFromQueryComponents(queryComponents);
+    const double duration = SpeedAboveAlertCondition::getDurationFromQueryComponents(queryComponents);
+    if (speed == -1.0 || duration == -1.0)
+      return false;
+
+    added = addSpeedAboveAlert(conditionName, level, sourceString, speed, duration);
+  }
+  else if (isNotUpdated)
+  {
+    const double duration = NotUpdatedAlertCondition::getDurationFromQueryComponents(queryComponents);
+    if (duration == -1.0)
+      return false;
+
+    added = addNotUpdatedAlert(conditionName, level, sourceString, duration);
   }
   else if (isWithinArea || isWithinDistance)
   {
@@ -995,7 +1256,7 @@ bool AlertConditionsController::addConditionFromJson(const QJsonObject& json)
 
     if (isWithinArea)
     {
-      return addWithinAreaAlert(conditionName, level, sourceString, itemId, targetOverlayIndex );
+      added = addWithinAreaAlert(conditionName, level, sourceString, itemId, targetOverlayIndex );
     }
     else if (isWithinDistance)
     {
@@ -1003,11 +1264,21 @@ bool AlertConditionsController::addConditionFromJson(const QJsonObject& json)
       if (distance == -1.0)
         return false;
 
-      return addWithinDistanceAlert(conditionName, level, sourceString, distance, itemId, targetOverlayIndex);
+      added = addWithinDistanceAlert(conditionName, level, sourceString, distance, itemId, targetOverlayIndex);
     }
   }
 
-  return false;
+  if (!added)
+    return false;
+
+  // apply the optional transition settings to the newly added condition
+  if (addedCondition)
+  {
+    addedCondition->setHysteresis(json.value(AlertConstants::CONDITION_HYSTERESIS).toDouble(0.0));
+    addedCondition->setDwellTime(json.value(AlertConstants::CONDITION_DWELL_TIME).toInt(0));
+  }
+
+  return true;
 }
 
 /*!
@@ -59,6 +59,7 @@ class AlertConditionsController : public AbstractTool
   Q_PROPERTY(QAbstractItemModel* levelNames READ levelNames CONSTANT)
   Q_PROPERTY(QAbstractItemModel* conditionsList READ conditionsList NOTIFY conditionsListChanged)
   Q_PROPERTY(bool pickMode READ pickMode NOTIFY pickModeChanged)
+  Q_PROPERTY(QAbstractItemModel* statistics READ statistics CONSTANT)
 
 public:
 
@@ -72,18 +73,24 @@ public:
   void setActive(bool active) override;
 
   Q_INVOKABLE bool addWithinDistanceAlert(const QString& conditionName, int levelIndex, const QString& sourceFeedname, double distance, int itemId, int targetOverlayIndex);
+  Q_INVOKABLE bool addWithinDistanceJoinAlert(const QString& conditionName, int levelIndex, const QString& sourceFeedName, double distance, const QString& targetFeedName);
   Q_INVOKABLE bool addWithinAreaAlert(const QString& conditionName, int levelIndex, const QString& sourceFeedname, int itemId, int targetOverlayIndex);
   Q_INVOKABLE bool addAttributeEqualsAlert(const QString& conditionName, int levelIndex, const QString& sourceFeedname, const QString& attributeName, const QVariant& targetValue);
+  Q_INVOKABLE bool addSpeedAboveAlert(const QString& conditionName, int levelIndex, const QString& sourceFeedName, double speed, double duration);
+  Q_INVOKABLE bool addNotUpdatedAlert(const QString& conditionName, int levelIndex, const QString& sourceFeedName, double duration);
   Q_INVOKABLE void removeConditionAt(int rowIndex);
   Q_INVOKABLE void togglePickMode();
   Q_INVOKABLE void updateConditionName(int rowIndex, const QString& conditionName);
   Q_INVOKABLE void updateConditionLevel(int rowIndex, int level);
+  Q_INVOKABLE void updateConditionHysteresis(int rowIndex, double hysteresis);
+  Q_INVOKABLE void updateConditionDwellTime(int rowIndex, int dwellTime);
 
   QAbstractItemModel* sourceNames() const;
   QAbstractItemModel* targetNames() const;
   QAbstractItemModel* levelNames() const;
   QAbstractItemModel* conditionsList() const;
   bool pickMode() const;
+  QAbstractItemModel* statistics() const;
 
 signals:
   void sourceNamesChanged();
@@ -21,12 +21,18 @@
 
 // dsa app headers
 #include "AttributeEqualsAlertCondition.h"
+#include "NotUpdatedAlertCondition.h"
+#include "SpeedAboveAlertCondition.h"
 #include "WithinAreaAlertCondition.h"
 #include "WithinDistanceAlertCondition.h"
+#include "WithinDistanceJoinAlertCondition.h"
 
 namespace Dsa {
 
 const QString AlertConstants::ALERT_CONDITIONS_PROPERTYNAME = "Conditions";
+const QString AlertConstants::ALERT_STATISTICS_ENABLED_PROPERTYNAME = "AlertStatisticsEnabled";
+const QString AlertConstants::ALERT_STATISTICS_INTERVAL_PROPERTYNAME = "AlertStatisticsInterval";
+const QString AlertConstants::ALERT_STATISTICS_LOGGING_PROPERTYNAME = "AlertStatisticsLogging";
 const QString AlertConstants::ATTRIBUTE_NAME = "attribute_name";
 const QString AlertConstants::CONDITION_TYPE = "condition_type";
 const QString AlertConstants::CONDITION_NAME = "name";
@@ -34,8 +40,12 @@ const QString AlertConstants::CONDITION_LEVEL = "level";
 const QString AlertConstants::CONDITION_SOURCE = "source";
 const QString AlertConstants::CONDITION_QUERY = "query";
 const QString AlertConstants::CONDITION_TARGET = "target";
+const QString AlertConstants::CONDITION_HYSTERESIS = "hysteresis";
+const QString AlertConstants::CONDITION_DWELL_TIME = "dwell_time";
 const QString AlertConstants::METERS = "meters";
+const QString AlertConstants::METERS_PER_SECOND = "meters_per_second";
 const QString AlertConstants::MY_LOCATION = "My Location";
+const QString AlertConstants::SECONDS = "seconds";
 
 QString AlertConstants::attributeEqualsAlertConditionType()
 {
@@ -52,4 +62,19 @@ QString AlertConstants::withinDistanceAlertConditionType()
   return WithinDistanceAlertCondition::staticMetaObject.className();
 }
 
+QString AlertConstants::withinDistanceJoinAlertConditionType()
+{
+  return WithinDistanceJoinAlertCondition::staticMetaObject.className();
+}
+
+QString AlertConstants::speedAboveAlertConditionType()
+{
+  return SpeedAboveAlertCondition::staticMetaObject.className();
+}
+
+QString AlertConstants::notUpdatedAlertConditionType()
+{
+  return NotUpdatedAlertCondition::staticMetaObject.className();
+}
+
 } // Dsa
@@ -25,6 +25,9 @@ namespace Dsa {
 class AlertConstants {
 public:
   static const QString ALERT_CONDITIONS_PROPERTYNAME;
+  static const QString ALERT_STATISTICS_ENABLED_PROPERTYNAME;
+  static const QString ALERT_STATISTICS_INTERVAL_PROPERTYNAME;
+  static const QString ALERT_STATISTICS_LOGGING_PROPERTYNAME;
   static const QString ATTRIBUTE_NAME;
   static const QString CONDITION_TYPE;
   static const QString CONDITION_NAME;
@@ -32,12 +35,19 @@ public:
   static const QString CONDITION_SOURCE;
   static const QString CONDITION_QUERY;
   static const QString CONDITION_TARGET;
+  static const QString CONDITION_HYSTERESIS;
+  static const QString CONDITION_DWELL_TIME;
   static const QString METERS;
+  static const QString METERS_PER_SECOND;
   static const QString MY_LOCATION;
+  static const QString SECONDS;
 
   static QString attributeEqualsAlertConditionType();
   static QString withinAreaAlertConditionType();
   static QString withinDistanceAlertConditionType();
+  static QString withinDistanceJoinAlertConditionType();
+  static QString speedAboveAlertConditionType();
+  static QString notUpdatedAlertConditionType();
 };
 
 } // Dsa
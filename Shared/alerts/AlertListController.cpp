@@ -82,9 +82,7 @@ AlertListController::AlertListController(QObject* parent /* = nullptr */):
   // sets the initial set of filters for condition data
   m_alertsProxyModel->applyFilter(m_filters);
 
-  connect(AlertListModel::instance(), &AlertListModel::dataChanged, this, &AlertListController::allAlertsCountChanged);
-  connect(AlertListModel::instance(), &AlertListModel::rowsInserted, this, &AlertListController::allAlertsCountChanged);
-  connect(AlertListModel::instance(), &AlertListModel::rowsRemoved, this, &AlertListController::allAlertsCountChanged);
+  connect(AlertListModel::instance(), &AlertListModel::alertCountsChanged, this, &AlertListController::allAlertsCountChanged);
   emit allAlertsCountChanged();
 
   ToolManager::instance().addTool(this);
@@ -116,24 +114,7 @@ int AlertListController::allAlertsCount() const
   if (!model)
     return 0;
 
-  int count = 0;
-  const int alertsCount = model->rowCount();
-  for (int i = 0; i < alertsCount; ++i)
-  {
-    AlertConditionData* alert = model->alertAt(i);
-    if (!alert)
-      continue;
-
-    if (!alert->isActive())
-      continue;
-
-    if (!alert->isConditionEnabled())
-      continue;
-
-    count++;
-  }
-
-  return count;
+  return model->activeAlertsCount();
 }
 
 /*!
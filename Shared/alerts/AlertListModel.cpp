@@ -23,7 +23,10 @@
 #include "AlertConditionData.h"
 
 // Qt headers
-#include <QUuid>
+#include <QTimer>
+
+// STL headers
+#include <algorithm>
 
 using namespace Esri::ArcGISRuntime;
 
@@ -59,6 +62,17 @@ namespace Dsa {
         \li bool
         \li Whether the alert condition has been viewed.
   \endtable
+
+  The row of each alert is indexed by its ID, so changes to an alert are found without
+  searching the model. A removed alert leaves an empty row (for which \l alertAt returns
+  \c nullptr) so that the rows which follow it keep their indexes. The empty rows are
+  removed together once they make up half of the model. Changes reported by the alerts are gathered and emitted as
+  \c dataChanged signals for contiguous ranges of rows once per turn of the event loop.
+
+  The number of active alerts and of active alerts which have not been viewed are
+  counted as each alert changes state, so they can be read without visiting every alert.
+  In debug builds, setting the \c DSA_VERIFY_ALERT_COUNTS environment variable checks
+  these counts against a full recount after every change.
  */
 
 /*!
@@ -82,6 +96,8 @@ AlertListModel::AlertListModel(QObject* parent):
   m_roles[AlertListRoles::Name] = "name";
   m_roles[AlertListRoles::Level] = "level";
   m_roles[AlertListRoles::Viewed] = "viewed";
+
+  m_verifyCounts = qEnvironmentVariableIsSet("DSA_VERIFY_ALERT_COUNTS");
 }
 
 /*!
@@ -110,26 +126,13 @@ bool AlertListModel::addAlertConditionData(AlertConditionData* newConditionData)
   const QUuid id = QUuid::createUuid();
   newConditionData->setId(id);
 
-  auto handleDataChanged = [this, newConditionData]()
+  auto handleDataChanged = [this, id, newConditionData]()
   {
-    if (newConditionData->id().isNull())
+    if (!m_rows.contains(id))
       return;
 
-    auto it = m_alerts.cbegin();
-    auto itEnd = m_alerts.cend();
-    int currRow = 0;
-    for (; it != itEnd; ++it, ++currRow)
-    {
-      AlertConditionData* testAlert = *it;
-      if (!testAlert)
-        continue;
-
-      if (testAlert->id() == newConditionData->id())
-      {
-        const QModelIndex changedIndex = index(currRow, 0);
-        emit dataChanged(changedIndex, changedIndex);
-      }
-    }
+    updateCounts(newConditionData);
+    markChanged(id);
   };
 
   connect(newConditionData, &AlertConditionData::viewedChanged, this, handleDataChanged);
@@ -142,8 +145,11 @@ bool AlertListModel::addAlertConditionData(AlertConditionData* newConditionData)
 
   beginInsertRows(QModelIndex(), insertIdx, insertIdx);
   m_alerts.append(newConditionData);
+  m_rows.insert(id, insertIdx);
   endInsertRows();
 
+  updateCounts(newConditionData);
+
   return true;
 }
 
@@ -158,20 +164,11 @@ void AlertListModel::removeAlert(AlertConditionData* conditionData)
   if (conditionData->id().isNull())
     return;
 
-  const QUuid theId = conditionData->id();
-
-  for (int i = 0; i < m_alerts.size(); ++i)
-  {
-    AlertConditionData* testAlert = m_alerts.at(i);
-    if (!testAlert)
-      continue;
-
-    if (testAlert->id() != theId)
-      continue;
+  auto findIt = m_rows.constFind(conditionData->id());
+  if (findIt == m_rows.cend())
+    return;
 
-    removeAt(i);
-    break;
-  }
+  removeAt(findIt.value());
 }
 
 /*!
@@ -185,6 +182,9 @@ AlertConditionData* AlertListModel::alertAt(int rowIndex) const
 
 /*!
   \brief Removes the \l AlertConditionData at \a rowIndex.
+
+  The row is left empty and reported as changed, and is removed from the model along
+  with the other empty rows later.
  */
 void AlertListModel::removeAt(int rowIndex)
 {
@@ -192,9 +192,35 @@ void AlertListModel::removeAt(int rowIndex)
   if (!alert)
     return;
 
-  beginRemoveRows(QModelIndex(), rowIndex, rowIndex);
-  m_alerts.removeAt(rowIndex);
-  endRemoveRows();
+  const QUuid id = alert->id();
+  m_alerts[rowIndex] = nullptr;
+  m_rows.remove(id);
+  ++m_removedCount;
+
+  const QModelIndex removedIndex = index(rowIndex, 0);
+  emit dataChanged(removedIndex, removedIndex);
+  emit alertRemoved(id);
+
+  removeFromCounts(id);
+
+  if (m_removedCount * 2 >= m_alerts.size())
+    compact();
+}
+
+/*!
+  \brief Returns the number of alerts which are active and enabled.
+ */
+int AlertListModel::activeAlertsCount() const
+{
+  return m_activeCount;
+}
+
+/*!
+  \brief Returns the number of alerts which are active and enabled and have not been viewed.
+ */
+int AlertListModel::unviewedAlertsCount() const
+{
+  return m_unviewedCount;
 }
 
 
@@ -296,4 +322,189 @@ QHash<int, QByteArray> AlertListModel::roleNames() const
   return m_roles;
 }
 
+/*!
+  \brief internal.
+
+  Emit a \c dataChanged signal for each contiguous range of rows which changed
+  since the last turn of the event loop.
+ */
+void AlertListModel::emitPendingChanges()
+{
+  if (m_pendingChanges.isEmpty())
+    return;
+
+  // find the current row of each changed alert (alerts may have been removed since the change)
+  QVector<int> changedRows;
+  changedRows.reserve(m_pendingChanges.size());
+  for (const QUuid& id : qAsConst(m_pendingChanges))
+  {
+    auto findIt = m_rows.constFind(id);
+    if (findIt != m_rows.cend())
+      changedRows.append(findIt.value());
+  }
+
+  m_pendingChanges.clear();
+
+  std::sort(changedRows.begin(), changedRows.end());
+  changedRows.erase(std::unique(changedRows.begin(), changedRows.end()), changedRows.end());
+
+  int rangeStart = 0;
+  for (int i = 1; i <= changedRows.size(); ++i)
+  {
+    if (i < changedRows.size() && changedRows[i] == changedRows[i - 1] + 1)
+      continue;
+
+    emit dataChanged(index(changedRows[rangeStart], 0), index(changedRows[i - 1], 0));
+    rangeStart = i;
+  }
+}
+
+/*!
+  \internal
+
+  Record that the alert with \a id has changed, to be reported on the next turn of the event loop.
+ */
+void AlertListModel::markChanged(const QUuid& id)
+{
+  if (m_pendingChanges.isEmpty())
+    QTimer::singleShot(0, this, &AlertListModel::emitPendingChanges);
+
+  m_pendingChanges.append(id);
+}
+
+/*!
+  \internal
+
+  Update the active and unviewed counts with the current state of \a alert.
+ */
+void AlertListModel::updateCounts(AlertConditionData* alert)
+{
+  // only test the active state (which may run the query) for enabled alerts
+  const bool active = alert->isConditionEnabled() && alert->isActive();
+  const bool unviewed = active && !alert->viewed();
+
+  CountedState& state = m_countedStates[alert->id()];
+  if (state.m_active == active && state.m_unviewed == unviewed)
+    return;
+
+  m_activeCount += static_cast<int>(active) - static_cast<int>(state.m_active);
+  m_unviewedCount += static_cast<int>(unviewed) - static_cast<int>(state.m_unviewed);
+  state.m_active = active;
+  state.m_unviewed = unviewed;
+
+  verifyCounts();
+  emit alertCountsChanged();
+}
+
+/*!
+  \internal
+
+  Remove the alert with \a id from the active and unviewed counts.
+ */
+void AlertListModel::removeFromCounts(const QUuid& id)
+{
+  auto findIt = m_countedStates.find(id);
+  if (findIt == m_countedStates.end())
+    return;
+
+  const CountedState state = findIt.value();
+  m_countedStates.erase(findIt);
+  if (!state.m_active && !state.m_unviewed)
+    return;
+
+  m_activeCount -= static_cast<int>(state.m_active);
+  m_unviewedCount -= static_cast<int>(state.m_unviewed);
+
+  verifyCounts();
+  emit alertCountsChanged();
+}
+
+/*!
+  \internal
+
+  In debug builds with verification enabled, assert that the counts match a full recount.
+ */
+void AlertListModel::verifyCounts() const
+{
+#ifndef QT_NO_DEBUG
+  if (!m_verifyCounts)
+    return;
+
+  int activeCount = 0;
+  int unviewedCount = 0;
+  for (AlertConditionData* alert : m_alerts)
+  {
+    if (!alert || !alert->isConditionEnabled() || !alert->isActive())
+      continue;
+
+    ++activeCount;
+    if (!alert->viewed())
+      ++unviewedCount;
+  }
+
+  Q_ASSERT_X(activeCount == m_activeCount, "AlertListModel::verifyCounts", "active alerts count is out of date");
+  Q_ASSERT_X(unviewedCount == m_unviewedCount, "AlertListModel::verifyCounts", "unviewed alerts count is out of date");
+#endif
+}
+
+/*!
+  \internal
+
+  Update the row stored for each alert from \a fromRow onwards, after rows have moved.
+ */
+void AlertListModel::updateRowIndex(int fromRow)
+{
+  for (int row = fromRow; row < m_alerts.size(); ++row)
+  {
+    AlertConditionData* alert = m_alerts.at(row);
+    if (alert)
+      m_rows.insert(alert->id(), row);
+  }
+}
+
+/*!
+  \internal
+
+  Remove the empty rows left by removed alerts and update the index of the rows which remain.
+
+  Each run of empty rows is removed in turn, starting from the end of the model so that the
+  runs before it keep their indexes.
+ */
+void AlertListModel::compact()
+{
+  int row = m_alerts.size() - 1;
+  while (row >= 0)
+  {
+    if (m_alerts.at(row))
+    {
+      --row;
+      continue;
+    }
+
+    const int last = row;
+    while (row > 0 && !m_alerts.at(row - 1))
+      --row;
+
+    beginRemoveRows(QModelIndex(), row, last);
+    m_alerts.erase(m_alerts.begin() + row, m_alerts.begin() + last + 1);
+    endRemoveRows();
+
+    --row;
+  }
+
+  m_removedCount = 0;
+  updateRowIndex(0);
+}
+
 } // Dsa
+
+// Signal Documentation
+/*!
+  \fn void AlertListModel::alertCountsChanged();
+  \brief Signal emitted when the number of active or unviewed alerts changes.
+ */
+
+/*!
+  \fn void AlertListModel::alertRemoved(const QUuid& id);
+  \brief Signal emitted when the alert with \a id has been removed from the model.
+ */
@@ -21,6 +21,8 @@
 #include <QAbstractListModel>
 #include <QHash>
 #include <QList>
+#include <QUuid>
+#include <QVector>
 
 namespace Dsa {
 
@@ -49,6 +51,9 @@ public:
 
   AlertConditionData* alertAt(int rowIndex) const;
 
+  int activeAlertsCount() const;
+  int unviewedAlertsCount() const;
+
   void removeAt(int rowIndex);
 
   // QAbstractItemModel interface
@@ -56,14 +61,41 @@ public:
   QVariant data(const QModelIndex& index, int role) const override;
   bool setData(const QModelIndex& index, const QVariant& value, int role) override;
 
+signals:
+  void alertCountsChanged();
+  void alertRemoved(const QUuid& id);
+
 protected:
   QHash<int, QByteArray> roleNames() const override;
 
+private slots:
+  void emitPendingChanges();
+
 private:
   AlertListModel(QObject* parent = nullptr);
 
+  struct CountedState
+  {
+    bool m_active = false;
+    bool m_unviewed = false;
+  };
+
+  void markChanged(const QUuid& id);
+  void updateRowIndex(int fromRow);
+  void compact();
+  void updateCounts(AlertConditionData* alert);
+  void removeFromCounts(const QUuid& id);
+  void verifyCounts() const;
+
   QHash<int, QByteArray>  m_roles;
   QList<AlertConditionData*>   m_alerts;
+  QHash<QUuid, int> m_rows;
+  QVector<QUuid> m_pendingChanges;
+  QHash<QUuid, CountedState> m_countedStates;
+  int m_activeCount = 0;
+  int m_unviewedCount = 0;
+  int m_removedCount = 0;
+  bool m_verifyCounts = false;
 };
 
 } // Dsa
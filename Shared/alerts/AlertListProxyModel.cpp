@@ -32,6 +32,11 @@ namespace Dsa {
   \inherits QSortFilterProxyModel
   \brief A proxy model responsible for filtering the list of \l AlertConditionData
   to show only those which are active and statisfy the current set of \l AlertFilter tests.
+
+  The filtered mapping is maintained incrementally: when a single condition data changes,
+  is added or is removed, only that row is tested and inserted into or removed from the
+  proxy. The result of the filters is cached for each alert by its ID and only
+  discarded when the alert changes or the filters are applied again.
   */
 
 /*!
@@ -41,43 +46,22 @@ AlertListProxyModel::AlertListProxyModel(AlertListModel* sourceModel, QObject* p
   QSortFilterProxyModel(parent),
   m_sourceModel(sourceModel)
 {
-  setSourceModel(m_sourceModel);
-
-  // handle changes to a given condition data in the underlying AlertListModel
-  connect(m_sourceModel, &AlertListModel::dataChanged, this, [this](const QModelIndex& topLeft)
-  {
-    // check whether the changed condition data is currently included in the filtered model
-    const bool inModel = m_rowsInModel.value(topLeft.row(), false);
-
-    // check whether the changed condition should now be included
-    const bool shouldBeInModel = passesAllQueries(topLeft.row());
-
-    // if the condition data has changed state, cache the new state and re-run the filter
-    if (inModel != shouldBeInModel)
-    {
-      m_rowsInModel.insert(topLeft.row(), shouldBeInModel);
-      invalidate();
-    }
-  });
-
-  // handle the addition of a new condition data in the underlying AlertListModel
-  connect(m_sourceModel, &AlertListModel::rowsInserted, this, [this](const QModelIndex&, int first, int)
+  // these connections are made before the source model is set, so that the cached filter
+  // state is discarded before the proxy tests the changed rows again
+  connect(m_sourceModel, &AlertListModel::dataChanged, this, [this](const QModelIndex& topLeft, const QModelIndex& bottomRight)
   {
-    // only clear the cache if this is an insert rather than an append
-    if (m_rowsInModel.contains(first))
-      m_rowsInModel.clear();
-
-    // re-run the filter
-    invalidate();
+    clearCachedRows(topLeft.row(), bottomRight.row());
   });
 
-  // handle condition data being removed from the underlying AlertListModel
-  connect(m_sourceModel, &AlertListModel::rowsRemoved, this, [this]()
+  // removed alerts leave an empty row in the source model, so they are forgotten by ID
+  connect(m_sourceModel, &AlertListModel::alertRemoved, this, [this](const QUuid& id)
   {
-    m_rowsInModel.clear();
-    invalidate();
+    m_alertsInModel.remove(id);
   });
 
+  // only the changed, inserted or removed rows are filtered again when the source model changes
+  setDynamicSortFilter(true);
+  setSourceModel(m_sourceModel);
 }
 
 /*!
@@ -94,8 +78,8 @@ AlertListProxyModel::~AlertListProxyModel()
 void AlertListProxyModel::applyFilter(const QList<AlertFilter*>& filters)
 {
   m_filters = filters;
-  m_rowsInModel.clear();
-  invalidate();
+  m_alertsInModel.clear();
+  invalidateFilter();
 }
 
 
@@ -105,11 +89,18 @@ void AlertListProxyModel::applyFilter(const QList<AlertFilter*>& filters)
  */
 bool AlertListProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex&) const
 {
+  AlertConditionData* conditionData = m_sourceModel->alertAt(sourceRow);
+  if (!conditionData)
+    return false;
+
   // if required, update the cache to record the filter state for the condition data
-  if (!m_rowsInModel.contains(sourceRow))
-    m_rowsInModel.insert(sourceRow, passesAllQueries(sourceRow));
+  auto findIt = m_alertsInModel.constFind(conditionData->id());
+  if (findIt != m_alertsInModel.cend())
+    return findIt.value();
 
-  return m_rowsInModel.value(sourceRow);
+  const bool inModel = passesAllQueries(sourceRow);
+  m_alertsInModel.insert(conditionData->id(), inModel);
+  return inModel;
 }
 
 /*!
@@ -143,8 +134,23 @@ bool AlertListProxyModel::passesAllQueries(int sourceRow) const
   }
 
   // if the condition data passes all filters, it should be in the filtered model
-  // if it currently satisfies its underlying condition
-  return conditionData->matchesQuery();
+  // if it is active, after any dwell time and hysteresis
+  return conditionData->isActive();
+}
+
+/*!
+  \internal
+
+  Discard the cached filter state of the condition data in the source rows \a first to \a last.
+ */
+void AlertListProxyModel::clearCachedRows(int first, int last)
+{
+  for (int row = first; row <= last; ++row)
+  {
+    AlertConditionData* conditionData = m_sourceModel->alertAt(row);
+    if (conditionData)
+      m_alertsInModel.remove(conditionData->id());
+  }
 }
 
 } // Dsa
@@ -21,6 +21,7 @@
 #include <QHash>
 #include <QList>
 #include <QSortFilterProxyModel>
+#include <QUuid>
 
 namespace Dsa {
 
@@ -44,10 +45,11 @@ protected:
 
 private:
   bool passesAllQueries(int sourceRow) const;
+  void clearCachedRows(int first, int last);
 
   AlertListModel* m_sourceModel;
   QList<AlertFilter*> m_filters;
-  mutable QHash<int, bool> m_rowsInModel;
+  mutable QHash<QUuid, bool> m_alertsInModel;
 };
 
 } // Dsa
@@ -0,0 +1,529 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "AlertStatisticsModel.h"
+
+// dsa app headers
+#include "AlertCondition.h"
+#include "GeometryProjectionCache.h"
+
+// Qt headers
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QtDebug>
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+
+namespace Dsa {
+
+namespace
+{
+// the number of recent query times kept for each condition to estimate the 99th percentile
+constexpr int recentSampleCount = 1024;
+
+// the default time between reports, in milliseconds
+constexpr int defaultReportInterval = 5000;
+
+double hitRate(quint64 hits, quint64 misses)
+{
+  const quint64 lookups = hits + misses;
+  return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+}
+}
+
+/*!
+  \class Dsa::AlertStatisticsModel
+  \inmodule Dsa
+  \inherits QAbstractListModel
+  \brief A singleton model of statistics describing the cost of the alert conditions.
+
+  Each row of the model describes one \l AlertCondition. The statistics are gathered as
+  the condition data for each condition is tested and are updated every \l reportInterval
+  milliseconds. Times are reported in microseconds.
+
+  The model returns data for the following roles:
+  \table
+    \header
+        \li Role
+        \li Type
+        \li Description
+    \row
+        \li conditionName
+        \li QString
+        \li The name of the alert condition.
+    \row
+        \li evaluationsPerSecond
+        \li double
+        \li The number of times the condition was tested per second during the last interval.
+    \row
+        \li meanQueryTime
+        \li double
+        \li The mean time taken by \l AlertConditionData::matchesQuery during the last interval.
+    \row
+        \li p99QueryTime
+        \li double
+        \li The 99th percentile of the time taken by \l AlertConditionData::matchesQuery,
+            over the most recent tests.
+    \row
+        \li meanCandidates
+        \li double
+        \li The mean number of target candidates tested per query during the last interval.
+    \row
+        \li totalEvaluations
+        \li int
+        \li The number of times the condition has been tested.
+  \endtable
+
+  The hit rates of the projection, prepared polygon and feature caches and the number
+  of times spatial indexes have been rebuilt are available from \l counters.
+
+  Statistics are only collected while \l enabled is \c true, so that the alert engine
+  does not pay for timing its queries unless somebody is looking at the results.
+
+  When \l loggingEnabled is \c true, each report is also written to the log as a single
+  line of compact JSON (see \l toJson), so that conditions can be tuned in the field.
+  */
+
+/*!
+  \brief Static method to return a singleton instance of the model.
+ */
+AlertStatisticsModel* AlertStatisticsModel::instance()
+{
+  static AlertStatisticsModel s_instance;
+
+  return &s_instance;
+}
+
+/*!
+  \brief Constructor for a model taking an optional \a parent.
+ */
+AlertStatisticsModel::AlertStatisticsModel(QObject* parent):
+  QAbstractListModel(parent),
+  m_caches(2),
+  m_rebuilds(2, 0),
+  m_reportInterval(defaultReportInterval)
+{
+  m_roles[AlertStatisticsRoles::ConditionName] = "conditionName";
+  m_roles[AlertStatisticsRoles::EvaluationsPerSecond] = "evaluationsPerSecond";
+  m_roles[AlertStatisticsRoles::MeanQueryTime] = "meanQueryTime";
+  m_roles[AlertStatisticsRoles::P99QueryTime] = "p99QueryTime";
+  m_roles[AlertStatisticsRoles::MeanCandidates] = "meanCandidates";
+  m_roles[AlertStatisticsRoles::TotalEvaluations] = "totalEvaluations";
+
+  connect(&m_reportTimer, &QTimer::timeout, this, &AlertStatisticsModel::report);
+}
+
+/*!
+  \brief Destructor.
+ */
+AlertStatisticsModel::~AlertStatisticsModel()
+{
+
+}
+
+/*!
+  \brief Records that a query for \a condition took \a queryNanoseconds and tested \a candidateCount
+  target candidates.
+ */
+void AlertStatisticsModel::recordEvaluation(AlertCondition* condition, qint64 queryNanoseconds, int candidateCount)
+{
+  if (!m_enabled || !condition)
+    return;
+
+  auto findIt = m_rows.constFind(condition);
+  const int row = findIt != m_rows.cend() ? findIt.value() : addCondition(condition);
+
+  ConditionStatistics& statistics = m_conditions[row];
+  ++statistics.m_totalEvaluations;
+  ++statistics.m_intervalEvaluations;
+  statistics.m_intervalQueryNanoseconds += queryNanoseconds;
+  statistics.m_intervalCandidates += candidateCount;
+
+  // keep a ring of recent query times for the percentile
+  if (statistics.m_recentQueryNanoseconds.size() < recentSampleCount)
+  {
+    statistics.m_recentQueryNanoseconds.append(queryNanoseconds);
+  }
+  else
+  {
+    statistics.m_recentQueryNanoseconds[statistics.m_nextSample] = queryNanoseconds;
+    statistics.m_nextSample = (statistics.m_nextSample + 1) % recentSampleCount;
+  }
+}
+
+/*!
+  \brief Records a lookup in \a cache, which found an up-to-date entry if \a hit is \c true.
+ */
+void AlertStatisticsModel::recordCacheLookup(Cache cache, bool hit)
+{
+  if (!m_enabled)
+    return;
+
+  CacheStatistics& statistics = m_caches[static_cast<int>(cache)];
+  if (hit)
+    ++statistics.m_hits;
+  else
+    ++statistics.m_misses;
+}
+
+/*!
+  \brief Records that a spatial index of type \a rebuild was built.
+ */
+void AlertStatisticsModel::recordRebuild(Rebuild rebuild)
+{
+  if (!m_enabled)
+    return;
+
+  ++m_rebuilds[static_cast<int>(rebuild)];
+}
+
+/*!
+  \property AlertStatisticsModel::enabled
+  \brief Whether statistics are collected and reported.
+
+  The default is \c false. While disabled, the record methods return immediately and
+  no reports are made.
+ */
+bool AlertStatisticsModel::isEnabled() const
+{
+  return m_enabled;
+}
+
+/*!
+  \brief Sets whether statistics are collected and reported to \a enabled.
+ */
+void AlertStatisticsModel::setEnabled(bool enabled)
+{
+  if (enabled == m_enabled)
+    return;
+
+  m_enabled = enabled;
+  if (m_enabled && m_reportInterval > 0)
+  {
+    m_intervalTimer.start();
+    m_reportTimer.start(m_reportInterval);
+  }
+  else
+  {
+    m_reportTimer.stop();
+  }
+
+  emit enabledChanged();
+}
+
+/*!
+  \property AlertStatisticsModel::reportInterval
+  \brief The time between updates of the statistics, in milliseconds.
+
+  The default is \c 5000. Values less than or equal to \c 0 stop the updates.
+  Updates are only made while the model is \l enabled.
+ */
+int AlertStatisticsModel::reportInterval() const
+{
+  return m_reportInterval;
+}
+
+/*!
+  \brief Sets the time between updates of the statistics to \a reportInterval milliseconds.
+ */
+void AlertStatisticsModel::setReportInterval(int reportInterval)
+{
+  if (reportInterval <= 0)
+    reportInterval = 0;
+
+  if (reportInterval == m_reportInterval)
+    return;
+
+  m_reportInterval = reportInterval;
+  if (m_enabled && m_reportInterval > 0)
+    m_reportTimer.start(m_reportInterval);
+  else
+    m_reportTimer.stop();
+
+  emit reportIntervalChanged();
+}
+
+/*!
+  \property AlertStatisticsModel::loggingEnabled
+  \brief Whether each update of the statistics is written to the log as a line of JSON.
+
+  The default is \c false. Enabling logging also sets \l enabled.
+ */
+bool AlertStatisticsModel::isLoggingEnabled() const
+{
+  return m_loggingEnabled;
+}
+
+/*!
+  \brief Sets whether each update of the statistics is written to the log to \a loggingEnabled.
+ */
+void AlertStatisticsModel::setLoggingEnabled(bool loggingEnabled)
+{
+  if (loggingEnabled == m_loggingEnabled)
+    return;
+
+  m_loggingEnabled = loggingEnabled;
+  emit loggingEnabledChanged();
+
+  if (m_loggingEnabled)
+    setEnabled(true);
+}
+
+/*!
+  \property AlertStatisticsModel::counters
+  \brief Returns the cache hit rates (between \c 0 and \c 1) and index rebuild counts
+  since the application started. Apart from the projection cache, which counts its own
+  lookups, only events which happened while the model was \l enabled are included.
+
+  The map contains the keys \c projectionCacheHitRate, \c preparedPolygonCacheHitRate,
+  \c featureCacheHitRate, \c quadtreeRebuilds and \c featureIndexRebuilds.
+ */
+QVariantMap AlertStatisticsModel::counters() const
+{
+  const GeometryProjectionCache* projection = GeometryProjectionCache::instance();
+  const CacheStatistics& preparedPolygon = m_caches[static_cast<int>(Cache::PreparedPolygon)];
+  const CacheStatistics& feature = m_caches[static_cast<int>(Cache::Feature)];
+
+  QVariantMap counters;
+  counters.insert(QStringLiteral("projectionCacheHitRate"), hitRate(projection->hitCount(), projection->missCount()));
+  counters.insert(QStringLiteral("preparedPolygonCacheHitRate"), hitRate(preparedPolygon.m_hits, preparedPolygon.m_misses));
+  counters.insert(QStringLiteral("featureCacheHitRate"), hitRate(feature.m_hits, feature.m_misses));
+  counters.insert(QStringLiteral("quadtreeRebuilds"), m_rebuilds[static_cast<int>(Rebuild::Quadtree)]);
+  counters.insert(QStringLiteral("featureIndexRebuilds"), m_rebuilds[static_cast<int>(Rebuild::FeatureIndex)]);
+  return counters;
+}
+
+/*!
+  \brief Returns a JSON representation of the statistics from the last update.
+
+  The object contains a \c conditions array with an object for each row of the model
+  (using the role names as keys) and a \c counters object (see \l counters).
+ */
+QJsonObject AlertStatisticsModel::toJson() const
+{
+  QJsonArray conditionsJson;
+  for (const ConditionStatistics& statistics : m_conditions)
+  {
+    QJsonObject conditionJson;
+    conditionJson.insert(m_roles[AlertStatisticsRoles::ConditionName], statistics.m_name);
+    conditionJson.insert(m_roles[AlertStatisticsRoles::EvaluationsPerSecond], statistics.m_evaluationsPerSecond);
+    conditionJson.insert(m_roles[AlertStatisticsRoles::MeanQueryTime], statistics.m_meanQueryTime);
+    conditionJson.insert(m_roles[AlertStatisticsRoles::P99QueryTime], statistics.m_p99QueryTime);
+    conditionJson.insert(m_roles[AlertStatisticsRoles::MeanCandidates], statistics.m_meanCandidates);
+    conditionJson.insert(m_roles[AlertStatisticsRoles::TotalEvaluations], static_cast<double>(statistics.m_totalEvaluations));
+    conditionsJson.append(conditionJson);
+  }
+
+  QJsonObject json;
+  json.insert(QStringLiteral("conditions"), conditionsJson);
+  json.insert(QStringLiteral("counters"), QJsonObject::fromVariantMap(counters()));
+  return json;
+}
+
+/*!
+  \brief Returns the number of conditions in the model.
+ */
+int AlertStatisticsModel::rowCount(const QModelIndex&) const
+{
+  return m_conditions.size();
+}
+
+/*!
+  \brief Returns the data stored under \a role at \a index in the model.
+
+  The role should make use of the \l AlertStatisticsRoles enum.
+ */
+QVariant AlertStatisticsModel::data(const QModelIndex& index, int role) const
+{
+  if (index.row() < 0 || index.row() >= rowCount())
+    return QVariant();
+
+  const ConditionStatistics& statistics = m_conditions.at(index.row());
+
+  switch (role)
+  {
+  case AlertStatisticsRoles::ConditionName:
+    return statistics.m_name;
+  case AlertStatisticsRoles::EvaluationsPerSecond:
+    return statistics.m_evaluationsPerSecond;
+  case AlertStatisticsRoles::MeanQueryTime:
+    return statistics.m_meanQueryTime;
+  case AlertStatisticsRoles::P99QueryTime:
+    return statistics.m_p99QueryTime;
+  case AlertStatisticsRoles::MeanCandidates:
+    return statistics.m_meanCandidates;
+  case AlertStatisticsRoles::TotalEvaluations:
+    return static_cast<double>(statistics.m_totalEvaluations);
+  default:
+    break;
+  }
+
+  return QVariant();
+}
+
+/*!
+  \brief Returns the hash of role names used by the model.
+
+  The roles are based on the \l AlertStatisticsRoles enum.
+ */
+QHash<int, QByteArray> AlertStatisticsModel::roleNames() const
+{
+  return m_roles;
+}
+
+/*!
+  \brief internal.
+
+  Calculate the statistics for the interval which has just finished and report them.
+ */
+void AlertStatisticsModel::report()
+{
+  updateRows();
+
+  if (m_loggingEnabled)
+    qInfo().noquote() << "AlertStatistics" << QJsonDocument(toJson()).toJson(QJsonDocument::Compact);
+
+  emit statisticsUpdated();
+}
+
+/*!
+  \internal
+
+  Add a row for \a condition and return its index.
+ */
+int AlertStatisticsModel::addCondition(AlertCondition* condition)
+{
+  const int row = m_conditions.size();
+
+  ConditionStatistics statistics;
+  statistics.m_condition = condition;
+  statistics.m_name = condition->name();
+  statistics.m_recentQueryNanoseconds.reserve(recentSampleCount);
+
+  beginInsertRows(QModelIndex(), row, row);
+  m_conditions.append(statistics);
+  m_rows.insert(condition, row);
+  endInsertRows();
+
+  connect(condition, &AlertCondition::conditionChanged, this, [this, condition]()
+  {
+    auto findIt = m_rows.constFind(condition);
+    if (findIt == m_rows.cend())
+      return;
+
+    const int changedRow = findIt.value();
+    m_conditions[changedRow].m_name = condition->name();
+
+    const QModelIndex changedIndex = index(changedRow, 0);
+    emit dataChanged(changedIndex, changedIndex, QVector<int>{AlertStatisticsRoles::ConditionName});
+  });
+
+  connect(condition, &AlertCondition::destroyed, this, [this, condition]()
+  {
+    removeCondition(condition);
+  });
+
+  return row;
+}
+
+/*!
+  \internal
+
+  Remove the row for \a condition.
+ */
+void AlertStatisticsModel::removeCondition(AlertCondition* condition)
+{
+  auto findIt = m_rows.find(condition);
+  if (findIt == m_rows.end())
+    return;
+
+  const int row = findIt.value();
+  m_rows.erase(findIt);
+
+  beginRemoveRows(QModelIndex(), row, row);
+  m_conditions.removeAt(row);
+  endRemoveRows();
+
+  // the rows after the removed condition have moved up
+  for (auto it = m_rows.begin(); it != m_rows.end(); ++it)
+  {
+    if (it.value() > row)
+      --it.value();
+  }
+}
+
+/*!
+  \internal
+
+  Calculate the statistics for each condition from the interval which has just finished.
+ */
+void AlertStatisticsModel::updateRows()
+{
+  const double intervalSeconds = m_intervalTimer.restart() / 1000.0;
+
+  QVector<qint64> sorted;
+  for (ConditionStatistics& statistics : m_conditions)
+  {
+    const int evaluations = statistics.m_intervalEvaluations;
+    statistics.m_evaluationsPerSecond = intervalSeconds > 0.0 ? evaluations / intervalSeconds : 0.0;
+    statistics.m_meanQueryTime = evaluations > 0 ? (statistics.m_intervalQueryNanoseconds / 1000.0) / evaluations : 0.0;
+    statistics.m_meanCandidates = evaluations > 0 ? static_cast<double>(statistics.m_intervalCandidates) / evaluations : 0.0;
+
+    // the 99th percentile is taken over the most recent queries, which may span several intervals
+    sorted = statistics.m_recentQueryNanoseconds;
+    if (!sorted.isEmpty())
+    {
+      const int percentileIndex = std::max(0, static_cast<int>(std::ceil(sorted.size() * 0.99)) - 1);
+      std::nth_element(sorted.begin(), sorted.begin() + percentileIndex, sorted.end());
+      statistics.m_p99QueryTime = sorted[percentileIndex] / 1000.0;
+    }
+
+    statistics.m_intervalEvaluations = 0;
+    statistics.m_intervalQueryNanoseconds = 0;
+    statistics.m_intervalCandidates = 0;
+  }
+
+  if (!m_conditions.isEmpty())
+    emit dataChanged(index(0, 0), index(m_conditions.size() - 1, 0));
+}
+
+} // Dsa
+
+// Signal Documentation
+/*!
+  \fn void AlertStatisticsModel::enabledChanged();
+  \brief Signal emitted when the enabled state changes.
+ */
+
+/*!
+  \fn void AlertStatisticsModel::reportIntervalChanged();
+  \brief Signal emitted when the report interval changes.
+ */
+
+/*!
+  \fn void AlertStatisticsModel::loggingEnabledChanged();
+  \brief Signal emitted when the logging enabled state changes.
+ */
+
+/*!
+  \fn void AlertStatisticsModel::statisticsUpdated();
+  \brief Signal emitted when the statistics have been updated.
+ */
@@ -0,0 +1,146 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef ALERTSTATISTICSMODEL_H
+#define ALERTSTATISTICSMODEL_H
+
+// Qt headers
+#include <QAbstractListModel>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QTimer>
+#include <QVariantMap>
+#include <QVector>
+
+namespace Dsa {
+
+class AlertCondition;
+
+class AlertStatisticsModel : public QAbstractListModel
+{
+  Q_OBJECT
+
+  Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)
+  Q_PROPERTY(int reportInterval READ reportInterval WRITE setReportInterval NOTIFY reportIntervalChanged)
+  Q_PROPERTY(bool loggingEnabled READ isLoggingEnabled WRITE setLoggingEnabled NOTIFY loggingEnabledChanged)
+  Q_PROPERTY(QVariantMap counters READ counters NOTIFY statisticsUpdated)
+
+public:
+
+  enum AlertStatisticsRoles
+  {
+    ConditionName = Qt::UserRole + 1,
+    EvaluationsPerSecond = Qt::UserRole + 2,
+    MeanQueryTime = Qt::UserRole + 3,
+    P99QueryTime = Qt::UserRole + 4,
+    MeanCandidates = Qt::UserRole + 5,
+    TotalEvaluations = Qt::UserRole + 6
+  };
+
+  enum class Cache
+  {
+    PreparedPolygon = 0,
+    Feature = 1
+  };
+
+  enum class Rebuild
+  {
+    Quadtree = 0,
+    FeatureIndex = 1
+  };
+
+  static AlertStatisticsModel* instance();
+
+  ~AlertStatisticsModel();
+
+  void recordEvaluation(AlertCondition* condition, qint64 queryNanoseconds, int candidateCount);
+  void recordCacheLookup(Cache cache, bool hit);
+  void recordRebuild(Rebuild rebuild);
+
+  bool isEnabled() const;
+  void setEnabled(bool enabled);
+
+  int reportInterval() const;
+  void setReportInterval(int reportInterval);
+
+  bool isLoggingEnabled() const;
+  void setLoggingEnabled(bool loggingEnabled);
+
+  QVariantMap counters() const;
+  QJsonObject toJson() const;
+
+  // QAbstractItemModel interface
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex& index, int role) const override;
+
+signals:
+  void enabledChanged();
+  void reportIntervalChanged();
+  void loggingEnabledChanged();
+  void statisticsUpdated();
+
+protected:
+  QHash<int, QByteArray> roleNames() const override;
+
+private slots:
+  void report();
+
+private:
+  explicit AlertStatisticsModel(QObject* parent = nullptr);
+
+  struct ConditionStatistics
+  {
+    AlertCondition* m_condition = nullptr;
+    QString m_name;
+    quint64 m_totalEvaluations = 0;
+    int m_intervalEvaluations = 0;
+    qint64 m_intervalQueryNanoseconds = 0;
+    qint64 m_intervalCandidates = 0;
+    QVector<qint64> m_recentQueryNanoseconds;
+    int m_nextSample = 0;
+    double m_evaluationsPerSecond = 0.0;
+    double m_meanQueryTime = 0.0;
+    double m_p99QueryTime = 0.0;
+    double m_meanCandidates = 0.0;
+  };
+
+  struct CacheStatistics
+  {
+    quint64 m_hits = 0;
+    quint64 m_misses = 0;
+  };
+
+  int addCondition(AlertCondition* condition);
+  void removeCondition(AlertCondition* condition);
+  void updateRows();
+
+  QHash<int, QByteArray> m_roles;
+  QList<ConditionStatistics> m_conditions;
+  QHash<AlertCondition*, int> m_rows;
+  QVector<CacheStatistics> m_caches;
+  QVector<quint64> m_rebuilds;
+  QTimer m_reportTimer;
+  QElapsedTimer m_intervalTimer;
+  int m_reportInterval;
+  bool m_enabled = false;
+  bool m_loggingEnabled = false;
+};
+
+} // Dsa
+
+#endif // ALERTSTATISTICSMODEL_H
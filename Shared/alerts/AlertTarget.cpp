@@ -20,6 +20,17 @@
 
 #include "AlertTarget.h"
 
+// dsa app headers
+#include "GeoElementUtils.h"
+#include "GeometryProjectionCache.h"
+
+// C++ API headers
+#include "Envelope.h"
+#include "GeoElement.h"
+#include "Geometry.h"
+
+using namespace Esri::ArcGISRuntime;
+
 namespace Dsa {
 
 /*!
@@ -47,6 +58,93 @@ AlertTarget::~AlertTarget()
   emit noLongerValid();
 }
 
+/*!
+  \brief Appends a \l GeoElementCandidate to \a candidates for each element of the target which
+  may be in the \a targetArea.
+
+  Returns \c false if the target is not made up of \l Esri::ArcGISRuntime::GeoElement objects,
+  in which case \l targetGeometries should be used instead. The default implementation
+  returns \c false.
+
+  The \a candidates buffer is not cleared, so callers can re-use it between queries
+  without allocating. Each candidate identifies the element, so conditions can report which
+  part of the target was matched.
+
+  \note No exact intersection tests are carried out to create this list.
+ */
+bool AlertTarget::targetCandidates(const Envelope&, QVector<GeoElementCandidate>&) const
+{
+  return false;
+}
+
+/*!
+  \brief Returns the geometry of \a geoElement, prepared for fast location tests.
+
+  The default implementation prepares the polygon on every call. Types which can track changes
+  to their elements should override this to re-use previously prepared polygons.
+
+  If the geometry of the element is not a polygon, an empty \l PreparedPolygon is returned.
+ */
+PreparedPolygon AlertTarget::targetPolygon(GeoElement* geoElement) const
+{
+  if (!geoElement)
+    return PreparedPolygon();
+
+  return PreparedPolygon(GeometryProjectionCache::instance()->wgs84Geometry(geoElement));
+}
+
+/*!
+  \brief Returns whether any call to \l targetCandidates since this was last called
+  omitted elements which are still being fetched, and clears the flag.
+
+  A query which found no match while candidates were pending has not shown that the
+  condition is not met. It should be run again when \l pendingCandidatesFetched is emitted.
+ */
+bool AlertTarget::takeCandidatesPending() const
+{
+  const bool pending = m_candidatesPending;
+  m_candidatesPending = false;
+  return pending;
+}
+
+/*!
+  \brief Records that \l targetCandidates omitted elements which are still being fetched.
+
+  Derived types should emit \l pendingCandidatesFetched once those elements are available.
+ */
+void AlertTarget::setCandidatesPending() const
+{
+  m_candidatesPending = true;
+}
+
+/*!
+  \brief Appends \a geoElement to \a candidates if its cached WGS84 extent intersects the \a wgs84Area.
+ */
+void AlertTarget::appendCandidate(GeoElement* geoElement, const Envelope& wgs84Area, QVector<GeoElementCandidate>& candidates)
+{
+  if (!geoElement)
+    return;
+
+  const Envelope extent = GeometryProjectionCache::instance()->wgs84Extent(geoElement);
+  if (extent.isEmpty())
+    return;
+
+  if (!wgs84Area.isEmpty() &&
+      (extent.xMin() > wgs84Area.xMax() || extent.xMax() < wgs84Area.xMin() ||
+       extent.yMin() > wgs84Area.yMax() || extent.yMax() < wgs84Area.yMin()))
+  {
+    return;
+  }
+
+  GeoElementCandidate candidate;
+  candidate.geoElement = geoElement;
+  candidate.xMin = extent.xMin();
+  candidate.xMax = extent.xMax();
+  candidate.yMin = extent.yMin();
+  candidate.yMax = extent.yMax();
+  candidates.append(candidate);
+}
+
 } // Dsa
 
 // Signal Documentation
@@ -60,3 +158,11 @@ AlertTarget::~AlertTarget()
   \brief Signal emitted when alert target's data changes.
  */
 
+/*!
+  \fn void AlertTarget::pendingCandidatesFetched();
+  \brief Signal emitted when elements which were reported as pending by \l takeCandidatesPending
+  have been fetched.
+
+  Only queries which had pending candidates need to be run again.
+ */
+
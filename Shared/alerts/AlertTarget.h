@@ -17,21 +17,28 @@
 #ifndef ALERTTARGET_H
 #define ALERTTARGET_H
 
+// dsa app headers
+#include "PreparedPolygon.h"
+
 // Qt headers
 #include <QObject>
 #include <QVariant>
+#include <QVector>
 
 namespace Esri
 {
 namespace ArcGISRuntime
 {
   class Envelope;
+  class GeoElement;
   class Geometry;
 }
 }
 
 namespace Dsa {
 
+struct GeoElementCandidate;
+
 class AlertTarget : public QObject
 {
   Q_OBJECT
@@ -41,11 +48,26 @@ public:
   ~AlertTarget();
 
   virtual QList<Esri::ArcGISRuntime::Geometry> targetGeometries(const Esri::ArcGISRuntime::Envelope& targetArea) const = 0;
+  virtual bool targetCandidates(const Esri::ArcGISRuntime::Envelope& targetArea, QVector<GeoElementCandidate>& candidates) const;
+  virtual PreparedPolygon targetPolygon(Esri::ArcGISRuntime::GeoElement* geoElement) const;
   virtual QVariant targetValue() const = 0;
 
+  bool takeCandidatesPending() const;
+
 signals:
   void noLongerValid();
   void dataChanged();
+  void pendingCandidatesFetched();
+
+protected:
+  void setCandidatesPending() const;
+
+  static void appendCandidate(Esri::ArcGISRuntime::GeoElement* geoElement,
+                              const Esri::ArcGISRuntime::Envelope& wgs84Area,
+                              QVector<GeoElementCandidate>& candidates);
+
+private:
+  mutable bool m_candidatesPending = false;
 };
 
 } // Dsa
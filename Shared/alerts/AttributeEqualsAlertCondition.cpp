@@ -21,7 +21,13 @@
 
 // dsa app headers
 #include "AlertConstants.h"
+#include "AlertTarget.h"
 #include "AttributeEqualsAlertConditionData.h"
+#include "GraphicsOverlayAttributeIndex.h"
+#include "GraphicsOverlaySourceStore.h"
+
+// C++ API headers
+#include "GraphicsOverlay.h"
 
 using namespace Esri::ArcGISRuntime;
 
@@ -34,6 +40,10 @@ namespace Dsa {
   \brief Represents an attribute condition which will be coninuosly monitored and will
   trigger an alert when a source object's attribute matches the target value.
 
+  When the source is a feed, the attribute is looked up in the \l GraphicsOverlayAttributeIndex
+  of the feed. The index tells the condition when a graphic gains or loses the target value, so
+  other changes to the graphics, such as their location, are not tested at all.
+
   This condition will create new \l AttributeEqualsAlertConditionData to track source and target objects.
   */
 
@@ -56,7 +66,27 @@ AttributeEqualsAlertCondition::AttributeEqualsAlertCondition(AlertLevel level,
  */
 AttributeEqualsAlertCondition::~AttributeEqualsAlertCondition()
 {
+  if (m_attributeIndex)
+    m_attributeIndex->removeCondition(this);
+}
+
+/*!
+  \brief Initializes the condition with a \a sourceFeed, \a sourceDescription, \a target
+  and \a targetDescription.
+
+  The attribute of the condition is indexed for the graphics in \a sourceFeed.
+ */
+void AttributeEqualsAlertCondition::init(GraphicsOverlay* sourceFeed, const QString& sourceDescription, AlertTarget* target, const QString& targetDescription)
+{
+  if (!sourceFeed || !target || m_attributeIndex)
+    return;
 
+  // the index must be up to date before the condition tests any graphics
+  m_attributeIndex = GraphicsOverlayAttributeIndex::forOverlay(sourceFeed);
+  if (m_attributeIndex)
+    m_attributeIndex->addCondition(this, target->targetValue());
+
+  AlertCondition::init(sourceFeed, sourceDescription, target, targetDescription);
 }
 
 /*!
@@ -67,6 +97,32 @@ AlertConditionData* AttributeEqualsAlertCondition::createData(AlertSource* sourc
   return new AttributeEqualsAlertConditionData(newConditionDataName(), level(), source, target, m_attributeName, this);
 }
 
+/*!
+  \brief Returns whether the source at \a row of \a sources has an attribute value matching the
+  value of \a target.
+
+  \a candidateCount is always set to \c 1.
+ */
+bool AttributeEqualsAlertCondition::matchesSource(const GraphicsOverlaySourceStore* sources, int row, AlertTarget* target, int& candidateCount) const
+{
+  candidateCount = 1;
+  if (!target)
+    return false;
+
+  if (m_attributeIndex)
+    return m_attributeIndex->contains(m_attributeName, target->targetValue(), sources->graphic(row));
+
+  return AttributeEqualsAlertConditionData::matchesValue(sources->value(row, m_attributeName), target->targetValue());
+}
+
+/*!
+  \brief Returns whether the attribute index reports every change to the result of this condition.
+ */
+bool AttributeEqualsAlertCondition::reportsSourceChanges() const
+{
+  return !m_attributeIndex.isNull();
+}
+
 /*!
   \brief Returns the query string component for this condition in the form "[MyAttribute] =".
  */
@@ -100,4 +156,20 @@ QString AttributeEqualsAlertCondition::attributeNameFromQueryComponents(const QV
   return queryMap.value(AlertConstants::ATTRIBUTE_NAME).toString();
 }
 
+/*!
+  \brief Returns the name of the attribute to be tested.
+ */
+QString AttributeEqualsAlertCondition::attributeName() const
+{
+  return m_attributeName;
+}
+
+/*!
+  \brief Called by the attribute index when the graphic at \a row gains or loses the target value.
+ */
+void AttributeEqualsAlertCondition::handleMembershipChanged(int row)
+{
+  emit sourceRowsChanged(QVector<int>{row});
+}
+
 } // Dsa
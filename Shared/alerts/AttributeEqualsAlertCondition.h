@@ -22,9 +22,12 @@
 
 // Qt headers
 #include <QObject>
+#include <QPointer>
 
 namespace Dsa {
 
+class GraphicsOverlayAttributeIndex;
+
 class AttributeEqualsAlertCondition : public AlertCondition
 {
   Q_OBJECT
@@ -37,15 +40,25 @@ public:
 
   ~AttributeEqualsAlertCondition();
 
+  using AlertCondition::init;
+  void init(Esri::ArcGISRuntime::GraphicsOverlay* sourceFeed, const QString& sourceDescription, AlertTarget* target, const QString& targetDescription);
+
   AlertConditionData* createData(AlertSource* source, AlertTarget* target) override;
+  bool matchesSource(const GraphicsOverlaySourceStore* sources, int row, AlertTarget* target, int& candidateCount) const override;
+  bool reportsSourceChanges() const override;
 
   QString queryString() const override;
   QVariantMap queryComponents() const override;
 
   static QString attributeNameFromQueryComponents(const QVariantMap& queryMap);
 
+  QString attributeName() const;
+
+  void handleMembershipChanged(int row);
+
 private:
   QString m_attributeName;
+  QPointer<GraphicsOverlayAttributeIndex> m_attributeIndex;
 };
 
 } // Dsa
@@ -81,11 +81,17 @@ bool AttributeEqualsAlertConditionData::matchesQuery() const
   if (!isQueryOutOfDate())
     return cachedQueryResult();
 
-  const QVariant sourceValue = source()->value(attributeName());
+  return matchesValue(source()->value(attributeName()), target()->targetValue());
+}
+
+/*!
+  \brief Returns whether \a sourceValue is valid and equal to \a targetValue.
+ */
+bool AttributeEqualsAlertConditionData::matchesValue(const QVariant& sourceValue, const QVariant& targetValue)
+{
   if (sourceValue.isNull() || !sourceValue.isValid())
     return false;
 
-  const QVariant targetValue = target()->targetValue();
   if (targetValue.isNull() || !targetValue.isValid())
     return false;
 
@@ -46,6 +46,8 @@ public:
 
   bool matchesQuery() const override;
 
+  static bool matchesValue(const QVariant& sourceValue, const QVariant& targetValue);
+
   QString attributeName() const;
 
 private:
@@ -0,0 +1,216 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "DistanceJoin.h"
+
+// dsa app headers
+#include "Geodesy.h"
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Dsa {
+
+namespace
+{
+quint64 cellKey(qint64 column, qint64 row)
+{
+  return (static_cast<quint64>(row) << 32) | static_cast<quint32>(column);
+}
+}
+
+/*!
+  \class Dsa::DistanceJoinPair
+  \inmodule Dsa
+  \brief A source and target within the distance of a \l DistanceJoin, with the distance between them in meters.
+ */
+
+/*!
+  \class Dsa::DistanceJoin
+  \inmodule Dsa
+  \brief Finds every pair of source and target locations which lie within a distance
+  of each other in a single pass.
+
+  Locations are WGS84 longitude (x) and latitude (y) in degrees. The targets are assigned to the
+  cells of a grid, with cells at least as large as the join distance, and sorted by cell. Rows of
+  cells are the height of the join distance, and the cells of each row are widened for the highest
+  latitude which a pair in that row or its neighbours can reach, so a location near a pole only
+  widens the cells near it. Each source then only visits the targets in the nearest three cells of
+  its own and the two neighbouring rows, found by binary search of the sorted cells. A join of N sources and M targets therefore takes
+  O((N + M) log M) rather than O(N x M) time.
+
+  Distances are great circle distances on a sphere of the mean radius of the earth. Cells do not
+  wrap around the antimeridian.
+ */
+
+/*!
+  \brief Constructor for an empty join.
+ */
+DistanceJoin::DistanceJoin()
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+DistanceJoin::~DistanceJoin()
+{
+}
+
+/*!
+  \brief Joins the sources at \a sourceX, \a sourceY with the targets at \a targetX, \a targetY,
+  finding all pairs within \a radius meters.
+
+  The results of any previous join are replaced.
+ */
+void DistanceJoin::join(const QVector<double>& sourceX, const QVector<double>& sourceY,
+                        const QVector<double>& targetX, const QVector<double>& targetY,
+                        double radius)
+{
+  const int sourceCount = sourceX.size();
+  const int targetCount = targetX.size();
+
+  m_pairs.clear();
+  m_matchCounts.fill(0, sourceCount);
+  m_nearestTargets.fill(-1, sourceCount);
+  m_nearestDistances.fill(std::numeric_limits<double>::infinity(), sourceCount);
+
+  if (sourceCount == 0 || targetCount == 0 || radius < 0.0)
+    return;
+
+  // cells are the height of the radius. The cells of each row are widened for the highest latitude
+  // that a pair in the row and its neighbours can reach, so that no pair can be more than one cell
+  // apart in either direction, measured in the cells of the target's row
+  const double cellHeight = std::max(radius / Geodesy::metersPerDegree, 1e-9);
+
+  auto row = [cellHeight](double y)
+  {
+    return std::max<qint64>(static_cast<qint64>(std::floor((y + 90.0) / cellHeight)), 0);
+  };
+
+  auto cellWidth = [cellHeight](qint64 cellRow)
+  {
+    const double south = -90.0 + (cellRow - 1) * cellHeight;
+    const double north = -90.0 + (cellRow + 2) * cellHeight;
+    const double widestLatitude = std::min(std::max(std::abs(south), std::abs(north)) + cellHeight, 90.0);
+    return std::min(cellHeight / std::max(std::cos(widestLatitude * Geodesy::degreesToRadians), 1e-9), 360.0);
+  };
+
+  auto column = [](double x, double width)
+  {
+    return std::max<qint64>(static_cast<qint64>(std::floor((x + 180.0) / width)), 0);
+  };
+
+  // sort the targets by cell, row by row, so each run of 3 neighbouring cells is contiguous.
+  // Targets without a valid location are left out
+  m_cellKeys.resize(targetCount);
+  m_targetOrder.clear();
+  m_targetOrder.reserve(targetCount);
+  for (int i = 0; i < targetCount; ++i)
+  {
+    if (!std::isfinite(targetX.at(i)) || !std::isfinite(targetY.at(i)))
+      continue;
+
+    const qint64 targetRow = row(targetY.at(i));
+    m_cellKeys[i] = cellKey(column(targetX.at(i), cellWidth(targetRow)), targetRow);
+    m_targetOrder.append(i);
+  }
+
+  std::sort(m_targetOrder.begin(), m_targetOrder.end(), [this](int a, int b)
+  {
+    return m_cellKeys.at(a) < m_cellKeys.at(b);
+  });
+
+  QVector<quint64> sortedKeys(m_targetOrder.size());
+  for (int i = 0; i < m_targetOrder.size(); ++i)
+    sortedKeys[i] = m_cellKeys.at(m_targetOrder.at(i));
+
+  for (int source = 0; source < sourceCount; ++source)
+  {
+    const double x = sourceX.at(source);
+    const double y = sourceY.at(source);
+    if (!std::isfinite(x) || !std::isfinite(y))
+      continue;
+    const qint64 sourceRow = row(y);
+
+    for (qint64 targetRow = std::max<qint64>(sourceRow - 1, 0); targetRow <= sourceRow + 1; ++targetRow)
+    {
+      const qint64 sourceColumn = column(x, cellWidth(targetRow));
+      const quint64 firstKey = cellKey(std::max<qint64>(sourceColumn - 1, 0), targetRow);
+      const quint64 lastKey = cellKey(sourceColumn + 1, targetRow);
+
+      auto it = std::lower_bound(sortedKeys.cbegin(), sortedKeys.cend(), firstKey);
+      for (; it != sortedKeys.cend() && *it <= lastKey; ++it)
+      {
+        const int target = m_targetOrder.at(static_cast<int>(it - sortedKeys.cbegin()));
+        const double targetDistance = Geodesy::distance(x, y, targetX.at(target), targetY.at(target));
+        if (targetDistance > radius)
+          continue;
+
+        m_pairs.append(DistanceJoinPair{source, target, targetDistance});
+        ++m_matchCounts[source];
+        if (targetDistance < m_nearestDistances.at(source))
+        {
+          m_nearestDistances[source] = targetDistance;
+          m_nearestTargets[source] = target;
+        }
+      }
+    }
+  }
+}
+
+/*!
+  \brief Returns all of the source and target pairs found by the last join.
+
+  Pairs are ordered by source.
+ */
+const QVector<DistanceJoinPair>& DistanceJoin::pairs() const
+{
+  return m_pairs;
+}
+
+/*!
+  \brief Returns the number of targets within the distance of the source at \a sourceIndex.
+ */
+int DistanceJoin::matchCount(int sourceIndex) const
+{
+  return m_matchCounts.value(sourceIndex, 0);
+}
+
+/*!
+  \brief Returns the index of the nearest target within the distance of the source at
+  \a sourceIndex, or \c -1 if there is none.
+ */
+int DistanceJoin::nearestTarget(int sourceIndex) const
+{
+  return m_nearestTargets.value(sourceIndex, -1);
+}
+
+/*!
+  \brief Returns the distance in meters to the nearest target within the distance of the
+  source at \a sourceIndex, or infinity if there is none.
+ */
+double DistanceJoin::nearestDistance(int sourceIndex) const
+{
+  return m_nearestDistances.value(sourceIndex, std::numeric_limits<double>::infinity());
+}
+
+} // Dsa
@@ -0,0 +1,61 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef DISTANCEJOIN_H
+#define DISTANCEJOIN_H
+
+// Qt headers
+#include <QVector>
+
+namespace Dsa {
+
+struct DistanceJoinPair
+{
+  int sourceIndex = -1;
+  int targetIndex = -1;
+  double distance = 0.0;
+};
+
+class DistanceJoin
+{
+public:
+  DistanceJoin();
+  ~DistanceJoin();
+
+  void join(const QVector<double>& sourceX, const QVector<double>& sourceY,
+            const QVector<double>& targetX, const QVector<double>& targetY,
+            double radius);
+
+  const QVector<DistanceJoinPair>& pairs() const;
+
+  int matchCount(int sourceIndex) const;
+  int nearestTarget(int sourceIndex) const;
+  double nearestDistance(int sourceIndex) const;
+
+private:
+  QVector<DistanceJoinPair> m_pairs;
+  QVector<int> m_matchCounts;
+  QVector<int> m_nearestTargets;
+  QVector<double> m_nearestDistances;
+
+  // buffers re-used between joins
+  QVector<quint64> m_cellKeys;
+  QVector<int> m_targetOrder;
+};
+
+} // Dsa
+
+#endif // DISTANCEJOIN_H
@@ -0,0 +1,271 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "DistanceJoinAlertTarget.h"
+
+// dsa app headers
+#include "GraphicsOverlaySourceStore.h"
+
+// C++ API headers
+#include "Envelope.h"
+#include "Graphic.h"
+
+// Qt headers
+#include <QTimer>
+
+// STL headers
+#include <algorithm>
+#include <limits>
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::DistanceJoinAlertTarget
+  \inmodule Dsa
+  \inherits AlertTarget
+  \brief Represents a target which joins every graphic of a source feed with every graphic
+  of a target feed that lies within a radius of it.
+
+  Rather than each source querying the target separately, the locations cached in the
+  \l GraphicsOverlaySourceStore of each feed are joined in a single pass by a \l DistanceJoin.
+  The join is run at most once per turn of the event loop, after either feed has changed,
+  and the \l AlertTarget::dataChanged signal is emitted when it completes.
+
+  The results of the last join can be read for each source graphic, or as the full list of
+  matching pairs.
+
+  \sa WithinDistanceJoinAlertCondition
+ */
+
+/*!
+  \brief Constructor taking the stores of the \a sources and \a targets feeds, the \a radius
+  of the join in meters and an optional \a parent.
+ */
+DistanceJoinAlertTarget::DistanceJoinAlertTarget(GraphicsOverlaySourceStore* sources,
+                                                 GraphicsOverlaySourceStore* targets,
+                                                 double radius,
+                                                 QObject* parent):
+  AlertTarget(parent),
+  m_sources(sources),
+  m_targets(targets),
+  m_radius(radius)
+{
+  for (GraphicsOverlaySourceStore* store : {m_sources, m_targets})
+  {
+    connect(store, &GraphicsOverlaySourceStore::rowsAdded, this, &DistanceJoinAlertTarget::scheduleJoin);
+    connect(store, &GraphicsOverlaySourceStore::rowsChanged, this, &DistanceJoinAlertTarget::scheduleJoin);
+    connect(store, &GraphicsOverlaySourceStore::rowAboutToBeRemoved, this, &DistanceJoinAlertTarget::scheduleJoin);
+  }
+
+  // forget removed graphics straight away, since they may be deleted before the next join
+  connect(m_sources, &GraphicsOverlaySourceStore::rowAboutToBeRemoved, this, [this](int row)
+  {
+    Graphic* graphic = m_sources->graphic(row);
+    const int index = m_sourceIndexes.take(graphic);
+    if (index >= 0 && index < m_joinedSources.size())
+      m_joinedSources[index] = nullptr;
+  });
+
+  connect(m_targets, &GraphicsOverlaySourceStore::rowAboutToBeRemoved, this, [this](int row)
+  {
+    Graphic* graphic = m_targets->graphic(row);
+    std::replace(m_joinedTargets.begin(), m_joinedTargets.end(), graphic, static_cast<Graphic*>(nullptr));
+  });
+
+  runJoin();
+}
+
+/*!
+  \brief Destructor.
+ */
+DistanceJoinAlertTarget::~DistanceJoinAlertTarget()
+{
+}
+
+/*!
+  \brief Returns the locations of the target graphics which lie within \a targetArea.
+
+  \note The join should be used in preference to this method.
+ */
+QList<Geometry> DistanceJoinAlertTarget::targetGeometries(const Envelope& targetArea) const
+{
+  QList<Geometry> geometries;
+  const int count = m_targets->size();
+  for (int row = 0; row < count; ++row)
+  {
+    const Point location = m_targets->location(row);
+    if (location.x() < targetArea.xMin() || location.x() > targetArea.xMax() ||
+        location.y() < targetArea.yMin() || location.y() > targetArea.yMax())
+    {
+      continue;
+    }
+
+    geometries.append(location);
+  }
+
+  return geometries;
+}
+
+/*!
+  \brief Not used for this target type.
+ */
+QVariant DistanceJoinAlertTarget::targetValue() const
+{
+  return QVariant();
+}
+
+/*!
+  \brief Returns the radius of the join in meters.
+ */
+double DistanceJoinAlertTarget::radius() const
+{
+  return m_radius;
+}
+
+/*!
+  \brief Sets the radius of the join to \a radius meters.
+
+  The join will be run again on the next turn of the event loop.
+ */
+void DistanceJoinAlertTarget::setRadius(double radius)
+{
+  if (radius == m_radius)
+    return;
+
+  m_radius = radius;
+  scheduleJoin();
+}
+
+/*!
+  \brief Returns the number of targets found within the radius of \a source by the last join.
+ */
+int DistanceJoinAlertTarget::matchCount(Graphic* source) const
+{
+  const int index = m_sourceIndexes.value(source, -1);
+  return index == -1 ? 0 : m_join.matchCount(index);
+}
+
+/*!
+  \brief Returns the distance in meters from \a source to the nearest target found by the last join.
+
+  Returns infinity if there was no target within the radius.
+ */
+double DistanceJoinAlertTarget::nearestDistance(Graphic* source) const
+{
+  const int index = m_sourceIndexes.value(source, -1);
+  return index == -1 ? std::numeric_limits<double>::infinity() : m_join.nearestDistance(index);
+}
+
+/*!
+  \brief Returns the nearest target to \a source found by the last join, or \c nullptr.
+ */
+Graphic* DistanceJoinAlertTarget::nearestTarget(Graphic* source) const
+{
+  const int index = m_sourceIndexes.value(source, -1);
+  return index == -1 ? nullptr : joinedTarget(m_join.nearestTarget(index));
+}
+
+/*!
+  \brief Returns all of the source and target pairs found by the last join.
+
+  The indexes of each pair can be converted to graphics with \l joinedSource and \l joinedTarget.
+ */
+const QVector<DistanceJoinPair>& DistanceJoinAlertTarget::pairs() const
+{
+  return m_join.pairs();
+}
+
+/*!
+  \brief Returns the source graphic at \a sourceIndex of the last join.
+
+  Returns \c nullptr if the graphic has since been removed.
+ */
+Graphic* DistanceJoinAlertTarget::joinedSource(int sourceIndex) const
+{
+  return m_joinedSources.value(sourceIndex, nullptr);
+}
+
+/*!
+  \brief Returns the target graphic at \a targetIndex of the last join.
+
+  Returns \c nullptr if the graphic has since been removed.
+ */
+Graphic* DistanceJoinAlertTarget::joinedTarget(int targetIndex) const
+{
+  return m_joinedTargets.value(targetIndex, nullptr);
+}
+
+/*!
+  \internal
+
+  Run the join on the next turn of the event loop, if it is not already scheduled.
+ */
+void DistanceJoinAlertTarget::scheduleJoin()
+{
+  if (m_joinScheduled)
+    return;
+
+  m_joinScheduled = true;
+  QTimer::singleShot(0, this, &DistanceJoinAlertTarget::runJoin);
+}
+
+/*!
+  \internal
+
+  Join the current locations of the source and target graphics and report the new results.
+ */
+void DistanceJoinAlertTarget::runJoin()
+{
+  m_joinScheduled = false;
+
+  const int sourceCount = m_sources->size();
+  m_sourceX.resize(sourceCount);
+  m_sourceY.resize(sourceCount);
+  m_joinedSources.resize(sourceCount);
+  m_sourceIndexes.clear();
+  m_sourceIndexes.reserve(sourceCount);
+  for (int row = 0; row < sourceCount; ++row)
+  {
+    const Point location = m_sources->location(row);
+    m_sourceX[row] = location.x();
+    m_sourceY[row] = location.y();
+    m_joinedSources[row] = m_sources->graphic(row);
+    m_sourceIndexes.insert(m_joinedSources.at(row), row);
+  }
+
+  const int targetCount = m_targets->size();
+  m_targetX.resize(targetCount);
+  m_targetY.resize(targetCount);
+  m_joinedTargets.resize(targetCount);
+  for (int row = 0; row < targetCount; ++row)
+  {
+    const Point location = m_targets->location(row);
+    m_targetX[row] = location.x();
+    m_targetY[row] = location.y();
+    m_joinedTargets[row] = m_targets->graphic(row);
+  }
+
+  m_join.join(m_sourceX, m_sourceY, m_targetX, m_targetY, m_radius);
+
+  emit dataChanged();
+}
+
+} // Dsa
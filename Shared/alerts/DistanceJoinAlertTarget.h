@@ -0,0 +1,91 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef DISTANCEJOINALERTTARGET_H
+#define DISTANCEJOINALERTTARGET_H
+
+// dsa app headers
+#include "AlertTarget.h"
+#include "DistanceJoin.h"
+
+// Qt headers
+#include <QHash>
+#include <QVector>
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class Graphic;
+}
+}
+
+namespace Dsa {
+
+class GraphicsOverlaySourceStore;
+
+class DistanceJoinAlertTarget : public AlertTarget
+{
+  Q_OBJECT
+
+public:
+  DistanceJoinAlertTarget(GraphicsOverlaySourceStore* sources,
+                          GraphicsOverlaySourceStore* targets,
+                          double radius,
+                          QObject* parent = nullptr);
+  ~DistanceJoinAlertTarget();
+
+  QList<Esri::ArcGISRuntime::Geometry> targetGeometries(const Esri::ArcGISRuntime::Envelope& targetArea) const override;
+  QVariant targetValue() const override;
+
+  double radius() const;
+  void setRadius(double radius);
+
+  int matchCount(Esri::ArcGISRuntime::Graphic* source) const;
+  double nearestDistance(Esri::ArcGISRuntime::Graphic* source) const;
+  Esri::ArcGISRuntime::Graphic* nearestTarget(Esri::ArcGISRuntime::Graphic* source) const;
+
+  const QVector<DistanceJoinPair>& pairs() const;
+  Esri::ArcGISRuntime::Graphic* joinedSource(int sourceIndex) const;
+  Esri::ArcGISRuntime::Graphic* joinedTarget(int targetIndex) const;
+
+private slots:
+  void runJoin();
+
+private:
+  void scheduleJoin();
+
+  GraphicsOverlaySourceStore* m_sources = nullptr;
+  GraphicsOverlaySourceStore* m_targets = nullptr;
+  double m_radius = 0.0;
+  bool m_joinScheduled = false;
+  DistanceJoin m_join;
+
+  // the graphics at each index of the last join
+  QVector<Esri::ArcGISRuntime::Graphic*> m_joinedSources;
+  QVector<Esri::ArcGISRuntime::Graphic*> m_joinedTargets;
+  QHash<Esri::ArcGISRuntime::Graphic*, int> m_sourceIndexes;
+
+  // location buffers re-used between joins
+  QVector<double> m_sourceX;
+  QVector<double> m_sourceY;
+  QVector<double> m_targetX;
+  QVector<double> m_targetY;
+};
+
+} // Dsa
+
+#endif // DISTANCEJOINALERTTARGET_H
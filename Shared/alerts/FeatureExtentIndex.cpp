@@ -0,0 +1,356 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "FeatureExtentIndex.h"
+
+// Qt headers
+#include <QPair>
+#include <QVarLengthArray>
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Dsa {
+
+namespace
+{
+// the number of children grouped beneath each node of the index
+constexpr int nodeSize = 16;
+}
+
+/*!
+  \class Dsa::FeatureExtentIndex
+  \inmodule Dsa
+  \brief A compact, read-mostly spatial index of feature ids and their WGS84 extents.
+
+  The index holds only the id and a single precision bounding box (rounded outwards) for
+  each feature, so it can cover very large feature tables without keeping the features
+  or their geometry in memory.
+
+  Entries are added with \l append and the index is packed with \l build using
+  sort-tile-recursive ordering: leaves hold runs of neighbouring entries and each
+  level above stores the bounding box of \c 16 nodes of the level below.
+
+  Once built, entries cannot be added or removed but their extent can be changed with
+  \l updateExtent.
+ */
+
+/*!
+  \brief Constructor for an empty index.
+ */
+FeatureExtentIndex::FeatureExtentIndex()
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+FeatureExtentIndex::~FeatureExtentIndex()
+{
+}
+
+/*!
+  \brief Removes all entries from the index.
+ */
+void FeatureExtentIndex::clear()
+{
+  m_ids.clear();
+  m_boxes.clear();
+  m_levelOffsets.clear();
+  m_entriesById.clear();
+  m_built = false;
+}
+
+/*!
+  \brief Reserves space for \a size entries.
+ */
+void FeatureExtentIndex::reserve(int size)
+{
+  m_ids.reserve(size);
+  m_boxes.reserve(size + (size / (nodeSize - 1)) + 1);
+}
+
+/*!
+  \brief Adds an entry for the feature \a id with the WGS84 extent \a xMin, \a xMax, \a yMin, \a yMax.
+
+  Entries added after \l build are ignored.
+ */
+void FeatureExtentIndex::append(qint64 id, double xMin, double xMax, double yMin, double yMax)
+{
+  if (m_built)
+    return;
+
+  m_ids.append(id);
+  m_boxes.append(outwardBox(xMin, xMax, yMin, yMax));
+}
+
+/*!
+  \brief Packs the entries added with \l append into the index.
+ */
+void FeatureExtentIndex::build()
+{
+  if (m_built)
+    return;
+
+  m_built = true;
+  const int count = m_ids.size();
+  if (count == 0)
+    return;
+
+  // sort the entries into vertical slices by x center and each slice by y center
+  QVector<int> order(count);
+  for (int i = 0; i < count; ++i)
+    order[i] = i;
+
+  auto centerX = [this](int i) { return m_boxes[i].m_xMin + m_boxes[i].m_xMax; };
+  auto centerY = [this](int i) { return m_boxes[i].m_yMin + m_boxes[i].m_yMax; };
+
+  std::sort(order.begin(), order.end(), [&centerX](int a, int b) { return centerX(a) < centerX(b); });
+
+  const int leafCount = (count + nodeSize - 1) / nodeSize;
+  const int sliceCount = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(leafCount))));
+  const int sliceSize = sliceCount * nodeSize;
+  for (int start = 0; start < count; start += sliceSize)
+  {
+    const int end = std::min(start + sliceSize, count);
+    std::sort(order.begin() + start, order.begin() + end, [&centerY](int a, int b) { return centerY(a) < centerY(b); });
+  }
+
+  // store the entries in the packed order
+  QVector<qint64> ids(count);
+  QVector<Box> boxes;
+  boxes.reserve(count + (count / (nodeSize - 1)) + 1);
+  for (int i = 0; i < count; ++i)
+  {
+    ids[i] = m_ids[order[i]];
+    boxes.append(m_boxes[order[i]]);
+  }
+
+  m_ids = ids;
+  m_boxes = boxes;
+
+  // build each level from the bounding boxes of the level beneath, until a single root remains
+  m_levelOffsets.append(0);
+  int levelStart = 0;
+  int levelCount = count;
+  while (levelCount > 1)
+  {
+    const int parentStart = m_boxes.size();
+    for (int i = 0; i < levelCount; i += nodeSize)
+    {
+      Box box = m_boxes[levelStart + i];
+      const int end = std::min(i + nodeSize, levelCount);
+      for (int j = i + 1; j < end; ++j)
+        expand(box, m_boxes[levelStart + j]);
+
+      m_boxes.append(box);
+    }
+
+    m_levelOffsets.append(parentStart);
+    levelStart = parentStart;
+    levelCount = m_boxes.size() - parentStart;
+  }
+
+  // sort the entries by id so that they can be found for updates
+  m_entriesById.resize(count);
+  for (int i = 0; i < count; ++i)
+    m_entriesById[i] = i;
+
+  std::sort(m_entriesById.begin(), m_entriesById.end(), [this](int a, int b) { return m_ids[a] < m_ids[b]; });
+}
+
+/*!
+  \brief Returns whether the index contains no entries.
+ */
+bool FeatureExtentIndex::isEmpty() const
+{
+  return m_ids.isEmpty();
+}
+
+/*!
+  \brief Returns the number of entries in the index.
+ */
+int FeatureExtentIndex::size() const
+{
+  return m_ids.size();
+}
+
+/*!
+  \brief Appends to \a entries the index of each entry whose extent intersects \a xMin, \a xMax, \a yMin, \a yMax.
+
+  The \a entries buffer is not cleared. Use \l id and the extent accessors to read the entries.
+
+  Returns no entries until the index has been built.
+ */
+void FeatureExtentIndex::intersectingEntries(double xMin, double xMax, double yMin, double yMax, QVector<int>& entries) const
+{
+  if (!m_built || m_ids.isEmpty())
+    return;
+
+  // each stack item is the level and index of a node within that level
+  QVarLengthArray<QPair<int, int>, 64> stack;
+  const int rootLevel = m_levelOffsets.size() - 1;
+  stack.append(qMakePair(rootLevel, 0));
+
+  while (!stack.isEmpty())
+  {
+    const QPair<int, int> item = stack.takeLast();
+    const int level = item.first;
+    const int index = item.second;
+    if (!intersects(m_boxes[m_levelOffsets[level] + index], xMin, xMax, yMin, yMax))
+      continue;
+
+    if (level == 0)
+    {
+      entries.append(index);
+      continue;
+    }
+
+    // visit the children of this node in the level beneath
+    const int childLevel = level - 1;
+    const int childCount = m_levelOffsets[level] - m_levelOffsets[childLevel];
+    const int childEnd = std::min((index + 1) * nodeSize, childCount);
+    for (int child = index * nodeSize; child < childEnd; ++child)
+      stack.append(qMakePair(childLevel, child));
+  }
+}
+
+/*!
+  \brief Sets the extent of the entry for feature \a id to \a xMin, \a xMax, \a yMin, \a yMax.
+
+  The nodes above the entry are grown to contain the new extent, so queries remain
+  correct although they may visit more nodes than a freshly built index would.
+
+  Returns \c false if there is no entry for \a id.
+ */
+bool FeatureExtentIndex::updateExtent(qint64 id, double xMin, double xMax, double yMin, double yMax)
+{
+  const int entry = entryIndex(id);
+  if (entry == -1)
+    return false;
+
+  const Box box = outwardBox(xMin, xMax, yMin, yMax);
+  m_boxes[entry] = box;
+
+  int index = entry;
+  for (int level = 1; level < m_levelOffsets.size(); ++level)
+  {
+    index /= nodeSize;
+    expand(m_boxes[m_levelOffsets[level] + index], box);
+  }
+
+  return true;
+}
+
+/*!
+  \brief Returns the feature id of \a entry.
+ */
+qint64 FeatureExtentIndex::id(int entry) const
+{
+  return m_ids.at(entry);
+}
+
+/*!
+  \brief Returns the minimum x of the extent of \a entry.
+ */
+double FeatureExtentIndex::xMin(int entry) const
+{
+  return m_boxes.at(entry).m_xMin;
+}
+
+/*!
+  \brief Returns the maximum x of the extent of \a entry.
+ */
+double FeatureExtentIndex::xMax(int entry) const
+{
+  return m_boxes.at(entry).m_xMax;
+}
+
+/*!
+  \brief Returns the minimum y of the extent of \a entry.
+ */
+double FeatureExtentIndex::yMin(int entry) const
+{
+  return m_boxes.at(entry).m_yMin;
+}
+
+/*!
+  \brief Returns the maximum y of the extent of \a entry.
+ */
+double FeatureExtentIndex::yMax(int entry) const
+{
+  return m_boxes.at(entry).m_yMax;
+}
+
+/*!
+  \internal
+
+  Returns a single precision box which contains the extent \a xMin, \a xMax, \a yMin, \a yMax.
+ */
+FeatureExtentIndex::Box FeatureExtentIndex::outwardBox(double xMin, double xMax, double yMin, double yMax)
+{
+  Box box;
+  box.m_xMin = std::nextafter(static_cast<float>(xMin), -std::numeric_limits<float>::infinity());
+  box.m_xMax = std::nextafter(static_cast<float>(xMax), std::numeric_limits<float>::infinity());
+  box.m_yMin = std::nextafter(static_cast<float>(yMin), -std::numeric_limits<float>::infinity());
+  box.m_yMax = std::nextafter(static_cast<float>(yMax), std::numeric_limits<float>::infinity());
+  return box;
+}
+
+/*!
+  \internal
+ */
+bool FeatureExtentIndex::intersects(const Box& box, double xMin, double xMax, double yMin, double yMax)
+{
+  return box.m_xMin <= xMax && box.m_xMax >= xMin &&
+         box.m_yMin <= yMax && box.m_yMax >= yMin;
+}
+
+/*!
+  \internal
+ */
+void FeatureExtentIndex::expand(Box& box, const Box& other)
+{
+  box.m_xMin = std::min(box.m_xMin, other.m_xMin);
+  box.m_xMax = std::max(box.m_xMax, other.m_xMax);
+  box.m_yMin = std::min(box.m_yMin, other.m_yMin);
+  box.m_yMax = std::max(box.m_yMax, other.m_yMax);
+}
+
+/*!
+  \internal
+
+  Returns the entry for the feature \a id, or \c -1 if there is none.
+ */
+int FeatureExtentIndex::entryIndex(qint64 id) const
+{
+  auto it = std::lower_bound(m_entriesById.cbegin(), m_entriesById.cend(), id, [this](int entry, qint64 value)
+  {
+    return m_ids[entry] < value;
+  });
+
+  if (it == m_entriesById.cend() || m_ids[*it] != id)
+    return -1;
+
+  return *it;
+}
+
+} // Dsa
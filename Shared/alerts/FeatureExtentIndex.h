@@ -0,0 +1,71 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef FEATUREEXTENTINDEX_H
+#define FEATUREEXTENTINDEX_H
+
+// Qt headers
+#include <QVector>
+
+namespace Dsa {
+
+class FeatureExtentIndex
+{
+public:
+  FeatureExtentIndex();
+  ~FeatureExtentIndex();
+
+  void clear();
+  void reserve(int size);
+  void append(qint64 id, double xMin, double xMax, double yMin, double yMax);
+  void build();
+
+  bool isEmpty() const;
+  int size() const;
+
+  void intersectingEntries(double xMin, double xMax, double yMin, double yMax, QVector<int>& entries) const;
+  bool updateExtent(qint64 id, double xMin, double xMax, double yMin, double yMax);
+
+  qint64 id(int entry) const;
+  double xMin(int entry) const;
+  double xMax(int entry) const;
+  double yMin(int entry) const;
+  double yMax(int entry) const;
+
+private:
+  struct Box
+  {
+    float m_xMin = 0.0f;
+    float m_xMax = 0.0f;
+    float m_yMin = 0.0f;
+    float m_yMax = 0.0f;
+  };
+
+  static Box outwardBox(double xMin, double xMax, double yMin, double yMax);
+  static bool intersects(const Box& box, double xMin, double xMax, double yMin, double yMax);
+  static void expand(Box& box, const Box& other);
+  int entryIndex(qint64 id) const;
+
+  QVector<qint64> m_ids;
+  QVector<Box> m_boxes;
+  QVector<int> m_levelOffsets;
+  QVector<int> m_entriesById;
+  bool m_built = false;
+};
+
+} // Dsa
+
+#endif // FEATUREEXTENTINDEX_H
@@ -20,16 +20,47 @@
 #include "FeatureLayerAlertTarget.h"
 
 // dsa app headers
+#include "AlertStatisticsModel.h"
 #include "FeatureQueryResultManager.h"
-#include "GeometryQuadtree.h"
+#include "GeoElementUtils.h"
+#include "GeometryProjectionCache.h"
+#include "PreparedPolygonCache.h"
 
 // C++ API headers
+#include "ArcGISFeatureTable.h"
+#include "AttributeListModel.h"
+#include "Envelope.h"
+#include "Feature.h"
 #include "FeatureLayer.h"
+#include "FeatureQueryResult.h"
+#include "SpatialReference.h"
+
+// Qt headers
+#include <QTimer>
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 using namespace Esri::ArcGISRuntime;
 
 namespace Dsa {
 
+namespace
+{
+// the default number of features whose geometry is held in memory
+constexpr int defaultMaximumCachedFeatures = 2048;
+
+// the maximum number of object ids requested by a single query
+constexpr int maximumFetchSize = 500;
+
+// the size in degrees of the WGS84 tiles in which features are indexed
+constexpr double tileSize = 0.5;
+constexpr int tileColumns = 720;
+constexpr int tileRows = 360;
+}
+
 /*!
   \class Dsa::FeatureLayerAlertTarget
   \inmodule Dsa
@@ -37,28 +68,69 @@ namespace Dsa {
   \brief Represents a target based on an \l Esri::ArcGISRuntime::FeatureLayer
   for an \l AlertCondition.
 
-  Changes to any of the features in the layer will cause the \l AlertTarget::locationChanged
-  signal to be emitted.
+  The layer is not read when the target is created. Instead, the first time a condition
+  asks for the features in an area, each WGS84 tile of \c 0.5 degrees covering the area
+  is queried spatially and a compact \l FeatureExtentIndex of the object ids and extents
+  of its features is built. The indexes of tiles which have been queried are kept.
+
+  The geometry of the features in the index is fetched on demand with an object id
+  query and held in a bounded, least recently used cache. Features which have not been
+  fetched yet are not reported as candidates; instead the query is recorded as pending
+  (see \l AlertTarget::takeCandidatesPending) and the
+  \l AlertTarget::pendingCandidatesFetched signal is emitted once they arrive.
+  The features received by a fetch are held outside the cache until the pending queries
+  have been tested again, so that they cannot release each other before they are used.
+
+  A single query never asks for more features than the cache can hold, so a query
+  covering more features than \l maximumCachedFeatures reports the ones which fit
+  rather than repeatedly fetching features which release each other from the cache.
+
+  Changes to the geometry of any of the cached features will cause the
+  \l AlertTarget::dataChanged signal to be emitted.
   */
 
 /*!
   \brief Constructor taking an \l Esri::ArcGISRuntime::FeatureLayer (\a featureLayer).
 
-  All features will be retrieved from the underlying feature layer.
+  No features are read until a condition is tested against the target.
  */
 FeatureLayerAlertTarget::FeatureLayerAlertTarget(FeatureLayer* featureLayer):
   AlertTarget(featureLayer),
-  m_FeatureLayer(featureLayer)
+  m_FeatureLayer(featureLayer),
+  m_polygonCache(new PreparedPolygonCache(this)),
+  m_featureCache(defaultMaximumCachedFeatures)
 {
   // assume no editing of feature table
 
   FeatureTable* table = m_FeatureLayer->featureTable();
-  QueryParameters allFeaturesQuery;
-  allFeaturesQuery.setWhereClause("1=1");
-  allFeaturesQuery.setReturnGeometry(true);
+  m_objectIdField = objectIdFieldName();
 
   connect(table, &FeatureTable::queryFeaturesCompleted, this, &FeatureLayerAlertTarget::handleQueryFeaturesCompleted);
-  table->queryFeatures(allFeaturesQuery);
+
+  // if a query fails, allow the features and tiles it requested to be requested again. The
+  // error does not identify the query, so every task which has finished is released
+  connect(table, &FeatureTable::errorOccurred, this, [this](Error)
+  {
+    for (auto it = m_fetchTasks.begin(); it != m_fetchTasks.end();)
+    {
+      if (it.value().m_task.isDone())
+        it = completeFetchTask(it, nullptr);
+      else
+        ++it;
+    }
+
+    for (auto it = m_tileTasks.begin(); it != m_tileTasks.end();)
+    {
+      if (!it.value().m_task.isDone())
+      {
+        ++it;
+        continue;
+      }
+
+      m_loadingTiles.remove(it.value().m_tile);
+      it = m_tileTasks.erase(it);
+    }
+  });
 }
 
 /*!
@@ -66,37 +138,116 @@ FeatureLayerAlertTarget::FeatureLayerAlertTarget(FeatureLayer* featureLayer):
  */
 FeatureLayerAlertTarget::~FeatureLayerAlertTarget()
 {
-
+  qDeleteAll(m_pinnedFeatures);
 }
 
 /*!
   \brief Returns the list of \l Esri::ArcGISRuntime::Geometry which are in the \a targetArea.
 
+  The geometry is returned in WGS84. Only the geometry of features which have already
+  been fetched is returned.
+
   \note No exact intersection tests are carried out to create this list.
  */
 QList<Geometry> FeatureLayerAlertTarget::targetGeometries(const Envelope& targetArea) const
 {
-  // if the quad-tree has been built use it to determine the candidate geometry
-  if (m_quadtree)
-    return m_quadtree->candidateIntersections(targetArea);
+  QVector<GeoElementCandidate> candidates;
+  targetCandidates(targetArea, candidates);
+
+  QList<Geometry> geometries;
+  geometries.reserve(candidates.size());
+  for (const GeoElementCandidate& candidate : candidates)
+    geometries.append(GeometryProjectionCache::instance()->wgs84Geometry(candidate.geoElement));
+
+  return geometries;
+}
+
+/*!
+  \brief Appends the features which may be in the \a targetArea to \a candidates.
+
+  The id of each candidate is the object id of the feature. Tiles of the area which
+  have not been indexed yet and features whose geometry has not been fetched yet are
+  requested and omitted from the results, and the candidates are recorded as pending.
+  No more features are requested than the cache can hold along with those already found.
+
+  Returns \c true.
+
+  \note No exact intersection tests are carried out to create this list.
+ */
+bool FeatureLayerAlertTarget::targetCandidates(const Envelope& targetArea, QVector<GeoElementCandidate>& candidates) const
+{
+  // ensure the area is in WGS84
+  const Envelope wgs84Area = GeometryProjectionCache::projectToWgs84(targetArea);
+  if (wgs84Area.isEmpty())
+    return true;
+
+  // features which cross tiles are in the index of each tile, but are reported once
+  m_candidateIds.clear();
 
-  // if there is no quad-tree just return the cache of geoemtry
-  if (!m_geomCache.isEmpty())
-    return m_geomCache;
+  // the features of this query which are cached or requested must all fit in the cache,
+  // otherwise fetching the last of them would release the first
+  int capacity = m_featureCache.maxCost();
 
-  // if there is no cached geometry, get the geometry for all features
-  auto it = m_features.begin();
-  auto itEnd = m_features.end();
-  for (; it != itEnd; ++it)
+  const QList<qint64> areaTiles = tiles(wgs84Area.xMin(), wgs84Area.xMax(), wgs84Area.yMin(), wgs84Area.yMax());
+  for (const qint64 tile : areaTiles)
   {
-    Feature* feat = *it;
-    if (!feat)
+    auto tileIt = m_tileIndexes.constFind(tile);
+    if (tileIt == m_tileIndexes.constEnd())
+    {
+      requestTile(tile);
+      setCandidatesPending();
       continue;
+    }
+
+    const FeatureExtentIndex& index = tileIt.value();
+    m_entries.clear();
+    index.intersectingEntries(wgs84Area.xMin(), wgs84Area.xMax(), wgs84Area.yMin(), wgs84Area.yMax(), m_entries);
+
+    for (const int entry : qAsConst(m_entries))
+    {
+      const qint64 id = index.id(entry);
+      if (m_candidateIds.contains(id))
+        continue;
+
+      m_candidateIds.insert(id);
+      CachedFeature* cached = cachedFeature(id);
+      AlertStatisticsModel::instance()->recordCacheLookup(AlertStatisticsModel::Cache::Feature, cached != nullptr);
+      if (!cached)
+      {
+        if (capacity > 0)
+        {
+          if (requestFeature(id))
+            setCandidatesPending();
 
-    m_geomCache.append(feat->geometry());
+          --capacity;
+        }
+        continue;
+      }
+
+      --capacity;
+
+      GeoElementCandidate candidate;
+      candidate.geoElement = cached->m_feature;
+      candidate.id = id;
+      candidate.xMin = index.xMin(entry);
+      candidate.xMax = index.xMax(entry);
+      candidate.yMin = index.yMin(entry);
+      candidate.yMax = index.yMax(entry);
+      candidates.append(candidate);
+    }
   }
 
-  return m_geomCache;
+  return true;
+}
+
+/*!
+  \brief Returns the prepared polygon of the feature \a geoElement.
+
+  Polygons are only prepared again when the geometry of the feature changes.
+ */
+PreparedPolygon FeatureLayerAlertTarget::targetPolygon(GeoElement* geoElement) const
+{
+  return m_polygonCache->polygon(geoElement);
 }
 
 /*!
@@ -107,64 +258,465 @@ QVariant FeatureLayerAlertTarget::targetValue() const
   return QVariant();
 }
 
+/*!
+  \brief Returns the maximum number of features whose geometry is held in memory.
+
+  The default is \c 2048.
+ */
+int FeatureLayerAlertTarget::maximumCachedFeatures() const
+{
+  return m_featureCache.maxCost();
+}
+
+/*!
+  \brief Sets the maximum number of features whose geometry is held in memory to \a maximumCachedFeatures.
+
+  When the limit is reached, the least recently used features are released.
+  The limit should be larger than the number of features which are near the
+  sources of the conditions at any one time.
+ */
+void FeatureLayerAlertTarget::setMaximumCachedFeatures(int maximumCachedFeatures)
+{
+  m_featureCache.setMaxCost(maximumCachedFeatures);
+}
+
 /*!
   \brief internal.
 
-  Handle the query to obtain all of the features in the layer.
+  Handle the queries to index the tiles of the layer and to fetch requested features.
  */
-void FeatureLayerAlertTarget::handleQueryFeaturesCompleted(QUuid, FeatureQueryResult* queryResults)
+void FeatureLayerAlertTarget::handleQueryFeaturesCompleted(QUuid taskId, FeatureQueryResult* queryResults)
 {
-  // Store the results in a RAII manager to ensure they are cleaned up
+  // a query used to index a tile
+  auto tileIt = m_tileTasks.find(taskId);
+  if (tileIt != m_tileTasks.end())
+  {
+    const qint64 tile = tileIt.value().m_tile;
+    m_tileTasks.erase(tileIt);
+
+    // Store the results in a RAII manager to ensure they are cleaned up
+    FeatureQueryResultManager results(queryResults);
+    loadTile(tile, results.m_results);
+    return;
+  }
+
+  // ignore queries made by other objects for this table
+  auto findIt = m_fetchTasks.find(taskId);
+  if (findIt == m_fetchTasks.end())
+    return;
+
   FeatureQueryResultManager results(queryResults);
-  if (!results.m_results)
+  completeFetchTask(findIt, results.m_results);
+}
+
+/*!
+  \brief internal.
+
+  Query the tiles and the geometry of the features requested since the last fetch. Tiles
+  are queried spatially and features in batches of object ids.
+
+  Features beyond those which the cache can hold, along with the features already being
+  fetched, are not queried; they will be requested again by a later query if still needed.
+ */
+void FeatureLayerAlertTarget::fetchRequestedFeatures()
+{
+  m_fetchScheduled = false;
+  if (m_requestedIds.isEmpty() && m_requestedTiles.isEmpty())
+    return;
+
+  FeatureTable* table = m_FeatureLayer->featureTable();
+  if (!table)
+    return;
+
+  for (const qint64 tile : qAsConst(m_requestedTiles))
   {
-    emit dataChanged();
+    QueryParameters tileQuery;
+    tileQuery.setGeometry(tileExtent(tile));
+    tileQuery.setSpatialRelationship(SpatialRelationship::Intersects);
+    tileQuery.setReturnGeometry(true);
+
+    TileTask tileTask;
+    tileTask.m_task = table->queryFeatures(tileQuery);
+    tileTask.m_tile = tile;
+    m_tileTasks.insert(tileTask.m_task.taskId(), tileTask);
+    m_loadingTiles.insert(tile);
+  }
+
+  m_requestedTiles.clear();
+  if (m_requestedIds.isEmpty())
     return;
+
+  const int fetchId = m_nextFetch++;
+  Fetch& fetch = m_fetches[fetchId];
+
+  QList<qint64> batch;
+  auto submitBatch = [this, table, fetchId, &fetch, &batch]()
+  {
+    QueryParameters fetchQuery;
+    fetchQuery.setObjectIds(batch);
+    fetchQuery.setReturnGeometry(true);
+
+    FetchTask fetchTask;
+    fetchTask.m_task = table->queryFeatures(fetchQuery);
+    fetchTask.m_ids = batch;
+    fetchTask.m_fetch = fetchId;
+    m_fetchTasks.insert(fetchTask.m_task.taskId(), fetchTask);
+    ++fetch.m_outstandingBatches;
+    batch.clear();
+  };
+
+  int capacity = m_featureCache.maxCost() - m_fetchingIds.size();
+  for (const qint64 id : qAsConst(m_requestedIds))
+  {
+    if (capacity-- <= 0)
+      break;
+
+    m_fetchingIds.insert(id);
+    batch.append(id);
+    if (batch.size() == maximumFetchSize)
+      submitBatch();
   }
 
-  // cache all of the features
-  m_geomCache.clear();
-  m_features = results.m_results->iterator().features(this);
-  auto it = m_features.begin();
-  auto itEnd = m_features.end();
-  for (; it != itEnd; ++it)
+  if (!batch.isEmpty())
+    submitBatch();
+
+  m_requestedIds.clear();
+  if (fetch.m_outstandingBatches == 0)
+    m_fetches.remove(fetchId);
+}
+
+/*!
+  \internal
+
+  Build the index of \a tile from the features in \a featureQueryResult, which failed
+  if it is \c nullptr, and emit \l AlertTarget::pendingCandidatesFetched.
+
+  The geometry of as many of the features as the cache can hold is kept. If the table
+  has no object id field, features cannot be fetched again and so all are kept.
+ */
+void FeatureLayerAlertTarget::loadTile(qint64 tile, FeatureQueryResult* featureQueryResult)
+{
+  m_loadingTiles.remove(tile);
+  if (!featureQueryResult)
+    return;
+
+  FeatureExtentIndex& index = m_tileIndexes[tile];
+  index.clear();
+
+  QList<qint64> pinnedIds;
+  const int maximumPinned = m_objectIdField.isEmpty() ? std::numeric_limits<int>::max() : m_featureCache.maxCost();
+  pinFeatures(featureQueryResult, maximumPinned, pinnedIds, &index);
+
+  index.build();
+  AlertStatisticsModel::instance()->recordRebuild(AlertStatisticsModel::Rebuild::FeatureIndex);
+
+  emit pendingCandidatesFetched();
+  releasePinnedFeatures(pinnedIds);
+}
+
+/*!
+  \internal
+
+  Hold up to \a maximumPinned of the features in \a featureQueryResult outside the cache,
+  appending their ids to \a pinnedIds, and delete the others. The id and WGS84 extent of
+  every feature is added to \a index, if it is not \c nullptr.
+
+  Features which are already held are not replaced.
+ */
+void FeatureLayerAlertTarget::pinFeatures(FeatureQueryResult* featureQueryResult, int maximumPinned,
+                                          QList<qint64>& pinnedIds, FeatureExtentIndex* index)
+{
+  const bool keepFeatures = m_objectIdField.isEmpty();
+
+  FeatureIterator& iterator = featureQueryResult->iterator();
+  while (iterator.hasNext())
   {
-    Feature* feature = *it;
+    Feature* feature = iterator.next(this);
     if (!feature)
       continue;
 
-    // for each feature, connect to the geometryChanged signal
-    connect(feature, &Feature::geometryChanged, this, [this]()
+    const qint64 id = keepFeatures ? m_nextFeatureId++ : featureId(feature);
+    if (index)
+    {
+      const Envelope extent = GeometryProjectionCache::projectToWgs84(feature->geometry().extent()).extent();
+      if (!extent.isEmpty())
+        index->append(id, extent.xMin(), extent.xMax(), extent.yMin(), extent.yMax());
+    }
+
+    if (pinnedIds.size() >= maximumPinned || m_pinnedFeatures.contains(id) || m_featureCache.contains(id))
+    {
+      delete feature;
+      continue;
+    }
+
+    // keep the index up to date if the geometry of the feature is changed
+    GeoElementSignaler* signaler = GeometryProjectionCache::instance()->signaler(feature);
+    connect(signaler, &GeoElementSignaler::geometryChanged, this, [this, feature, id]()
     {
-      m_geomCache.clear();
-      rebuildQuadtree();
-      emit dataChanged();
+      updateFeatureExtent(feature, id);
     });
+
+    m_pinnedFeatures.insert(id, new CachedFeature(feature));
+    pinnedIds.append(id);
+  }
+}
+
+/*!
+  \internal
+
+  Move the features \a pinnedIds into the cache, where they may be released.
+ */
+void FeatureLayerAlertTarget::releasePinnedFeatures(const QList<qint64>& pinnedIds)
+{
+  const bool keepFeatures = m_objectIdField.isEmpty();
+  for (const qint64 id : pinnedIds)
+  {
+    CachedFeature* cached = m_pinnedFeatures.take(id);
+    if (!cached)
+      continue;
+
+    if (keepFeatures)
+      m_featureCache.setMaxCost(std::max(m_featureCache.maxCost(), m_featureCache.size() + 1));
+
+    m_featureCache.insert(id, cached);
+  }
+}
+
+/*!
+  \internal
+
+  Update the extent of the feature \a id in the tile indexes after the geometry of \a feature
+  has changed, and emit \l AlertTarget::dataChanged.
+
+  Indexed tiles which the feature has moved into are indexed again when next needed.
+ */
+void FeatureLayerAlertTarget::updateFeatureExtent(Feature* feature, qint64 id)
+{
+  const Envelope extent = GeometryProjectionCache::instance()->wgs84Extent(feature);
+  if (!extent.isEmpty())
+  {
+    const QList<qint64> extentTiles = tiles(extent.xMin(), extent.xMax(), extent.yMin(), extent.yMax());
+    for (auto it = m_tileIndexes.begin(); it != m_tileIndexes.end();)
+    {
+      const bool updated = it.value().updateExtent(id, extent.xMin(), extent.xMax(), extent.yMin(), extent.yMax());
+      if (!updated && extentTiles.contains(it.key()))
+        it = m_tileIndexes.erase(it);
+      else
+        ++it;
+    }
   }
 
-  rebuildQuadtree();
   emit dataChanged();
 }
 
 /*!
-  \brief internal.
+  \internal
+
+  Pin the results of the fetch task at \a taskIt, which failed if \a featureQueryResult
+  is \c nullptr, and remove the task.
+
+  When this was the last outstanding batch of its fetch, the
+  \l AlertTarget::pendingCandidatesFetched signal is emitted once if any of the batches
+  succeeded, and the features of the fetch are then moved into the cache.
+
+  Returns the iterator following the removed task.
+ */
+QHash<QUuid, FeatureLayerAlertTarget::FetchTask>::iterator FeatureLayerAlertTarget::completeFetchTask(QHash<QUuid, FetchTask>::iterator taskIt,
+                                                                                                      FeatureQueryResult* featureQueryResult)
+{
+  const FetchTask fetchTask = taskIt.value();
+  taskIt = m_fetchTasks.erase(taskIt);
+  for (const qint64 id : fetchTask.m_ids)
+    m_fetchingIds.remove(id);
+
+  auto fetchIt = m_fetches.find(fetchTask.m_fetch);
+  if (fetchIt == m_fetches.end())
+  {
+    if (featureQueryResult)
+    {
+      QList<qint64> pinnedIds;
+      pinFeatures(featureQueryResult, fetchTask.m_ids.size(), pinnedIds, nullptr);
+      releasePinnedFeatures(pinnedIds);
+    }
+    return taskIt;
+  }
+
+  Fetch& fetch = fetchIt.value();
+  if (featureQueryResult)
+    pinFeatures(featureQueryResult, fetchTask.m_ids.size() + fetch.m_pinnedIds.size(), fetch.m_pinnedIds, nullptr);
+
+  --fetch.m_outstandingBatches;
+  if (fetch.m_outstandingBatches > 0)
+    return taskIt;
+
+  const QList<qint64> pinnedIds = fetch.m_pinnedIds;
+  m_fetches.erase(fetchIt);
+  if (pinnedIds.isEmpty())
+    return taskIt;
+
+  emit pendingCandidatesFetched();
+  releasePinnedFeatures(pinnedIds);
+
+  return taskIt;
+}
+
+/*!
+  \internal
+
+  Returns the feature \a id if it is pinned or cached, or \c nullptr.
+ */
+FeatureLayerAlertTarget::CachedFeature* FeatureLayerAlertTarget::cachedFeature(qint64 id) const
+{
+  CachedFeature* pinned = m_pinnedFeatures.value(id);
+  if (pinned)
+    return pinned;
+
+  return m_featureCache.object(id);
+}
+
+/*!
+  \internal
+
+  Request that the feature \a id is fetched on the next turn of the event loop.
+
+  Returns \c true if the feature is being fetched or has been requested.
+ */
+bool FeatureLayerAlertTarget::requestFeature(qint64 id) const
+{
+  if (m_objectIdField.isEmpty())
+    return false;
+
+  if (m_fetchingIds.contains(id))
+    return true;
+
+  m_requestedIds.insert(id);
+  scheduleFetch();
+  return true;
+}
+
+/*!
+  \internal
+
+  Request that \a tile is indexed on the next turn of the event loop.
+ */
+void FeatureLayerAlertTarget::requestTile(qint64 tile) const
+{
+  if (m_loadingTiles.contains(tile))
+    return;
+
+  m_requestedTiles.insert(tile);
+  scheduleFetch();
+}
+
+/*!
+  \internal
+
+  Schedule \l fetchRequestedFeatures for the next turn of the event loop, once.
+ */
+void FeatureLayerAlertTarget::scheduleFetch() const
+{
+  if (m_fetchScheduled)
+    return;
+
+  m_fetchScheduled = true;
+  QTimer::singleShot(0, const_cast<FeatureLayerAlertTarget*>(this), &FeatureLayerAlertTarget::fetchRequestedFeatures);
+}
+
+/*!
+  \internal
+
+  Returns the object id of \a feature.
+ */
+qint64 FeatureLayerAlertTarget::featureId(Feature* feature) const
+{
+  return feature->attributes()->attributeValue(m_objectIdField).toLongLong();
+}
 
-  Build the quadtree used to find intersections with feature geometry etc.
+/*!
+  \internal
+
+  Returns the name of the object id field of the layer's table.
  */
-void FeatureLayerAlertTarget::rebuildQuadtree()
+QString FeatureLayerAlertTarget::objectIdFieldName() const
 {
-  if (m_quadtree)
+  FeatureTable* featureTable = m_FeatureLayer->featureTable();
+  if (!featureTable)
+    return QString();
+
+  ArcGISFeatureTable* agsFeatureTable = qobject_cast<ArcGISFeatureTable*>(featureTable);
+  if (agsFeatureTable)
+    return agsFeatureTable->objectIdField();
+
+  const QList<Field> fields = featureTable->fields();
+  for (const Field& field : fields)
   {
-    delete m_quadtree;
-    m_quadtree = nullptr;
+    if (field.fieldType() == FieldType::OID)
+      return field.name();
   }
 
-  QList<GeoElement*> elements;
-  for (auto it = m_features.begin(); it != m_features.end(); ++it)
-    elements.append(*it);
+  return QString();
+}
+
+/*!
+  \internal
+
+  Returns the tiles which cover the WGS84 extent \a xMin, \a xMax, \a yMin, \a yMax.
+ */
+QList<qint64> FeatureLayerAlertTarget::tiles(double xMin, double xMax, double yMin, double yMax)
+{
+  auto tileColumn = [](double x) { return qBound(0, static_cast<int>(std::floor((x + 180.0) / tileSize)), tileColumns - 1); };
+  auto tileRow = [](double y) { return qBound(0, static_cast<int>(std::floor((y + 90.0) / tileSize)), tileRows - 1); };
+
+  const int firstColumn = tileColumn(xMin);
+  const int lastColumn = tileColumn(xMax);
+  const int firstRow = tileRow(yMin);
+  const int lastRow = tileRow(yMax);
+
+  QList<qint64> result;
+  result.reserve((lastColumn - firstColumn + 1) * (lastRow - firstRow + 1));
+  for (int row = firstRow; row <= lastRow; ++row)
+  {
+    for (int column = firstColumn; column <= lastColumn; ++column)
+      result.append(static_cast<qint64>(row) * tileColumns + column);
+  }
+
+  return result;
+}
+
+/*!
+  \internal
+
+  Returns the WGS84 extent of \a tile.
+ */
+Envelope FeatureLayerAlertTarget::tileExtent(qint64 tile)
+{
+  const double xMin = -180.0 + (tile % tileColumns) * tileSize;
+  const double yMin = -90.0 + (tile / tileColumns) * tileSize;
+  return Envelope(xMin, yMin, xMin + tileSize, yMin + tileSize, SpatialReference::wgs84());
+}
+
+/*!
+  \internal
+
+  Constructor taking ownership of \a feature.
+ */
+FeatureLayerAlertTarget::CachedFeature::CachedFeature(Feature* feature):
+  m_feature(feature)
+{
+}
+
+/*!
+  \internal
+
+  Destructor. The feature is deleted later, as a condition may still be testing it.
+ */
+FeatureLayerAlertTarget::CachedFeature::~CachedFeature()
+{
+  if (!m_feature)
+    return;
 
-  if (elements.size() > 1)
-    m_quadtree = new GeometryQuadtree(m_FeatureLayer->fullExtent(), elements, 8, this);
+  GeometryProjectionCache::instance()->release(m_feature);
+  m_feature->deleteLater();
 }
 
 } // Dsa
@@ -19,12 +19,20 @@
 
 // dsa app headers
 #include "AlertTarget.h"
+#include "FeatureExtentIndex.h"
+
+// C++ API headers
+#include "TaskWatcher.h"
 
 // Qt headers
+#include <QCache>
+#include <QHash>
+#include <QSet>
 #include <QUuid>
 
 namespace Esri {
 namespace ArcGISRuntime {
+class Envelope;
 class Feature;
 class FeatureLayer;
 class FeatureQueryResult;
@@ -33,7 +41,7 @@ class FeatureQueryResult;
 
 namespace Dsa {
 
-class GeometryQuadtree;
+class PreparedPolygonCache;
 
 class FeatureLayerAlertTarget : public AlertTarget
 {
@@ -44,18 +52,83 @@ public:
   ~FeatureLayerAlertTarget();
 
   QList<Esri::ArcGISRuntime::Geometry> targetGeometries(const Esri::ArcGISRuntime::Envelope& targetArea) const override;
+  bool targetCandidates(const Esri::ArcGISRuntime::Envelope& targetArea, QVector<GeoElementCandidate>& candidates) const override;
+  PreparedPolygon targetPolygon(Esri::ArcGISRuntime::GeoElement* geoElement) const override;
   QVariant targetValue() const override;
 
+  int maximumCachedFeatures() const;
+  void setMaximumCachedFeatures(int maximumCachedFeatures);
+
 private slots:
   void handleQueryFeaturesCompleted(QUuid taskId, Esri::ArcGISRuntime::FeatureQueryResult* featureQueryResult);
+  void fetchRequestedFeatures();
 
 private:
-  void rebuildQuadtree();
+  struct CachedFeature
+  {
+    explicit CachedFeature(Esri::ArcGISRuntime::Feature* feature);
+    ~CachedFeature();
+
+    Esri::ArcGISRuntime::Feature* m_feature = nullptr;
+  };
+
+  // a query for one batch of the object ids requested by a fetch
+  struct FetchTask
+  {
+    Esri::ArcGISRuntime::TaskWatcher m_task;
+    QList<qint64> m_ids;
+    int m_fetch = 0;
+  };
+
+  // the batches of a fetch which have not completed yet, and the features they have received
+  struct Fetch
+  {
+    int m_outstandingBatches = 0;
+    QList<qint64> m_pinnedIds;
+  };
+
+  // a spatial query for the features of one tile of the index
+  struct TileTask
+  {
+    Esri::ArcGISRuntime::TaskWatcher m_task;
+    qint64 m_tile = 0;
+  };
+
+  void loadTile(qint64 tile, Esri::ArcGISRuntime::FeatureQueryResult* featureQueryResult);
+  void pinFeatures(Esri::ArcGISRuntime::FeatureQueryResult* featureQueryResult, int maximumPinned,
+                   QList<qint64>& pinnedIds, FeatureExtentIndex* index);
+  void releasePinnedFeatures(const QList<qint64>& pinnedIds);
+  void updateFeatureExtent(Esri::ArcGISRuntime::Feature* feature, qint64 id);
+  QHash<QUuid, FetchTask>::iterator completeFetchTask(QHash<QUuid, FetchTask>::iterator taskIt,
+                                                      Esri::ArcGISRuntime::FeatureQueryResult* featureQueryResult);
+  CachedFeature* cachedFeature(qint64 id) const;
+  bool requestFeature(qint64 id) const;
+  void requestTile(qint64 tile) const;
+  void scheduleFetch() const;
+  qint64 featureId(Esri::ArcGISRuntime::Feature* feature) const;
+  QString objectIdFieldName() const;
+
+  static QList<qint64> tiles(double xMin, double xMax, double yMin, double yMax);
+  static Esri::ArcGISRuntime::Envelope tileExtent(qint64 tile);
 
   Esri::ArcGISRuntime::FeatureLayer* m_FeatureLayer = nullptr;
-  GeometryQuadtree* m_quadtree = nullptr;
-  QList<Esri::ArcGISRuntime::Feature*> m_features;
-  mutable QList<Esri::ArcGISRuntime::Geometry> m_geomCache;
+  PreparedPolygonCache* m_polygonCache = nullptr;
+  QString m_objectIdField;
+  QHash<qint64, FeatureExtentIndex> m_tileIndexes;
+  QHash<QUuid, TileTask> m_tileTasks;
+  QHash<QUuid, FetchTask> m_fetchTasks;
+  QHash<int, Fetch> m_fetches;
+  QHash<qint64, CachedFeature*> m_pinnedFeatures;
+  int m_nextFetch = 0;
+  qint64 m_nextFeatureId = 0;
+  mutable QCache<qint64, CachedFeature> m_featureCache;
+  mutable QSet<qint64> m_requestedIds;
+  mutable QSet<qint64> m_fetchingIds;
+  mutable QSet<qint64> m_requestedTiles;
+  mutable QSet<qint64> m_loadingTiles;
+  mutable QSet<qint64> m_candidateIds;
+  mutable QVector<int> m_entries;
+  mutable bool m_fetchScheduled = false;
 };
 
 } // Dsa
@@ -21,6 +21,7 @@
 #include "GeoElementAlertTarget.h"
 
 #include "GeoElementUtils.h"
+#include "GeometryProjectionCache.h"
 
 // C++ API headers
 #include "GeoElement.h"
@@ -47,9 +48,14 @@ namespace Dsa {
  */
 GeoElementAlertTarget::GeoElementAlertTarget(GeoElement* geoElement):
   AlertTarget(GeoElementUtils::toQObject(geoElement)),
-  m_geoElementSignaler(new GeoElementSignaler(geoElement, this))
+  m_geoElement(geoElement),
+  m_geoElementSignaler(GeometryProjectionCache::instance()->signaler(geoElement))
 {
-  connect(m_geoElementSignaler, &GeoElementSignaler::geometryChanged, this, &GeoElementAlertTarget::dataChanged);
+  connect(m_geoElementSignaler, &GeoElementSignaler::geometryChanged, this, [this]()
+  {
+    m_polygonUpToDate = false;
+    emit dataChanged();
+  });
 }
 
 /*!
@@ -57,16 +63,52 @@ GeoElementAlertTarget::GeoElementAlertTarget(GeoElement* geoElement):
  */
 GeoElementAlertTarget::~GeoElementAlertTarget()
 {
+  // the signaler may already have been destroyed along with the element, so release by element
+  GeometryProjectionCache::instance()->release(m_geoElement);
 }
 
 /*!
   \brief Returns the \l Esri::ArcGISRuntime::Geometry of the underlying \l \l Esri::ArcGISRuntime::GeoElement.
 
+  The geometry is returned in WGS84.
+
   \note No exact intersection tests are carried against the \a targetArea for this type.
  */
 QList<Geometry> GeoElementAlertTarget::targetGeometries(const Envelope&) const
 {
-  return QList<Geometry>{m_geoElementSignaler->geoElement()->geometry()};
+  return QList<Geometry>{GeometryProjectionCache::instance()->wgs84Geometry(m_geoElementSignaler->geoElement())};
+}
+
+/*!
+  \brief Appends the underlying \l Esri::ArcGISRuntime::GeoElement to \a candidates.
+
+  Returns \c true.
+
+  \note No exact intersection tests are carried against the \a targetArea for this type.
+ */
+bool GeoElementAlertTarget::targetCandidates(const Envelope&, QVector<GeoElementCandidate>& candidates) const
+{
+  appendCandidate(m_geoElementSignaler->geoElement(), Envelope(), candidates);
+  return true;
+}
+
+/*!
+  \brief Returns the prepared polygon of the underlying \l Esri::ArcGISRuntime::GeoElement.
+
+  The polygon is only prepared again when the geometry of the element changes.
+ */
+PreparedPolygon GeoElementAlertTarget::targetPolygon(GeoElement* geoElement) const
+{
+  if (geoElement != m_geoElementSignaler->geoElement())
+    return AlertTarget::targetPolygon(geoElement);
+
+  if (!m_polygonUpToDate)
+  {
+    m_polygon = PreparedPolygon(GeometryProjectionCache::instance()->wgs84Geometry(geoElement));
+    m_polygonUpToDate = true;
+  }
+
+  return m_polygon;
 }
 
 /*!
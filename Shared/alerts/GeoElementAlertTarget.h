@@ -38,10 +38,15 @@ public:
   ~GeoElementAlertTarget();
 
   QList<Esri::ArcGISRuntime::Geometry> targetGeometries(const Esri::ArcGISRuntime::Envelope& targetArea) const override;
+  bool targetCandidates(const Esri::ArcGISRuntime::Envelope& targetArea, QVector<GeoElementCandidate>& candidates) const override;
+  PreparedPolygon targetPolygon(Esri::ArcGISRuntime::GeoElement* geoElement) const override;
   QVariant targetValue() const override;
 
 private:
+  Esri::ArcGISRuntime::GeoElement* m_geoElement = nullptr;
   GeoElementSignaler* m_geoElementSignaler = nullptr;
+  mutable PreparedPolygon m_polygon;
+  mutable bool m_polygonUpToDate = false;
 };
 
 } // Dsa
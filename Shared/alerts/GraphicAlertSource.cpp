@@ -90,4 +90,12 @@ void GraphicAlertSource::setSelected(bool selected)
   m_graphic->setSelected(selected);
 }
 
+/*!
+  \brief Returns the underlying \l Esri::ArcGISRuntime::Graphic.
+ */
+Graphic* GraphicAlertSource::graphic() const
+{
+  return m_graphic;
+}
+
 } // Dsa
@@ -41,6 +41,8 @@ public:
 
   void setSelected(bool selected) override;
 
+  Esri::ArcGISRuntime::Graphic* graphic() const;
+
 private:
   Esri::ArcGISRuntime::Graphic* m_graphic = nullptr;
 };
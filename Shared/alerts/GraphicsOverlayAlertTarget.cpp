@@ -20,7 +20,11 @@
 #include "GraphicsOverlayAlertTarget.h"
 
 // dsa app headers
+#include "AlertStatisticsModel.h"
+#include "GeoElementUtils.h"
+#include "GeometryProjectionCache.h"
 #include "GeometryQuadtree.h"
+#include "PreparedPolygonCache.h"
 
 // C++ API headers
 #include "GraphicListModel.h"
@@ -49,12 +53,22 @@ namespace Dsa {
  */
 GraphicsOverlayAlertTarget::GraphicsOverlayAlertTarget(GraphicsOverlay* graphicsOverlay):
   AlertTarget(graphicsOverlay),
-  m_graphicsOverlay(graphicsOverlay)
+  m_graphicsOverlay(graphicsOverlay),
+  m_polygonCache(new PreparedPolygonCache(this))
 {
-  // respond to graphics being removed from the overlay
+  // graphics are removed while they can still be found in the overlay
+  connect(m_graphicsOverlay->graphics(), &GraphicListModel::rowsAboutToBeRemoved, this, [this](const QModelIndex&, int first, int last)
+  {
+    for (int i = last; i >= first; --i)
+      removeGraphic(m_graphicsOverlay->graphics()->at(i));
+  });
+
   connect(m_graphicsOverlay->graphics(), &GraphicListModel::graphicRemoved, this, [this](int)
   {
-    rebuildQuadtree();
+    // if a removal was missed, synchronize with the overlay again
+    if (m_graphics.size() != m_graphicsOverlay->graphics()->rowCount())
+      resetGraphics();
+
     emit dataChanged();
   });
 
@@ -62,7 +76,10 @@ GraphicsOverlayAlertTarget::GraphicsOverlayAlertTarget(GraphicsOverlay* graphics
   connect(m_graphicsOverlay->graphics(), &GraphicListModel::graphicAdded, this, [this](int index)
   {
     Graphic* graphic = m_graphicsOverlay->graphics()->at(index);
-    setupGraphicConnections(graphic);
+    if (!graphic || m_graphicIndexes.contains(graphic))
+      return;
+
+    addGraphic(graphic);
     if (m_quadtree)
       m_quadtree->appendGeoElment(graphic);
     else
@@ -71,8 +88,15 @@ GraphicsOverlayAlertTarget::GraphicsOverlayAlertTarget(GraphicsOverlay* graphics
     emit dataChanged();
   });
 
+  // the overlay was cleared or replaced wholesale
+  connect(m_graphicsOverlay->graphics(), &GraphicListModel::modelReset, this, [this]()
+  {
+    resetGraphics();
+    emit dataChanged();
+  });
+
   // build the quadtree for all graphics in the overlay to begin with
-  rebuildQuadtree();
+  resetGraphics();
 }
 
 /*!
@@ -86,6 +110,8 @@ GraphicsOverlayAlertTarget::~GraphicsOverlayAlertTarget()
 /*!
   \brief Returns the list of \l Esri::ArcGISRuntime::Geometry which are in the \a targetArea.
 
+  The geometry is returned in WGS84.
+
   \note No exact intersection tests are carried out to create this list.
  */
 QList<Geometry> GraphicsOverlayAlertTarget::targetGeometries(const Envelope& targetArea) const
@@ -105,12 +131,46 @@ QList<Geometry> GraphicsOverlayAlertTarget::targetGeometries(const Envelope& tar
   {
     Graphic* graphic = m_graphicsOverlay->graphics()->at(i);
     if (graphic)
-      geomList.append(graphic->geometry());
+      geomList.append(GeometryProjectionCache::instance()->wgs84Geometry(graphic));
   }
 
   return geomList;
 }
 
+/*!
+  \brief Appends the graphics which may be in the \a targetArea to \a candidates.
+
+  Returns \c true.
+
+  \note No exact intersection tests are carried out to create this list.
+ */
+bool GraphicsOverlayAlertTarget::targetCandidates(const Envelope& targetArea, QVector<GeoElementCandidate>& candidates) const
+{
+  // if the quadtree has been built, use it to find the candidate graphics
+  if (m_quadtree)
+  {
+    m_quadtree->candidateElements(targetArea, candidates);
+    return true;
+  }
+
+  // otherwise, test the cached extent of each graphic in the overlay
+  const Envelope wgs84Area = GeometryProjectionCache::projectToWgs84(targetArea);
+  for (Graphic* graphic : m_graphics)
+    appendCandidate(graphic, wgs84Area, candidates);
+
+  return true;
+}
+
+/*!
+  \brief Returns the prepared polygon of the graphic \a geoElement.
+
+  Polygons are only prepared again when the geometry of the graphic changes.
+ */
+PreparedPolygon GraphicsOverlayAlertTarget::targetPolygon(GeoElement* geoElement) const
+{
+  return m_polygonCache->polygon(geoElement);
+}
+
 /*!
   \brief Returns an empty QVariant.
  */
@@ -123,13 +183,105 @@ QVariant GraphicsOverlayAlertTarget::targetValue() const
   \internal
 
   Connect signals etc. for a new \a graphic.
+
+  A graphic is only ever connected once, however often the quadtree is rebuilt.
  */
 void GraphicsOverlayAlertTarget::setupGraphicConnections(Graphic* graphic)
 {
-  if (!graphic)
+  if (!graphic || m_graphicConnections.contains(graphic))
+    return;
+
+  m_graphicConnections.insert(graphic, connect(graphic, &Graphic::geometryChanged, this, &GraphicsOverlayAlertTarget::dataChanged));
+}
+
+/*!
+  \internal
+
+  Disconnect the signals for a \a graphic which is no longer in the overlay.
+ */
+void GraphicsOverlayAlertTarget::removeGraphicConnections(Graphic* graphic)
+{
+  auto findIt = m_graphicConnections.find(graphic);
+  if (findIt == m_graphicConnections.end())
+    return;
+
+  disconnect(findIt.value());
+  m_graphicConnections.erase(findIt);
+}
+
+/*!
+  \internal
+
+  Add \a graphic to the local set of graphics and connect to its changes.
+ */
+void GraphicsOverlayAlertTarget::addGraphic(Graphic* graphic)
+{
+  m_graphicIndexes.insert(graphic, m_graphics.size());
+  m_graphics.append(graphic);
+  setupGraphicConnections(graphic);
+}
+
+/*!
+  \internal
+
+  Remove \a graphic from the local set of graphics and from the quadtree, without rebuilding it.
+
+  The local set is unordered: the last graphic is moved into the place of the removed one,
+  so a removal does not move the graphics which follow it.
+ */
+void GraphicsOverlayAlertTarget::removeGraphic(Graphic* graphic)
+{
+  auto findIt = m_graphicIndexes.find(graphic);
+  if (findIt == m_graphicIndexes.end())
     return;
 
-  m_graphicConnections.append(connect(graphic, &Graphic::geometryChanged, this, &GraphicsOverlayAlertTarget::dataChanged));
+  const int index = findIt.value();
+  m_graphicIndexes.erase(findIt);
+
+  Graphic* lastGraphic = m_graphics.last();
+  m_graphics.removeLast();
+  if (lastGraphic != graphic)
+  {
+    m_graphics[index] = lastGraphic;
+    m_graphicIndexes[lastGraphic] = index;
+  }
+
+  removeGraphicConnections(graphic);
+  m_polygonCache->remove(graphic);
+
+  if (m_quadtree)
+    m_quadtree->removeGeoElement(graphic);
+}
+
+/*!
+  \internal
+
+  Re-synchronize with every graphic in the overlay and rebuild the quadtree.
+ */
+void GraphicsOverlayAlertTarget::resetGraphics()
+{
+  for (auto it = m_graphicConnections.cbegin(); it != m_graphicConnections.cend(); ++it)
+    disconnect(it.value());
+
+  m_graphicConnections.clear();
+  m_graphics.clear();
+  m_graphicIndexes.clear();
+  m_polygonCache->clear();
+
+  const GraphicListModel* graphics = m_graphicsOverlay->graphics();
+  if (graphics)
+  {
+    const int count = graphics->rowCount();
+    m_graphics.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+      Graphic* graphic = m_graphicsOverlay->graphics()->at(i);
+      if (graphic && !m_graphicIndexes.contains(graphic))
+        addGraphic(graphic);
+    }
+  }
+
+  rebuildQuadtree();
 }
 
 /*!
@@ -145,25 +297,17 @@ void GraphicsOverlayAlertTarget::rebuildQuadtree()
     m_quadtree = nullptr;
   }
 
-  const GraphicListModel* graphics = m_graphicsOverlay->graphics();
-  if (!graphics)
-    return;
-
-  const int count = graphics->rowCount();
   QList<GeoElement*> elements;
-  for (int i = 0; i < count; ++i)
-  {
-    Graphic* g = m_graphicsOverlay->graphics()->at(i);
-    if (!g)
-      continue;
-
-    setupGraphicConnections(g);
-    elements.append(g);
-  }
+  elements.reserve(m_graphics.size());
+  for (Graphic* graphic : qAsConst(m_graphics))
+    elements.append(graphic);
 
   // if there is more than 1 element in the overlay, build a quadtree
   if (elements.size() > 1)
+  {
     m_quadtree = new GeometryQuadtree(m_graphicsOverlay->extent(), elements, 8, this);
+    AlertStatisticsModel::instance()->recordRebuild(AlertStatisticsModel::Rebuild::Quadtree);
+  }
 }
 
 } // Dsa
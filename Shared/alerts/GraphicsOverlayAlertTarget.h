@@ -30,6 +30,7 @@ class GraphicsOverlay;
 namespace Dsa {
 
 class GeometryQuadtree;
+class PreparedPolygonCache;
 
 class GraphicsOverlayAlertTarget : public AlertTarget
 {
@@ -40,15 +41,26 @@ public:
   ~GraphicsOverlayAlertTarget();
 
   QList<Esri::ArcGISRuntime::Geometry> targetGeometries(const Esri::ArcGISRuntime::Envelope& targetArea) const override;
+  bool targetCandidates(const Esri::ArcGISRuntime::Envelope& targetArea, QVector<GeoElementCandidate>& candidates) const override;
+  PreparedPolygon targetPolygon(Esri::ArcGISRuntime::GeoElement* geoElement) const override;
   QVariant targetValue() const override;
 
 private:
   void setupGraphicConnections(Esri::ArcGISRuntime::Graphic* graphic);
+  void removeGraphicConnections(Esri::ArcGISRuntime::Graphic* graphic);
+  void addGraphic(Esri::ArcGISRuntime::Graphic* graphic);
+  void removeGraphic(Esri::ArcGISRuntime::Graphic* graphic);
+  void resetGraphics();
   void rebuildQuadtree();
 
   Esri::ArcGISRuntime::GraphicsOverlay* m_graphicsOverlay = nullptr;
   GeometryQuadtree* m_quadtree = nullptr;
-  QList<QMetaObject::Connection> m_graphicConnections;
+  PreparedPolygonCache* m_polygonCache = nullptr;
+
+  // the graphics of the overlay in no particular order, with the index of each
+  QVector<Esri::ArcGISRuntime::Graphic*> m_graphics;
+  QHash<Esri::ArcGISRuntime::Graphic*, int> m_graphicIndexes;
+  QHash<Esri::ArcGISRuntime::Graphic*, QMetaObject::Connection> m_graphicConnections;
 };
 
 } // Dsa
@@ -0,0 +1,318 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "GraphicsOverlayAttributeIndex.h"
+
+// dsa app headers
+#include "AttributeEqualsAlertCondition.h"
+#include "AttributeEqualsAlertConditionData.h"
+#include "GraphicsOverlaySourceStore.h"
+
+// C++ API headers
+#include "GraphicsOverlay.h"
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::GraphicsOverlayAttributeIndex
+  \inmodule Dsa
+  \inherits QObject
+  \brief An inverted index of the attribute values of the graphics in an
+  \l Esri::ArcGISRuntime::GraphicsOverlay, for \l AttributeEqualsAlertCondition queries.
+
+  For each attribute used by a condition on the overlay, the index holds the value of
+  each graphic and the set of graphics with each value. The index is updated from the
+  \l GraphicsOverlaySourceStore of the overlay as soon as the attributes of a graphic change.
+
+  The index also records which conditions test for each value. When the value of a graphic
+  changes, only the conditions testing for the old or the new value are told, so many
+  conditions on the same attribute (for example, one per status) cost a hash lookup per
+  change rather than a test each.
+
+  Values are grouped by their string form and matched exactly as by
+  \l AttributeEqualsAlertConditionData::matchesValue.
+ */
+
+/*!
+  \brief Returns the index for \a overlay, creating it if required.
+
+  The index is owned by \a overlay.
+ */
+GraphicsOverlayAttributeIndex* GraphicsOverlayAttributeIndex::forOverlay(GraphicsOverlay* overlay)
+{
+  if (!overlay)
+    return nullptr;
+
+  GraphicsOverlayAttributeIndex* index = overlay->findChild<GraphicsOverlayAttributeIndex*>(QString(), Qt::FindDirectChildrenOnly);
+  if (index)
+    return index;
+
+  GraphicsOverlaySourceStore* sources = GraphicsOverlaySourceStore::forOverlay(overlay);
+  if (!sources)
+    return nullptr;
+
+  return new GraphicsOverlayAttributeIndex(overlay, sources);
+}
+
+/*!
+  \internal
+
+  Constructor taking the \a overlay, which will be the parent of the index, and its \a sources.
+ */
+GraphicsOverlayAttributeIndex::GraphicsOverlayAttributeIndex(GraphicsOverlay* overlay, GraphicsOverlaySourceStore* sources):
+  QObject(overlay),
+  m_sources(sources)
+{
+  connect(m_sources, &GraphicsOverlaySourceStore::rowsAdded, this, &GraphicsOverlayAttributeIndex::handleRowsAdded);
+  connect(m_sources, &GraphicsOverlaySourceStore::attributesChanged, this, &GraphicsOverlayAttributeIndex::handleAttributesChanged);
+  connect(m_sources, &GraphicsOverlaySourceStore::rowAboutToBeRemoved, this, &GraphicsOverlayAttributeIndex::handleRowAboutToBeRemoved);
+}
+
+/*!
+  \brief Destructor.
+ */
+GraphicsOverlayAttributeIndex::~GraphicsOverlayAttributeIndex()
+{
+}
+
+/*!
+  \brief Registers \a condition as testing for its attribute to equal \a value.
+
+  The attribute is indexed for every graphic in the overlay if it is not already.
+ */
+void GraphicsOverlayAttributeIndex::addCondition(AttributeEqualsAlertCondition* condition, const QVariant& value)
+{
+  if (!condition)
+    return;
+
+  const QString attributeName = condition->attributeName();
+  auto it = m_columns.find(attributeName);
+  if (it == m_columns.end())
+  {
+    it = m_columns.insert(attributeName, AttributeColumn());
+
+    const int count = m_sources->size();
+    it->m_values.reserve(count);
+    for (int row = 0; row < count; ++row)
+      updateValue(it.value(), attributeName, row, false);
+  }
+
+  it->m_conditions.insert(valueKey(value), condition);
+}
+
+/*!
+  \brief Unregisters \a condition.
+
+  The attribute is no longer indexed once no conditions use it.
+ */
+void GraphicsOverlayAttributeIndex::removeCondition(AttributeEqualsAlertCondition* condition)
+{
+  for (auto it = m_columns.begin(); it != m_columns.end();)
+  {
+    AttributeColumn& column = it.value();
+    for (auto conditionIt = column.m_conditions.begin(); conditionIt != column.m_conditions.end();)
+    {
+      if (conditionIt.value() == condition)
+        conditionIt = column.m_conditions.erase(conditionIt);
+      else
+        ++conditionIt;
+    }
+
+    if (column.m_conditions.isEmpty())
+      it = m_columns.erase(it);
+    else
+      ++it;
+  }
+}
+
+/*!
+  \brief Returns whether \a attributeName is indexed.
+ */
+bool GraphicsOverlayAttributeIndex::isIndexed(const QString& attributeName) const
+{
+  return m_columns.contains(attributeName);
+}
+
+/*!
+  \brief Returns whether the \a attributeName of \a graphic equals \a value.
+
+  Returns \c false if \a attributeName is not indexed.
+ */
+bool GraphicsOverlayAttributeIndex::contains(const QString& attributeName, const QVariant& value, Graphic* graphic) const
+{
+  auto it = m_columns.constFind(attributeName);
+  if (it == m_columns.constEnd())
+    return false;
+
+  auto membersIt = it->m_members.constFind(valueKey(value));
+  if (membersIt == it->m_members.constEnd() || !membersIt->contains(graphic))
+    return false;
+
+  return AttributeEqualsAlertConditionData::matchesValue(it->m_values.value(graphic), value);
+}
+
+/*!
+  \brief Returns the number of graphics whose \a attributeName has the same string form as \a value.
+
+  Returns \c 0 if \a attributeName is not indexed.
+ */
+int GraphicsOverlayAttributeIndex::count(const QString& attributeName, const QVariant& value) const
+{
+  auto it = m_columns.constFind(attributeName);
+  if (it == m_columns.constEnd())
+    return 0;
+
+  return it->m_members.value(valueKey(value)).size();
+}
+
+/*!
+  \internal
+
+  Index the attributes of the new rows \a first to \a last.
+ */
+void GraphicsOverlayAttributeIndex::handleRowsAdded(int first, int last)
+{
+  for (auto it = m_columns.begin(); it != m_columns.end(); ++it)
+  {
+    for (int row = first; row <= last; ++row)
+      updateValue(it.value(), it.key(), row, false);
+  }
+}
+
+/*!
+  \internal
+
+  Update the indexed attributes of \a row and tell the conditions whose result may have changed.
+ */
+void GraphicsOverlayAttributeIndex::handleAttributesChanged(int row)
+{
+  for (auto it = m_columns.begin(); it != m_columns.end(); ++it)
+    updateValue(it.value(), it.key(), row, true);
+}
+
+/*!
+  \internal
+
+  Remove the graphic at \a row from the index.
+ */
+void GraphicsOverlayAttributeIndex::handleRowAboutToBeRemoved(int row)
+{
+  // the graphic may be being destroyed, so it is only used as a key
+  Graphic* graphic = m_sources->graphic(row);
+  for (auto it = m_columns.begin(); it != m_columns.end(); ++it)
+  {
+    AttributeColumn& column = it.value();
+    auto valueIt = column.m_values.find(graphic);
+    if (valueIt == column.m_values.end())
+      continue;
+
+    const QString key = valueKey(valueIt.value());
+    column.m_values.erase(valueIt);
+
+    auto membersIt = column.m_members.find(key);
+    if (membersIt == column.m_members.end())
+      continue;
+
+    membersIt->remove(graphic);
+    if (membersIt->isEmpty())
+      column.m_members.erase(membersIt);
+  }
+}
+
+/*!
+  \internal
+
+  Update the \a column for \a attributeName with the value of the graphic at \a row.
+
+  If \a notify is \c true, the conditions testing for the old or the new value are told.
+ */
+void GraphicsOverlayAttributeIndex::updateValue(AttributeColumn& column, const QString& attributeName, int row, bool notify)
+{
+  Graphic* graphic = m_sources->graphic(row);
+  if (!graphic)
+    return;
+
+  const QVariant newValue = m_sources->value(row, attributeName);
+  const QString newKey = valueKey(newValue);
+
+  QString oldKey;
+  auto valueIt = column.m_values.find(graphic);
+  if (valueIt != column.m_values.end())
+  {
+    // most attribute changes are to other attributes
+    if (valueIt.value() == newValue && valueIt.value().userType() == newValue.userType())
+      return;
+
+    oldKey = valueKey(valueIt.value());
+    column.m_values.erase(valueIt);
+
+    auto membersIt = column.m_members.find(oldKey);
+    if (membersIt != column.m_members.end())
+    {
+      membersIt->remove(graphic);
+      if (membersIt->isEmpty())
+        column.m_members.erase(membersIt);
+    }
+  }
+
+  // null values, and values without a string form, are not indexed and never match
+  if (!newKey.isNull())
+  {
+    column.m_values.insert(graphic, newValue);
+    column.m_members[newKey].insert(graphic);
+  }
+
+  if (!notify)
+    return;
+
+  if (!oldKey.isNull())
+    notifyConditions(column, oldKey, row);
+
+  if (!newKey.isNull() && newKey != oldKey)
+    notifyConditions(column, newKey, row);
+}
+
+/*!
+  \internal
+
+  Tell the conditions in \a column testing for the value \a key that the result for \a row may have changed.
+ */
+void GraphicsOverlayAttributeIndex::notifyConditions(const AttributeColumn& column, const QString& key, int row) const
+{
+  const QList<AttributeEqualsAlertCondition*> conditions = column.m_conditions.values(key);
+  for (AttributeEqualsAlertCondition* condition : conditions)
+    condition->handleMembershipChanged(row);
+}
+
+/*!
+  \internal
+
+  Returns the key for \a value in the index, or a null string if it is not indexed.
+ */
+QString GraphicsOverlayAttributeIndex::valueKey(const QVariant& value)
+{
+  if (value.isNull() || !value.isValid())
+    return QString();
+
+  return value.toString();
+}
+
+} // Dsa
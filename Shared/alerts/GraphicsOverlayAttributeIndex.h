@@ -0,0 +1,86 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef GRAPHICSOVERLAYATTRIBUTEINDEX_H
+#define GRAPHICSOVERLAYATTRIBUTEINDEX_H
+
+// Qt headers
+#include <QHash>
+#include <QMultiHash>
+#include <QObject>
+#include <QSet>
+#include <QVariant>
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class Graphic;
+class GraphicsOverlay;
+}
+}
+
+namespace Dsa {
+
+class AttributeEqualsAlertCondition;
+class GraphicsOverlaySourceStore;
+
+class GraphicsOverlayAttributeIndex : public QObject
+{
+  Q_OBJECT
+
+public:
+  static GraphicsOverlayAttributeIndex* forOverlay(Esri::ArcGISRuntime::GraphicsOverlay* overlay);
+
+  ~GraphicsOverlayAttributeIndex();
+
+  void addCondition(AttributeEqualsAlertCondition* condition, const QVariant& value);
+  void removeCondition(AttributeEqualsAlertCondition* condition);
+
+  bool isIndexed(const QString& attributeName) const;
+  bool contains(const QString& attributeName, const QVariant& value, Esri::ArcGISRuntime::Graphic* graphic) const;
+  int count(const QString& attributeName, const QVariant& value) const;
+
+private slots:
+  void handleRowsAdded(int first, int last);
+  void handleAttributesChanged(int row);
+  void handleRowAboutToBeRemoved(int row);
+
+private:
+  GraphicsOverlayAttributeIndex(Esri::ArcGISRuntime::GraphicsOverlay* overlay, GraphicsOverlaySourceStore* sources);
+
+  struct AttributeColumn
+  {
+    // the indexed value of each graphic and the graphics with each value
+    QHash<Esri::ArcGISRuntime::Graphic*, QVariant> m_values;
+    QHash<QString, QSet<Esri::ArcGISRuntime::Graphic*>> m_members;
+
+    // the conditions testing for each value
+    QMultiHash<QString, AttributeEqualsAlertCondition*> m_conditions;
+  };
+
+  void updateValue(AttributeColumn& column, const QString& attributeName, int row, bool notify);
+  void notifyConditions(const AttributeColumn& column, const QString& key, int row) const;
+
+  static QString valueKey(const QVariant& value);
+
+  GraphicsOverlaySourceStore* m_sources = nullptr;
+  QHash<QString, AttributeColumn> m_columns;
+};
+
+} // Dsa
+
+#endif // GRAPHICSOVERLAYATTRIBUTEINDEX_H
@@ -0,0 +1,363 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "GraphicsOverlaySourceStore.h"
+
+// dsa app headers
+#include "GeometryProjectionCache.h"
+
+// C++ API headers
+#include "AttributeListModel.h"
+#include "Envelope.h"
+#include "Graphic.h"
+#include "GraphicListModel.h"
+#include "GraphicsOverlay.h"
+
+// Qt headers
+#include <QTimer>
+
+// STL headers
+#include <algorithm>
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::GraphicsOverlaySourceStore
+  \inmodule Dsa
+  \inherits QObject
+  \brief A column store of the source objects in an \l Esri::ArcGISRuntime::GraphicsOverlay
+  for \l AlertCondition queries.
+
+  Each \l Esri::ArcGISRuntime::Graphic in the overlay is a row, with columns for the graphic,
+  a stable source ID and the cached WGS84 location of the graphic. A single store is shared
+  by every condition which uses the overlay as a source, so the location of each graphic is
+  projected once per change and each graphic is only connected to once, however many
+  conditions are applied.
+
+  Changes to the graphics are gathered and reported by \l rowsChanged once per turn of the
+  event loop.
+
+  Rows are not kept in the order of the overlay: when a graphic is removed, the last row
+  moves into its place, so that a removal does not move every row which follows it.
+
+  \sa AlertConditionStore
+ */
+
+/*!
+  \brief Returns the store for \a overlay, creating it if required.
+
+  The store is owned by \a overlay.
+ */
+GraphicsOverlaySourceStore* GraphicsOverlaySourceStore::forOverlay(GraphicsOverlay* overlay)
+{
+  if (!overlay)
+    return nullptr;
+
+  GraphicsOverlaySourceStore* store = overlay->findChild<GraphicsOverlaySourceStore*>(QString(), Qt::FindDirectChildrenOnly);
+  if (store)
+    return store;
+
+  return new GraphicsOverlaySourceStore(overlay);
+}
+
+/*!
+  \internal
+
+  Constructor taking the \a overlay, which will be the parent of the store.
+ */
+GraphicsOverlaySourceStore::GraphicsOverlaySourceStore(GraphicsOverlay* overlay):
+  QObject(overlay),
+  m_overlay(overlay)
+{
+  GraphicListModel* graphics = m_overlay->graphics();
+  if (!graphics)
+    return;
+
+  connect(graphics, &GraphicListModel::graphicAdded, this, [this, graphics](int index)
+  {
+    Graphic* graphic = graphics->at(index);
+    if (!graphic || m_rows.contains(graphic))
+      return;
+
+    addGraphic(graphic);
+    emit rowsAdded(m_graphics.size() - 1, m_graphics.size() - 1);
+  });
+
+  connect(graphics, &GraphicListModel::rowsAboutToBeRemoved, this, [this, graphics](const QModelIndex&, int first, int last)
+  {
+    for (int i = last; i >= first; --i)
+      removeGraphic(graphics->at(i));
+  });
+
+  connect(graphics, &GraphicListModel::modelAboutToBeReset, this, [this]()
+  {
+    while (!m_graphics.isEmpty())
+      removeGraphic(m_graphics.last());
+  });
+
+  const int count = graphics->rowCount();
+  m_graphics.reserve(count);
+  m_sourceIds.reserve(count);
+  m_locations.reserve(count);
+  for (int i = 0; i < count; ++i)
+  {
+    Graphic* graphic = graphics->at(i);
+    if (graphic && !m_rows.contains(graphic))
+      addGraphic(graphic);
+  }
+}
+
+/*!
+  \brief Destructor.
+ */
+GraphicsOverlaySourceStore::~GraphicsOverlaySourceStore()
+{
+}
+
+/*!
+  \brief Returns the number of rows (graphics) in the store.
+ */
+int GraphicsOverlaySourceStore::size() const
+{
+  return m_graphics.size();
+}
+
+/*!
+  \brief Returns the row for \a graphic, or \c -1 if it is not in the store.
+ */
+int GraphicsOverlaySourceStore::row(Graphic* graphic) const
+{
+  return m_rows.value(graphic, -1);
+}
+
+/*!
+  \brief Returns the \l Esri::ArcGISRuntime::Graphic at \a row.
+ */
+Graphic* GraphicsOverlaySourceStore::graphic(int row) const
+{
+  return m_graphics.value(row, nullptr);
+}
+
+/*!
+  \brief Returns the source ID at \a row.
+
+  Source IDs are unique within the store and do not change when other rows are removed.
+ */
+int GraphicsOverlaySourceStore::sourceId(int row) const
+{
+  return m_sourceIds.value(row, -1);
+}
+
+/*!
+  \brief Returns the cached WGS84 location of the graphic at \a row.
+ */
+Point GraphicsOverlaySourceStore::location(int row) const
+{
+  return m_locations.value(row);
+}
+
+/*!
+  \brief Returns the attribute value for the field \a key of the graphic at \a row.
+ */
+QVariant GraphicsOverlaySourceStore::value(int row, const QString& key) const
+{
+  Graphic* graphic = m_graphics.value(row, nullptr);
+  if (!graphic || !graphic->attributes())
+    return QVariant();
+
+  return graphic->attributes()->attributeValue(key);
+}
+
+/*!
+  \internal
+
+  Append a row for \a graphic and connect to its changes.
+ */
+void GraphicsOverlaySourceStore::addGraphic(Graphic* graphic)
+{
+  m_rows.insert(graphic, m_graphics.size());
+  m_graphics.append(graphic);
+  m_sourceIds.append(m_nextSourceId++);
+  m_locations.append(wgs84Location(graphic));
+
+  auto handleGraphicChanged = [this, graphic]()
+  {
+    markChanged(graphic);
+  };
+
+  connect(graphic, &Graphic::geometryChanged, this, handleGraphicChanged);
+  connect(graphic, &Graphic::destroyed, this, [this, graphic]()
+  {
+    // the graphic is being destroyed, so only the row is removed
+    const int row = m_rows.value(graphic, -1);
+    if (row != -1)
+      removeRow(row);
+  });
+
+  // attribute changes are also reported straight away, for the attribute indexes
+  auto handleAttributesChanged = [this, graphic]()
+  {
+    markChanged(graphic);
+
+    const int row = m_rows.value(graphic, -1);
+    if (row != -1)
+      emit attributesChanged(row);
+  };
+
+  if (graphic->attributes())
+  {
+    connect(graphic->attributes(), &AttributeListModel::modelReset, this, handleAttributesChanged);
+    connect(graphic->attributes(), &AttributeListModel::dataChanged, this, handleAttributesChanged);
+  }
+}
+
+/*!
+  \internal
+
+  Remove the row for \a graphic and disconnect from its changes.
+ */
+void GraphicsOverlaySourceStore::removeGraphic(Graphic* graphic)
+{
+  const int row = m_rows.value(graphic, -1);
+  if (row == -1)
+    return;
+
+  removeRow(row);
+
+  disconnect(graphic, nullptr, this, nullptr);
+  if (graphic->attributes())
+    disconnect(graphic->attributes(), nullptr, this, nullptr);
+}
+
+/*!
+  \internal
+
+  Remove \a row from each column, after reporting it with \l rowAboutToBeRemoved.
+
+  The last row is moved into \a row.
+ */
+void GraphicsOverlaySourceStore::removeRow(int row)
+{
+  emit rowAboutToBeRemoved(row);
+
+  Graphic* graphic = m_graphics.at(row);
+  m_rows.remove(graphic);
+  m_pendingChanges.remove(graphic);
+
+  const int lastRow = m_graphics.size() - 1;
+  if (row != lastRow)
+  {
+    m_graphics[row] = m_graphics.at(lastRow);
+    m_sourceIds[row] = m_sourceIds.at(lastRow);
+    m_locations[row] = m_locations.at(lastRow);
+    m_rows[m_graphics.at(row)] = row;
+  }
+
+  m_graphics.removeLast();
+  m_sourceIds.removeLast();
+  m_locations.removeLast();
+}
+
+/*!
+  \internal
+
+  Record that \a graphic has changed, to be reported on the next turn of the event loop.
+ */
+void GraphicsOverlaySourceStore::markChanged(Graphic* graphic)
+{
+  if (m_pendingChanges.isEmpty())
+    QTimer::singleShot(0, this, &GraphicsOverlaySourceStore::emitPendingChanges);
+
+  m_pendingChanges.insert(graphic);
+}
+
+/*!
+  \internal
+
+  Update the cached locations of the changed graphics and report their rows.
+ */
+void GraphicsOverlaySourceStore::emitPendingChanges()
+{
+  if (m_pendingChanges.isEmpty())
+    return;
+
+  QVector<int> changedRows;
+  changedRows.reserve(m_pendingChanges.size());
+  for (Graphic* graphic : qAsConst(m_pendingChanges))
+  {
+    const int row = m_rows.value(graphic, -1);
+    if (row == -1)
+      continue;
+
+    m_locations[row] = wgs84Location(graphic);
+    changedRows.append(row);
+  }
+  m_pendingChanges.clear();
+
+  if (changedRows.isEmpty())
+    return;
+
+  std::sort(changedRows.begin(), changedRows.end());
+  emit rowsChanged(changedRows);
+}
+
+/*!
+  \internal
+
+  Returns the location of \a graphic in WGS84. Non-point geometries use the center of their extent.
+ */
+Point GraphicsOverlaySourceStore::wgs84Location(Graphic* graphic)
+{
+  const Geometry geometry = graphic->geometry();
+  const Point location = geometry.geometryType() == GeometryType::Point ? Point(geometry)
+                                                                        : geometry.extent().center();
+
+  return Point(GeometryProjectionCache::projectToWgs84(location));
+}
+
+} // Dsa
+
+// Signal Documentation
+/*!
+  \fn void GraphicsOverlaySourceStore::rowsAdded(int first, int last);
+  \brief Signal emitted when the rows \a first to \a last are appended to the store.
+ */
+
+/*!
+  \fn void GraphicsOverlaySourceStore::rowsChanged(const QVector<int>& rows);
+  \brief Signal emitted when the graphics at \a rows have changed.
+
+  The rows are in ascending order.
+ */
+
+/*!
+  \fn void GraphicsOverlaySourceStore::attributesChanged(int row);
+  \brief Signal emitted as soon as the attributes of the graphic at \a row change.
+
+  The change is also reported by \l rowsChanged on the next turn of the event loop.
+ */
+
+/*!
+  \fn void GraphicsOverlaySourceStore::rowAboutToBeRemoved(int row);
+  \brief Signal emitted before \a row is removed from the store.
+
+  The last row of the store will then move into \a row. Other rows do not move.
+ */
@@ -0,0 +1,91 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef GRAPHICSOVERLAYSOURCESTORE_H
+#define GRAPHICSOVERLAYSOURCESTORE_H
+
+// C++ API headers
+#include "Point.h"
+
+// Qt headers
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QVariant>
+#include <QVector>
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class Graphic;
+class GraphicsOverlay;
+}
+}
+
+namespace Dsa {
+
+class GraphicsOverlaySourceStore : public QObject
+{
+  Q_OBJECT
+
+public:
+  static GraphicsOverlaySourceStore* forOverlay(Esri::ArcGISRuntime::GraphicsOverlay* overlay);
+
+  ~GraphicsOverlaySourceStore();
+
+  int size() const;
+  int row(Esri::ArcGISRuntime::Graphic* graphic) const;
+
+  Esri::ArcGISRuntime::Graphic* graphic(int row) const;
+  int sourceId(int row) const;
+  Esri::ArcGISRuntime::Point location(int row) const;
+  QVariant value(int row, const QString& key) const;
+
+signals:
+  void rowsAdded(int first, int last);
+  void rowsChanged(const QVector<int>& rows);
+  void attributesChanged(int row);
+  void rowAboutToBeRemoved(int row);
+
+private slots:
+  void emitPendingChanges();
+
+private:
+  explicit GraphicsOverlaySourceStore(Esri::ArcGISRuntime::GraphicsOverlay* overlay);
+
+  void addGraphic(Esri::ArcGISRuntime::Graphic* graphic);
+  void removeGraphic(Esri::ArcGISRuntime::Graphic* graphic);
+  void removeRow(int row);
+  void markChanged(Esri::ArcGISRuntime::Graphic* graphic);
+
+  static Esri::ArcGISRuntime::Point wgs84Location(Esri::ArcGISRuntime::Graphic* graphic);
+
+  Esri::ArcGISRuntime::GraphicsOverlay* m_overlay = nullptr;
+  int m_nextSourceId = 0;
+
+  // one entry per graphic in each column
+  QVector<Esri::ArcGISRuntime::Graphic*> m_graphics;
+  QVector<int> m_sourceIds;
+  QVector<Esri::ArcGISRuntime::Point> m_locations;
+
+  QHash<Esri::ArcGISRuntime::Graphic*, int> m_rows;
+  QSet<Esri::ArcGISRuntime::Graphic*> m_pendingChanges;
+};
+
+} // Dsa
+
+#endif // GRAPHICSOVERLAYSOURCESTORE_H
@@ -0,0 +1,203 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "NotUpdatedAlertCondition.h"
+
+// dsa app headers
+#include "AlertConstants.h"
+#include "TrackHistory.h"
+
+// Qt headers
+#include <QDateTime>
+#include <QTimer>
+
+// STL headers
+#include <algorithm>
+#include <limits>
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::NotUpdatedAlertCondition
+  \inmodule Dsa
+  \inherits TrackHistoryAlertCondition
+  \brief Represents a condition which will be continuously monitored and will
+  trigger an alert when a track in a message feed has not been updated for a given time.
+
+  For example, "any friendly not updated for 120 seconds".
+
+  The \l TrackHistory keeps the tracks in the order they were last seen, so a single timer
+  is set for when the least recently seen track will become stale. The stale tracks are
+  always at the start of the history, so the condition remembers the last of them and,
+  when the timer fires, only the tracks which have become stale since are visited.
+ */
+
+/*!
+  \brief Constructor taking an \l AlertLevel (\a level) the \a name of the condition,
+  the \a duration (in seconds) after which a track without updates is stale and an
+  optional \a parent.
+ */
+NotUpdatedAlertCondition::NotUpdatedAlertCondition(AlertLevel level,
+                                                   const QString& name,
+                                                   double duration,
+                                                   QObject* parent):
+  TrackHistoryAlertCondition(level, name, parent),
+  m_duration(duration),
+  m_staleTimer(new QTimer(this))
+{
+  m_staleTimer->setSingleShot(true);
+  connect(m_staleTimer, &QTimer::timeout, this, &NotUpdatedAlertCondition::checkStaleTracks);
+}
+
+/*!
+  \brief Destructor.
+ */
+NotUpdatedAlertCondition::~NotUpdatedAlertCondition()
+{
+}
+
+/*!
+  \brief Initializes the condition with a \a sourceFeed and a \a sourceDescription.
+ */
+void NotUpdatedAlertCondition::init(GraphicsOverlay* sourceFeed, const QString& sourceDescription)
+{
+  initTracks(sourceFeed, sourceDescription, QString("%1 %2").arg(QString::number(m_duration), AlertConstants::SECONDS));
+  checkStaleTracks();
+}
+
+/*!
+  \brief Returns whether \a track has not been updated for the duration of the condition.
+ */
+bool NotUpdatedAlertCondition::matchesTrack(Graphic* track) const
+{
+  return m_staleTracks.contains(track);
+}
+
+/*!
+  \brief The time (in seconds) after which a track without updates is stale.
+ */
+double NotUpdatedAlertCondition::duration() const
+{
+  return m_duration;
+}
+
+/*!
+  \brief Returns a map of the variable components that make up the query for this condition.
+
+  This condition type uses a query comprising the following components:
+
+  \list
+    \li seconds. The time after which a track without updates is stale.
+  \endlist
+ */
+QVariantMap NotUpdatedAlertCondition::queryComponents() const
+{
+  QVariantMap queryMap;
+  queryMap.insert(AlertConstants::SECONDS, m_duration);
+
+  return queryMap;
+}
+
+/*!
+  \brief Returns the duration from the \a queryComponents, or \c -1 if there is none.
+ */
+double NotUpdatedAlertCondition::getDurationFromQueryComponents(const QVariantMap& queryComponents)
+{
+  return queryComponents.value(AlertConstants::SECONDS, -1.0).toDouble();
+}
+
+/*!
+  \brief Returns the query string component for this condition - e.g. "has not been updated for".
+ */
+QString NotUpdatedAlertCondition::queryString() const
+{
+  return QStringLiteral("has not been updated for");
+}
+
+/*!
+  \brief Marks \a track as no longer stale and makes sure a check is scheduled.
+ */
+void NotUpdatedAlertCondition::handleSampleAdded(Graphic* track)
+{
+  if (m_staleTracks.remove(track))
+  {
+    // the track has moved to the end of the history, so the stale tracks before it must be found again
+    if (track == m_lastStaleTrack)
+      m_lastStaleTrack = nullptr;
+
+    emitTracksChanged(QVector<Graphic*>{track});
+  }
+
+  // with no check pending every other track is already stale, so this track will be the next
+  if (!m_staleTimer->isActive())
+    m_staleTimer->start(static_cast<int>(std::min(m_duration * 1000.0, static_cast<double>(std::numeric_limits<int>::max()))));
+}
+
+/*!
+  \brief Discards the state of \a track.
+ */
+void NotUpdatedAlertCondition::handleTrackRemoved(Graphic* track)
+{
+  m_staleTracks.remove(track);
+  if (track == m_lastStaleTrack)
+    m_lastStaleTrack = nullptr;
+}
+
+/*!
+  \internal
+
+  Mark the tracks which have not been updated for the duration as stale, in the order
+  they were last seen, and set the timer for the next track to become stale.
+
+  The walk starts after the last track which was already known to be stale.
+ */
+void NotUpdatedAlertCondition::checkStaleTracks()
+{
+  TrackHistory* history = trackHistory();
+  if (!history)
+    return;
+
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  const qint64 duration = static_cast<qint64>(m_duration * 1000.0);
+
+  QVector<Graphic*> changedTracks;
+  Graphic* firstTrack = m_lastStaleTrack ? history->nextMoreRecentlySeen(m_lastStaleTrack) : history->leastRecentlySeen();
+  for (Graphic* track = firstTrack; track; track = history->nextMoreRecentlySeen(track))
+  {
+    const qint64 staleTime = history->lastSeen(track) + duration;
+    if (staleTime > now)
+    {
+      m_staleTimer->start(static_cast<int>(std::min<qint64>(staleTime - now, std::numeric_limits<int>::max())));
+      break;
+    }
+
+    m_lastStaleTrack = track;
+    if (m_staleTracks.contains(track))
+      continue;
+
+    m_staleTracks.insert(track);
+    changedTracks.append(track);
+  }
+
+  emitTracksChanged(changedTracks);
+}
+
+} // Dsa
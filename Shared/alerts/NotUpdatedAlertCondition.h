@@ -0,0 +1,72 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef NOTUPDATEDALERTCONDITION_H
+#define NOTUPDATEDALERTCONDITION_H
+
+// dsa app headers
+#include "TrackHistoryAlertCondition.h"
+
+// Qt headers
+#include <QObject>
+#include <QSet>
+
+class QTimer;
+
+namespace Dsa {
+
+class NotUpdatedAlertCondition : public TrackHistoryAlertCondition
+{
+  Q_OBJECT
+
+public:
+  NotUpdatedAlertCondition(AlertLevel level,
+                           const QString& name,
+                           double duration,
+                           QObject* parent = nullptr);
+
+  ~NotUpdatedAlertCondition();
+
+  void init(Esri::ArcGISRuntime::GraphicsOverlay* sourceFeed, const QString& sourceDescription);
+
+  bool matchesTrack(Esri::ArcGISRuntime::Graphic* track) const override;
+
+  QString queryString() const override;
+  QVariantMap queryComponents() const override;
+
+  double duration() const;
+
+  static double getDurationFromQueryComponents(const QVariantMap& queryComponents);
+
+protected:
+  void handleSampleAdded(Esri::ArcGISRuntime::Graphic* track) override;
+  void handleTrackRemoved(Esri::ArcGISRuntime::Graphic* track) override;
+
+private slots:
+  void checkStaleTracks();
+
+private:
+  double m_duration;
+  QTimer* m_staleTimer = nullptr;
+  QSet<Esri::ArcGISRuntime::Graphic*> m_staleTracks;
+
+  // the most recently seen of the tracks at the start of the history which are all stale
+  Esri::ArcGISRuntime::Graphic* m_lastStaleTrack = nullptr;
+};
+
+} // Dsa
+
+#endif // NOTUPDATEDALERTCONDITION_H
@@ -0,0 +1,361 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "PreparedPolygon.h"
+
+// C++ API headers
+#include "Envelope.h"
+#include "GeometryEngine.h"
+#include "ImmutablePart.h"
+#include "ImmutablePartCollection.h"
+#include "Point.h"
+#include "Polygon.h"
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+namespace
+{
+// the xy tolerance of WGS84, used to treat locations on the boundary as intersecting
+constexpr double wgs84Tolerance = 8.983152841195214e-9;
+
+// upper bound on the number of y-buckets in the edge index
+constexpr int maxBucketCount = 8192;
+}
+
+/*!
+  \class Dsa::PreparedPolygon
+  \inmodule Dsa
+  \brief A polygon which has been projected to WGS84 and indexed for fast
+  point-in-polygon tests.
+
+  Preparing a polygon walks its vertices once: the geometry is projected to WGS84,
+  simplified and its edges are sorted into horizontal buckets of equal height.
+  A location test then only needs to consider the edges in the single bucket
+  which spans the location's y coordinate, rather than every vertex of the polygon.
+
+  The result of \l intersects matches \l Esri::ArcGISRuntime::GeometryEngine::intersects
+  for a point and a polygon: locations inside the polygon or on its boundary intersect.
+
+  PreparedPolygon is implicitly shared and cheap to copy.
+ */
+
+/*!
+  \brief Default constructor. Creates an empty polygon which intersects nothing.
+ */
+PreparedPolygon::PreparedPolygon() :
+  d(new PreparedPolygonData())
+{
+}
+
+/*!
+  \brief Constructor taking a \a polygon geometry in any spatial reference.
+
+  If the geometry is not a polygon, the prepared polygon will be empty.
+ */
+PreparedPolygon::PreparedPolygon(const Geometry& polygon) :
+  d(new PreparedPolygonData())
+{
+  if (polygon.isEmpty() || polygon.geometryType() != GeometryType::Polygon)
+    return;
+
+  Geometry wgs84 = polygon.spatialReference() == SpatialReference::wgs84() ?
+        polygon : GeometryEngine::project(polygon, SpatialReference::wgs84());
+
+  // a simple polygon ensures the even-odd crossing rule matches the GeometryEngine's notion of interior
+  if (!GeometryEngine::isSimple(wgs84))
+    wgs84 = GeometryEngine::simplify(wgs84);
+
+  const Polygon wgs84Polygon = geometry_cast<Polygon>(wgs84);
+  const ImmutablePartCollection parts = wgs84Polygon.parts();
+  const int partCount = parts.size();
+  for (int p = 0; p < partCount; ++p)
+  {
+    const ImmutablePart part = parts.part(p);
+    const int pointCount = part.pointCount();
+    if (pointCount < 2)
+      continue;
+
+    Point previous = part.point(pointCount - 1);
+    for (int i = 0; i < pointCount; ++i)
+    {
+      const Point current = part.point(i);
+      PreparedPolygonData::Edge edge;
+      edge.x0 = previous.x();
+      edge.y0 = previous.y();
+      edge.x1 = current.x();
+      edge.y1 = current.y();
+      d->edges.append(edge);
+      previous = current;
+    }
+  }
+
+  const Envelope extent = wgs84.extent();
+  d->xMin = extent.xMin();
+  d->xMax = extent.xMax();
+  d->yMin = extent.yMin();
+  d->yMax = extent.yMax();
+  d->buildBuckets();
+}
+
+/*!
+  \brief Copy constructor.
+ */
+PreparedPolygon::PreparedPolygon(const PreparedPolygon& other) :
+  d(other.d)
+{
+}
+
+/*!
+  \brief Move constructor.
+ */
+PreparedPolygon::PreparedPolygon(PreparedPolygon&& other) :
+  d(std::move(other.d))
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+PreparedPolygon::~PreparedPolygon()
+{
+}
+
+/*!
+  \brief Assignment operator.
+ */
+PreparedPolygon& PreparedPolygon::operator=(const PreparedPolygon& other)
+{
+  if (d != other.d)
+  {
+    d = other.d;
+  }
+
+  return *this;
+}
+
+/*!
+  \brief Move operator.
+ */
+PreparedPolygon& PreparedPolygon::operator=(PreparedPolygon&& other)
+{
+  if (d != other.d)
+  {
+    d = std::move(other.d);
+  }
+
+  return *this;
+}
+
+/*!
+  \brief Returns whether this polygon has no edges.
+ */
+bool PreparedPolygon::isEmpty() const
+{
+  return d->edges.isEmpty();
+}
+
+/*!
+  \brief Returns the number of edges in the polygon.
+ */
+int PreparedPolygon::edgeCount() const
+{
+  return d->edges.size();
+}
+
+/*!
+  \brief Returns the minimum longitude of the polygon.
+ */
+double PreparedPolygon::xMin() const
+{
+  return d->xMin;
+}
+
+/*!
+  \brief Returns the maximum longitude of the polygon.
+ */
+double PreparedPolygon::xMax() const
+{
+  return d->xMax;
+}
+
+/*!
+  \brief Returns the minimum latitude of the polygon.
+ */
+double PreparedPolygon::yMin() const
+{
+  return d->yMin;
+}
+
+/*!
+  \brief Returns the maximum latitude of the polygon.
+ */
+double PreparedPolygon::yMax() const
+{
+  return d->yMax;
+}
+
+/*!
+  \brief Returns whether the \a wgs84Location is inside the polygon or on its boundary.
+
+  \note The location must be in WGS84.
+ */
+bool PreparedPolygon::intersects(const Point& wgs84Location) const
+{
+  if (wgs84Location.isEmpty())
+    return false;
+
+  return intersects(wgs84Location.x(), wgs84Location.y());
+}
+
+/*!
+  \brief Returns whether the WGS84 location (\a x, \a y) is inside the polygon or on its boundary.
+ */
+bool PreparedPolygon::intersects(double x, double y) const
+{
+  if (d->edges.isEmpty())
+    return false;
+
+  // reject anything outside of the extent of the polygon
+  if (x < d->xMin - wgs84Tolerance || x > d->xMax + wgs84Tolerance ||
+      y < d->yMin - wgs84Tolerance || y > d->yMax + wgs84Tolerance)
+  {
+    return false;
+  }
+
+  // every edge which crosses the horizontal line through y is in this bucket
+  const int bucket = d->bucketIndex(y);
+  const int* it = d->bucketEdges.constData() + d->bucketOffsets.at(bucket);
+  const int* itEnd = d->bucketEdges.constData() + d->bucketOffsets.at(bucket + 1);
+  const PreparedPolygonData::Edge* edges = d->edges.constData();
+
+  bool inside = false;
+  for (; it != itEnd; ++it)
+  {
+    const PreparedPolygonData::Edge& edge = edges[*it];
+
+    // a location on the boundary intersects the polygon
+    const double dx = edge.x1 - edge.x0;
+    const double dy = edge.y1 - edge.y0;
+    const double lengthSquared = dx * dx + dy * dy;
+    double t = lengthSquared > 0.0 ? ((x - edge.x0) * dx + (y - edge.y0) * dy) / lengthSquared : 0.0;
+    t = std::max(0.0, std::min(1.0, t));
+    const double nearestX = edge.x0 + t * dx - x;
+    const double nearestY = edge.y0 + t * dy - y;
+    if (nearestX * nearestX + nearestY * nearestY <= wgs84Tolerance * wgs84Tolerance)
+      return true;
+
+    // even-odd crossing test against a ray cast in the positive x direction
+    if ((edge.y0 > y) != (edge.y1 > y))
+    {
+      const double crossingX = edge.x0 + (y - edge.y0) * dx / dy;
+      if (x < crossingX)
+        inside = !inside;
+    }
+  }
+
+  return inside;
+}
+
+/*!
+  \internal
+ */
+PreparedPolygonData::PreparedPolygonData()
+{
+}
+
+/*!
+  \internal
+ */
+PreparedPolygonData::PreparedPolygonData(const PreparedPolygonData& other) :
+  QSharedData(other),
+  edges(other.edges),
+  bucketOffsets(other.bucketOffsets),
+  bucketEdges(other.bucketEdges),
+  bucketHeight(other.bucketHeight),
+  xMin(other.xMin),
+  xMax(other.xMax),
+  yMin(other.yMin),
+  yMax(other.yMax)
+{
+}
+
+/*!
+  \internal
+ */
+PreparedPolygonData::~PreparedPolygonData()
+{
+}
+
+/*!
+  \internal
+
+  Sort the edges into horizontal buckets. The index is stored in compressed form:
+  the edges of bucket \c i are \c bucketEdges[bucketOffsets[i]] to \c bucketEdges[bucketOffsets[i + 1]].
+ */
+void PreparedPolygonData::buildBuckets()
+{
+  const int bucketCount = std::max(1, std::min(edges.size(), maxBucketCount));
+  const double height = yMax - yMin;
+  bucketHeight = height > 0.0 ? height / bucketCount : 1.0;
+
+  // count the edges which overlap each bucket, allowing for the boundary tolerance
+  bucketOffsets.fill(0, bucketCount + 1);
+  for (const Edge& edge : edges)
+  {
+    const int first = bucketIndex(std::min(edge.y0, edge.y1) - wgs84Tolerance);
+    const int last = bucketIndex(std::max(edge.y0, edge.y1) + wgs84Tolerance);
+    for (int b = first; b <= last; ++b)
+      ++bucketOffsets[b + 1];
+  }
+
+  for (int b = 0; b < bucketCount; ++b)
+    bucketOffsets[b + 1] += bucketOffsets[b];
+
+  // fill in the edge indices for each bucket
+  bucketEdges.resize(bucketOffsets.last());
+  QVector<int> cursor = bucketOffsets;
+  for (int e = 0; e < edges.size(); ++e)
+  {
+    const Edge& edge = edges.at(e);
+    const int first = bucketIndex(std::min(edge.y0, edge.y1) - wgs84Tolerance);
+    const int last = bucketIndex(std::max(edge.y0, edge.y1) + wgs84Tolerance);
+    for (int b = first; b <= last; ++b)
+      bucketEdges[cursor[b]++] = e;
+  }
+}
+
+/*!
+  \internal
+
+  Returns the bucket spanning latitude \a y, clamped to the valid range.
+ */
+int PreparedPolygonData::bucketIndex(double y) const
+{
+  const int lastBucket = bucketOffsets.size() - 2;
+  const int index = static_cast<int>(std::floor((y - yMin) / bucketHeight));
+  return std::max(0, std::min(lastBucket, index));
+}
+
+} // Dsa
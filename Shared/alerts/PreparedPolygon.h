@@ -0,0 +1,92 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef PREPAREDPOLYGON_H
+#define PREPAREDPOLYGON_H
+
+// Qt headers
+#include <QSharedData>
+#include <QVector>
+
+namespace Esri {
+namespace ArcGISRuntime {
+class Geometry;
+class Point;
+}
+}
+
+namespace Dsa {
+
+class PreparedPolygonData;
+
+class PreparedPolygon
+{
+public:
+  PreparedPolygon();
+  explicit PreparedPolygon(const Esri::ArcGISRuntime::Geometry& polygon);
+  PreparedPolygon(const PreparedPolygon& other);
+  PreparedPolygon(PreparedPolygon&& other);
+  ~PreparedPolygon();
+
+  PreparedPolygon& operator=(const PreparedPolygon& other);
+  PreparedPolygon& operator=(PreparedPolygon&& other);
+
+  bool isEmpty() const;
+  int edgeCount() const;
+
+  double xMin() const;
+  double xMax() const;
+  double yMin() const;
+  double yMax() const;
+
+  bool intersects(const Esri::ArcGISRuntime::Point& wgs84Location) const;
+  bool intersects(double x, double y) const;
+
+private:
+  QSharedDataPointer<PreparedPolygonData> d;
+};
+
+class PreparedPolygonData : public QSharedData
+{
+public:
+  struct Edge
+  {
+    double x0 = 0.0;
+    double y0 = 0.0;
+    double x1 = 0.0;
+    double y1 = 0.0;
+  };
+
+  PreparedPolygonData();
+  PreparedPolygonData(const PreparedPolygonData& other);
+  ~PreparedPolygonData();
+
+  void buildBuckets();
+  int bucketIndex(double y) const;
+
+  QVector<Edge> edges;
+  QVector<int> bucketOffsets;
+  QVector<int> bucketEdges;
+  double bucketHeight = 0.0;
+  double xMin = 0.0;
+  double xMax = 0.0;
+  double yMin = 0.0;
+  double yMax = 0.0;
+};
+
+} // Dsa
+
+#endif // PREPAREDPOLYGON_H
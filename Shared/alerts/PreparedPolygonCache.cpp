@@ -0,0 +1,129 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "PreparedPolygonCache.h"
+
+// dsa app headers
+#include "AlertStatisticsModel.h"
+#include "GeoElementUtils.h"
+#include "GeometryProjectionCache.h"
+
+// C++ API headers
+#include "GeoElement.h"
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::PreparedPolygonCache
+  \inmodule Dsa
+  \inherits QObject
+  \brief A cache of \l PreparedPolygon objects keyed by
+  \l Esri::ArcGISRuntime::GeoElement.
+
+  Each polygon is prepared the first time it is requested and re-used until the
+  geometry version reported by the \l GeometryProjectionCache changes. Entries
+  are removed when the element is destroyed.
+ */
+
+/*!
+  \brief Constructor taking an optional \a parent.
+ */
+PreparedPolygonCache::PreparedPolygonCache(QObject* parent):
+  QObject(parent)
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+PreparedPolygonCache::~PreparedPolygonCache()
+{
+  clear();
+}
+
+/*!
+  \brief Returns the \l PreparedPolygon for the geometry of \a geoElement.
+
+  If the geometry of the element is not a polygon, an empty \l PreparedPolygon is returned.
+ */
+PreparedPolygon PreparedPolygonCache::polygon(GeoElement* geoElement)
+{
+  if (!geoElement)
+    return PreparedPolygon();
+
+  GeometryProjectionCache* projectionCache = GeometryProjectionCache::instance();
+
+  auto findIt = m_entries.find(geoElement);
+  if (findIt == m_entries.end())
+  {
+    Entry entry;
+    entry.destroyedConnection = connect(projectionCache->signaler(geoElement), &GeoElementSignaler::destroyed, this, [this, geoElement]()
+    {
+      remove(geoElement);
+    });
+
+    findIt = m_entries.insert(geoElement, entry);
+  }
+
+  // prepare the polygon again if the geometry has changed since it was last prepared
+  Entry& entry = findIt.value();
+  const quint64 geometryVersion = projectionCache->geometryVersion(geoElement);
+  const bool upToDate = entry.geometryVersion == geometryVersion;
+  AlertStatisticsModel::instance()->recordCacheLookup(AlertStatisticsModel::Cache::PreparedPolygon, upToDate);
+  if (!upToDate)
+  {
+    entry.polygon = PreparedPolygon(projectionCache->wgs84Geometry(geoElement));
+    entry.geometryVersion = geometryVersion;
+  }
+
+  return entry.polygon;
+}
+
+/*!
+  \brief Removes any cached polygon for \a geoElement.
+ */
+void PreparedPolygonCache::remove(GeoElement* geoElement)
+{
+  auto findIt = m_entries.find(geoElement);
+  if (findIt == m_entries.end())
+    return;
+
+  disconnect(findIt.value().destroyedConnection);
+  GeometryProjectionCache::instance()->release(geoElement);
+  m_entries.erase(findIt);
+}
+
+/*!
+  \brief Removes all cached polygons.
+ */
+void PreparedPolygonCache::clear()
+{
+  GeometryProjectionCache* projectionCache = GeometryProjectionCache::instance();
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    disconnect(it.value().destroyedConnection);
+    projectionCache->release(it.key());
+  }
+
+  m_entries.clear();
+}
+
+} // Dsa
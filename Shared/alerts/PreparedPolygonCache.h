@@ -0,0 +1,61 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef PREPAREDPOLYGONCACHE_H
+#define PREPAREDPOLYGONCACHE_H
+
+// dsa app headers
+#include "PreparedPolygon.h"
+
+// Qt headers
+#include <QHash>
+#include <QObject>
+
+namespace Esri {
+namespace ArcGISRuntime {
+class GeoElement;
+}
+}
+
+namespace Dsa {
+
+class PreparedPolygonCache : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit PreparedPolygonCache(QObject* parent = nullptr);
+  ~PreparedPolygonCache();
+
+  PreparedPolygon polygon(Esri::ArcGISRuntime::GeoElement* geoElement);
+
+  void remove(Esri::ArcGISRuntime::GeoElement* geoElement);
+  void clear();
+
+private:
+  struct Entry
+  {
+    QMetaObject::Connection destroyedConnection;
+    PreparedPolygon polygon;
+    quint64 geometryVersion = 0;
+  };
+
+  QHash<Esri::ArcGISRuntime::GeoElement*, Entry> m_entries;
+};
+
+} // Dsa
+
+#endif // PREPAREDPOLYGONCACHE_H
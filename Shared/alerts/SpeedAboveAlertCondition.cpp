@@ -0,0 +1,190 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "SpeedAboveAlertCondition.h"
+
+// dsa app headers
+#include "AlertConstants.h"
+#include "TrackHistory.h"
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::SpeedAboveAlertCondition
+  \inmodule Dsa
+  \inherits TrackHistoryAlertCondition
+  \brief Represents a condition which will be continuously monitored and will
+  trigger an alert when a track in a message feed has been moving faster than a
+  threshold speed for a given time.
+
+  For example, "any hostile faster than 20 m/s for 30 seconds".
+
+  The speed of each track is taken from its \l TrackHistory. The time at which each track
+  first exceeded the threshold is kept as samples are added, so each update is tested
+  without revisiting the history.
+ */
+
+/*!
+  \brief Constructor taking an \l AlertLevel (\a level) the \a name of the condition,
+  the threshold \a speed (in meters per second), the \a duration (in seconds) for which
+  it must be exceeded and an optional \a parent.
+ */
+SpeedAboveAlertCondition::SpeedAboveAlertCondition(AlertLevel level,
+                                                   const QString& name,
+                                                   double speed,
+                                                   double duration,
+                                                   QObject* parent):
+  TrackHistoryAlertCondition(level, name, parent),
+  m_speed(speed),
+  m_duration(duration)
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+SpeedAboveAlertCondition::~SpeedAboveAlertCondition()
+{
+}
+
+/*!
+  \brief Initializes the condition with a \a sourceFeed and a \a sourceDescription.
+ */
+void SpeedAboveAlertCondition::init(GraphicsOverlay* sourceFeed, const QString& sourceDescription)
+{
+  initTracks(sourceFeed, sourceDescription, QString("%1 %2").arg(QString::number(m_duration), AlertConstants::SECONDS));
+}
+
+/*!
+  \brief Returns whether \a track has been faster than the threshold speed for the duration
+  of the condition, as of its most recent sample.
+ */
+bool SpeedAboveAlertCondition::matchesTrack(Graphic* track) const
+{
+  auto it = m_aboveTracks.constFind(track);
+  return it != m_aboveTracks.constEnd() && it->m_matches;
+}
+
+/*!
+  \brief The threshold speed (in meters per second) for this condition.
+ */
+double SpeedAboveAlertCondition::speed() const
+{
+  return m_speed;
+}
+
+/*!
+  \brief The time (in seconds) for which the threshold speed must be exceeded.
+ */
+double SpeedAboveAlertCondition::duration() const
+{
+  return m_duration;
+}
+
+/*!
+  \brief Returns a map of the variable components that make up the query for this condition.
+
+  This condition type uses a query comprising the following components:
+
+  \list
+    \li meters_per_second. The threshold speed in meters per second.
+    \li seconds. The time for which the speed must be exceeded.
+  \endlist
+ */
+QVariantMap SpeedAboveAlertCondition::queryComponents() const
+{
+  QVariantMap queryMap;
+  queryMap.insert(AlertConstants::METERS_PER_SECOND, m_speed);
+  queryMap.insert(AlertConstants::SECONDS, m_duration);
+
+  return queryMap;
+}
+
+/*!
+  \brief Returns the threshold speed from the \a queryComponents, or \c -1 if there is none.
+ */
+double SpeedAboveAlertCondition::getSpeedFromQueryComponents(const QVariantMap& queryComponents)
+{
+  return queryComponents.value(AlertConstants::METERS_PER_SECOND, -1.0).toDouble();
+}
+
+/*!
+  \brief Returns the duration from the \a queryComponents, or \c -1 if there is none.
+ */
+double SpeedAboveAlertCondition::getDurationFromQueryComponents(const QVariantMap& queryComponents)
+{
+  return queryComponents.value(AlertConstants::SECONDS, -1.0).toDouble();
+}
+
+/*!
+  \brief Returns the query string component for this condition - e.g. "is faster than X meters_per_second for".
+ */
+QString SpeedAboveAlertCondition::queryString() const
+{
+  return QString("is faster than %1 %2 for").arg(QString::number(m_speed), AlertConstants::METERS_PER_SECOND);
+}
+
+/*!
+  \brief Updates the time at which \a track exceeded the threshold speed from its newest sample.
+ */
+void SpeedAboveAlertCondition::handleSampleAdded(Graphic* track)
+{
+  TrackHistory* history = trackHistory();
+  auto it = m_aboveTracks.find(track);
+
+  if (history->speed(track) <= m_speed)
+  {
+    if (it == m_aboveTracks.end())
+      return;
+
+    const bool matched = it->m_matches;
+    m_aboveTracks.erase(it);
+    if (matched)
+      emitTracksChanged(QVector<Graphic*>{track});
+
+    return;
+  }
+
+  // the speed is measured from the previous sample, so the threshold was exceeded from then
+  if (it == m_aboveTracks.end())
+  {
+    TrackState state;
+    state.m_aboveSince = history->sample(track, 1).m_timestamp;
+    it = m_aboveTracks.insert(track, state);
+  }
+
+  const bool matches = history->lastSeen(track) - it->m_aboveSince >= static_cast<qint64>(m_duration * 1000.0);
+  if (matches == it->m_matches)
+    return;
+
+  it->m_matches = matches;
+  emitTracksChanged(QVector<Graphic*>{track});
+}
+
+/*!
+  \brief Discards the state of \a track.
+ */
+void SpeedAboveAlertCondition::handleTrackRemoved(Graphic* track)
+{
+  m_aboveTracks.remove(track);
+}
+
+} // Dsa
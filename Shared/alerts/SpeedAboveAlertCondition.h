@@ -0,0 +1,73 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef SPEEDABOVEALERTCONDITION_H
+#define SPEEDABOVEALERTCONDITION_H
+
+// dsa app headers
+#include "TrackHistoryAlertCondition.h"
+
+// Qt headers
+#include <QHash>
+#include <QObject>
+
+namespace Dsa {
+
+class SpeedAboveAlertCondition : public TrackHistoryAlertCondition
+{
+  Q_OBJECT
+
+public:
+  SpeedAboveAlertCondition(AlertLevel level,
+                           const QString& name,
+                           double speed,
+                           double duration,
+                           QObject* parent = nullptr);
+
+  ~SpeedAboveAlertCondition();
+
+  void init(Esri::ArcGISRuntime::GraphicsOverlay* sourceFeed, const QString& sourceDescription);
+
+  bool matchesTrack(Esri::ArcGISRuntime::Graphic* track) const override;
+
+  QString queryString() const override;
+  QVariantMap queryComponents() const override;
+
+  double speed() const;
+  double duration() const;
+
+  static double getSpeedFromQueryComponents(const QVariantMap& queryComponents);
+  static double getDurationFromQueryComponents(const QVariantMap& queryComponents);
+
+protected:
+  void handleSampleAdded(Esri::ArcGISRuntime::Graphic* track) override;
+  void handleTrackRemoved(Esri::ArcGISRuntime::Graphic* track) override;
+
+private:
+  struct TrackState
+  {
+    qint64 m_aboveSince = 0;
+    bool m_matches = false;
+  };
+
+  double m_speed;
+  double m_duration;
+  QHash<Esri::ArcGISRuntime::Graphic*, TrackState> m_aboveTracks;
+};
+
+} // Dsa
+
+#endif // SPEEDABOVEALERTCONDITION_H
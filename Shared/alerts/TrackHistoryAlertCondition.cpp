@@ -0,0 +1,168 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "TrackHistoryAlertCondition.h"
+
+// dsa app headers
+#include "FixedValueAlertTarget.h"
+#include "GraphicsOverlaySourceStore.h"
+#include "TrackHistory.h"
+#include "TrackHistoryAlertConditionData.h"
+
+// C++ API headers
+#include "GraphicsOverlay.h"
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::TrackHistoryAlertCondition
+  \inmodule Dsa
+  \inherits AlertCondition
+  \brief Base class for conditions which are tested against the recent history of each
+  track in a message feed, rather than against its current state.
+
+  The history of the tracks is held by the \l TrackHistory of the source feed. Derived
+  conditions update any state they need as each sample is added (see \l handleSampleAdded)
+  so that \l matchesTrack can be answered without visiting the history again.
+
+  Where the result for a track changes without a change to the track itself, for example
+  because time has passed, derived conditions report it with \l emitTracksChanged.
+
+  This condition will create new \l TrackHistoryAlertConditionData for the tracks which match.
+ */
+
+/*!
+  \brief Constructor taking an \l AlertLevel (\a level) the \a name of the condition
+  and an optional \a parent.
+ */
+TrackHistoryAlertCondition::TrackHistoryAlertCondition(AlertLevel level,
+                                                       const QString& name,
+                                                       QObject* parent):
+  AlertCondition(level, name, parent)
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+TrackHistoryAlertCondition::~TrackHistoryAlertCondition()
+{
+}
+
+/*!
+  \brief Creates a new \l TrackHistoryAlertConditionData to track \a source and \a target objects.
+ */
+AlertConditionData* TrackHistoryAlertCondition::createData(AlertSource* source, AlertTarget* target)
+{
+  return new TrackHistoryAlertConditionData(newConditionDataName(), level(), source, target, this);
+}
+
+/*!
+  \brief Returns whether the track at \a row of \a sources matches the condition.
+
+  The \a target and \a candidateCount are not used.
+ */
+bool TrackHistoryAlertCondition::matchesSource(const GraphicsOverlaySourceStore* sources, int row, AlertTarget* /*target*/, int& /*candidateCount*/) const
+{
+  return matchesTrack(sources->graphic(row));
+}
+
+/*!
+  \brief Returns \c true, since derived conditions report each change with \l emitTracksChanged.
+ */
+bool TrackHistoryAlertCondition::reportsSourceChanges() const
+{
+  return true;
+}
+
+/*!
+  \fn bool TrackHistoryAlertCondition::matchesTrack(Esri::ArcGISRuntime::Graphic* track) const;
+  \brief Returns whether the history of \a track matches the condition.
+ */
+
+/*!
+  \brief Returns the history of the tracks in the source feed.
+ */
+TrackHistory* TrackHistoryAlertCondition::trackHistory() const
+{
+  return m_trackHistory;
+}
+
+/*!
+  \brief Initializes the condition with a \a sourceFeed, a \a sourceDescription and
+  a \a targetDescription.
+
+  The tracks in \a sourceFeed are tested as samples are added to their history.
+ */
+void TrackHistoryAlertCondition::initTracks(GraphicsOverlay* sourceFeed, const QString& sourceDescription, const QString& targetDescription)
+{
+  if (!sourceFeed || m_trackHistory)
+    return;
+
+  m_sources = GraphicsOverlaySourceStore::forOverlay(sourceFeed);
+  m_trackHistory = TrackHistory::forOverlay(sourceFeed);
+
+  connect(m_trackHistory, &TrackHistory::sampleAdded, this, [this](Graphic* track)
+  {
+    handleSampleAdded(track);
+  });
+
+  connect(m_trackHistory, &TrackHistory::trackRemoved, this, [this](Graphic* track)
+  {
+    handleTrackRemoved(track);
+  });
+
+  // the condition has no target, only a description of the threshold
+  AlertCondition::init(sourceFeed, sourceDescription, new FixedValueAlertTarget(QVariant(), this), targetDescription);
+}
+
+/*!
+  \fn void TrackHistoryAlertCondition::handleSampleAdded(Esri::ArcGISRuntime::Graphic* track);
+  \brief Called when a sample has been added to the history of \a track.
+ */
+
+/*!
+  \fn void TrackHistoryAlertCondition::handleTrackRemoved(Esri::ArcGISRuntime::Graphic* track);
+  \brief Called when the history of \a track has been removed.
+ */
+
+/*!
+  \brief Reports that the result of the condition has changed for \a tracks.
+ */
+void TrackHistoryAlertCondition::emitTracksChanged(const QVector<Graphic*>& tracks)
+{
+  if (!m_sources || tracks.isEmpty())
+    return;
+
+  QVector<int> rows;
+  rows.reserve(tracks.size());
+  for (Graphic* track : tracks)
+  {
+    const int row = m_sources->row(track);
+    if (row != -1)
+      rows.append(row);
+  }
+
+  if (!rows.isEmpty())
+    emit sourceRowsChanged(rows);
+}
+
+} // Dsa
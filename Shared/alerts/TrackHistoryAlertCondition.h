@@ -0,0 +1,73 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef TRACKHISTORYALERTCONDITION_H
+#define TRACKHISTORYALERTCONDITION_H
+
+// dsa app headers
+#include "AlertCondition.h"
+
+// Qt headers
+#include <QObject>
+#include <QVector>
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class Graphic;
+}
+}
+
+namespace Dsa {
+
+class TrackHistory;
+
+class TrackHistoryAlertCondition : public AlertCondition
+{
+  Q_OBJECT
+
+public:
+  TrackHistoryAlertCondition(AlertLevel level,
+                             const QString& name,
+                             QObject* parent = nullptr);
+
+  ~TrackHistoryAlertCondition();
+
+  AlertConditionData* createData(AlertSource* source, AlertTarget* target) override;
+  bool matchesSource(const GraphicsOverlaySourceStore* sources, int row, AlertTarget* target, int& candidateCount) const override;
+  bool reportsSourceChanges() const override;
+
+  virtual bool matchesTrack(Esri::ArcGISRuntime::Graphic* track) const = 0;
+
+  TrackHistory* trackHistory() const;
+
+protected:
+  void initTracks(Esri::ArcGISRuntime::GraphicsOverlay* sourceFeed, const QString& sourceDescription, const QString& targetDescription);
+
+  virtual void handleSampleAdded(Esri::ArcGISRuntime::Graphic* track) = 0;
+  virtual void handleTrackRemoved(Esri::ArcGISRuntime::Graphic* track) = 0;
+
+  void emitTracksChanged(const QVector<Esri::ArcGISRuntime::Graphic*>& tracks);
+
+private:
+  TrackHistory* m_trackHistory = nullptr;
+  GraphicsOverlaySourceStore* m_sources = nullptr;
+};
+
+} // Dsa
+
+#endif // TRACKHISTORYALERTCONDITION_H
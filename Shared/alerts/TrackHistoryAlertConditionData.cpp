@@ -0,0 +1,85 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "TrackHistoryAlertConditionData.h"
+
+// dsa app headers
+#include "GraphicAlertSource.h"
+#include "TrackHistoryAlertCondition.h"
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::TrackHistoryAlertConditionData
+  \inmodule Dsa
+  \inherits AlertConditionData
+  \brief Represents the data to be tested as part of a condition on the history of a track.
+
+  This condition data determines whether the track matches by asking its parent
+  \l TrackHistoryAlertCondition, which keeps the aggregates of the history of each track.
+ */
+
+/*!
+  \brief Constructor for a new track history condition data object.
+
+  \list
+    \li \a name. The name of the condition.
+    \li \a level. The \l AlertLevel for the condition.
+    \li \a source. The source data for the condition. This should be a \l GraphicAlertSource.
+    \li \a target. The target data for the condition.
+    \li \a parent. The parent object. This should be a \l TrackHistoryAlertCondition.
+  \endlist
+ */
+TrackHistoryAlertConditionData::TrackHistoryAlertConditionData(const QString& name,
+                                                               AlertLevel level,
+                                                               AlertSource* source,
+                                                               AlertTarget* target,
+                                                               QObject* parent):
+  AlertConditionData(name, level, source, target, parent)
+{
+
+}
+
+/*!
+  \brief Destructor.
+ */
+TrackHistoryAlertConditionData::~TrackHistoryAlertConditionData()
+{
+
+}
+
+/*!
+  \brief Returns whether the history of the source track matches the condition.
+ */
+bool TrackHistoryAlertConditionData::matchesQuery() const
+{
+  if (!isQueryOutOfDate())
+    return cachedQueryResult();
+
+  TrackHistoryAlertCondition* condition = qobject_cast<TrackHistoryAlertCondition*>(parent());
+  GraphicAlertSource* graphicSource = qobject_cast<GraphicAlertSource*>(source());
+  if (!condition || !graphicSource)
+    return false;
+
+  return condition->matchesTrack(graphicSource->graphic());
+}
+
+} // Dsa
@@ -55,9 +55,8 @@ ViewedAlertsController::ViewedAlertsController(QObject* parent /* = nullptr */):
   AlertListModel* model = AlertListModel::instance();
   if (model)
   {
-    connect(model, &AlertListModel::dataChanged, this, &ViewedAlertsController::handleDataChanged);
-    connect(model, &AlertListModel::rowsInserted, this, &ViewedAlertsController::handleDataChanged);
-    connect(model, &AlertListModel::rowsRemoved, this, &ViewedAlertsController::handleDataChanged);
+    connect(model, &AlertListModel::alertCountsChanged, this, &ViewedAlertsController::handleAlertCountsChanged);
+    m_cachedCount = model->unviewedAlertsCount();
     emit unviewedCountChanged();
   }
 
@@ -72,10 +71,9 @@ QString ViewedAlertsController::toolName() const
   return QString("viewed alerts");
 }
 
-void ViewedAlertsController::handleDataChanged()
+void ViewedAlertsController::handleAlertCountsChanged()
 {
   const int oldCount = m_cachedCount;
-  m_cachedCount = -1;
   m_cachedCount = unviewedCount();
 
   if (oldCount != m_cachedCount)
@@ -96,36 +94,11 @@ ViewedAlertsController::~ViewedAlertsController()
  */
 int ViewedAlertsController::unviewedCount() const
 {
-  if (m_cachedCount != -1)
-    return m_cachedCount;
-
   AlertListModel* model = AlertListModel::instance();
   if (!model)
     return 0;
 
-  int count = 0;
-  const int alertsCount = model->rowCount();
-  for (int i = 0; i < alertsCount; ++i)
-  {
-    AlertConditionData* alert = model->alertAt(i);
-    if (!alert)
-      continue;
-
-    if (!alert->isActive())
-      continue;
-
-    if (!alert->isConditionEnabled())
-      continue;
-
-    if (alert->viewed())
-      continue;
-
-    count++;
-  }
-
-  m_cachedCount = count;
-
-  return m_cachedCount;
+  return model->unviewedAlertsCount();
 }
 
 } // Dsa
@@ -48,10 +48,10 @@ signals:
   void unviewedCountChanged();
 
 private slots:
-  void handleDataChanged();
+  void handleAlertCountsChanged();
 
 private:
-  mutable int m_cachedCount = -1;
+  int m_cachedCount = 0;
 };
 
 } // Dsa
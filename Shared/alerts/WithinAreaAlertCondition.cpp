@@ -20,13 +20,9 @@
 #include "WithinAreaAlertCondition.h"
 
 // dsa app headers
-#include "GraphicAlertSource.h"
+#include "GraphicsOverlaySourceStore.h"
 #include "WithinAreaAlertConditionData.h"
 
-// C++ API headers
-#include "GraphicListModel.h"
-#include "GraphicsOverlay.h"
-
 using namespace Esri::ArcGISRuntime;
 
 namespace Dsa {
@@ -71,6 +67,16 @@ AlertConditionData* WithinAreaAlertCondition::createData(AlertSource* source, Al
   return new WithinAreaAlertConditionData(newConditionDataName(), level(), source, target, this);
 }
 
+/*!
+  \brief Returns whether the source at \a row of \a sources lies within the \a target object or objects.
+
+  The number of target candidates tested is returned in \a candidateCount.
+ */
+bool WithinAreaAlertCondition::matchesSource(const GraphicsOverlaySourceStore* sources, int row, AlertTarget* target, int& candidateCount) const
+{
+  return WithinAreaAlertConditionData::matchesLocation(sources->location(row), target, m_candidates, nullptr, &candidateCount);
+}
+
 /*!
   \brief Returns the query string component for this condition - e.g. "is within".
  */
@@ -19,9 +19,11 @@
 
 // dsa app headers
 #include "AlertCondition.h"
+#include "GeoElementUtils.h"
 
 // Qt headers
 #include <QObject>
+#include <QVector>
 
 namespace Dsa {
 
@@ -37,11 +39,15 @@ public:
   ~WithinAreaAlertCondition();
 
   AlertConditionData* createData(AlertSource* source, AlertTarget* target) override;
+  bool matchesSource(const GraphicsOverlaySourceStore* sources, int row, AlertTarget* target, int& candidateCount) const override;
 
   QString queryString() const override;
   QVariantMap queryComponents() const override;
 
   static QString isWithinQueryString();
+
+private:
+  mutable QVector<GeoElementCandidate> m_candidates;
 };
 
 } // Dsa
@@ -22,6 +22,7 @@
 // dsa app headers
 #include "AlertSource.h"
 #include "AlertTarget.h"
+#include "GeometryProjectionCache.h"
 
 // C++ API headers
 #include "GeoElement.h"
@@ -83,21 +84,120 @@ bool WithinAreaAlertConditionData::matchesQuery() const
   if (!isQueryOutOfDate())
     return cachedQueryResult();
 
-  Geometry sourceWgs84 = GeometryEngine::project(sourceLocation(), SpatialReference::wgs84());
-  const QList<Geometry> targetGeometries = target()->targetGeometries(sourceWgs84.extent());
+  // the candidate buffer is re-used between queries to avoid allocating for each update
+  GeoElement* matchedElement = nullptr;
+  int candidateCount = 0;
+  const bool matches = matchesLocation(sourceLocation(), target(), m_candidates, &matchedElement, &candidateCount);
 
-  for (const Geometry& target : targetGeometries)
+  setCandidateCount(candidateCount);
+  if (matches)
   {
-    if (target.geometryType() != GeometryType::Polygon)
-      continue;
+    setMatchedElement(matchedElement);
+    return true;
+  }
+
+  return matchesHysteresis();
+}
+
+/*!
+  \brief Returns whether \a location lies within the \a target object or objects.
+
+  \a candidates is used as a buffer for the target candidates. If the match is with a target element,
+  it is returned in \a matchedElement. The number of candidates tested is returned in \a candidateCount.
+  Both of these may be \c nullptr.
+ */
+bool WithinAreaAlertConditionData::matchesLocation(const Point& location,
+                                                   AlertTarget* target,
+                                                   QVector<GeoElementCandidate>& candidates,
+                                                   GeoElement** matchedElement,
+                                                   int* candidateCount)
+{
+  if (!target)
+    return false;
 
-    const Geometry targetWgs84 = GeometryEngine::project(target, sourceWgs84.spatialReference());
-    if (GeometryEngine::instance()->intersects(sourceWgs84, targetWgs84))
+  const Point sourceWgs84 = GeometryProjectionCache::projectToWgs84(location);
+
+  candidates.clear();
+  if (target->targetCandidates(sourceWgs84.extent(), candidates))
+  {
+    if (candidateCount)
+      *candidateCount = candidates.size();
+
+    // the target polygons are cached in WGS84 and indexed for fast location tests
+    for (const GeoElementCandidate& candidate : qAsConst(candidates))
+    {
+      if (sourceWgs84.x() < candidate.xMin || sourceWgs84.x() > candidate.xMax ||
+          sourceWgs84.y() < candidate.yMin || sourceWgs84.y() > candidate.yMax)
+      {
+        continue;
+      }
+
+      if (target->targetPolygon(candidate.geoElement).intersects(sourceWgs84))
+      {
+        if (matchedElement)
+          *matchedElement = candidate.geoElement;
+
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // targets which are not made up of elements only provide geometries
+  const QList<Geometry> targetGeometries = target->targetGeometries(sourceWgs84.extent());
+  if (candidateCount)
+    *candidateCount = targetGeometries.size();
+
+  for (const Geometry& targetGeometry : targetGeometries)
+  {
+    if (PreparedPolygon(targetGeometry).intersects(sourceWgs84))
       return true;
   }
 
   return false;
 }
 
+/*!
+  \internal
+
+  Returns whether an active condition should remain active because the source lies
+  within the hysteresis margin of the target object or objects.
+ */
+bool WithinAreaAlertConditionData::matchesHysteresis() const
+{
+  if (!wasActive() || hysteresis() <= 0.0)
+    return false;
+
+  // buffer the source position by the margin and test it against the target geometry
+  const Geometry bufferGeom = GeometryEngine::bufferGeodetic(sourceLocation(), hysteresis(), LinearUnit::meters(), 1.0,
+                                                             GeodeticCurveType::Geodesic);
+  const Geometry bufferWgs84 = GeometryProjectionCache::projectToWgs84(bufferGeom);
+
+  m_candidates.clear();
+  if (target()->targetCandidates(bufferWgs84.extent(), m_candidates))
+  {
+    GeometryProjectionCache* projectionCache = GeometryProjectionCache::instance();
+    for (const GeoElementCandidate& candidate : qAsConst(m_candidates))
+    {
+      if (GeometryEngine::intersects(bufferWgs84, projectionCache->wgs84Geometry(candidate.geoElement)))
+      {
+        setMatchedElement(candidate.geoElement);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  const QList<Geometry> targetGeometries = target()->targetGeometries(bufferWgs84.extent());
+  for (const Geometry& targetGeometry : targetGeometries)
+  {
+    if (GeometryEngine::intersects(bufferWgs84, GeometryProjectionCache::projectToWgs84(targetGeometry)))
+      return true;
+  }
+
+  return false;
+}
 
 } // Dsa
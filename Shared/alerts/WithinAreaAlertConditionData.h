@@ -19,6 +19,10 @@
 
 // dsa app headers
 #include "AlertConditionData.h"
+#include "GeoElementUtils.h"
+
+// Qt headers
+#include <QVector>
 
 namespace Esri
 {
@@ -45,6 +49,17 @@ public:
   ~WithinAreaAlertConditionData();
 
   bool matchesQuery() const override;
+
+  static bool matchesLocation(const Esri::ArcGISRuntime::Point& location,
+                              AlertTarget* target,
+                              QVector<GeoElementCandidate>& candidates,
+                              Esri::ArcGISRuntime::GeoElement** matchedElement,
+                              int* candidateCount);
+
+private:
+  bool matchesHysteresis() const;
+
+  mutable QVector<GeoElementCandidate> m_candidates;
 };
 
 } // Dsa
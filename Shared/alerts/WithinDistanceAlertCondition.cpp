@@ -21,6 +21,7 @@
 
 // dsa app headers
 #include "AlertConstants.h"
+#include "GraphicsOverlaySourceStore.h"
 #include "WithinDistanceAlertConditionData.h"
 
 using namespace Esri::ArcGISRuntime;
@@ -69,6 +70,17 @@ AlertConditionData* WithinDistanceAlertCondition::createData(AlertSource* source
   return new WithinDistanceAlertConditionData(newConditionDataName(), level(), source, target, m_distance, this);
 }
 
+/*!
+  \brief Returns whether the source at \a row of \a sources lies within the threshold distance of
+  the \a target object or objects.
+
+  The number of target candidates tested is returned in \a candidateCount.
+ */
+bool WithinDistanceAlertCondition::matchesSource(const GraphicsOverlaySourceStore* sources, int row, AlertTarget* target, int& candidateCount) const
+{
+  return WithinDistanceAlertConditionData::matchesLocation(sources->location(row), m_distance, target, m_candidates, nullptr, &candidateCount);
+}
+
 /*!
   \brief The threshold distance (in meters) for this condition.
  */
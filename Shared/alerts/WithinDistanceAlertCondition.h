@@ -19,9 +19,11 @@
 
 // dsa app headers
 #include "AlertCondition.h"
+#include "GeoElementUtils.h"
 
 // Qt headers
 #include <QObject>
+#include <QVector>
 
 namespace Dsa {
 
@@ -39,6 +41,7 @@ public:
   ~WithinDistanceAlertCondition();
 
   AlertConditionData* createData(AlertSource* source, AlertTarget* target) override;
+  bool matchesSource(const GraphicsOverlaySourceStore* sources, int row, AlertTarget* target, int& candidateCount) const override;
 
   QString queryString() const override;
   QVariantMap queryComponents() const override;
@@ -49,6 +52,7 @@ public:
 
 private:
   double m_distance;
+  mutable QVector<GeoElementCandidate> m_candidates;
 };
 
 } // Dsa
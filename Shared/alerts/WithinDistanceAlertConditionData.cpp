@@ -22,6 +22,7 @@
 // dsa app headers
 #include "AlertSource.h"
 #include "AlertTarget.h"
+#include "GeometryProjectionCache.h"
 
 // C++ API headers
 #include "GeoElement.h"
@@ -67,8 +68,7 @@ WithinDistanceAlertConditionData::WithinDistanceAlertConditionData(const QString
                                                                    double distance,
                                                                    QObject* parent):
   AlertConditionData(name, level, source, target, parent),
-  m_distance(distance),
-  m_moveDistance(std::sqrt((m_distance * m_distance) + (m_distance * m_distance)))
+  m_distance(distance)
 {
 
 }
@@ -98,32 +98,93 @@ bool WithinDistanceAlertConditionData::matchesQuery() const
   if (!isQueryOutOfDate())
     return cachedQueryResult();
 
+  // once active, the source may move up to the hysteresis margin beyond the distance before the query stops matching
+  const double queryDistance = wasActive() ? distance() + hysteresis() : distance();
+
+  // the candidate buffer is re-used between queries to avoid allocating for each update
+  GeoElement* matchedElement = nullptr;
+  int candidateCount = 0;
+  const bool matches = matchesLocation(sourceLocation(), queryDistance, target(), m_candidates, &matchedElement, &candidateCount);
+
+  setCandidateCount(candidateCount);
+  setMatchedElement(matchedElement);
+
+  return matches;
+}
+
+/*!
+  \brief Returns whether \a location lies within \a distance meters of the \a target object or objects.
+
+  \a candidates is used as a buffer for the target candidates. If the match is with a target element,
+  it is returned in \a matchedElement. The number of candidates tested is returned in \a candidateCount.
+  Both of these may be \c nullptr.
+ */
+bool WithinDistanceAlertConditionData::matchesLocation(const Point& location,
+                                                       double distance,
+                                                       AlertTarget* target,
+                                                       QVector<GeoElementCandidate>& candidates,
+                                                       GeoElement** matchedElement,
+                                                       int* candidateCount)
+{
+  if (!target)
+    return false;
+
   // get 2 new points by moving the source position in a NE and SW position
-  // m_moveDistance is the hypotenuse of the triangle with opposite and adjacent of distance
-  const QList<Point> southWest = GeometryEngine::moveGeodetic(QList<Point>{sourceLocation()}, m_moveDistance,
+  // moveDistance is the hypotenuse of the triangle with opposite and adjacent of distance
+  const double moveDistance = std::sqrt((distance * distance) + (distance * distance));
+  const QList<Point> southWest = GeometryEngine::moveGeodetic(QList<Point>{location}, moveDistance,
                                                               LinearUnit::meters(), 225.0, AngularUnit::degrees(),
                                                               GeodeticCurveType::Geodesic);
-  const QList<Point> northEast = GeometryEngine::moveGeodetic(QList<Point>{sourceLocation()}, m_moveDistance,
+  const QList<Point> northEast = GeometryEngine::moveGeodetic(QList<Point>{location}, moveDistance,
                                                               LinearUnit::meters(), 45.0, AngularUnit::degrees(),
                                                               GeodeticCurveType::Geodesic);
 
-  // form an Envelope from these 2 extreme points and check for target geometrties within this extent
+  // form an Envelope from these 2 extreme points and check for target elements within this extent
   const Envelope distanceExtent(southWest.first(), northEast.first());
-  const QList<Geometry> targetGeometries = target()->targetGeometries(distanceExtent);
 
-  // if there are no target geometries within the distance extent, stop
-  if (targetGeometries.isEmpty())
+  candidates.clear();
+  const bool hasCandidates = target->targetCandidates(distanceExtent, candidates);
+
+  // targets which are not made up of elements only provide geometries
+  const QList<Geometry> targetGeometries = hasCandidates ? QList<Geometry>()
+                                                         : target->targetGeometries(distanceExtent);
+
+  if (candidateCount)
+    *candidateCount = candidates.size() + targetGeometries.size();
+
+  // if there are no targets within the distance extent, stop
+  if (candidates.isEmpty() && targetGeometries.isEmpty())
     return false;
 
   // buffer the source position by the distance for an accurate within distance test
-  const Geometry bufferGeom = GeometryEngine::bufferGeodetic(sourceLocation(), distance(), LinearUnit::meters(), 1.0,
+  const Geometry bufferGeom = GeometryEngine::bufferGeodetic(location, distance, LinearUnit::meters(), 1.0,
                                                              GeodeticCurveType::Geodesic);
-  const Geometry bufferWgs84 = GeometryEngine::project(bufferGeom, SpatialReference::wgs84());
+  const Geometry bufferWgs84 = GeometryProjectionCache::projectToWgs84(bufferGeom);
+  const Envelope bufferExtent = bufferWgs84.extent();
+
+  // test the buffer against the cached WGS84 geometry of each candidate element
+  GeometryProjectionCache* projectionCache = GeometryProjectionCache::instance();
+  for (const GeoElementCandidate& candidate : qAsConst(candidates))
+  {
+    if (candidate.xMin > bufferExtent.xMax() || candidate.xMax < bufferExtent.xMin() ||
+        candidate.yMin > bufferExtent.yMax() || candidate.yMax < bufferExtent.yMin())
+    {
+      continue;
+    }
 
-  // test the buffer against all the target geometries
-  for (const Geometry& target : targetGeometries)
+    if (GeometryEngine::intersects(bufferWgs84, projectionCache->wgs84Geometry(candidate.geoElement)))
+    {
+      if (matchedElement)
+        *matchedElement = candidate.geoElement;
+
+      return true;
+    }
+  }
+
+  // test the buffer against all the target geometries (which are generally already in WGS84)
+  for (const Geometry& targetGeometry : targetGeometries)
   {
-    Geometry targetWgs84 = GeometryEngine::project(target, SpatialReference::wgs84());
+    const Geometry targetWgs84 = GeometryProjectionCache::projectToWgs84(targetGeometry);
     if (GeometryEngine::intersects(bufferWgs84, targetWgs84))
       return true;
   }
@@ -131,5 +192,4 @@ bool WithinDistanceAlertConditionData::matchesQuery() const
   return false;
 }
 
-
 } // Dsa
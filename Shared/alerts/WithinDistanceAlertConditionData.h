@@ -19,10 +19,14 @@
 
 // dsa app headers
 #include "AlertConditionData.h"
+#include "GeoElementUtils.h"
 
 // C++ API headers
 #include "Geometry.h"
 
+// Qt headers
+#include <QVector>
+
 namespace Dsa {
 
 class WithinDistanceAlertConditionData : public AlertConditionData
@@ -42,9 +46,16 @@ public:
 
   bool matchesQuery() const override;
 
+  static bool matchesLocation(const Esri::ArcGISRuntime::Point& location,
+                              double distance,
+                              AlertTarget* target,
+                              QVector<GeoElementCandidate>& candidates,
+                              Esri::ArcGISRuntime::GeoElement** matchedElement,
+                              int* candidateCount);
+
 private:
   double m_distance = 0.0;
-  double m_moveDistance = 0.0;
+  mutable QVector<GeoElementCandidate> m_candidates;
 };
 
 } // Dsa
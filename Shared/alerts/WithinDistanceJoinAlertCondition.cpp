@@ -0,0 +1,177 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "WithinDistanceJoinAlertCondition.h"
+
+// dsa app headers
+#include "AlertConstants.h"
+#include "DistanceJoinAlertTarget.h"
+#include "GraphicsOverlaySourceStore.h"
+#include "WithinDistanceJoinAlertConditionData.h"
+
+// C++ API headers
+#include "GraphicsOverlay.h"
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::WithinDistanceJoinAlertCondition
+  \inmodule Dsa
+  \inherits AlertCondition
+  \brief Represents a spatial condition which will be continuously monitored and will
+  trigger an alert when a graphic of a source feed is within a threshold distance of any
+  graphic of a target feed.
+
+  For example, "any friendly within 500 m of any hostile".
+
+  Rather than testing each source graphic against the target separately, as a
+  \l WithinDistanceAlertCondition does, this condition joins both feeds in a single pass
+  with a \l DistanceJoinAlertTarget. Each source is then tested by looking up the result
+  of the join.
+
+  This condition will create new \l WithinDistanceJoinAlertConditionData for the source
+  graphics which match.
+  */
+
+/*!
+  \brief Constructor taking an \l AlertLevel (\a level) the \a name of the condition,
+  the threshold \a distance (in meters) and an optional \a parent.
+ */
+WithinDistanceJoinAlertCondition::WithinDistanceJoinAlertCondition(AlertLevel level,
+                                                                   const QString& name,
+                                                                   double distance,
+                                                                   QObject* parent):
+  AlertCondition(level, name, parent),
+  m_distance(distance)
+{
+  // the join must also find targets within the hysteresis margin of active sources
+  connect(this, &WithinDistanceJoinAlertCondition::conditionChanged, this, &WithinDistanceJoinAlertCondition::updateJoinRadius);
+}
+
+/*!
+  \brief Destructor.
+ */
+WithinDistanceJoinAlertCondition::~WithinDistanceJoinAlertCondition()
+{
+
+}
+
+/*!
+  \brief Initializes the condition with a \a sourceFeed, \a sourceDescription, a \a targetFeed
+  and a \a targetDescription.
+
+  The two feeds are joined by a new \l DistanceJoinAlertTarget and each graphic in the source
+  feed is tested against the results of the join.
+ */
+void WithinDistanceJoinAlertCondition::init(GraphicsOverlay* sourceFeed, const QString& sourceDescription,
+                                            GraphicsOverlay* targetFeed, const QString& targetDescription)
+{
+  if (!sourceFeed || !targetFeed || m_joinTarget)
+    return;
+
+  GraphicsOverlaySourceStore* sources = GraphicsOverlaySourceStore::forOverlay(sourceFeed);
+  GraphicsOverlaySourceStore* targets = GraphicsOverlaySourceStore::forOverlay(targetFeed);
+  if (!sources || !targets)
+    return;
+
+  m_joinTarget = new DistanceJoinAlertTarget(sources, targets, m_distance + hysteresis(), this);
+  AlertCondition::init(sourceFeed, sourceDescription, m_joinTarget, targetDescription);
+}
+
+/*!
+  \brief Creates a new \l WithinDistanceJoinAlertConditionData to track \a source and \a target objects.
+ */
+AlertConditionData* WithinDistanceJoinAlertCondition::createData(AlertSource* source, AlertTarget* target)
+{
+  return new WithinDistanceJoinAlertConditionData(newConditionDataName(), level(), source, target, m_distance, this);
+}
+
+/*!
+  \brief Returns whether the last join found a target within the threshold distance of the
+  source at \a row of \a sources.
+
+  The number of targets found within the join radius is returned in \a candidateCount.
+ */
+bool WithinDistanceJoinAlertCondition::matchesSource(const GraphicsOverlaySourceStore* sources, int row, AlertTarget* target, int& candidateCount) const
+{
+  DistanceJoinAlertTarget* joinTarget = qobject_cast<DistanceJoinAlertTarget*>(target);
+  if (!joinTarget)
+    return false;
+
+  Graphic* graphic = sources->graphic(row);
+  candidateCount = joinTarget->matchCount(graphic);
+
+  return joinTarget->nearestDistance(graphic) <= m_distance;
+}
+
+/*!
+  \brief The threshold distance (in meters) for this condition.
+ */
+double WithinDistanceJoinAlertCondition::distance() const
+{
+  return m_distance;
+}
+
+/*!
+  \brief Returns the target which joins the source and target feeds.
+ */
+DistanceJoinAlertTarget* WithinDistanceJoinAlertCondition::joinTarget() const
+{
+  return m_joinTarget;
+}
+
+/*!
+  \brief Returns a map of the variable components that make up the query for this condition.
+
+  This condition type uses a query comprising the following components:
+
+  \list
+    \li distance. The threshold distance in meters.
+  \endlist
+ */
+QVariantMap WithinDistanceJoinAlertCondition::queryComponents() const
+{
+  QVariantMap queryMap;
+  queryMap.insert(AlertConstants::METERS, m_distance);
+
+  return queryMap;
+}
+
+/*!
+  \brief Returns the query string component for this condition - e.g. "is within X meters of any of".
+ */
+QString WithinDistanceJoinAlertCondition::queryString() const
+{
+  return QString("is within %1 %2 of any of").arg(QString::number(m_distance), AlertConstants::METERS);
+}
+
+/*!
+  \internal
+
+  Set the radius of the join to cover the threshold distance and the hysteresis margin.
+ */
+void WithinDistanceJoinAlertCondition::updateJoinRadius()
+{
+  if (m_joinTarget)
+    m_joinTarget->setRadius(m_distance + hysteresis());
+}
+
+} // Dsa
@@ -0,0 +1,64 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef WITHINDISTANCEJOINALERTCONDITION_H
+#define WITHINDISTANCEJOINALERTCONDITION_H
+
+// dsa app headers
+#include "AlertCondition.h"
+
+// Qt headers
+#include <QObject>
+
+namespace Dsa {
+
+class DistanceJoinAlertTarget;
+
+class WithinDistanceJoinAlertCondition : public AlertCondition
+{
+  Q_OBJECT
+
+public:
+  WithinDistanceJoinAlertCondition(AlertLevel level,
+                                   const QString& name,
+                                   double distance,
+                                   QObject* parent = nullptr);
+
+  ~WithinDistanceJoinAlertCondition();
+
+  void init(Esri::ArcGISRuntime::GraphicsOverlay* sourceFeed, const QString& sourceDescription,
+            Esri::ArcGISRuntime::GraphicsOverlay* targetFeed, const QString& targetDescription);
+
+  AlertConditionData* createData(AlertSource* source, AlertTarget* target) override;
+  bool matchesSource(const GraphicsOverlaySourceStore* sources, int row, AlertTarget* target, int& candidateCount) const override;
+
+  QString queryString() const override;
+  QVariantMap queryComponents() const override;
+
+  double distance() const;
+
+  DistanceJoinAlertTarget* joinTarget() const;
+
+private:
+  void updateJoinRadius();
+
+  double m_distance;
+  DistanceJoinAlertTarget* m_joinTarget = nullptr;
+};
+
+} // Dsa
+
+#endif // WITHINDISTANCEJOINALERTCONDITION_H
@@ -0,0 +1,108 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "WithinDistanceJoinAlertConditionData.h"
+
+// dsa app headers
+#include "DistanceJoinAlertTarget.h"
+#include "GraphicAlertSource.h"
+
+// C++ API headers
+#include "Graphic.h"
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::WithinDistanceJoinAlertConditionData
+  \inmodule Dsa
+  \inherits AlertConditionData
+  \brief Represents the data to be tested as part of a spatial join, within distance condition.
+
+  This condition data determines whether a source graphic is within a threshold distance of
+  any target graphic by looking up the result of the last join by its \l DistanceJoinAlertTarget.
+ */
+
+/*!
+  \brief Constructor for a new within distance join condition data object.
+
+  \list
+    \li \a name. The name of the condition.
+    \li \a level. The \l AlertLevel for the condition.
+    \li \a source. The source data for the condition. This should be a \l GraphicAlertSource.
+    \li \a target. The target data for the condition. This should be a \l DistanceJoinAlertTarget.
+    \li \a distance. The threshold distance in meters.
+    \li \a parent. The (optional) parent object.
+  \endlist
+ */
+WithinDistanceJoinAlertConditionData::WithinDistanceJoinAlertConditionData(const QString& name,
+                                                                           AlertLevel level,
+                                                                           AlertSource* source,
+                                                                           AlertTarget* target,
+                                                                           double distance,
+                                                                           QObject* parent):
+  AlertConditionData(name, level, source, target, parent),
+  m_distance(distance)
+{
+
+}
+
+/*!
+  \brief Destructor.
+ */
+WithinDistanceJoinAlertConditionData::~WithinDistanceJoinAlertConditionData()
+{
+
+}
+
+/*!
+  \brief Returns the threshold distance in meters.
+ */
+double WithinDistanceJoinAlertConditionData::distance() const
+{
+  return m_distance;
+}
+
+/*!
+  \brief Returns whether the last join found a target within the threshold distance of the source.
+ */
+bool WithinDistanceJoinAlertConditionData::matchesQuery() const
+{
+  if (!isQueryOutOfDate())
+    return cachedQueryResult();
+
+  DistanceJoinAlertTarget* joinTarget = qobject_cast<DistanceJoinAlertTarget*>(target());
+  GraphicAlertSource* graphicSource = qobject_cast<GraphicAlertSource*>(source());
+  if (!joinTarget || !graphicSource)
+    return false;
+
+  // once active, the source may move up to the hysteresis margin beyond the distance before the query stops matching
+  const double queryDistance = wasActive() ? distance() + hysteresis() : distance();
+
+  Graphic* graphic = graphicSource->graphic();
+  setCandidateCount(joinTarget->matchCount(graphic));
+  if (joinTarget->nearestDistance(graphic) > queryDistance)
+    return false;
+
+  setMatchedElement(joinTarget->nearestTarget(graphic));
+  return true;
+}
+
+} // Dsa
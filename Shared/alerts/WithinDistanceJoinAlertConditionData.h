@@ -0,0 +1,48 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef WITHINDISTANCEJOINALERTCONDITIONDATA_H
+#define WITHINDISTANCEJOINALERTCONDITIONDATA_H
+
+// dsa app headers
+#include "AlertConditionData.h"
+
+namespace Dsa {
+
+class WithinDistanceJoinAlertConditionData : public AlertConditionData
+{
+  Q_OBJECT
+
+public:
+  WithinDistanceJoinAlertConditionData(const QString& name,
+                                       AlertLevel level,
+                                       AlertSource* source,
+                                       AlertTarget* target,
+                                       double distance,
+                                       QObject* parent = nullptr);
+  ~WithinDistanceJoinAlertConditionData();
+
+  double distance() const;
+
+  bool matchesQuery() const override;
+
+private:
+  double m_distance = 0.0;
+};
+
+} // Dsa
+
+#endif // WITHINDISTANCEJOINALERTCONDITIONDATA_H
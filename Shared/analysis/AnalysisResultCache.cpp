@@ -0,0 +1,850 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "AnalysisResultCache.h"
+
+// dsa app headers
+#include "ElevationSampler.h"
+#include "LineOfSightEngine.h"
+#include "TerrainProfileEngine.h"
+#include "ViewshedEngine.h"
+
+// Qt headers
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QThreadPool>
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace Dsa {
+
+namespace
+{
+// changing the way any result is computed or stored must increase the version, so
+// that results from older versions of the app are no longer found
+constexpr int cacheVersion = 1;
+
+// values in the key are rounded to this many decimal places before they are compared
+constexpr double keyPrecision = 1e7;
+
+const QString viewshedKind = QStringLiteral("viewshed");
+const QString profileKind = QStringLiteral("profile");
+const QString intervisibilityKind = QStringLiteral("intervisibility");
+
+// TIFF tags and field types used for the viewshed rasters
+enum TiffTag : quint16
+{
+  ImageWidth = 256,
+  ImageLength = 257,
+  BitsPerSample = 258,
+  Compression = 259,
+  PhotometricInterpretation = 262,
+  StripOffsets = 273,
+  SamplesPerPixel = 277,
+  RowsPerStrip = 278,
+  StripByteCounts = 279,
+  PlanarConfiguration = 284,
+  SampleFormat = 339,
+  ModelPixelScale = 33550,
+  ModelTiepoint = 33922,
+  GeoKeyDirectory = 34735,
+  GdalNoData = 42113
+};
+
+enum TiffType : quint16
+{
+  Ascii = 2,
+  Short = 3,
+  Long = 4,
+  Double = 12
+};
+
+struct TiffEntry
+{
+  quint16 m_type = 0;
+  quint32 m_count = 0;
+  quint32 m_value = 0;
+};
+
+/*!
+  \internal
+
+  Writes an IFD entry for \a tag whose \a count values of \a type fit in the entry as \a value.
+ */
+void writeEntry(QDataStream& stream, quint16 tag, quint16 type, quint32 count, quint32 value)
+{
+  stream << tag << type << count;
+  if (type == Short && count == 1)
+    stream << static_cast<quint16>(value) << static_cast<quint16>(0);
+  else
+    stream << value;
+}
+
+/*!
+  \internal
+
+  Returns \a raster as a single band, 8 bit GeoTIFF in WGS84, with \c 255 as no data.
+ */
+QByteArray viewshedTiff(const ViewshedRaster& raster)
+{
+  constexpr quint16 entryCount = 15;
+  constexpr quint16 geoKeyCount = 16;
+  constexpr quint32 ifdOffset = 8;
+  constexpr quint32 scaleOffset = ifdOffset + 2 + entryCount * 12 + 4;
+  constexpr quint32 tiepointOffset = scaleOffset + 3 * 8;
+  constexpr quint32 geoKeysOffset = tiepointOffset + 6 * 8;
+  constexpr quint32 pixelsOffset = geoKeysOffset + geoKeyCount * 2;
+
+  const quint32 pixelCount = static_cast<quint32>(raster.m_values.size());
+
+  QByteArray data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+  stream.writeRawData("II", 2);
+  stream << static_cast<quint16>(42) << ifdOffset;
+
+  // the entries must be in ascending order of tag
+  stream << entryCount;
+  writeEntry(stream, ImageWidth, Long, 1, static_cast<quint32>(raster.m_columns));
+  writeEntry(stream, ImageLength, Long, 1, static_cast<quint32>(raster.m_rows));
+  writeEntry(stream, BitsPerSample, Short, 1, 8);
+  writeEntry(stream, Compression, Short, 1, 1);
+  writeEntry(stream, PhotometricInterpretation, Short, 1, 1);
+  writeEntry(stream, StripOffsets, Long, 1, pixelsOffset);
+  writeEntry(stream, SamplesPerPixel, Short, 1, 1);
+  writeEntry(stream, RowsPerStrip, Long, 1, static_cast<quint32>(raster.m_rows));
+  writeEntry(stream, StripByteCounts, Long, 1, pixelCount);
+  writeEntry(stream, PlanarConfiguration, Short, 1, 1);
+  writeEntry(stream, SampleFormat, Short, 1, 1);
+  writeEntry(stream, ModelPixelScale, Double, 3, scaleOffset);
+  writeEntry(stream, ModelTiepoint, Double, 6, tiepointOffset);
+  writeEntry(stream, GeoKeyDirectory, Short, geoKeyCount, geoKeysOffset);
+  stream << static_cast<quint16>(GdalNoData) << static_cast<quint16>(Ascii) << static_cast<quint32>(4);
+  stream.writeRawData("255", 4);
+  stream << static_cast<quint32>(0);
+
+  // the raster origin is the center of the north west cell, the tie point is its corner
+  stream << raster.m_cellSizeX << raster.m_cellSizeY << 0.0;
+  stream << 0.0 << 0.0 << 0.0
+         << raster.m_originX - raster.m_cellSizeX * 0.5 << raster.m_originY + raster.m_cellSizeY * 0.5 << 0.0;
+
+  // geographic WGS84 (4326), with each value covering the area of its cell
+  const quint16 geoKeys[geoKeyCount] = { 1, 1, 0, 3,
+                                         1024, 0, 1, 2,
+                                         1025, 0, 1, 1,
+                                         2048, 0, 1, 4326 };
+  for (quint16 geoKey : geoKeys)
+    stream << geoKey;
+
+  stream.writeRawData(reinterpret_cast<const char*>(raster.m_values.constData()), static_cast<int>(pixelCount));
+  return data;
+}
+
+/*!
+  \internal
+
+  Reads a viewshed raster written by \c viewshedTiff from \a data into \a raster.
+ */
+bool readViewshedTiff(const QByteArray& data, ViewshedRaster& raster)
+{
+  if (data.size() < 8 || !data.startsWith("II"))
+    return false;
+
+  QDataStream stream(data);
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+  stream.skipRawData(2);
+
+  quint16 magic = 0;
+  quint32 ifdOffset = 0;
+  stream >> magic >> ifdOffset;
+  if (magic != 42 || ifdOffset >= static_cast<quint32>(data.size()))
+    return false;
+
+  stream.device()->seek(ifdOffset);
+  quint16 entryCount = 0;
+  stream >> entryCount;
+
+  QHash<quint16, TiffEntry> entries;
+  for (int i = 0; i < entryCount; ++i)
+  {
+    quint16 tag = 0;
+    TiffEntry entry;
+    stream >> tag >> entry.m_type >> entry.m_count;
+    if (entry.m_type == Short && entry.m_count == 1)
+    {
+      quint16 value = 0;
+      quint16 padding = 0;
+      stream >> value >> padding;
+      entry.m_value = value;
+    }
+    else
+    {
+      stream >> entry.m_value;
+    }
+
+    entries.insert(tag, entry);
+  }
+
+  if (stream.status() != QDataStream::Ok)
+    return false;
+
+  auto value = [&entries](quint16 tag) { return entries.value(tag).m_value; };
+  if (value(BitsPerSample) != 8 || value(Compression) != 1 || value(SamplesPerPixel) != 1 ||
+      entries.value(StripOffsets).m_count != 1 ||
+      entries.value(ModelPixelScale).m_count != 3 || entries.value(ModelTiepoint).m_count != 6)
+  {
+    return false;
+  }
+
+  const qint64 columns = value(ImageWidth);
+  const qint64 rows = value(ImageLength);
+  const qint64 pixelsOffset = value(StripOffsets);
+  if (columns <= 0 || rows <= 0 || pixelsOffset + columns * rows > data.size())
+    return false;
+
+  double scale[3];
+  stream.device()->seek(value(ModelPixelScale));
+  stream >> scale[0] >> scale[1] >> scale[2];
+
+  double tiepoint[6];
+  stream.device()->seek(value(ModelTiepoint));
+  for (double& tiepointValue : tiepoint)
+    stream >> tiepointValue;
+
+  if (stream.status() != QDataStream::Ok)
+    return false;
+
+  raster.m_columns = static_cast<int>(columns);
+  raster.m_rows = static_cast<int>(rows);
+  raster.m_cellSizeX = scale[0];
+  raster.m_cellSizeY = scale[1];
+  raster.m_originX = tiepoint[3] + scale[0] * 0.5;
+  raster.m_originY = tiepoint[4] - scale[1] * 0.5;
+
+  const int pixelCount = static_cast<int>(columns * rows);
+  raster.m_values.resize(pixelCount);
+  std::copy(data.constData() + pixelsOffset, data.constData() + pixelsOffset + pixelCount,
+            reinterpret_cast<char*>(raster.m_values.data()));
+  return true;
+}
+
+/*!
+  \internal
+
+  Returns \a values as a JSON array, with \c null for values which are not numbers.
+ */
+QJsonArray toJsonArray(const QVector<double>& values)
+{
+  QJsonArray array;
+  for (double value : values)
+    array.append(std::isfinite(value) ? QJsonValue(value) : QJsonValue());
+
+  return array;
+}
+
+/*!
+  \internal
+
+  Returns the numbers in \a array, with \c NAN for any \c null.
+ */
+QVector<double> fromJsonArray(const QJsonArray& array)
+{
+  QVector<double> values;
+  values.reserve(array.size());
+  for (const QJsonValue& value : array)
+    values.append(value.toDouble(std::numeric_limits<double>::quiet_NaN()));
+
+  return values;
+}
+
+/*!
+  \internal
+
+  Returns the contents of the file at \a path, or an empty array if it cannot be read.
+ */
+QByteArray readFile(const QString& path)
+{
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+    return QByteArray();
+
+  return file.readAll();
+}
+
+/*!
+  \internal
+
+  Writes a result on a thread of the cache's pool.
+ */
+class ResultWrite : public QRunnable
+{
+public:
+  explicit ResultWrite(const std::function<void()>& write):
+    m_write(write)
+  {
+  }
+
+  void run() override
+  {
+    m_write();
+  }
+
+private:
+  std::function<void()> m_write;
+};
+}
+
+/*!
+  \class Dsa::AnalysisResultCache
+  \inmodule Dsa
+  \inherits QObject
+  \brief A cache on disk of the results of analyses computed on the CPU.
+
+  Each result is stored under a key made by \l resultKey from the kind of analysis, the
+  values it was computed from, such as the observer, the parameters and the engine settings,
+  and a fingerprint of the local raster elevation. The same analysis is then found again after
+  the app restarts, instead of being recomputed, while changing any parameter or elevation
+  source gives a different key.
+
+  Results are stored in \l directory in formats which can be used outside of the app:
+
+  \list
+    \li Viewsheds are 8 bit GeoTIFFs in WGS84, with \c 1 for visible cells, \c 0 for cells
+        which are not visible and \c 255 for no data. They can be added to the scene as
+        raster layers.
+    \li Terrain profiles and intervisibility matrices are JSON.
+  \endlist
+
+  When the files exceed \l maximumSize, the least recently used are removed. The size and
+  last use of each file are kept in memory, from a single scan of the directory, so storing a
+  result does not list the directory. Files are written on a background thread, one at a time;
+  until a file is written the result is found from memory.
+
+  The cache is configured by the \l LayerCacheManager and can be used from any thread.
+
+  \sa ViewshedEngine, TerrainProfileEngine
+ */
+
+/*!
+  \brief Returns the instance of the cache.
+ */
+AnalysisResultCache* AnalysisResultCache::instance()
+{
+  static AnalysisResultCache s_instance;
+
+  return &s_instance;
+}
+
+/*!
+  \internal
+ */
+AnalysisResultCache::AnalysisResultCache(QObject* parent):
+  QObject(parent),
+  m_writePool(new QThreadPool(this))
+{
+  m_writePool->setMaxThreadCount(1);
+
+  // the cache outlives the application object, so its thread is stopped while the application still exists
+  if (QCoreApplication::instance())
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &AnalysisResultCache::shutDown);
+}
+
+/*!
+  \brief Destructor.
+
+  Waits for the results which are still being written.
+ */
+AnalysisResultCache::~AnalysisResultCache()
+{
+  shutDown();
+}
+
+/*!
+  \brief Returns the directory where results are stored.
+
+  Results are not cached until the directory has been set.
+ */
+QString AnalysisResultCache::directory() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_directory;
+}
+
+/*!
+  \brief Sets the directory where results are stored to \a directory, creating it if needed.
+ */
+void AnalysisResultCache::setDirectory(const QString& directory)
+{
+  if (!directory.isEmpty() && !QDir().mkpath(directory))
+    return;
+
+  QMutexLocker locker(&m_mutex);
+  if (directory == m_directory)
+    return;
+
+  m_directory = directory;
+  resetEntries();
+}
+
+/*!
+  \brief Returns the largest total size in bytes of the stored results.
+
+  The default is 256 MB. A size of \c 0 or less does not limit the cache.
+ */
+qint64 AnalysisResultCache::maximumSize() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_maximumSize;
+}
+
+/*!
+  \brief Sets the largest total size in bytes of the stored results to \a maximumSize.
+ */
+void AnalysisResultCache::setMaximumSize(qint64 maximumSize)
+{
+  QMutexLocker locker(&m_mutex);
+  m_maximumSize = maximumSize;
+  prune();
+}
+
+/*!
+  \brief Returns the key for a result of \a kind computed from \a values over the elevation of \a sampler.
+
+  The values are rounded to 7 decimal places, so that a result is found for an observer
+  which has been stored and reloaded. The elevation is identified by the path, size and
+  modification time of each raster, rather than its contents, so that the key is quick to make.
+ */
+QString AnalysisResultCache::resultKey(const QString& kind, const QVector<double>& values, const ElevationSampler& sampler)
+{
+  QByteArray keyData;
+  QDataStream stream(&keyData, QIODevice::WriteOnly);
+  stream << cacheVersion << kind << values.size();
+  for (double value : values)
+  {
+    const bool finite = std::isfinite(value);
+    stream << finite << (finite ? static_cast<qint64>(std::llround(value * keyPrecision)) : Q_INT64_C(0));
+  }
+
+  QStringList paths = sampler.paths();
+  std::sort(paths.begin(), paths.end());
+  for (const QString& path : qAsConst(paths))
+  {
+    const QFileInfo fileInfo(path);
+    stream << fileInfo.absoluteFilePath() << fileInfo.size() << fileInfo.lastModified().toMSecsSinceEpoch();
+  }
+
+  return QString::fromLatin1(QCryptographicHash::hash(keyData, QCryptographicHash::Sha1).toHex());
+}
+
+/*!
+  \brief Reads the viewshed stored with \a key into \a raster.
+
+  Returns \c false if there is no such viewshed.
+ */
+bool AnalysisResultCache::findViewshed(const QString& key, ViewshedRaster& raster) const
+{
+  const QString path = filePath(viewshedKind, key, QStringLiteral("tif"));
+  if (path.isEmpty())
+    return false;
+
+  ViewshedRaster cached;
+  if (!readViewshedTiff(read(path), cached))
+    return false;
+
+  raster = cached;
+  return true;
+}
+
+/*!
+  \brief Stores \a raster with \a key as a GeoTIFF.
+
+  The file is written on a background thread. Returns the path of the file, or an empty
+  string if there is no \l directory.
+ */
+QString AnalysisResultCache::insertViewshed(const QString& key, const ViewshedRaster& raster)
+{
+  if (!raster.isValid())
+    return QString();
+
+  return write(filePath(viewshedKind, key, QStringLiteral("tif")), viewshedTiff(raster));
+}
+
+/*!
+  \brief Reads the terrain profile stored with \a key into \a profile.
+
+  Returns \c false if there is no such profile.
+ */
+bool AnalysisResultCache::findProfile(const QString& key, TerrainProfile& profile) const
+{
+  const QString path = filePath(profileKind, key, QStringLiteral("json"));
+  if (path.isEmpty())
+    return false;
+
+  const QJsonObject json = QJsonDocument::fromJson(read(path)).object();
+  if (json.isEmpty())
+    return false;
+
+  TerrainProfile cached;
+  cached.m_x = fromJsonArray(json.value(QStringLiteral("x")).toArray());
+  cached.m_y = fromJsonArray(json.value(QStringLiteral("y")).toArray());
+  cached.m_distances = fromJsonArray(json.value(QStringLiteral("distances")).toArray());
+  cached.m_elevations = fromJsonArray(json.value(QStringLiteral("elevations")).toArray());
+
+  const int size = cached.m_x.size();
+  if (cached.m_y.size() != size || cached.m_distances.size() != size || cached.m_elevations.size() != size)
+    return false;
+
+  profile = cached;
+  return true;
+}
+
+/*!
+  \brief Stores \a profile with \a key as JSON.
+
+  The file is written on a background thread. Returns the path of the file, or an empty
+  string if there is no \l directory.
+ */
+QString AnalysisResultCache::insertProfile(const QString& key, const TerrainProfile& profile)
+{
+  QJsonObject json;
+  json.insert(QStringLiteral("x"), toJsonArray(profile.m_x));
+  json.insert(QStringLiteral("y"), toJsonArray(profile.m_y));
+  json.insert(QStringLiteral("distances"), toJsonArray(profile.m_distances));
+  json.insert(QStringLiteral("elevations"), toJsonArray(profile.m_elevations));
+
+  return write(filePath(profileKind, key, QStringLiteral("json")), QJsonDocument(json).toJson(QJsonDocument::Compact));
+}
+
+/*!
+  \brief Reads the intervisibility matrix of \a pointCount points stored with \a key into \a results.
+
+  Returns \c false if there is no such matrix.
+ */
+bool AnalysisResultCache::findIntervisibility(const QString& key, int pointCount, QVector<LineOfSightVisibility>& results) const
+{
+  const QString path = filePath(intervisibilityKind, key, QStringLiteral("json"));
+  if (path.isEmpty())
+    return false;
+
+  const QJsonArray json = QJsonDocument::fromJson(read(path)).array();
+  if (json.size() != pointCount * pointCount)
+    return false;
+
+  QVector<LineOfSightVisibility> cached;
+  cached.reserve(json.size());
+  for (const QJsonValue& value : json)
+  {
+    const int visibility = value.toInt(-1);
+    if (visibility < static_cast<int>(LineOfSightVisibility::Visible) || visibility > static_cast<int>(LineOfSightVisibility::Unknown))
+      return false;
+
+    cached.append(static_cast<LineOfSightVisibility>(visibility));
+  }
+
+  results = cached;
+  return true;
+}
+
+/*!
+  \brief Stores the intervisibility matrix \a results with \a key as JSON.
+
+  The file is written on a background thread. Returns the path of the file, or an empty
+  string if there is no \l directory.
+ */
+QString AnalysisResultCache::insertIntervisibility(const QString& key, const QVector<LineOfSightVisibility>& results)
+{
+  QJsonArray json;
+  for (LineOfSightVisibility visibility : results)
+    json.append(static_cast<int>(visibility));
+
+  return write(filePath(intervisibilityKind, key, QStringLiteral("json")), QJsonDocument(json).toJson(QJsonDocument::Compact));
+}
+
+/*!
+  \brief Removes all of the stored results.
+ */
+void AnalysisResultCache::clear()
+{
+  // results waiting to be written are dropped, and the one being written is finished first
+  QThreadPool* writePool = nullptr;
+  {
+    QMutexLocker locker(&m_mutex);
+    writePool = m_writePool;
+  }
+
+  if (writePool)
+  {
+    writePool->clear();
+    writePool->waitForDone();
+  }
+
+  QMutexLocker locker(&m_mutex);
+  m_pendingWrites.clear();
+  if (m_directory.isEmpty())
+    return;
+
+  QDir directory(m_directory);
+  const QStringList files = directory.entryList(QStringList{QStringLiteral("*-*.tif"), QStringLiteral("*-*.json")}, QDir::Files);
+  for (const QString& file : files)
+    directory.remove(file);
+
+  resetEntries();
+}
+
+/*!
+  \internal
+
+  Returns the path of the result of \a kind with \a key, or an empty string if there is no directory.
+ */
+QString AnalysisResultCache::filePath(const QString& kind, const QString& key, const QString& suffix) const
+{
+  QMutexLocker locker(&m_mutex);
+  if (m_directory.isEmpty() || key.isEmpty())
+    return QString();
+
+  return QStringLiteral("%1/%2-%3.%4").arg(m_directory, kind, key, suffix);
+}
+
+/*!
+  \internal
+
+  Returns the contents of the result at \a path, or an empty array if there is none, and
+  marks it as the most recently used.
+
+  A result which is still waiting to be written is returned from memory.
+ */
+QByteArray AnalysisResultCache::read(const QString& path) const
+{
+  {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_pendingWrites.constFind(path);
+    if (it != m_pendingWrites.constEnd())
+      return it.value();
+  }
+
+  const QByteArray data = readFile(path);
+  if (!data.isEmpty())
+  {
+    QMutexLocker locker(&m_mutex);
+    loadEntries();
+    useEntry(QFileInfo(path).fileName());
+  }
+
+  return data;
+}
+
+/*!
+  \internal
+
+  Queues \a data to be written to \a path on the write pool.
+
+  Once the pool has been shut down, the data is written straight away instead.
+ */
+QString AnalysisResultCache::write(const QString& path, const QByteArray& data)
+{
+  if (path.isEmpty())
+    return QString();
+
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_writePool)
+    {
+      m_pendingWrites.insert(path, data);
+      m_writePool->start(new ResultWrite([this, path, data]()
+      {
+        writeFile(path, data);
+      }));
+
+      return path;
+    }
+  }
+
+  writeFile(path, data);
+  return path;
+}
+
+/*!
+  \internal
+
+  Waits for the results which are still being written and deletes the write pool, when
+  the application is about to quit or the cache is destroyed.
+ */
+void AnalysisResultCache::shutDown()
+{
+  QThreadPool* writePool = nullptr;
+  {
+    QMutexLocker locker(&m_mutex);
+    writePool = m_writePool;
+    m_writePool = nullptr;
+  }
+
+  if (!writePool)
+    return;
+
+  writePool->waitForDone();
+  delete writePool;
+}
+
+/*!
+  \internal
+
+  Writes \a data to \a path, replacing any file there in one step so that a partly
+  written result is never read, then removes the least recently used results if the
+  cache is too large.
+ */
+void AnalysisResultCache::writeFile(const QString& path, const QByteArray& data)
+{
+  QSaveFile file(path);
+  const bool written = file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit();
+
+  QMutexLocker locker(&m_mutex);
+
+  // a newer result for the same path may be waiting to be written
+  auto it = m_pendingWrites.find(path);
+  if (it != m_pendingWrites.end() && it.value().constData() == data.constData())
+    m_pendingWrites.erase(it);
+
+  // the directory may have changed while the file was written
+  const QFileInfo fileInfo(path);
+  if (!written || m_directory.isEmpty() || fileInfo.absolutePath() != QFileInfo(m_directory).absoluteFilePath())
+    return;
+
+  loadEntries();
+  addEntry(fileInfo.fileName(), data.size());
+  prune();
+}
+
+/*!
+  \internal
+
+  Reads the size of each result in the directory, ordering them by modification time, if
+  this has not been done since the directory was set. The mutex must be locked.
+ */
+void AnalysisResultCache::loadEntries() const
+{
+  if (m_entriesLoaded || m_directory.isEmpty())
+    return;
+
+  m_entriesLoaded = true;
+  const QDir directory(m_directory);
+  const QFileInfoList files = directory.entryInfoList(QStringList{QStringLiteral("*-*.tif"), QStringLiteral("*-*.json")},
+                                                      QDir::Files, QDir::Time | QDir::Reversed);
+  for (const QFileInfo& file : files)
+    addEntry(file.fileName(), file.size());
+}
+
+/*!
+  \internal
+
+  Records the result \a fileName of \a size bytes as the most recently used, replacing any
+  earlier record of it. The mutex must be locked.
+ */
+void AnalysisResultCache::addEntry(const QString& fileName, qint64 size) const
+{
+  auto it = m_entries.find(fileName);
+  if (it != m_entries.end())
+  {
+    m_totalSize -= it.value().m_size;
+    m_entriesByUse.erase(it.value().m_lastUse);
+  }
+
+  Entry entry;
+  entry.m_size = size;
+  entry.m_lastUse = ++m_lastUse;
+  m_entries.insert(fileName, entry);
+  m_entriesByUse.emplace(entry.m_lastUse, fileName);
+  m_totalSize += size;
+}
+
+/*!
+  \internal
+
+  Marks the result \a fileName as the most recently used. The mutex must be locked.
+ */
+void AnalysisResultCache::useEntry(const QString& fileName) const
+{
+  auto it = m_entries.find(fileName);
+  if (it == m_entries.end())
+    return;
+
+  m_entriesByUse.erase(it.value().m_lastUse);
+  it.value().m_lastUse = ++m_lastUse;
+  m_entriesByUse.emplace(it.value().m_lastUse, fileName);
+}
+
+/*!
+  \internal
+
+  Forgets the recorded results, so that the directory is read again when they are next
+  needed. The mutex must be locked.
+ */
+void AnalysisResultCache::resetEntries()
+{
+  m_entries.clear();
+  m_entriesByUse.clear();
+  m_totalSize = 0;
+  m_entriesLoaded = false;
+}
+
+/*!
+  \internal
+
+  Removes the least recently used results until the total size is no larger than the
+  maximum. The mutex must be locked.
+ */
+void AnalysisResultCache::prune()
+{
+  if (m_directory.isEmpty() || m_maximumSize <= 0)
+    return;
+
+  loadEntries();
+
+  QDir directory(m_directory);
+  while (m_totalSize > m_maximumSize && !m_entriesByUse.empty())
+  {
+    auto oldest = m_entriesByUse.begin();
+    const QString fileName = oldest->second;
+    directory.remove(fileName);
+
+    m_totalSize -= m_entries.value(fileName).m_size;
+    m_entries.remove(fileName);
+    m_entriesByUse.erase(oldest);
+  }
+}
+
+} // Dsa
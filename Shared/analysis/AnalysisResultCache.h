@@ -0,0 +1,106 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef ANALYSISRESULTCACHE_H
+#define ANALYSISRESULTCACHE_H
+
+// Qt headers
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+
+// STL headers
+#include <map>
+
+class QThreadPool;
+
+namespace Dsa {
+
+class ElevationSampler;
+struct TerrainProfile;
+struct ViewshedRaster;
+enum class LineOfSightVisibility;
+
+class AnalysisResultCache : public QObject
+{
+  Q_OBJECT
+
+public:
+  static AnalysisResultCache* instance();
+
+  ~AnalysisResultCache();
+
+  QString directory() const;
+  void setDirectory(const QString& directory);
+
+  qint64 maximumSize() const;
+  void setMaximumSize(qint64 maximumSize);
+
+  static QString resultKey(const QString& kind, const QVector<double>& values, const ElevationSampler& sampler);
+
+  bool findViewshed(const QString& key, ViewshedRaster& raster) const;
+  QString insertViewshed(const QString& key, const ViewshedRaster& raster);
+
+  bool findProfile(const QString& key, TerrainProfile& profile) const;
+  QString insertProfile(const QString& key, const TerrainProfile& profile);
+
+  bool findIntervisibility(const QString& key, int pointCount, QVector<LineOfSightVisibility>& results) const;
+  QString insertIntervisibility(const QString& key, const QVector<LineOfSightVisibility>& results);
+
+  void clear();
+
+private slots:
+  void shutDown();
+
+private:
+  struct Entry
+  {
+    qint64 m_size = 0;
+    quint64 m_lastUse = 0;
+  };
+
+  explicit AnalysisResultCache(QObject* parent = nullptr);
+
+  QString filePath(const QString& kind, const QString& key, const QString& suffix) const;
+  QByteArray read(const QString& path) const;
+  QString write(const QString& path, const QByteArray& data);
+  void writeFile(const QString& path, const QByteArray& data);
+  void loadEntries() const;
+  void addEntry(const QString& fileName, qint64 size) const;
+  void useEntry(const QString& fileName) const;
+  void resetEntries();
+  void prune();
+
+  mutable QMutex m_mutex;
+  QString m_directory;
+  qint64 m_maximumSize = 256 * 1024 * 1024;
+
+  // results are written one at a time on a background thread, and found in memory until then
+  QThreadPool* m_writePool = nullptr;
+  QHash<QString, QByteArray> m_pendingWrites;
+
+  // the stored results by file name, with their total size and the order in which they were used
+  mutable QHash<QString, Entry> m_entries;
+  mutable std::map<quint64, QString> m_entriesByUse;
+  mutable quint64 m_lastUse = 0;
+  mutable qint64 m_totalSize = 0;
+  mutable bool m_entriesLoaded = false;
+};
+
+} // Dsa
+
+#endif // ANALYSISRESULTCACHE_H
@@ -0,0 +1,169 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "AnalysisUpdateThrottle.h"
+
+// Qt headers
+#include <QTimer>
+
+// STL headers
+#include <algorithm>
+
+namespace Dsa {
+
+/*!
+  \class Dsa::AnalysisUpdateThrottle
+  \inmodule Dsa
+  \inherits QObject
+  \brief Limits how often interactive changes are applied to an analysis.
+
+  Each change to an analysis, such as moving a viewshed, makes the Runtime recompute it.
+  While the user drags the analysis or a slider, changes arrive far faster than they can
+  be drawn, so the throttle applies them at no more than \l updateRate times per second.
+
+  Changes are passed to \l schedule with a key. While \l interactive, a change is applied at
+  once if the last update was long enough ago, otherwise it waits for the next update; a
+  later change with the same key replaces it, so intermediate positions are skipped. When
+  the interaction ends, anything still waiting is applied straight away so the analysis
+  always finishes on the final values. Outside an interaction, changes are applied at once.
+ */
+
+/*!
+  \brief Constructor taking an optional \a parent.
+ */
+AnalysisUpdateThrottle::AnalysisUpdateThrottle(QObject* parent /* = nullptr */):
+  QObject(parent),
+  m_timer(new QTimer(this))
+{
+  m_timer->setSingleShot(true);
+  connect(m_timer, &QTimer::timeout, this, &AnalysisUpdateThrottle::flush);
+}
+
+/*!
+  \brief Destructor.
+ */
+AnalysisUpdateThrottle::~AnalysisUpdateThrottle()
+{
+}
+
+/*!
+  \brief Returns the most updates applied per second during an interaction.
+
+  The default is \c 20.
+ */
+int AnalysisUpdateThrottle::updateRate() const
+{
+  return m_updateRate;
+}
+
+/*!
+  \brief Sets the most updates applied per second during an interaction to \a updateRate.
+
+  A rate of \c 0 or less applies every change at once.
+ */
+void AnalysisUpdateThrottle::setUpdateRate(int updateRate)
+{
+  m_updateRate = updateRate;
+}
+
+/*!
+  \brief Returns whether the user is interacting with the analysis.
+ */
+bool AnalysisUpdateThrottle::isInteractive() const
+{
+  return m_interactive;
+}
+
+/*!
+  \brief Sets whether the user is interacting with the analysis to \a interactive.
+
+  When the interaction ends, any waiting changes are applied.
+ */
+void AnalysisUpdateThrottle::setInteractive(bool interactive)
+{
+  if (m_interactive == interactive)
+    return;
+
+  m_interactive = interactive;
+
+  if (!m_interactive)
+    flush();
+}
+
+/*!
+  \brief Schedules \a update to be applied, replacing any waiting update with the same \a key.
+ */
+void AnalysisUpdateThrottle::schedule(int key, const std::function<void()>& update)
+{
+  m_pending.insert(key, update);
+
+  if (!m_interactive || m_updateRate <= 0)
+  {
+    flush();
+    return;
+  }
+
+  const qint64 interval = 1000 / m_updateRate;
+  const qint64 elapsed = m_sinceLastUpdate.isValid() ? m_sinceLastUpdate.elapsed() : interval;
+  if (elapsed >= interval)
+  {
+    flush();
+    return;
+  }
+
+  if (!m_timer->isActive())
+    m_timer->start(static_cast<int>(std::max<qint64>(1, interval - elapsed)));
+}
+
+/*!
+  \brief Returns whether an update with \a key is waiting to be applied.
+ */
+bool AnalysisUpdateThrottle::isPending(int key) const
+{
+  return m_pending.contains(key);
+}
+
+/*!
+  \brief Applies all waiting updates now.
+ */
+void AnalysisUpdateThrottle::flush()
+{
+  m_timer->stop();
+  if (m_pending.isEmpty())
+    return;
+
+  m_sinceLastUpdate.start();
+
+  // take the waiting updates first, so that any changes they schedule are kept
+  QMap<int, std::function<void()>> pending;
+  pending.swap(m_pending);
+  for (const auto& update : pending)
+    update();
+}
+
+/*!
+  \brief Discards all waiting updates.
+ */
+void AnalysisUpdateThrottle::cancel()
+{
+  m_timer->stop();
+  m_pending.clear();
+}
+
+} // Dsa
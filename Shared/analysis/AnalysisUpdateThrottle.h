@@ -0,0 +1,61 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef ANALYSISUPDATETHROTTLE_H
+#define ANALYSISUPDATETHROTTLE_H
+
+// Qt headers
+#include <QElapsedTimer>
+#include <QMap>
+#include <QObject>
+
+// STL headers
+#include <functional>
+
+class QTimer;
+
+namespace Dsa {
+
+class AnalysisUpdateThrottle : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit AnalysisUpdateThrottle(QObject* parent = nullptr);
+  ~AnalysisUpdateThrottle();
+
+  int updateRate() const;
+  void setUpdateRate(int updateRate);
+
+  bool isInteractive() const;
+  void setInteractive(bool interactive);
+
+  void schedule(int key, const std::function<void()>& update);
+  bool isPending(int key) const;
+  void flush();
+  void cancel();
+
+private:
+  QTimer* m_timer = nullptr;
+  QElapsedTimer m_sinceLastUpdate;
+  QMap<int, std::function<void()>> m_pending;
+  int m_updateRate = 20;
+  bool m_interactive = false;
+};
+
+} // Dsa
+
+#endif // ANALYSISUPDATETHROTTLE_H
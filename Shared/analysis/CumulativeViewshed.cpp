@@ -0,0 +1,385 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "CumulativeViewshed.h"
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+
+namespace Dsa {
+
+/*!
+  \class Dsa::CumulativeViewshed
+  \inmodule Dsa
+  \brief Counts, for each cell, how many of a set of observers can see it.
+
+  Each observer is computed by a \l ViewshedEngine and its visible cells are resampled onto
+  a lattice shared by all of the observers, whose cell size is set by the first observer.
+  The viewsheds may also be computed elsewhere, for example on a background thread, and
+  passed to \l setObserver as rasters.
+  The visible cells of each observer are kept, so when an observer moves or changes only
+  its own contribution is recomputed: the old cells are subtracted from the counts and the
+  new cells are added.
+
+  The counts cover the union of the observers' fields of view: they grow as observers are
+  added and are cropped when an observer moves away or is removed.
+
+  \sa ViewshedController
+ */
+
+/*!
+  \brief Constructor taking the \a sampler for the surface.
+ */
+CumulativeViewshed::CumulativeViewshed(const QSharedPointer<const ElevationSampler>& sampler):
+  m_engine(sampler)
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+CumulativeViewshed::~CumulativeViewshed()
+{
+}
+
+/*!
+  \brief Returns the engine used to compute each observer.
+ */
+ViewshedEngine& CumulativeViewshed::engine()
+{
+  return m_engine;
+}
+
+/*!
+  \brief Adds the observer \a id described by \a parameters, or recomputes it if it exists.
+
+  Returns \c false, and removes the observer, if its viewshed cannot be computed.
+ */
+bool CumulativeViewshed::setObserver(int id, const ViewshedParameters& parameters)
+{
+  return setObserver(id, m_engine.compute(parameters));
+}
+
+/*!
+  \brief Adds the observer \a id whose viewshed is \a raster, or replaces it if it exists.
+
+  Returns \c false, and removes the observer, if \a raster is invalid.
+ */
+bool CumulativeViewshed::setObserver(int id, const ViewshedRaster& raster)
+{
+  if (!raster.isValid())
+  {
+    removeObserver(id);
+    return false;
+  }
+
+  // the first observer sets the lattice
+  if (m_contributions.isEmpty() && m_counts.isEmpty())
+  {
+    m_cellSizeX = raster.m_cellSizeX;
+    m_cellSizeY = raster.m_cellSizeY;
+  }
+
+  Contribution contribution = resample(raster);
+
+  auto it = m_contributions.find(id);
+  if (it != m_contributions.end())
+    apply(it.value(), -1);
+
+  m_contributions.insert(id, contribution);
+  fitToContributions();
+  apply(contribution, 1);
+  return true;
+}
+
+/*!
+  \brief Removes the observer \a id, subtracting its visible cells from the counts.
+
+  Returns \c false if there is no such observer.
+ */
+bool CumulativeViewshed::removeObserver(int id)
+{
+  auto it = m_contributions.find(id);
+  if (it == m_contributions.end())
+    return false;
+
+  apply(it.value(), -1);
+  m_contributions.erase(it);
+
+  if (m_contributions.isEmpty())
+    clear();
+  else
+    fitToContributions();
+
+  return true;
+}
+
+/*!
+  \brief Returns whether there is an observer \a id.
+ */
+bool CumulativeViewshed::containsObserver(int id) const
+{
+  return m_contributions.contains(id);
+}
+
+/*!
+  \brief Returns the number of observers.
+ */
+int CumulativeViewshed::observerCount() const
+{
+  return m_contributions.size();
+}
+
+/*!
+  \brief Removes all of the observers.
+ */
+void CumulativeViewshed::clear()
+{
+  m_contributions.clear();
+  m_counts.clear();
+  m_firstColumn = 0;
+  m_firstRow = 0;
+  m_columns = 0;
+  m_rows = 0;
+}
+
+/*!
+  \brief Returns the number of columns of counts.
+ */
+int CumulativeViewshed::columns() const
+{
+  return m_columns;
+}
+
+/*!
+  \brief Returns the number of rows of counts.
+ */
+int CumulativeViewshed::rows() const
+{
+  return m_rows;
+}
+
+/*!
+  \brief Returns the longitude of the center of the north west cell.
+ */
+double CumulativeViewshed::originX() const
+{
+  return m_firstColumn * m_cellSizeX;
+}
+
+/*!
+  \brief Returns the latitude of the center of the north west cell.
+ */
+double CumulativeViewshed::originY() const
+{
+  return -m_firstRow * m_cellSizeY;
+}
+
+/*!
+  \brief Returns the width of the cells in degrees of longitude.
+ */
+double CumulativeViewshed::cellSizeX() const
+{
+  return m_cellSizeX;
+}
+
+/*!
+  \brief Returns the height of the cells in degrees of latitude.
+ */
+double CumulativeViewshed::cellSizeY() const
+{
+  return m_cellSizeY;
+}
+
+/*!
+  \brief Returns the number of observers which can see the cell at \a column and \a row,
+  where row \c 0 is the northernmost.
+ */
+int CumulativeViewshed::count(int column, int row) const
+{
+  if (column < 0 || row < 0 || column >= m_columns || row >= m_rows)
+    return 0;
+
+  return m_counts.at(row * m_columns + column);
+}
+
+/*!
+  \brief Returns the number of observers which can see the WGS84 location \a x, \a y.
+ */
+int CumulativeViewshed::countAt(double x, double y) const
+{
+  if (m_counts.isEmpty())
+    return 0;
+
+  const int column = static_cast<int>(std::lround(x / m_cellSizeX)) - m_firstColumn;
+  const int row = static_cast<int>(std::lround(-y / m_cellSizeY)) - m_firstRow;
+  return count(column, row);
+}
+
+/*!
+  \brief Returns the largest number of observers which can see any one cell.
+ */
+int CumulativeViewshed::maxCount() const
+{
+  if (m_counts.isEmpty())
+    return 0;
+
+  return *std::max_element(m_counts.cbegin(), m_counts.cend());
+}
+
+/*!
+  \brief Returns a summary of the counts, where item \c n is the number of cells which
+  can be seen by exactly \c n observers.
+
+  Item \c 0 counts the cells within the counted area which no observer can see.
+ */
+QVector<int> CumulativeViewshed::histogram() const
+{
+  QVector<int> histogram(maxCount() + 1, 0);
+  for (quint16 count : m_counts)
+    ++histogram[count];
+
+  return histogram;
+}
+
+/*!
+  \internal
+
+  Returns the visible cells of \a raster resampled, by nearest cell, onto the lattice.
+ */
+CumulativeViewshed::Contribution CumulativeViewshed::resample(const ViewshedRaster& raster) const
+{
+  const double xMin = raster.m_originX;
+  const double xMax = raster.m_originX + (raster.m_columns - 1) * raster.m_cellSizeX;
+  const double yMax = raster.m_originY;
+  const double yMin = raster.m_originY - (raster.m_rows - 1) * raster.m_cellSizeY;
+
+  Contribution contribution;
+  contribution.m_firstColumn = static_cast<int>(std::floor(xMin / m_cellSizeX));
+  contribution.m_firstRow = static_cast<int>(std::floor(-yMax / m_cellSizeY));
+  contribution.m_columns = static_cast<int>(std::ceil(xMax / m_cellSizeX)) - contribution.m_firstColumn + 1;
+  contribution.m_rows = static_cast<int>(std::ceil(-yMin / m_cellSizeY)) - contribution.m_firstRow + 1;
+  contribution.m_visible.fill(0, contribution.m_columns * contribution.m_rows);
+
+  quint8* visible = contribution.m_visible.data();
+  for (int row = 0; row < contribution.m_rows; ++row)
+  {
+    const double y = -(contribution.m_firstRow + row) * m_cellSizeY;
+    const int rasterRow = static_cast<int>(std::lround((raster.m_originY - y) / raster.m_cellSizeY));
+    for (int column = 0; column < contribution.m_columns; ++column)
+    {
+      const double x = (contribution.m_firstColumn + column) * m_cellSizeX;
+      const int rasterColumn = static_cast<int>(std::lround((x - raster.m_originX) / raster.m_cellSizeX));
+      if (raster.value(rasterColumn, rasterRow) == ViewshedRaster::Visible)
+        visible[row * contribution.m_columns + column] = 1;
+    }
+  }
+
+  return contribution;
+}
+
+/*!
+  \internal
+
+  Fit the counts to the union of the windows of the contributions, keeping the existing counts.
+
+  Cells outside every window have a count of \c 0, so none are lost when the counts shrink.
+ */
+void CumulativeViewshed::fitToContributions()
+{
+  if (m_contributions.isEmpty())
+    return;
+
+  auto it = m_contributions.cbegin();
+  int firstColumn = it->m_firstColumn;
+  int firstRow = it->m_firstRow;
+  int lastColumn = it->m_firstColumn + it->m_columns;
+  int lastRow = it->m_firstRow + it->m_rows;
+  for (++it; it != m_contributions.cend(); ++it)
+  {
+    firstColumn = std::min(firstColumn, it->m_firstColumn);
+    firstRow = std::min(firstRow, it->m_firstRow);
+    lastColumn = std::max(lastColumn, it->m_firstColumn + it->m_columns);
+    lastRow = std::max(lastRow, it->m_firstRow + it->m_rows);
+  }
+
+  setWindow(firstColumn, firstRow, lastColumn - firstColumn, lastRow - firstRow);
+}
+
+/*!
+  \internal
+
+  Move the counts to the window of \a columns by \a rows cells from \a firstColumn and
+  \a firstRow, keeping the counts where the old and new windows overlap.
+ */
+void CumulativeViewshed::setWindow(int firstColumn, int firstRow, int columns, int rows)
+{
+  if (!m_counts.isEmpty() && firstColumn == m_firstColumn && firstRow == m_firstRow &&
+      columns == m_columns && rows == m_rows)
+  {
+    return;
+  }
+
+  QVector<quint16> counts(columns * rows, 0);
+  const int overlapFirstColumn = std::max(firstColumn, m_firstColumn);
+  const int overlapLastColumn = std::min(firstColumn + columns, m_firstColumn + m_columns);
+  const int overlapFirstRow = std::max(firstRow, m_firstRow);
+  const int overlapLastRow = std::min(firstRow + rows, m_firstRow + m_rows);
+  if (!m_counts.isEmpty() && overlapFirstColumn < overlapLastColumn)
+  {
+    for (int row = overlapFirstRow; row < overlapLastRow; ++row)
+    {
+      const auto source = m_counts.cbegin() + (row - m_firstRow) * m_columns + (overlapFirstColumn - m_firstColumn);
+      std::copy(source, source + (overlapLastColumn - overlapFirstColumn),
+                counts.begin() + (row - firstRow) * columns + (overlapFirstColumn - firstColumn));
+    }
+  }
+
+  m_firstColumn = firstColumn;
+  m_firstRow = firstRow;
+  m_columns = columns;
+  m_rows = rows;
+  m_counts = counts;
+}
+
+/*!
+  \internal
+
+  Add \a delta to the count of each visible cell of \a contribution.
+ */
+void CumulativeViewshed::apply(const Contribution& contribution, int delta)
+{
+  const int columnOffset = contribution.m_firstColumn - m_firstColumn;
+  const int rowOffset = contribution.m_firstRow - m_firstRow;
+  const quint8* visible = contribution.m_visible.constData();
+  quint16* counts = m_counts.data();
+  for (int row = 0; row < contribution.m_rows; ++row)
+  {
+    quint16* countsRow = counts + (row + rowOffset) * m_columns + columnOffset;
+    const quint8* visibleRow = visible + row * contribution.m_columns;
+    for (int column = 0; column < contribution.m_columns; ++column)
+    {
+      if (visibleRow[column])
+        countsRow[column] = static_cast<quint16>(countsRow[column] + delta);
+    }
+  }
+}
+
+} // Dsa
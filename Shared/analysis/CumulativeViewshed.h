@@ -0,0 +1,91 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef CUMULATIVEVIEWSHED_H
+#define CUMULATIVEVIEWSHED_H
+
+// dsa app headers
+#include "ViewshedEngine.h"
+
+// Qt headers
+#include <QHash>
+#include <QVector>
+
+namespace Dsa {
+
+class CumulativeViewshed
+{
+public:
+  explicit CumulativeViewshed(const QSharedPointer<const ElevationSampler>& sampler);
+  ~CumulativeViewshed();
+
+  ViewshedEngine& engine();
+
+  bool setObserver(int id, const ViewshedParameters& parameters);
+  bool setObserver(int id, const ViewshedRaster& raster);
+  bool removeObserver(int id);
+  bool containsObserver(int id) const;
+  int observerCount() const;
+  void clear();
+
+  int columns() const;
+  int rows() const;
+  double originX() const;
+  double originY() const;
+  double cellSizeX() const;
+  double cellSizeY() const;
+
+  int count(int column, int row) const;
+  int countAt(double x, double y) const;
+  int maxCount() const;
+  QVector<int> histogram() const;
+
+private:
+  struct Contribution
+  {
+    // the window of the lattice covered, with one flag per cell row by row from the north
+    int m_firstColumn = 0;
+    int m_firstRow = 0;
+    int m_columns = 0;
+    int m_rows = 0;
+    QVector<quint8> m_visible;
+  };
+
+  Contribution resample(const ViewshedRaster& raster) const;
+  void fitToContributions();
+  void setWindow(int firstColumn, int firstRow, int columns, int rows);
+  void apply(const Contribution& contribution, int delta);
+
+  ViewshedEngine m_engine;
+
+  // the lattice is fixed by the first observer: cell column, row is centered on
+  // column * m_cellSizeX, -row * m_cellSizeY
+  double m_cellSizeX = 0.0;
+  double m_cellSizeY = 0.0;
+
+  // the window of the lattice covered by the counts
+  int m_firstColumn = 0;
+  int m_firstRow = 0;
+  int m_columns = 0;
+  int m_rows = 0;
+  QVector<quint16> m_counts;
+
+  QHash<int, Contribution> m_contributions;
+};
+
+} // Dsa
+
+#endif // CUMULATIVEVIEWSHED_H
@@ -0,0 +1,1031 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "ElevationRaster.h"
+
+// Qt headers
+#include <QByteArray>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutexLocker>
+
+// STL headers
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Dsa {
+
+namespace
+{
+// DTED: user header label, data set identification and accuracy records precede the data
+constexpr int dtedHeaderSize = 80 + 648 + 2700;
+constexpr int dtedRecordOverhead = 8 + 4;
+constexpr int dtedNoData = -32767;
+
+// TIFF tags and GeoTIFF keys used when reading elevation
+constexpr quint16 tagImageWidth = 256;
+constexpr quint16 tagImageLength = 257;
+constexpr quint16 tagBitsPerSample = 258;
+constexpr quint16 tagCompression = 259;
+constexpr quint16 tagStripOffsets = 273;
+constexpr quint16 tagSamplesPerPixel = 277;
+constexpr quint16 tagRowsPerStrip = 278;
+constexpr quint16 tagStripByteCounts = 279;
+constexpr quint16 tagTileWidth = 322;
+constexpr quint16 tagTileLength = 323;
+constexpr quint16 tagTileOffsets = 324;
+constexpr quint16 tagTileByteCounts = 325;
+constexpr quint16 tagSampleFormat = 339;
+constexpr quint16 tagModelPixelScale = 33550;
+constexpr quint16 tagModelTiepoint = 33922;
+constexpr quint16 tagGeoKeyDirectory = 34735;
+constexpr quint16 tagGdalNoData = 42113;
+
+constexpr quint16 keyModelType = 1024;
+constexpr quint16 keyRasterType = 1025;
+constexpr quint16 modelTypeGeographic = 2;
+constexpr quint16 rasterTypePixelIsPoint = 2;
+
+constexpr float noData = std::numeric_limits<float>::quiet_NaN();
+
+// the number of locations interpolated together by elevations
+constexpr int elevationBatchSize = 64;
+
+// the number of posts along each side of a tile and the default number of tiles kept per raster
+constexpr int tileSizePosts = 256;
+constexpr int defaultTileCacheSize = 64;
+
+// identifies each raster, so that tiles remembered by a thread are never confused with those of a new raster
+std::atomic<quint64> s_nextRasterId(1);
+
+/*!
+  \internal
+
+  The tile most recently used by a thread, which is checked before the shared cache.
+ */
+struct RecentTile
+{
+  quint64 m_rasterId = 0;
+  int m_key = -1;
+  QSharedPointer<const QVector<float>> m_tile;
+};
+
+thread_local RecentTile s_recentTile;
+
+/*!
+  \internal
+
+  Reads values of either byte order from a block of memory.
+ */
+struct ByteReader
+{
+  ByteReader(const uchar* data, qint64 size, bool bigEndian = false):
+    m_data(data),
+    m_size(size),
+    m_bigEndian(bigEndian)
+  {
+  }
+
+  bool inRange(quint64 offset, quint64 size) const
+  {
+    return offset + size <= static_cast<quint64>(m_size);
+  }
+
+  quint16 u16(quint32 offset) const
+  {
+    const uchar* p = m_data + offset;
+    return m_bigEndian ? static_cast<quint16>((p[0] << 8) | p[1])
+                       : static_cast<quint16>((p[1] << 8) | p[0]);
+  }
+
+  quint32 u32(quint32 offset) const
+  {
+    const uchar* p = m_data + offset;
+    return m_bigEndian ? (quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8) | quint32(p[3])
+                       : (quint32(p[3]) << 24) | (quint32(p[2]) << 16) | (quint32(p[1]) << 8) | quint32(p[0]);
+  }
+
+  quint64 u64(quint32 offset) const
+  {
+    const quint64 first = u32(offset);
+    const quint64 second = u32(offset + 4);
+    return m_bigEndian ? (first << 32) | second : (second << 32) | first;
+  }
+
+  // reads the sample at offset with the given size and format (1 unsigned, 2 signed, 3 floating point)
+  double sample(quint32 offset, int bytes, int format) const
+  {
+    switch (bytes)
+    {
+    case 1:
+      return format == 2 ? static_cast<double>(static_cast<qint8>(m_data[offset])) : m_data[offset];
+    case 2:
+      return format == 2 ? static_cast<double>(static_cast<qint16>(u16(offset))) : u16(offset);
+    case 4:
+      if (format == 3)
+      {
+        const quint32 bits = u32(offset);
+        float value = 0.0f;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+      }
+      return format == 2 ? static_cast<double>(static_cast<qint32>(u32(offset))) : u32(offset);
+    case 8:
+    {
+      const quint64 bits = u64(offset);
+      double value = 0.0;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+    default:
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+  }
+
+  const uchar* m_data = nullptr;
+  qint64 m_size = 0;
+  bool m_bigEndian = false;
+};
+
+/*!
+  \internal
+
+  Minimal reader for the first image of a classic (not Big) TIFF file.
+ */
+struct TiffReader : public ByteReader
+{
+  struct Entry
+  {
+    quint16 m_type = 0;
+    quint32 m_count = 0;
+    quint32 m_offset = 0;
+  };
+
+  TiffReader(const uchar* data, qint64 size):
+    ByteReader(data, size)
+  {
+  }
+
+  bool readHeader()
+  {
+    if (m_size < 8)
+      return false;
+
+    if (m_data[0] == 'I' && m_data[1] == 'I')
+      m_bigEndian = false;
+    else if (m_data[0] == 'M' && m_data[1] == 'M')
+      m_bigEndian = true;
+    else
+      return false;
+
+    if (u16(2) != 42)
+      return false;
+
+    const quint32 ifdOffset = u32(4);
+    if (!inRange(ifdOffset, 2))
+      return false;
+
+    const quint16 entryCount = u16(ifdOffset);
+    if (!inRange(ifdOffset + 2, entryCount * 12))
+      return false;
+
+    for (quint16 i = 0; i < entryCount; ++i)
+    {
+      const quint32 entryOffset = ifdOffset + 2 + i * 12;
+      Entry entry;
+      entry.m_type = u16(entryOffset + 2);
+      entry.m_count = u32(entryOffset + 4);
+
+      // skip entries of unknown types, and those whose values do not fit in the file, so that
+      // their values can be read without further checks
+      const quint64 valueSize = static_cast<quint64>(typeSize(entry.m_type)) * entry.m_count;
+      if (valueSize == 0 || valueSize > static_cast<quint64>(m_size))
+        continue;
+
+      // values which fit in four bytes are stored in the entry itself
+      entry.m_offset = valueSize <= 4 ? entryOffset + 8 : u32(entryOffset + 8);
+      if (!inRange(entry.m_offset, valueSize))
+        continue;
+
+      m_entries.insert(u16(entryOffset), entry);
+    }
+
+    return true;
+  }
+
+  static quint32 typeSize(quint16 type)
+  {
+    switch (type)
+    {
+    case 1: case 2: case 6: case 7:
+      return 1;
+    case 3: case 8:
+      return 2;
+    case 4: case 9: case 11:
+      return 4;
+    case 5: case 10: case 12:
+      return 8;
+    default:
+      return 0;
+    }
+  }
+
+  bool has(quint16 tag) const
+  {
+    return m_entries.contains(tag);
+  }
+
+  QVector<quint32> unsignedValues(quint16 tag) const
+  {
+    QVector<quint32> values;
+    auto it = m_entries.constFind(tag);
+    if (it == m_entries.constEnd())
+      return values;
+
+    const Entry& entry = it.value();
+    values.reserve(static_cast<int>(entry.m_count));
+    for (quint32 i = 0; i < entry.m_count; ++i)
+    {
+      if (entry.m_type == 3)
+        values.append(u16(entry.m_offset + i * 2));
+      else if (entry.m_type == 4)
+        values.append(u32(entry.m_offset + i * 4));
+      else if (entry.m_type == 1)
+        values.append(m_data[entry.m_offset + i]);
+    }
+
+    return values;
+  }
+
+  quint32 unsignedValue(quint16 tag, quint32 defaultValue) const
+  {
+    const QVector<quint32> values = unsignedValues(tag);
+    return values.isEmpty() ? defaultValue : values.first();
+  }
+
+  QVector<double> doubleValues(quint16 tag) const
+  {
+    QVector<double> values;
+    auto it = m_entries.constFind(tag);
+    if (it == m_entries.constEnd() || it->m_type != 12)
+      return values;
+
+    values.reserve(static_cast<int>(it->m_count));
+    for (quint32 i = 0; i < it->m_count; ++i)
+    {
+      const quint64 bits = u64(it->m_offset + i * 8);
+      double value = 0.0;
+      std::memcpy(&value, &bits, sizeof(value));
+      values.append(value);
+    }
+
+    return values;
+  }
+
+  QByteArray asciiValue(quint16 tag) const
+  {
+    auto it = m_entries.constFind(tag);
+    if (it == m_entries.constEnd() || it->m_type != 2)
+      return QByteArray();
+
+    return QByteArray(reinterpret_cast<const char*>(m_data + it->m_offset), static_cast<int>(it->m_count));
+  }
+
+  QHash<quint16, Entry> m_entries;
+};
+
+/*!
+  \internal
+
+  Returns the angle in degrees from a DTED "DDDMMSSH" field, or NaN if it is not valid.
+ */
+double dtedAngle(const uchar* field)
+{
+  const char* text = reinterpret_cast<const char*>(field);
+  bool ok = false;
+  const int degrees = QByteArray(text, 3).toInt(&ok);
+  if (!ok)
+    return std::numeric_limits<double>::quiet_NaN();
+
+  const int minutes = QByteArray(text + 3, 2).toInt(&ok);
+  if (!ok)
+    return std::numeric_limits<double>::quiet_NaN();
+
+  const int seconds = QByteArray(text + 5, 2).toInt(&ok);
+  if (!ok)
+    return std::numeric_limits<double>::quiet_NaN();
+
+  const double angle = degrees + minutes / 60.0 + seconds / 3600.0;
+  const char hemisphere = text[7];
+  return (hemisphere == 'S' || hemisphere == 'W') ? -angle : angle;
+}
+
+/*!
+  \internal
+
+  Returns an integer from the DTED text field of \a length characters, or \c -1.
+ */
+int dtedInteger(const uchar* field, int length)
+{
+  bool ok = false;
+  const int value = QByteArray(reinterpret_cast<const char*>(field), length).trimmed().toInt(&ok);
+  return ok ? value : -1;
+}
+}
+
+/*!
+  \class Dsa::ElevationRaster
+  \inmodule Dsa
+  \brief A grid of elevation values read from a local raster file, for CPU analysis.
+
+  The following formats are supported:
+
+  \list
+    \li DTED levels 0, 1 and 2 (\c .dt0, \c .dt1, \c .dt2).
+    \li Uncompressed, single band GeoTIFF in geographic coordinates, stored in strips or tiles
+      (\c .tif, \c .tiff, \c .geotiff).
+  \endlist
+
+  The file is memory mapped rather than read, and its heights are decoded into square tiles
+  of \l tileSize posts as they are needed. The most recently used tiles are kept, up to
+  \l tileCacheSize, and the others are discarded. Tiles can be decoded ahead of time with
+  \l loadTile, for example along the track of the vehicle.
+
+  Heights are in meters, with posts spaced regularly in WGS84 degrees. The raster can be
+  sampled from several threads at once: each thread remembers the last tile it used, so
+  successive samples which fall in the same tile do not touch the shared cache.
+
+  \sa ElevationSampler
+ */
+
+/*!
+  \brief Constructor for an empty raster.
+ */
+ElevationRaster::ElevationRaster():
+  m_id(s_nextRasterId++),
+  m_tiles(defaultTileCacheSize)
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+ElevationRaster::~ElevationRaster()
+{
+}
+
+/*!
+  \brief Opens the elevation raster at \a path.
+
+  Returns \c false if the file cannot be read or its format is not supported: see \l errorMessage.
+ */
+bool ElevationRaster::load(const QString& path)
+{
+  // a new id, so that tiles of the previous file remembered by any thread are not used
+  m_id = s_nextRasterId++;
+  m_path = path;
+  m_errorMessage.clear();
+  m_columns = 0;
+  m_rows = 0;
+
+  {
+    QMutexLocker locker(&m_tilesMutex);
+    m_tiles.clear();
+  }
+
+  m_file.close();
+  m_buffer.clear();
+  m_data = nullptr;
+  m_size = 0;
+
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::ReadOnly))
+    return setError(QString("Could not open %1").arg(path));
+
+  // read the file if it cannot be mapped
+  m_size = m_file.size();
+  m_data = m_file.map(0, m_size);
+  if (!m_data)
+  {
+    m_buffer = m_file.readAll();
+    m_data = reinterpret_cast<const uchar*>(m_buffer.constData());
+    m_size = m_buffer.size();
+  }
+
+  const QString suffix = QFileInfo(path).suffix().toLower();
+
+  bool loaded = false;
+  if (suffix.startsWith(QStringLiteral("dt")))
+    loaded = loadDted();
+  else if (suffix == QStringLiteral("tif") || suffix == QStringLiteral("tiff") || suffix == QStringLiteral("geotiff"))
+    loaded = loadGeoTiff();
+  else
+    return setError(QString("Unsupported elevation format: %1").arg(suffix));
+
+  if (loaded)
+    m_tilesAcross = (m_columns + tileSizePosts - 1) / tileSizePosts;
+
+  return loaded;
+}
+
+/*!
+  \brief Returns whether the raster contains elevation values.
+ */
+bool ElevationRaster::isValid() const
+{
+  return m_data && m_columns > 0 && m_rows > 0;
+}
+
+/*!
+  \brief Returns the path of the raster file.
+ */
+QString ElevationRaster::path() const
+{
+  return m_path;
+}
+
+/*!
+  \brief Returns the reason the last \l load failed.
+ */
+QString ElevationRaster::errorMessage() const
+{
+  return m_errorMessage;
+}
+
+/*!
+  \brief Returns the number of columns of posts.
+ */
+int ElevationRaster::columns() const
+{
+  return m_columns;
+}
+
+/*!
+  \brief Returns the number of rows of posts.
+ */
+int ElevationRaster::rows() const
+{
+  return m_rows;
+}
+
+/*!
+  \brief Returns the longitude of the north west post.
+ */
+double ElevationRaster::originX() const
+{
+  return m_originX;
+}
+
+/*!
+  \brief Returns the latitude of the north west post.
+ */
+double ElevationRaster::originY() const
+{
+  return m_originY;
+}
+
+/*!
+  \brief Returns the spacing of the posts in degrees of longitude.
+ */
+double ElevationRaster::cellSizeX() const
+{
+  return m_cellSizeX;
+}
+
+/*!
+  \brief Returns the spacing of the posts in degrees of latitude.
+ */
+double ElevationRaster::cellSizeY() const
+{
+  return m_cellSizeY;
+}
+
+/*!
+  \brief Returns the longitude of the westernmost posts.
+ */
+double ElevationRaster::xMin() const
+{
+  return m_originX;
+}
+
+/*!
+  \brief Returns the longitude of the easternmost posts.
+ */
+double ElevationRaster::xMax() const
+{
+  return m_originX + (m_columns - 1) * m_cellSizeX;
+}
+
+/*!
+  \brief Returns the latitude of the southernmost posts.
+ */
+double ElevationRaster::yMin() const
+{
+  return m_originY - (m_rows - 1) * m_cellSizeY;
+}
+
+/*!
+  \brief Returns the latitude of the northernmost posts.
+ */
+double ElevationRaster::yMax() const
+{
+  return m_originY;
+}
+
+/*!
+  \brief Returns whether the WGS84 location \a x, \a y is within the posts of the raster.
+ */
+bool ElevationRaster::contains(double x, double y) const
+{
+  return isValid() && x >= xMin() && x <= xMax() && y >= yMin() && y <= yMax();
+}
+
+/*!
+  \brief Returns the height in meters of the post at \a column and \a row, where row \c 0 is
+  the northernmost.
+
+  Returns NaN where there is no data.
+ */
+float ElevationRaster::height(int column, int row) const
+{
+  if (column < 0 || row < 0 || column >= m_columns || row >= m_rows)
+    return noData;
+
+  return tile(tileKey(column, row)).at((row % tileSizePosts) * tileSizePosts + (column % tileSizePosts));
+}
+
+/*!
+  \brief Returns the elevation in meters at the WGS84 location \a x, \a y, interpolated
+  bilinearly from the four surrounding posts.
+
+  Where any of the posts has no data, the nearest post is used. Returns NaN outside the raster.
+ */
+double ElevationRaster::elevation(double x, double y) const
+{
+  if (!contains(x, y))
+    return std::numeric_limits<double>::quiet_NaN();
+
+  const double column = (x - m_originX) / m_cellSizeX;
+  const double row = (m_originY - y) / m_cellSizeY;
+  const int column0 = std::min(static_cast<int>(column), m_columns - 2 < 0 ? 0 : m_columns - 2);
+  const int row0 = std::min(static_cast<int>(row), m_rows - 2 < 0 ? 0 : m_rows - 2);
+  const int column1 = std::min(column0 + 1, m_columns - 1);
+  const int row1 = std::min(row0 + 1, m_rows - 1);
+  const double fx = column - column0;
+  const double fy = row - row0;
+
+  const double h00 = height(column0, row0);
+  const double h10 = height(column1, row0);
+  const double h01 = height(column0, row1);
+  const double h11 = height(column1, row1);
+
+  if (std::isnan(h00) || std::isnan(h10) || std::isnan(h01) || std::isnan(h11))
+  {
+    const int nearestColumn = fx < 0.5 ? column0 : column1;
+    const int nearestRow = fy < 0.5 ? row0 : row1;
+    return height(nearestColumn, nearestRow);
+  }
+
+  const double north = h00 + (h10 - h00) * fx;
+  const double south = h01 + (h11 - h01) * fx;
+  return north + (south - north) * fy;
+}
+
+/*!
+  \brief Writes to \a results the elevation in meters at each of the \a count WGS84 locations
+  \a x, \a y.
+
+  The results are the same as those of \l elevation, but locations are handled in batches:
+  the grid positions and the interpolation are computed in separate passes over arrays, which
+  the compiler can vectorise, and only the reads of the posts are done one location at a time.
+  Use this when many locations are needed at once, for example along a profile.
+ */
+void ElevationRaster::elevations(const double* x, const double* y, int count, double* results) const
+{
+  const double inverseCellSizeX = 1.0 / m_cellSizeX;
+  const double inverseCellSizeY = 1.0 / m_cellSizeY;
+  const double maxColumn = m_columns - 1;
+  const double maxRow = m_rows - 1;
+  const int lastColumn0 = std::max(0, m_columns - 2);
+  const int lastRow0 = std::max(0, m_rows - 2);
+
+  double columns[elevationBatchSize];
+  double rows[elevationBatchSize];
+  double h00[elevationBatchSize];
+  double h10[elevationBatchSize];
+  double h01[elevationBatchSize];
+  double h11[elevationBatchSize];
+
+  for (int start = 0; start < count; start += elevationBatchSize)
+  {
+    const int batchCount = std::min(elevationBatchSize, count - start);
+    const double* batchX = x + start;
+    const double* batchY = y + start;
+    double* batchResults = results + start;
+
+    // the fractional grid position of each location
+    for (int i = 0; i < batchCount; ++i)
+    {
+      columns[i] = (batchX[i] - m_originX) * inverseCellSizeX;
+      rows[i] = (m_originY - batchY[i]) * inverseCellSizeY;
+    }
+
+    // read the four posts around each location, leaving the fractions in columns and rows
+    const Tile* currentTile = nullptr;
+    int currentKey = -1;
+    for (int i = 0; i < batchCount; ++i)
+    {
+      const double column = columns[i];
+      const double row = rows[i];
+      if (!(column >= 0.0 && column <= maxColumn && row >= 0.0 && row <= maxRow))
+      {
+        h00[i] = h10[i] = h01[i] = h11[i] = noData;
+        columns[i] = rows[i] = 0.0;
+        continue;
+      }
+
+      const int column0 = std::min(static_cast<int>(column), lastColumn0);
+      const int row0 = std::min(static_cast<int>(row), lastRow0);
+      const int column1 = std::min(column0 + 1, m_columns - 1);
+      const int row1 = std::min(row0 + 1, m_rows - 1);
+      columns[i] = column - column0;
+      rows[i] = row - row0;
+
+      const int tileColumn0 = column0 % tileSizePosts;
+      const int tileRow0 = row0 % tileSizePosts;
+      if (tileColumn0 + 1 < tileSizePosts && tileRow0 + 1 < tileSizePosts)
+      {
+        // all four posts are in the same tile
+        const int key = tileKey(column0, row0);
+        if (key != currentKey)
+        {
+          currentTile = &tile(key);
+          currentKey = key;
+        }
+
+        const float* posts = currentTile->constData() + tileRow0 * tileSizePosts + tileColumn0;
+        h00[i] = posts[0];
+        h10[i] = posts[column1 - column0];
+        h01[i] = posts[(row1 - row0) * tileSizePosts];
+        h11[i] = posts[(row1 - row0) * tileSizePosts + column1 - column0];
+      }
+      else
+      {
+        // the posts span tiles, and reading them may release the current tile
+        h00[i] = height(column0, row0);
+        h10[i] = height(column1, row0);
+        h01[i] = height(column0, row1);
+        h11[i] = height(column1, row1);
+        currentTile = nullptr;
+        currentKey = -1;
+      }
+    }
+
+    // interpolate, where any post without data gives NaN
+    for (int i = 0; i < batchCount; ++i)
+    {
+      const double north = h00[i] + (h10[i] - h00[i]) * columns[i];
+      const double south = h01[i] + (h11[i] - h01[i]) * columns[i];
+      batchResults[i] = north + (south - north) * rows[i];
+    }
+
+    // use the nearest post where the interpolation had no data
+    for (int i = 0; i < batchCount; ++i)
+    {
+      if (!std::isnan(batchResults[i]))
+        continue;
+
+      if (columns[i] < 0.5)
+        batchResults[i] = rows[i] < 0.5 ? h00[i] : h01[i];
+      else
+        batchResults[i] = rows[i] < 0.5 ? h10[i] : h11[i];
+    }
+  }
+}
+
+/*!
+  \brief Returns the number of posts along each side of a tile.
+ */
+int ElevationRaster::tileSize()
+{
+  return tileSizePosts;
+}
+
+/*!
+  \brief Returns the most decoded tiles which are kept in memory.
+
+  The default is \c 64 tiles, or 16 MB.
+ */
+int ElevationRaster::tileCacheSize() const
+{
+  QMutexLocker locker(&m_tilesMutex);
+  return m_tiles.maxCost();
+}
+
+/*!
+  \brief Sets the most decoded tiles which are kept in memory to \a tileCount.
+ */
+void ElevationRaster::setTileCacheSize(int tileCount)
+{
+  QMutexLocker locker(&m_tilesMutex);
+  m_tiles.setMaxCost(std::max(1, tileCount));
+}
+
+/*!
+  \brief Returns whether the tile containing the WGS84 location \a x, \a y has been decoded.
+ */
+bool ElevationRaster::isTileLoaded(double x, double y) const
+{
+  if (!contains(x, y))
+    return false;
+
+  const int column = static_cast<int>(std::lround((x - m_originX) / m_cellSizeX));
+  const int row = static_cast<int>(std::lround((m_originY - y) / m_cellSizeY));
+
+  QMutexLocker locker(&m_tilesMutex);
+  return m_tiles.contains(tileKey(column, row));
+}
+
+/*!
+  \brief Decodes the tile containing the WGS84 location \a x, \a y, if it is not already in memory.
+
+  This can be called from any thread.
+ */
+void ElevationRaster::loadTile(double x, double y) const
+{
+  if (!contains(x, y))
+    return;
+
+  const int column = static_cast<int>(std::lround((x - m_originX) / m_cellSizeX));
+  const int row = static_cast<int>(std::lround((m_originY - y) / m_cellSizeY));
+  tile(tileKey(column, row));
+}
+
+/*!
+  \internal
+
+  Read the layout of a DTED file. DTED stores columns of posts from south to north, beginning
+  with the westernmost, as signed magnitude 16 bit integers.
+ */
+bool ElevationRaster::loadDted()
+{
+  if (m_size < dtedHeaderSize || std::memcmp(m_data, "UHL", 3) != 0)
+    return setError(QString("%1 is not a DTED file").arg(m_path));
+
+  const double originX = dtedAngle(m_data + 4);
+  const double originY = dtedAngle(m_data + 12);
+  const int intervalX = dtedInteger(m_data + 20, 4);
+  const int intervalY = dtedInteger(m_data + 24, 4);
+  const int columns = dtedInteger(m_data + 47, 4);
+  const int rows = dtedInteger(m_data + 51, 4);
+
+  if (std::isnan(originX) || std::isnan(originY) || intervalX <= 0 || intervalY <= 0 || columns < 2 || rows < 2)
+    return setError(QString("%1 has an invalid DTED header").arg(m_path));
+
+  const int recordSize = dtedRecordOverhead + rows * 2;
+  if (m_size < dtedHeaderSize + static_cast<qint64>(recordSize) * columns)
+    return setError(QString("%1 is truncated").arg(m_path));
+
+  if (m_data[dtedHeaderSize] != 0xAA)
+    return setError(QString("%1 has an invalid DTED data record").arg(m_path));
+
+  // intervals are in tenths of arc seconds and the origin is the south west post
+  m_format = Format::Dted;
+  m_recordSize = recordSize;
+  m_columns = columns;
+  m_rows = rows;
+  m_cellSizeX = intervalX / 36000.0;
+  m_cellSizeY = intervalY / 36000.0;
+  m_originX = originX;
+  m_originY = originY + (rows - 1) * m_cellSizeY;
+
+  return true;
+}
+
+/*!
+  \internal
+
+  Read the layout of an uncompressed, single band GeoTIFF in geographic coordinates.
+ */
+bool ElevationRaster::loadGeoTiff()
+{
+  TiffReader tiff(m_data, m_size);
+  if (!tiff.readHeader())
+    return setError(QString("%1 is not a TIFF file").arg(m_path));
+
+  const int columns = static_cast<int>(tiff.unsignedValue(tagImageWidth, 0));
+  const int rows = static_cast<int>(tiff.unsignedValue(tagImageLength, 0));
+  const int bitsPerSample = static_cast<int>(tiff.unsignedValue(tagBitsPerSample, 1));
+  const int sampleFormat = static_cast<int>(tiff.unsignedValue(tagSampleFormat, 1));
+  const int bytesPerSample = bitsPerSample / 8;
+
+  if (columns < 2 || rows < 2)
+    return setError(QString("%1 has an invalid size").arg(m_path));
+
+  if (tiff.unsignedValue(tagCompression, 1) != 1)
+    return setError(QString("%1 is compressed, which is not supported").arg(m_path));
+
+  if (tiff.unsignedValue(tagSamplesPerPixel, 1) != 1 || bitsPerSample % 8 != 0 || bytesPerSample == 3 || bytesPerSample > 8)
+    return setError(QString("%1 does not have a single band of elevation").arg(m_path));
+
+  // the raster must be in geographic coordinates
+  const QVector<quint32> geoKeys = tiff.unsignedValues(tagGeoKeyDirectory);
+  quint32 modelType = 0;
+  quint32 rasterType = 1;
+  for (int i = 4; i + 3 < geoKeys.size(); i += 4)
+  {
+    if (geoKeys[i + 1] != 0)
+      continue;
+
+    if (geoKeys[i] == keyModelType)
+      modelType = geoKeys[i + 3];
+    else if (geoKeys[i] == keyRasterType)
+      rasterType = geoKeys[i + 3];
+  }
+
+  if (modelType != modelTypeGeographic)
+    return setError(QString("%1 is not in geographic coordinates").arg(m_path));
+
+  const QVector<double> scale = tiff.doubleValues(tagModelPixelScale);
+  const QVector<double> tiepoint = tiff.doubleValues(tagModelTiepoint);
+  if (scale.size() < 2 || tiepoint.size() < 6 || scale[0] <= 0.0 || scale[1] <= 0.0)
+    return setError(QString("%1 is not georeferenced").arg(m_path));
+
+  // strips are handled as tiles which are the full width of the raster
+  const bool tiled = tiff.has(tagTileOffsets);
+  const int blockWidth = tiled ? static_cast<int>(tiff.unsignedValue(tagTileWidth, 0)) : columns;
+  const int blockHeight = tiled ? static_cast<int>(tiff.unsignedValue(tagTileLength, 0))
+                                : static_cast<int>(std::min<quint32>(tiff.unsignedValue(tagRowsPerStrip, rows), rows));
+  const QVector<quint32> offsets = tiff.unsignedValues(tiled ? tagTileOffsets : tagStripOffsets);
+  const QVector<quint32> byteCounts = tiff.unsignedValues(tiled ? tagTileByteCounts : tagStripByteCounts);
+
+  if (blockWidth <= 0 || blockHeight <= 0)
+    return setError(QString("%1 has an invalid layout").arg(m_path));
+
+  const int blocksAcross = (columns + blockWidth - 1) / blockWidth;
+  const int blocksDown = (rows + blockHeight - 1) / blockHeight;
+  if (offsets.size() < blocksAcross * blocksDown || byteCounts.size() < offsets.size())
+    return setError(QString("%1 has an invalid layout").arg(m_path));
+
+  // posts are at the centers of the pixels unless the raster is pixel is point
+  const double pixelOffset = rasterType == rasterTypePixelIsPoint ? 0.0 : 0.5;
+  m_format = Format::GeoTiff;
+  m_columns = columns;
+  m_rows = rows;
+  m_cellSizeX = scale[0];
+  m_cellSizeY = scale[1];
+  m_originX = tiepoint[3] + (pixelOffset - tiepoint[0]) * m_cellSizeX;
+  m_originY = tiepoint[4] - (pixelOffset - tiepoint[1]) * m_cellSizeY;
+
+  m_blockWidth = blockWidth;
+  m_blockHeight = blockHeight;
+  m_blocksAcross = blocksAcross;
+  m_blockOffsets = offsets;
+  m_blockByteCounts = byteCounts;
+  m_bytesPerSample = bytesPerSample;
+  m_sampleFormat = sampleFormat;
+  m_bigEndian = tiff.m_bigEndian;
+  m_noDataValue = tiff.asciiValue(tagGdalNoData).trimmed().toDouble(&m_hasNoData);
+
+  return true;
+}
+
+/*!
+  \internal
+
+  Record \a errorMessage and return \c false.
+ */
+bool ElevationRaster::setError(const QString& errorMessage)
+{
+  m_errorMessage = errorMessage;
+  m_columns = 0;
+  m_rows = 0;
+  return false;
+}
+
+/*!
+  \internal
+
+  Read the height of the post at \a column and \a row from the file.
+ */
+float ElevationRaster::readHeight(int column, int row) const
+{
+  if (m_format == Format::Dted)
+  {
+    // the first post of each record is the southernmost
+    const qint64 offset = dtedHeaderSize + static_cast<qint64>(column) * m_recordSize + 8 + (m_rows - 1 - row) * 2;
+    const int raw = (m_data[offset] << 8) | m_data[offset + 1];
+    const int value = (raw & 0x8000) ? -(raw & 0x7FFF) : raw;
+    return value == dtedNoData ? noData : static_cast<float>(value);
+  }
+
+  const int block = (row / m_blockHeight) * m_blocksAcross + (column / m_blockWidth);
+  const quint32 index = static_cast<quint32>((row % m_blockHeight) * m_blockWidth + (column % m_blockWidth));
+  const quint32 blockBytes = m_blockByteCounts.at(block);
+  const quint32 blockOffset = m_blockOffsets.at(block);
+  if ((static_cast<quint64>(index) + 1) * static_cast<quint64>(m_bytesPerSample) > blockBytes)
+    return noData;
+
+  const ByteReader reader(m_data, m_size, m_bigEndian);
+  if (!reader.inRange(blockOffset, blockBytes))
+    return noData;
+
+  const double value = reader.sample(blockOffset + index * m_bytesPerSample, m_bytesPerSample, m_sampleFormat);
+  if (std::isnan(value) || (m_hasNoData && value == m_noDataValue))
+    return noData;
+
+  return static_cast<float>(value);
+}
+
+/*!
+  \internal
+
+  Returns the key of the tile containing the post at \a column and \a row.
+ */
+int ElevationRaster::tileKey(int column, int row) const
+{
+  return (row / tileSizePosts) * m_tilesAcross + (column / tileSizePosts);
+}
+
+/*!
+  \internal
+
+  Returns the tile \a key, decoding it if it is not in memory.
+
+  The tile is held by the calling thread until it next asks for a different tile.
+ */
+const ElevationRaster::Tile& ElevationRaster::tile(int key) const
+{
+  RecentTile& recent = s_recentTile;
+  if (recent.m_rasterId == m_id && recent.m_key == key)
+    return *recent.m_tile;
+
+  QSharedPointer<const Tile> heights;
+  {
+    QMutexLocker locker(&m_tilesMutex);
+    TileHandle* handle = m_tiles.object(key);
+    if (handle)
+      heights = handle->m_tile;
+  }
+
+  // decode outside of the lock, so that other threads can read tiles in the meantime
+  if (!heights)
+  {
+    heights = decodeTile(key);
+
+    QMutexLocker locker(&m_tilesMutex);
+    TileHandle* handle = new TileHandle;
+    handle->m_tile = heights;
+    m_tiles.insert(key, handle);
+  }
+
+  recent.m_rasterId = m_id;
+  recent.m_key = key;
+  recent.m_tile = heights;
+  return *recent.m_tile;
+}
+
+/*!
+  \internal
+
+  Read the posts of tile \a key from the file. Posts of the tile beyond the edge of the raster are NaN.
+ */
+QSharedPointer<const ElevationRaster::Tile> ElevationRaster::decodeTile(int key) const
+{
+  QSharedPointer<Tile> heights(new Tile(tileSizePosts * tileSizePosts, noData));
+  const int firstColumn = (key % m_tilesAcross) * tileSizePosts;
+  const int firstRow = (key / m_tilesAcross) * tileSizePosts;
+  const int columnEnd = std::min(firstColumn + tileSizePosts, m_columns);
+  const int rowEnd = std::min(firstRow + tileSizePosts, m_rows);
+
+  float* data = heights->data();
+  for (int row = firstRow; row < rowEnd; ++row)
+  {
+    float* tileRow = data + (row - firstRow) * tileSizePosts;
+    for (int column = firstColumn; column < columnEnd; ++column)
+      tileRow[column - firstColumn] = readHeight(column, row);
+  }
+
+  return heights;
+}
+
+} // Dsa
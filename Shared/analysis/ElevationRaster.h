@@ -0,0 +1,132 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef ELEVATIONRASTER_H
+#define ELEVATIONRASTER_H
+
+// Qt headers
+#include <QByteArray>
+#include <QCache>
+#include <QFile>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+namespace Dsa {
+
+class ElevationRaster
+{
+public:
+  ElevationRaster();
+  ~ElevationRaster();
+
+  bool load(const QString& path);
+
+  bool isValid() const;
+  QString path() const;
+  QString errorMessage() const;
+
+  int columns() const;
+  int rows() const;
+
+  double originX() const;
+  double originY() const;
+  double cellSizeX() const;
+  double cellSizeY() const;
+
+  double xMin() const;
+  double xMax() const;
+  double yMin() const;
+  double yMax() const;
+  bool contains(double x, double y) const;
+
+  float height(int column, int row) const;
+  double elevation(double x, double y) const;
+  void elevations(const double* x, const double* y, int count, double* results) const;
+
+  static int tileSize();
+  int tileCacheSize() const;
+  void setTileCacheSize(int tileCount);
+  bool isTileLoaded(double x, double y) const;
+  void loadTile(double x, double y) const;
+
+private:
+  Q_DISABLE_COPY(ElevationRaster)
+
+  enum class Format
+  {
+    Dted,
+    GeoTiff
+  };
+
+  using Tile = QVector<float>;
+
+  struct TileHandle
+  {
+    QSharedPointer<const Tile> m_tile;
+  };
+
+  bool loadDted();
+  bool loadGeoTiff();
+  bool setError(const QString& errorMessage);
+
+  float readHeight(int column, int row) const;
+  int tileKey(int column, int row) const;
+  const Tile& tile(int key) const;
+  QSharedPointer<const Tile> decodeTile(int key) const;
+
+  QString m_path;
+  QString m_errorMessage;
+  int m_columns = 0;
+  int m_rows = 0;
+
+  // the location of the north west post and the spacing of the posts, in WGS84 degrees
+  double m_originX = 0.0;
+  double m_originY = 0.0;
+  double m_cellSizeX = 0.0;
+  double m_cellSizeY = 0.0;
+
+  // the file is mapped into memory and its heights are read from the mapping as tiles are needed
+  QFile m_file;
+  QByteArray m_buffer;
+  const uchar* m_data = nullptr;
+  qint64 m_size = 0;
+  Format m_format = Format::Dted;
+
+  // the layout of the heights in the file: DTED records or GeoTIFF strips and tiles
+  int m_recordSize = 0;
+  int m_blockWidth = 0;
+  int m_blockHeight = 0;
+  int m_blocksAcross = 0;
+  QVector<quint32> m_blockOffsets;
+  QVector<quint32> m_blockByteCounts;
+  int m_bytesPerSample = 0;
+  int m_sampleFormat = 1;
+  bool m_bigEndian = false;
+  bool m_hasNoData = false;
+  double m_noDataValue = 0.0;
+
+  // decoded tiles, least recently used first out, shared between threads
+  quint64 m_id = 0;
+  int m_tilesAcross = 0;
+  mutable QMutex m_tilesMutex;
+  mutable QCache<int, TileHandle> m_tiles;
+};
+
+} // Dsa
+
+#endif // ELEVATIONRASTER_H
@@ -0,0 +1,269 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "ElevationSampler.h"
+
+// dsa app headers
+#include "ElevationRaster.h"
+
+// C++ API headers
+#include "ElevationSourceListModel.h"
+#include "RasterElevationSource.h"
+#include "Scene.h"
+#include "Surface.h"
+
+// Qt headers
+#include <QDebug>
+#include <QHash>
+#include <QWeakPointer>
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::ElevationSampler
+  \inmodule Dsa
+  \brief Samples elevation from a set of local rasters on the CPU.
+
+  The sampler is used by analysis which needs many elevation values at once, for example
+  \l LineOfSightEngine, where querying the scene's surface for each value would be too slow.
+
+  Where rasters overlap, the first raster added which has a value is used.
+
+  Only local raster elevation sources (DTED and uncompressed GeoTIFF) can be sampled:
+  tiled elevation packages, such as the default elevation, are ignored.
+
+  \sa ElevationRaster
+ */
+
+/*!
+  \brief Constructor for a sampler with no rasters.
+ */
+ElevationSampler::ElevationSampler()
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+ElevationSampler::~ElevationSampler()
+{
+}
+
+/*!
+  \brief Returns a sampler for the raster elevation sources in the base surface of \a scene.
+
+  The sampler is empty if the scene has no raster elevation sources which can be read.
+ */
+QSharedPointer<ElevationSampler> ElevationSampler::fromScene(Scene* scene)
+{
+  QSharedPointer<ElevationSampler> sampler(new ElevationSampler());
+  if (!scene || !scene->baseSurface())
+    return sampler;
+
+  ElevationSourceListModel* sources = scene->baseSurface()->elevationSources();
+  const int sourceCount = sources->rowCount();
+  for (int i = 0; i < sourceCount; ++i)
+  {
+    RasterElevationSource* rasterSource = qobject_cast<RasterElevationSource*>(sources->at(i));
+    if (rasterSource)
+      sampler->addRasters(rasterSource->fileNames());
+  }
+
+  return sampler;
+}
+
+/*!
+  \brief Adds \a raster to the sampler.
+
+  Invalid rasters are ignored.
+ */
+void ElevationSampler::addRaster(const QSharedPointer<const ElevationRaster>& raster)
+{
+  if (!raster || !raster->isValid())
+    return;
+
+  m_rasters.append(raster);
+}
+
+/*!
+  \brief Reads the rasters at \a paths and adds those which are valid to the sampler.
+
+  Rasters which have already been read by another sampler are shared rather than read again.
+
+  Returns the number of rasters added.
+ */
+int ElevationSampler::addRasters(const QStringList& paths)
+{
+  int added = 0;
+  for (const QString& path : paths)
+  {
+    QSharedPointer<const ElevationRaster> raster = loadRaster(path);
+    if (!raster)
+      continue;
+
+    addRaster(raster);
+    ++added;
+  }
+
+  return added;
+}
+
+/*!
+  \brief Returns whether the sampler has no rasters.
+ */
+bool ElevationSampler::isEmpty() const
+{
+  return m_rasters.isEmpty();
+}
+
+/*!
+  \brief Returns the paths of the rasters in the sampler.
+ */
+QStringList ElevationSampler::paths() const
+{
+  QStringList paths;
+  for (const auto& raster : m_rasters)
+    paths.append(raster->path());
+
+  return paths;
+}
+
+/*!
+  \brief Returns whether any raster covers the WGS84 location \a x, \a y.
+ */
+bool ElevationSampler::contains(double x, double y) const
+{
+  for (const auto& raster : m_rasters)
+  {
+    if (raster->contains(x, y))
+      return true;
+  }
+
+  return false;
+}
+
+/*!
+  \brief Returns the elevation in meters at the WGS84 location \a x, \a y.
+
+  Returns NaN where no raster has a value.
+ */
+double ElevationSampler::elevation(double x, double y) const
+{
+  for (const auto& raster : m_rasters)
+  {
+    const double value = raster->elevation(x, y);
+    if (!std::isnan(value))
+      return value;
+  }
+
+  return std::numeric_limits<double>::quiet_NaN();
+}
+
+/*!
+  \brief Writes to \a results the elevation in meters at each of the \a count WGS84 locations
+  \a x, \a y.
+
+  Results are NaN where no raster has a value.
+
+  \sa ElevationRaster::elevations
+ */
+void ElevationSampler::elevations(const double* x, const double* y, int count, double* results) const
+{
+  if (m_rasters.isEmpty())
+  {
+    std::fill(results, results + count, std::numeric_limits<double>::quiet_NaN());
+    return;
+  }
+
+  m_rasters.first()->elevations(x, y, count, results);
+
+  // fill the gaps from the other rasters
+  for (int raster = 1; raster < m_rasters.size(); ++raster)
+  {
+    const auto& nextRaster = m_rasters.at(raster);
+    for (int i = 0; i < count; ++i)
+    {
+      if (std::isnan(results[i]))
+        results[i] = nextRaster->elevation(x[i], y[i]);
+    }
+  }
+}
+
+/*!
+  \brief Returns whether the tiles of every raster covering the WGS84 location \a x, \a y are in memory.
+
+  \sa ElevationRaster::isTileLoaded
+ */
+bool ElevationSampler::isTileLoaded(double x, double y) const
+{
+  for (const auto& raster : m_rasters)
+  {
+    if (raster->contains(x, y) && !raster->isTileLoaded(x, y))
+      return false;
+  }
+
+  return true;
+}
+
+/*!
+  \brief Decodes the tile of each raster covering the WGS84 location \a x, \a y.
+
+  This can be called from any thread, so that tiles can be read ahead of the analysis which needs them.
+
+  \sa ElevationRaster::loadTile
+ */
+void ElevationSampler::loadTile(double x, double y) const
+{
+  for (const auto& raster : m_rasters)
+    raster->loadTile(x, y);
+}
+
+/*!
+  \internal
+
+  Returns the raster at \a path, reading it if no other sampler holds it. Returns
+  \c nullptr if the raster cannot be read.
+ */
+QSharedPointer<const ElevationRaster> ElevationSampler::loadRaster(const QString& path)
+{
+  static QHash<QString, QWeakPointer<const ElevationRaster>> loadedRasters;
+
+  QSharedPointer<const ElevationRaster> raster = loadedRasters.value(path).toStrongRef();
+  if (raster)
+    return raster;
+
+  QSharedPointer<ElevationRaster> newRaster(new ElevationRaster());
+  if (!newRaster->load(path))
+  {
+    qWarning() << newRaster->errorMessage();
+    return QSharedPointer<const ElevationRaster>();
+  }
+
+  loadedRasters.insert(path, newRaster);
+  return newRaster;
+}
+
+} // Dsa
@@ -0,0 +1,64 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef ELEVATIONSAMPLER_H
+#define ELEVATIONSAMPLER_H
+
+// Qt headers
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+
+namespace Esri {
+namespace ArcGISRuntime {
+  class Scene;
+}
+}
+
+namespace Dsa {
+
+class ElevationRaster;
+
+class ElevationSampler
+{
+public:
+  ElevationSampler();
+  ~ElevationSampler();
+
+  static QSharedPointer<ElevationSampler> fromScene(Esri::ArcGISRuntime::Scene* scene);
+
+  void addRaster(const QSharedPointer<const ElevationRaster>& raster);
+  int addRasters(const QStringList& paths);
+
+  bool isEmpty() const;
+  QStringList paths() const;
+
+  bool contains(double x, double y) const;
+  double elevation(double x, double y) const;
+  void elevations(const double* x, const double* y, int count, double* results) const;
+
+  bool isTileLoaded(double x, double y) const;
+  void loadTile(double x, double y) const;
+
+private:
+  static QSharedPointer<const ElevationRaster> loadRaster(const QString& path);
+
+  QVector<QSharedPointer<const ElevationRaster>> m_rasters;
+};
+
+} // Dsa
+
+#endif // ELEVATIONSAMPLER_H
@@ -21,7 +21,12 @@
 #include "LineOfSightController.h"
 
 // dsa app headers
+#include "ElevationSampler.h"
 #include "FeatureQueryResultManager.h"
+#include "GeoElementUtils.h"
+#include "GeometryProjectionCache.h"
+#include "LineOfSightEngine.h"
+#include "LocalElevationCache.h"
 #include "LocationController.h"
 #include "LocationDisplay3d.h"
 
@@ -35,16 +40,96 @@
 #include "GeoElementLineOfSight.h"
 #include "GeoView.h"
 #include "GeometryEngine.h"
+#include "GraphicsOverlay.h"
 #include "LayerListModel.h"
+#include "PolylineBuilder.h"
 #include "SceneView.h"
+#include "SimpleLineSymbol.h"
 
 // Qt headers
+#include <QRunnable>
 #include <QStringListModel>
+#include <QThreadPool>
+#include <QTimer>
+
+// STL headers
+#include <functional>
 
 using namespace Esri::ArcGISRuntime;
 
 namespace Dsa {
 
+namespace
+{
+// the most features used for line of sight analyses, above which a batch analysis on the CPU is used
+constexpr int maxFeatures = 16;
+
+// the height in meters above the surface of the observers and the target for batch analysis
+constexpr double batchObserverHeight = 2.0;
+
+// the shortest interval in milliseconds between changes to the visible by count, about one frame
+constexpr int visibleByCountInterval = 16;
+}
+
+/*!
+  \internal
+
+  The visibility of each observer of a batch analysis from one location, with the elevations
+  needed to draw the result lines.
+ */
+struct LineOfSightBatchResult
+{
+  int m_generation = 0;
+  double m_targetX = 0.0;
+  double m_targetY = 0.0;
+  double m_targetZ = 0.0;
+  QVector<LineOfSightVisibility> m_visibilities;
+  QVector<double> m_observerZ;
+};
+
+namespace
+{
+/*!
+  \internal
+
+  Traces the rays of a batch analysis on a pool thread, passing the result to \c m_deliver.
+ */
+class BatchTrace : public QRunnable
+{
+public:
+  BatchTrace(const QSharedPointer<LineOfSightEngine>& engine,
+             const QVector<LineOfSightRay>& rays,
+             const LineOfSightBatchResult& result,
+             const std::function<void(const LineOfSightBatchResult&)>& deliver):
+    m_engine(engine),
+    m_rays(rays),
+    m_result(result),
+    m_deliver(deliver)
+  {
+  }
+
+  void run() override
+  {
+    m_result.m_visibilities = m_engine->trace(m_rays);
+
+    // the elevations are read here too, as they may need tiles to be loaded
+    const QSharedPointer<const ElevationSampler> sampler = m_engine->sampler();
+    m_result.m_targetZ = sampler->elevation(m_result.m_targetX, m_result.m_targetY) + batchObserverHeight;
+    m_result.m_observerZ.resize(m_rays.size());
+    for (int i = 0; i < m_rays.size(); ++i)
+      m_result.m_observerZ[i] = sampler->elevation(m_rays.at(i).m_observerX, m_rays.at(i).m_observerY) + batchObserverHeight;
+
+    m_deliver(m_result);
+  }
+
+private:
+  QSharedPointer<LineOfSightEngine> m_engine;
+  QVector<LineOfSightRay> m_rays;
+  LineOfSightBatchResult m_result;
+  std::function<void(const LineOfSightBatchResult&)> m_deliver;
+};
+}
+
 /*!
   \class Dsa::LineOfSightController
   \inmodule Dsa
@@ -57,6 +142,13 @@ namespace Dsa {
     \li From the objects in a feature layer to the current position.
     \li From the current position to a supplied GeoElement.
   \endlist
+
+  Layers with more than \c 16 features are analysed in a batch by a \l LineOfSightEngine,
+  using the local raster elevation sources of the scene. The results are drawn as lines which
+  are green where the current position is visible and red where it is obstructed, and are
+  updated as the current position moves. The rays are traced on a background thread, one
+  location at a time; when the trace completes the lines are updated and, if the position
+  moved meanwhile, a single trace is started for its latest location.
  */
 
 /*!
@@ -81,9 +173,14 @@ int LineOfSightController::visibleByCount() const
 
 /*!
   \internal
+
+  Set the visible by count immediately, discarding any pending change.
  */
 void LineOfSightController::setVisibleByCount(int visibleByCount)
 {
+  m_visibleByCountTimer->stop();
+  m_pendingVisibleByCount = visibleByCount;
+
   if (m_visibleByCount == visibleByCount)
     return;
 
@@ -91,14 +188,60 @@ void LineOfSightController::setVisibleByCount(int visibleByCount)
   emit visibleByCountChanged();
 }
 
+/*!
+  \internal
+
+  Set the visible by count to \a visibleByCount once the current frame has passed. Changes
+  made in the meantime are combined, so \l visibleByCountChanged is emitted at most once per frame.
+ */
+void LineOfSightController::scheduleVisibleByCount(int visibleByCount)
+{
+  m_pendingVisibleByCount = visibleByCount;
+
+  if (!m_visibleByCountTimer->isActive())
+    m_visibleByCountTimer->start();
+}
+
+/*!
+  \internal
+
+  Record the \a visible state of \a lineOfSight, adjusting the pending visible by count
+  if it has changed.
+ */
+void LineOfSightController::updateVisibleBy(GeoElementLineOfSight* lineOfSight, bool visible)
+{
+  auto it = m_visibleByStates.find(lineOfSight);
+  if (it == m_visibleByStates.end() || it.value() == visible)
+    return;
+
+  it.value() = visible;
+  scheduleVisibleByCount(m_pendingVisibleByCount + (visible ? 1 : -1));
+}
+
 /*!
   \brief Constructor accepting an optional \a parent.
  */
 LineOfSightController::LineOfSightController(QObject* parent):
   AbstractTool(parent),
   m_overlayNames(new QStringListModel(this)),
-  m_lineOfSightOverlay(new AnalysisOverlay(this))
+  m_lineOfSightOverlay(new AnalysisOverlay(this)),
+  m_visibleByCountTimer(new QTimer(this)),
+  m_batchResultsOverlay(new GraphicsOverlay(this)),
+  m_visibleSymbol(new SimpleLineSymbol(SimpleLineSymbolStyle::Solid, Qt::green, 2.0f, this)),
+  m_obstructedSymbol(new SimpleLineSymbol(SimpleLineSymbolStyle::Solid, Qt::red, 2.0f, this)),
+  m_batchThreadPool(new QThreadPool(this))
 {
+  m_batchThreadPool->setMaxThreadCount(1);
+
+  m_visibleByCountTimer->setSingleShot(true);
+  m_visibleByCountTimer->setInterval(visibleByCountInterval);
+  connect(m_visibleByCountTimer, &QTimer::timeout, this, [this]()
+  {
+    setVisibleByCount(m_pendingVisibleByCount);
+  });
+
+  m_batchResultsOverlay->setSceneProperties(LayerSceneProperties(SurfacePlacement::Absolute));
+
   // connect to ToolResourceProvider signals
   auto resourecProvider = ToolResourceProvider::instance();
   connect(resourecProvider, &ToolResourceProvider::geoViewChanged, this, [this]()
@@ -123,7 +266,7 @@ LineOfSightController::LineOfSightController(QObject* parent):
     }
 
     m_geoView = sceneView;
-    sceneView->analysisOverlays()->append(m_lineOfSightOverlay);
+    addToSceneView(sceneView);
   });
 
   onOperationalLayersChanged();
@@ -135,7 +278,7 @@ LineOfSightController::LineOfSightController(QObject* parent):
   if (sceneView)
   {
     m_geoView = sceneView;
-    sceneView->analysisOverlays()->append(m_lineOfSightOverlay);
+    addToSceneView(sceneView);
   }
 }
 
@@ -145,6 +288,9 @@ LineOfSightController::LineOfSightController(QObject* parent):
 LineOfSightController::~LineOfSightController()
 {
   cancelTask();
+
+  // a running trace delivers its result to this object
+  m_batchThreadPool->waitForDone();
 }
 
 /*!
@@ -185,7 +331,20 @@ void LineOfSightController::onGeoViewChanged(GeoView* geoView)
   if (!sceneView)
     return;
 
+  addToSceneView(sceneView);
+}
+
+/*!
+  \internal
+
+  Add the overlays for the results of the analysis to \a sceneView.
+ */
+void LineOfSightController::addToSceneView(SceneView* sceneView)
+{
   sceneView->analysisOverlays()->append(m_lineOfSightOverlay);
+
+  if (!sceneView->graphicsOverlays()->contains(m_batchResultsOverlay))
+    sceneView->graphicsOverlays()->append(m_batchResultsOverlay);
 }
 
 /*!
@@ -295,6 +454,7 @@ void LineOfSightController::onQueryFeaturesCompleted(QUuid taskId, FeatureQueryR
     disconnect(conn);
 
   m_visibleByConnections.clear();
+  m_visibleByStates.clear();
   setVisibleByCount(0);
 
   // clear the QObject used as a parent for Line of Sight results
@@ -312,6 +472,12 @@ void LineOfSightController::onQueryFeaturesCompleted(QUuid taskId, FeatureQueryR
   // For each feature, obtain a point location and use it as the observer for a new
   // GeoElementLineOfSight which will be added to the overlay.
   QList<Feature*> features = resultsMgr.m_results->iterator().features(&localParent);
+  if (m_lineOfSightEngine)
+  {
+    startBatchAnalysis(features);
+    return;
+  }
+
   auto it = features.constBegin();
   auto itEnd = features.constEnd();
   for (; it != itEnd; ++it)
@@ -325,30 +491,11 @@ void LineOfSightController::onQueryFeaturesCompleted(QUuid taskId, FeatureQueryR
     lineOfSight->setVisible(m_analysisVisible);
     m_lineOfSightOverlay->analyses()->append(lineOfSight);
 
-    m_visibleByConnections.append(connect(lineOfSight, &GeoElementLineOfSight::targetVisibilityChanged, this, [this]()
+    // each analysis updates the count by the change in its own visibility
+    m_visibleByStates.insert(lineOfSight, false);
+    m_visibleByConnections.append(connect(lineOfSight, &GeoElementLineOfSight::targetVisibilityChanged, this, [this, lineOfSight]()
     {
-      int visibleCount = 0;
-      AnalysisListModel* losList = m_lineOfSightOverlay->analyses();
-      const int count = losList->rowCount();
-      for (int i = 0; i < count; ++i)
-      {
-        Analysis* analysis = losList->at(i);
-        if (!analysis)
-          continue;
-
-        GeoElementLineOfSight* lineOfSight = qobject_cast<GeoElementLineOfSight*>(analysis);
-        if (!lineOfSight)
-          continue;
-
-        // don't count Line of Sight from the current location
-        if (lineOfSight->observerGeoElement() == m_locationGeoElement)
-          continue;
-
-        if (lineOfSight->targetVisibility() == LineOfSightTargetVisibility::Visible)
-          visibleCount += 1;
-      }
-
-      setVisibleByCount(visibleCount);
+      updateVisibleBy(lineOfSight, lineOfSight->targetVisibility() == LineOfSightTargetVisibility::Visible);
     }));
   }
 }
@@ -416,6 +563,7 @@ void LineOfSightController::setAnalysisVisible(bool analysisVisible)
     return;
 
   m_analysisVisible = analysisVisible;
+  m_batchResultsOverlay->setVisible(m_analysisVisible);
 
   AnalysisListModel* model = m_lineOfSightOverlay->analyses();
   if (model == nullptr)
@@ -475,13 +623,13 @@ bool LineOfSightController::selectOverlayIndex(int selectOverlayIndex)
     return false;
   }
 
-  constexpr int maxFeatures = 16; // Due to performance reasons, limit the number of features which can be used in the analysis
+  // Due to performance reasons, larger layers are analysed in a batch using local elevation
   const int featuresCount = overlay->featureTable()->numberOfFeatures();
-  if (featuresCount > maxFeatures)
+  if (featuresCount > maxFeatures && !createLineOfSightEngine())
   {
-    emit toolErrorOccurred(QString("There are too many points in this layer (%1).\n Please choose another one with %2 or fewer points.")
+    emit toolErrorOccurred(QString("There are too many points in this layer (%1).\n Please choose another one with %2 or fewer points, or add local elevation data.")
                            .arg(QString::number(featuresCount), QString::number(maxFeatures)),
-                           QStringLiteral("For performance reasons, Line of Sight analysis is limited to a maximum number of features"));
+                           QStringLiteral("For performance reasons, Line of Sight analysis is limited to a maximum number of features without raster elevation"));
     return false;
   }
 
@@ -500,13 +648,27 @@ bool LineOfSightController::selectOverlayIndex(int selectOverlayIndex)
  */
 void LineOfSightController::clearAnalysis()
 {
-  // remove all of the results from the overlay
+  // remove all of the results from the overlays
   m_lineOfSightOverlay->analyses()->clear();
+  m_batchResultsOverlay->graphics()->clear();
+  m_batchGraphics.clear();
+  m_batchObservers.clear();
+  m_lineOfSightEngine.reset();
+  if (m_batchLocationConnection)
+  {
+    disconnect(m_batchLocationConnection);
+    GeometryProjectionCache::instance()->release(m_locationGeoElement);
+  }
+
+  // any trace which is still running belongs to this analysis and its result is discarded
+  ++m_batchGeneration;
+  m_batchRetracePending = false;
 
   for (const auto& conn : m_visibleByConnections)
     disconnect(conn);
 
   m_visibleByConnections.clear();
+  m_visibleByStates.clear();
   setVisibleByCount(0);
 
   // delete the QObject used as the parent for the analysis
@@ -517,6 +679,181 @@ void LineOfSightController::clearAnalysis()
   }
 }
 
+/*!
+  \internal
+
+  Create the engine for batch analysis from the raster elevation sources of the scene.
+
+  Returns \c false if the scene has no raster elevation which can be sampled.
+ */
+bool LineOfSightController::createLineOfSightEngine()
+{
+  QSharedPointer<const ElevationSampler> sampler = LocalElevationCache::instance()->sampler();
+  if (sampler->isEmpty())
+    return false;
+
+  m_lineOfSightEngine.reset(new LineOfSightEngine(sampler));
+  return true;
+}
+
+/*!
+  \internal
+
+  Start a batch analysis from each of \a features to the current location.
+ */
+void LineOfSightController::startBatchAnalysis(const QList<Feature*>& features)
+{
+  m_batchObservers.reserve(features.size());
+  for (Feature* feature : features)
+  {
+    if (!feature)
+      continue;
+
+    const Geometry geometry = GeometryProjectionCache::projectToWgs84(feature->geometry());
+    if (geometry.isEmpty() || geometry.geometryType() != GeometryType::Point)
+      continue;
+
+    m_batchObservers.append(Point(geometry));
+
+    Graphic* graphic = new Graphic(m_lineOfSightParent);
+    graphic->setVisible(false);
+    m_batchGraphics.append(graphic);
+  }
+
+  m_batchResultsOverlay->graphics()->append(m_batchGraphics);
+  m_batchResultsOverlay->setVisible(m_analysisVisible);
+
+  // the results are recalculated, at most once per event loop, whenever the location moves
+  GeoElementSignaler* signaler = GeometryProjectionCache::instance()->signaler(m_locationGeoElement);
+  m_batchLocationConnection = connect(signaler, &GeoElementSignaler::geometryChanged, this, &LineOfSightController::scheduleBatchUpdate);
+
+  updateBatchAnalysis();
+}
+
+/*!
+  \internal
+
+  Request that the batch analysis is updated once control returns to the event loop.
+ */
+void LineOfSightController::scheduleBatchUpdate()
+{
+  if (m_batchUpdatePending)
+    return;
+
+  m_batchUpdatePending = true;
+  QTimer::singleShot(0, this, [this]()
+  {
+    m_batchUpdatePending = false;
+    updateBatchAnalysis();
+  });
+}
+
+/*!
+  \internal
+
+  Start tracing the line of sight from each observer of the batch analysis to the current
+  location on a background thread.
+
+  Only one trace runs at a time. If one is running, another is started for the latest location
+  once it completes.
+ */
+void LineOfSightController::updateBatchAnalysis()
+{
+  if (!m_lineOfSightEngine || !m_locationGeoElement || m_batchObservers.isEmpty())
+    return;
+
+  if (m_batchTracing)
+  {
+    m_batchRetracePending = true;
+    return;
+  }
+
+  const Geometry locationGeometry = GeometryProjectionCache::instance()->wgs84Geometry(m_locationGeoElement);
+  if (locationGeometry.isEmpty() || locationGeometry.geometryType() != GeometryType::Point)
+    return;
+
+  const Point location(locationGeometry);
+  const int observerCount = m_batchObservers.size();
+  QVector<LineOfSightRay> rays(observerCount);
+  for (int i = 0; i < observerCount; ++i)
+  {
+    LineOfSightRay& ray = rays[i];
+    ray.m_observerX = m_batchObservers.at(i).x();
+    ray.m_observerY = m_batchObservers.at(i).y();
+    ray.m_observerHeight = batchObserverHeight;
+    ray.m_targetX = location.x();
+    ray.m_targetY = location.y();
+    ray.m_targetHeight = batchObserverHeight;
+  }
+
+  LineOfSightBatchResult result;
+  result.m_generation = m_batchGeneration;
+  result.m_targetX = location.x();
+  result.m_targetY = location.y();
+
+  // the result is applied on the thread of this object
+  auto deliver = [this](const LineOfSightBatchResult& traced)
+  {
+    QMetaObject::invokeMethod(this, [this, traced]()
+    {
+      applyBatchResults(traced);
+    }, Qt::QueuedConnection);
+  };
+
+  m_batchTracing = true;
+  m_batchThreadPool->start(new BatchTrace(m_lineOfSightEngine, rays, result, deliver));
+}
+
+/*!
+  \internal
+
+  Update the result lines and \l visibleByCount from a completed trace \a result.
+
+  Results of an analysis which has since been cleared are discarded.
+ */
+void LineOfSightController::applyBatchResults(const LineOfSightBatchResult& result)
+{
+  m_batchTracing = false;
+
+  if (result.m_generation == m_batchGeneration &&
+      result.m_visibilities.size() == m_batchGraphics.size())
+  {
+    int visibleCount = 0;
+    for (int i = 0; i < m_batchGraphics.size(); ++i)
+    {
+      Graphic* graphic = m_batchGraphics.at(i);
+      const LineOfSightVisibility visibility = result.m_visibilities.at(i);
+      if (visibility == LineOfSightVisibility::Unknown)
+      {
+        graphic->setVisible(false);
+        continue;
+      }
+
+      const bool visible = visibility == LineOfSightVisibility::Visible;
+      if (visible)
+        ++visibleCount;
+
+      const Point& observer = m_batchObservers.at(i);
+      PolylineBuilder builder(SpatialReference::wgs84());
+      builder.addPoint(observer.x(), observer.y(), result.m_observerZ.at(i));
+      builder.addPoint(result.m_targetX, result.m_targetY, result.m_targetZ);
+
+      graphic->setGeometry(builder.toGeometry());
+      graphic->setSymbol(visible ? m_visibleSymbol : m_obstructedSymbol);
+      graphic->setVisible(true);
+    }
+
+    scheduleVisibleByCount(visibleCount);
+  }
+
+  // the location moved, or a new analysis started, while this trace was running
+  if (m_batchRetracePending)
+  {
+    m_batchRetracePending = false;
+    updateBatchAnalysis();
+  }
+}
+
 } // Dsa
 
 // Signal Documentation
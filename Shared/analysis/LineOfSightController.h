@@ -26,22 +26,36 @@
 
 // Qt headers
 #include <QAbstractItemModel>
+#include <QHash>
+#include <QSharedPointer>
+#include <QVector>
 
 namespace Esri {
 namespace ArcGISRuntime {
   class AnalysisOverlay;
   class GeoElement;
+  class GeoElementLineOfSight;
   class GeoView;
   class LayerListModel;
   class FeatureLayer;
+  class Feature;
   class FeatureQueryResult;
+  class Graphic;
+  class GraphicsOverlay;
+  class SceneView;
+  class SimpleLineSymbol;
 }
 }
 
 class QStringListModel;
+class QThreadPool;
+class QTimer;
 
 namespace Dsa {
 
+class LineOfSightEngine;
+struct LineOfSightBatchResult;
+
 class LineOfSightController : public AbstractTool
 {
   Q_OBJECT
@@ -89,6 +103,14 @@ private:
   void cancelTask();
   void getLocationGeoElement();
   void setVisibleByCount(int visibleByCount);
+  void scheduleVisibleByCount(int visibleByCount);
+  void updateVisibleBy(Esri::ArcGISRuntime::GeoElementLineOfSight* lineOfSight, bool visible);
+  void addToSceneView(Esri::ArcGISRuntime::SceneView* sceneView);
+  bool createLineOfSightEngine();
+  void startBatchAnalysis(const QList<Esri::ArcGISRuntime::Feature*>& features);
+  void scheduleBatchUpdate();
+  void updateBatchAnalysis();
+  void applyBatchResults(const LineOfSightBatchResult& result);
 
   QStringListModel* m_overlayNames;
   Esri::ArcGISRuntime::GeoView* m_geoView = nullptr;
@@ -100,7 +122,24 @@ private:
   QMetaObject::Connection m_queryFeaturesConnection;
   bool m_analysisVisible = true;
   int m_visibleByCount = 0;
+  int m_pendingVisibleByCount = 0;
+  QTimer* m_visibleByCountTimer = nullptr;
+  QHash<Esri::ArcGISRuntime::GeoElementLineOfSight*, bool> m_visibleByStates;
   QList<QMetaObject::Connection> m_visibleByConnections;
+
+  // batch analysis on the CPU, used for layers with too many features for line of sight analyses
+  QSharedPointer<LineOfSightEngine> m_lineOfSightEngine;
+  Esri::ArcGISRuntime::GraphicsOverlay* m_batchResultsOverlay = nullptr;
+  Esri::ArcGISRuntime::SimpleLineSymbol* m_visibleSymbol = nullptr;
+  Esri::ArcGISRuntime::SimpleLineSymbol* m_obstructedSymbol = nullptr;
+  QVector<Esri::ArcGISRuntime::Point> m_batchObservers;
+  QList<Esri::ArcGISRuntime::Graphic*> m_batchGraphics;
+  QMetaObject::Connection m_batchLocationConnection;
+  bool m_batchUpdatePending = false;
+  QThreadPool* m_batchThreadPool = nullptr;
+  int m_batchGeneration = 0;
+  bool m_batchTracing = false;
+  bool m_batchRetracePending = false;
 };
 
 } // Dsa
@@ -0,0 +1,187 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "LineOfSightEngine.h"
+
+// dsa app headers
+#include "ElevationSampler.h"
+#include "Geodesy.h"
+#include "ParallelRanges.h"
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+
+namespace Dsa {
+
+namespace
+{
+// the fewest rays worth handing to a thread of their own
+constexpr int minRaysPerThread = 16;
+}
+
+/*!
+  \class Dsa::LineOfSightEngine
+  \inmodule Dsa
+  \brief Traces batches of line of sight rays over local elevation on the CPU.
+
+  Each ray runs from an observer to a target, both placed at a height above the surface.
+  The surface is sampled from an \l ElevationSampler at a fixed \l stepSize along the ray
+  and the target is obstructed if the surface rises above the sight line at any sample.
+
+  Batches of rays are split across threads, so that hundreds of observers can be traced
+  each time the target moves.
+
+  \sa LineOfSightController
+ */
+
+/*!
+  \brief Constructor taking the \a sampler for the surface.
+ */
+LineOfSightEngine::LineOfSightEngine(const QSharedPointer<const ElevationSampler>& sampler):
+  m_sampler(sampler)
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+LineOfSightEngine::~LineOfSightEngine()
+{
+}
+
+/*!
+  \brief Returns the sampler for the surface.
+ */
+QSharedPointer<const ElevationSampler> LineOfSightEngine::sampler() const
+{
+  return m_sampler;
+}
+
+/*!
+  \brief Returns the distance in meters between samples along each ray.
+
+  The default is \c 30 meters, which matches the spacing of DTED level 2.
+ */
+double LineOfSightEngine::stepSize() const
+{
+  return m_stepSize;
+}
+
+/*!
+  \brief Sets the distance in meters between samples along each ray to \a stepSize.
+ */
+void LineOfSightEngine::setStepSize(double stepSize)
+{
+  if (stepSize <= 0.0)
+    return;
+
+  m_stepSize = stepSize;
+}
+
+/*!
+  \brief Returns the maximum number of threads used to trace a batch of rays.
+
+  The default, \c 0, uses the number of cores.
+ */
+int LineOfSightEngine::threadCount() const
+{
+  return m_threadCount;
+}
+
+/*!
+  \brief Sets the maximum number of threads used to trace a batch of rays to \a threadCount.
+ */
+void LineOfSightEngine::setThreadCount(int threadCount)
+{
+  m_threadCount = std::max(0, threadCount);
+}
+
+/*!
+  \brief Returns whether the target of \a ray is visible from its observer.
+
+  Returns \c LineOfSightVisibility::Unknown if the surface beneath either end of the ray
+  has no elevation.
+ */
+LineOfSightVisibility LineOfSightEngine::trace(const LineOfSightRay& ray) const
+{
+  if (!m_sampler)
+    return LineOfSightVisibility::Unknown;
+
+  const double observerGround = m_sampler->elevation(ray.m_observerX, ray.m_observerY);
+  const double targetGround = m_sampler->elevation(ray.m_targetX, ray.m_targetY);
+  if (std::isnan(observerGround) || std::isnan(targetGround))
+    return LineOfSightVisibility::Unknown;
+
+  const double observerZ = observerGround + ray.m_observerHeight;
+  const double targetZ = targetGround + ray.m_targetHeight;
+
+  // rays are short enough to interpolate linearly in degrees between the ends
+  const double length = Geodesy::distance(ray.m_observerX, ray.m_observerY, ray.m_targetX, ray.m_targetY);
+  const int steps = static_cast<int>(std::ceil(length / m_stepSize));
+  for (int step = 1; step < steps; ++step)
+  {
+    const double t = static_cast<double>(step) / steps;
+    const double x = ray.m_observerX + (ray.m_targetX - ray.m_observerX) * t;
+    const double y = ray.m_observerY + (ray.m_targetY - ray.m_observerY) * t;
+    const double ground = m_sampler->elevation(x, y);
+    if (std::isnan(ground))
+      continue;
+
+    if (ground > observerZ + (targetZ - observerZ) * t)
+      return LineOfSightVisibility::Obstructed;
+  }
+
+  return LineOfSightVisibility::Visible;
+}
+
+/*!
+  \brief Returns the visibility of each of \a rays, in the same order.
+
+  The rays are traced in parallel and the call returns once all of them are complete.
+ */
+QVector<LineOfSightVisibility> LineOfSightEngine::trace(const QVector<LineOfSightRay>& rays) const
+{
+  QVector<LineOfSightVisibility> results(rays.size(), LineOfSightVisibility::Unknown);
+  if (rays.isEmpty())
+    return results;
+
+  // each thread writes to its own range of the results
+  LineOfSightVisibility* data = results.data();
+  const int threads = ParallelRanges::threadCount(rays.size(), minRaysPerThread, m_threadCount);
+  ParallelRanges::split(rays.size(), threads, [this, &rays, data](int, int begin, int end)
+  {
+    traceRange(rays, begin, end, data);
+  });
+
+  return results;
+}
+
+/*!
+  \internal
+
+  Trace the \a rays from \a begin up to \a end into \a results.
+ */
+void LineOfSightEngine::traceRange(const QVector<LineOfSightRay>& rays, int begin, int end, LineOfSightVisibility* results) const
+{
+  for (int i = begin; i < end; ++i)
+    results[i] = trace(rays.at(i));
+}
+
+} // Dsa
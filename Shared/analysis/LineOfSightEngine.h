@@ -0,0 +1,73 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef LINEOFSIGHTENGINE_H
+#define LINEOFSIGHTENGINE_H
+
+// Qt headers
+#include <QSharedPointer>
+#include <QVector>
+
+namespace Dsa {
+
+class ElevationSampler;
+
+struct LineOfSightRay
+{
+  // WGS84 locations, with heights in meters above the surface
+  double m_observerX = 0.0;
+  double m_observerY = 0.0;
+  double m_observerHeight = 0.0;
+  double m_targetX = 0.0;
+  double m_targetY = 0.0;
+  double m_targetHeight = 0.0;
+};
+
+enum class LineOfSightVisibility
+{
+  Visible,
+  Obstructed,
+  Unknown
+};
+
+class LineOfSightEngine
+{
+public:
+  explicit LineOfSightEngine(const QSharedPointer<const ElevationSampler>& sampler);
+  ~LineOfSightEngine();
+
+  QSharedPointer<const ElevationSampler> sampler() const;
+
+  double stepSize() const;
+  void setStepSize(double stepSize);
+
+  int threadCount() const;
+  void setThreadCount(int threadCount);
+
+  LineOfSightVisibility trace(const LineOfSightRay& ray) const;
+  QVector<LineOfSightVisibility> trace(const QVector<LineOfSightRay>& rays) const;
+
+private:
+  void traceRange(const QVector<LineOfSightRay>& rays, int begin, int end, LineOfSightVisibility* results) const;
+
+  QSharedPointer<const ElevationSampler> m_sampler;
+  double m_stepSize = 30.0;
+  int m_threadCount = 0;
+};
+
+} // Dsa
+
+#endif // LINEOFSIGHTENGINE_H
@@ -0,0 +1,289 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "LocalElevationCache.h"
+
+// dsa app headers
+#include "ElevationSampler.h"
+#include "Geodesy.h"
+#include "GeometryProjectionCache.h"
+
+// toolkit headers
+#include "ToolResourceProvider.h"
+
+// C++ API headers
+#include "ElevationSourceListModel.h"
+#include "Scene.h"
+#include "Surface.h"
+
+// Qt headers
+#include <QRunnable>
+#include <QThreadPool>
+#include <QVector>
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+namespace
+{
+// the spacing of the locations ahead of the vehicle whose tiles are read
+constexpr double prefetchStep = 500.0;
+
+/*!
+  \internal
+
+  Reads the tiles at a set of locations on a thread of the global pool.
+ */
+class TilePrefetch : public QRunnable
+{
+public:
+  TilePrefetch(const QSharedPointer<const ElevationSampler>& sampler,
+               const QVector<QPair<double, double>>& locations,
+               const QSharedPointer<QAtomicInt>& prefetching):
+    m_sampler(sampler),
+    m_locations(locations),
+    m_prefetching(prefetching)
+  {
+  }
+
+  void run() override
+  {
+    for (const auto& location : m_locations)
+    {
+      if (!m_sampler->isTileLoaded(location.first, location.second))
+        m_sampler->loadTile(location.first, location.second);
+    }
+
+    m_prefetching->storeRelease(0);
+  }
+
+private:
+  QSharedPointer<const ElevationSampler> m_sampler;
+  QVector<QPair<double, double>> m_locations;
+  QSharedPointer<QAtomicInt> m_prefetching;
+};
+}
+
+/*!
+  \class Dsa::LocalElevationCache
+  \inmodule Dsa
+  \inherits QObject
+  \brief Shared, synchronous access to the local raster elevation of the scene.
+
+  Tools which sample elevation on the CPU use the single \l ElevationSampler held by this
+  cache, so that the tiles of each \l ElevationRaster are decoded once and shared. The
+  sampler is rebuilt when the scene or its elevation sources change.
+
+  As the location of the vehicle changes, the tiles under it and along its heading, up to
+  \l prefetchDistance ahead, are read on a background thread. Analysis around the vehicle
+  then rarely has to wait for the file.
+
+  Only one prefetch runs at a time: if the vehicle moves while one is running, the next
+  location update starts a new one.
+
+  \sa ElevationSampler
+ */
+
+/*!
+  \brief Returns the shared instance of the cache.
+ */
+LocalElevationCache* LocalElevationCache::instance()
+{
+  static LocalElevationCache s_instance;
+
+  return &s_instance;
+}
+
+/*!
+  \internal
+ */
+LocalElevationCache::LocalElevationCache(QObject* parent):
+  QObject(parent),
+  m_x(std::numeric_limits<double>::quiet_NaN()),
+  m_y(std::numeric_limits<double>::quiet_NaN()),
+  m_heading(std::numeric_limits<double>::quiet_NaN()),
+  m_prefetching(new QAtomicInt(0))
+{
+  connect(ToolResourceProvider::instance(), &ToolResourceProvider::sceneChanged, this, &LocalElevationCache::onSceneChanged);
+}
+
+/*!
+  \brief Destructor.
+ */
+LocalElevationCache::~LocalElevationCache()
+{
+}
+
+/*!
+  \brief Returns the sampler for the raster elevation sources of the current scene.
+
+  The sampler is empty if the scene has no local raster elevation.
+ */
+QSharedPointer<const ElevationSampler> LocalElevationCache::sampler()
+{
+  if (!m_samplerValid)
+  {
+    if (m_scene != ToolResourceProvider::instance()->scene())
+      onSceneChanged();
+
+    m_sampler = ElevationSampler::fromScene(m_scene);
+    m_samplerValid = true;
+  }
+
+  return m_sampler;
+}
+
+/*!
+  \brief Returns the elevation in meters at the WGS84 location \a x, \a y.
+
+  Returns NaN where there is no local raster elevation.
+ */
+double LocalElevationCache::elevation(double x, double y)
+{
+  return sampler()->elevation(x, y);
+}
+
+/*!
+  \brief Returns the distance in meters ahead of the vehicle whose tiles are read.
+
+  The default is \c 5000 meters.
+ */
+double LocalElevationCache::prefetchDistance() const
+{
+  return m_prefetchDistance;
+}
+
+/*!
+  \brief Sets the distance in meters ahead of the vehicle whose tiles are read to \a prefetchDistance.
+
+  A distance of \c 0 reads only the tiles under the vehicle.
+ */
+void LocalElevationCache::setPrefetchDistance(double prefetchDistance)
+{
+  m_prefetchDistance = std::max(0.0, prefetchDistance);
+}
+
+/*!
+  \brief Handles a change in the \a location of the vehicle.
+ */
+void LocalElevationCache::onLocationChanged(const Point& location)
+{
+  const Point wgs84Location = GeometryProjectionCache::projectToWgs84(location);
+  if (wgs84Location.isEmpty())
+    return;
+
+  m_x = wgs84Location.x();
+  m_y = wgs84Location.y();
+  prefetch();
+}
+
+/*!
+  \brief Handles a change in the \a heading of the vehicle, in degrees clockwise from north.
+ */
+void LocalElevationCache::onHeadingChanged(double heading)
+{
+  m_heading = heading;
+}
+
+/*!
+  \internal
+
+  Track the elevation sources of the current scene.
+ */
+void LocalElevationCache::onSceneChanged()
+{
+  disconnect(m_sourcesInsertedConnection);
+  disconnect(m_sourcesRemovedConnection);
+  disconnect(m_sourcesResetConnection);
+
+  m_scene = ToolResourceProvider::instance()->scene();
+  if (m_scene && m_scene->baseSurface())
+  {
+    ElevationSourceListModel* sources = m_scene->baseSurface()->elevationSources();
+    m_sourcesInsertedConnection = connect(sources, &ElevationSourceListModel::rowsInserted, this, &LocalElevationCache::invalidateSampler);
+    m_sourcesRemovedConnection = connect(sources, &ElevationSourceListModel::rowsRemoved, this, &LocalElevationCache::invalidateSampler);
+    m_sourcesResetConnection = connect(sources, &ElevationSourceListModel::modelReset, this, &LocalElevationCache::invalidateSampler);
+  }
+
+  invalidateSampler();
+}
+
+/*!
+  \internal
+
+  Release the sampler, so that it is rebuilt from the current elevation sources when next needed.
+ */
+void LocalElevationCache::invalidateSampler()
+{
+  m_sampler.reset();
+  m_samplerValid = false;
+  emit samplerChanged();
+}
+
+/*!
+  \internal
+
+  Read the tiles under the vehicle and along its heading on a background thread.
+ */
+void LocalElevationCache::prefetch()
+{
+  if (std::isnan(m_x) || std::isnan(m_y))
+    return;
+
+  const QSharedPointer<const ElevationSampler> localSampler = sampler();
+  if (localSampler->isEmpty())
+    return;
+
+  if (!m_prefetching->testAndSetAcquire(0, 1))
+    return;
+
+  QVector<QPair<double, double>> locations;
+  locations.append(qMakePair(m_x, m_y));
+
+  if (!std::isnan(m_heading))
+  {
+    // offsets in degrees for each meter travelled along the heading
+    const double headingRadians = m_heading * Geodesy::degreesToRadians;
+    const double metersToDegrees = 1.0 / Geodesy::metersPerDegree;
+    const double latitudeScale = std::max(std::cos(m_y * Geodesy::degreesToRadians), 1e-6);
+    const double dx = std::sin(headingRadians) * metersToDegrees / latitudeScale;
+    const double dy = std::cos(headingRadians) * metersToDegrees;
+
+    for (double distance = prefetchStep; distance <= m_prefetchDistance; distance += prefetchStep)
+      locations.append(qMakePair(m_x + dx * distance, m_y + dy * distance));
+  }
+
+  QThreadPool::globalInstance()->start(new TilePrefetch(localSampler, locations, m_prefetching));
+}
+
+} // Dsa
+
+// Signal Documentation
+/*!
+  \fn void LocalElevationCache::samplerChanged();
+  \brief Signal emitted when the elevation sources of the scene change.
+
+  The \l sampler is rebuilt when it is next used.
+ */
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef LOCALELEVATIONCACHE_H
+#define LOCALELEVATIONCACHE_H
+
+// C++ API headers
+#include "Point.h"
+
+// Qt headers
+#include <QAtomicInt>
+#include <QObject>
+#include <QSharedPointer>
+
+namespace Esri {
+namespace ArcGISRuntime {
+  class Scene;
+}
+}
+
+namespace Dsa {
+
+class ElevationSampler;
+
+class LocalElevationCache : public QObject
+{
+  Q_OBJECT
+
+public:
+  static LocalElevationCache* instance();
+
+  ~LocalElevationCache();
+
+  QSharedPointer<const ElevationSampler> sampler();
+  double elevation(double x, double y);
+
+  double prefetchDistance() const;
+  void setPrefetchDistance(double prefetchDistance);
+
+public slots:
+  void onLocationChanged(const Esri::ArcGISRuntime::Point& location);
+  void onHeadingChanged(double heading);
+
+signals:
+  void samplerChanged();
+
+private:
+  explicit LocalElevationCache(QObject* parent = nullptr);
+
+  void onSceneChanged();
+  void invalidateSampler();
+  void prefetch();
+
+  Esri::ArcGISRuntime::Scene* m_scene = nullptr;
+  QMetaObject::Connection m_sourcesInsertedConnection;
+  QMetaObject::Connection m_sourcesRemovedConnection;
+  QMetaObject::Connection m_sourcesResetConnection;
+  QSharedPointer<const ElevationSampler> m_sampler;
+  bool m_samplerValid = false;
+
+  // the last known WGS84 location and heading of the vehicle
+  double m_x;
+  double m_y;
+  double m_heading;
+  double m_prefetchDistance = 5000.0;
+  QSharedPointer<QAtomicInt> m_prefetching;
+};
+
+} // Dsa
+
+#endif // LOCALELEVATIONCACHE_H
@@ -100,6 +100,8 @@ void LocationViewshed360::setPoint(const Point& point)
 {
   static_cast<LocationViewshed*>(viewshed())->setLocation(point);
   m_locationViewshedGraphic->setGeometry(point);
+
+  emit pointChanged();
 }
 
 /*!
@@ -161,3 +163,9 @@ void LocationViewshed360::setPitch(double pitch)
 }
 
 } // Dsa
+
+// Signal Documentation
+/*!
+  \fn void LocationViewshed360::pointChanged();
+  \brief Signal emitted when the point which the viewshed is centered upon changes.
+ */
@@ -51,6 +51,9 @@ public:
   double pitch() const override;
   void setPitch(double pitch) override;
 
+signals:
+  void pointChanged();
+
 private:
   Q_DISABLE_COPY(LocationViewshed360)
   LocationViewshed360() = delete;
@@ -0,0 +1,582 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "TerrainProfileController.h"
+
+// dsa app headers
+#include "AnalysisResultCache.h"
+#include "ElevationSampler.h"
+#include "GeometryProjectionCache.h"
+#include "LocalElevationCache.h"
+#include "MarkupController.h"
+
+// toolkit headers
+#include "ToolManager.h"
+
+// C++ API headers
+#include "Graphic.h"
+#include "GraphicListModel.h"
+#include "GraphicsOverlay.h"
+#include "ImmutablePart.h"
+#include "ImmutablePartCollection.h"
+#include "Polyline.h"
+
+// Qt headers
+#include <QRunnable>
+#include <QThreadPool>
+
+// STL headers
+#include <functional>
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \internal
+
+  A profile calculated on a pool thread, for the request numbered \c m_generation.
+ */
+struct TerrainProfileResult
+{
+  int m_generation = 0;
+  TerrainProfile m_profile;
+};
+
+/*!
+  \internal
+
+  An intervisibility matrix calculated on a pool thread, for the request numbered \c m_generation.
+ */
+struct IntervisibilityResult
+{
+  int m_generation = 0;
+  int m_pointCount = 0;
+  QVector<LineOfSightVisibility> m_visibilities;
+};
+
+namespace
+{
+/*!
+  \internal
+
+  Calculates the profile along the parts of a path on a pool thread, passing the result to \c m_deliver.
+ */
+class ProfileCalculation : public QRunnable
+{
+public:
+  ProfileCalculation(const QSharedPointer<TerrainProfileEngine>& engine,
+                     const QVector<QVector<QPointF>>& parts,
+                     int generation,
+                     const std::function<void(const TerrainProfileResult&)>& deliver):
+    m_engine(engine),
+    m_parts(parts),
+    m_generation(generation),
+    m_deliver(deliver)
+  {
+  }
+
+  void run() override
+  {
+    TerrainProfileResult result;
+    result.m_generation = m_generation;
+    result.m_profile = m_engine->profile(m_parts);
+    m_deliver(result);
+  }
+
+private:
+  QSharedPointer<TerrainProfileEngine> m_engine;
+  QVector<QVector<QPointF>> m_parts;
+  int m_generation = 0;
+  std::function<void(const TerrainProfileResult&)> m_deliver;
+};
+
+/*!
+  \internal
+
+  Calculates the intervisibility of a set of points on a pool thread, passing the result to \c m_deliver.
+ */
+class IntervisibilityCalculation : public QRunnable
+{
+public:
+  IntervisibilityCalculation(const QSharedPointer<TerrainProfileEngine>& engine,
+                             const QVector<IntervisibilityPoint>& points,
+                             int generation,
+                             const std::function<void(const IntervisibilityResult&)>& deliver):
+    m_engine(engine),
+    m_points(points),
+    m_generation(generation),
+    m_deliver(deliver)
+  {
+  }
+
+  void run() override
+  {
+    IntervisibilityResult result;
+    result.m_generation = m_generation;
+    result.m_pointCount = m_points.size();
+    result.m_visibilities = m_engine->intervisibility(m_points);
+    m_deliver(result);
+  }
+
+private:
+  QSharedPointer<TerrainProfileEngine> m_engine;
+  QVector<IntervisibilityPoint> m_points;
+  int m_generation = 0;
+  std::function<void(const IntervisibilityResult&)> m_deliver;
+};
+}
+
+/*!
+  \class Dsa::TerrainProfileController
+  \inmodule Dsa
+  \inherits AbstractTool
+  \brief Tool controller for terrain profiles and intervisibility.
+
+  A profile samples the elevation of the surface along a path, such as a markup polyline.
+  Intervisibility tests whether each of a set of points can see each of the others.
+
+  Both are computed on the CPU by a \l TerrainProfileEngine from the local raster elevation
+  of the scene (see \l LocalElevationCache), and sightlines are corrected for the curvature
+  of the earth and refraction. If the scene has no local raster elevation,
+  \l toolErrorOccurred is emitted.
+
+  The calculations run on a pool thread, so that long paths and large sets of points do not
+  block the UI. \l profileChanged and \l intervisibilityChanged are emitted when they
+  complete. While one is running, only the latest new request of the same kind is kept and
+  it is run once the current one completes.
+
+  \sa LineOfSightController
+ */
+
+/*!
+  \brief Constructor taking an optional \a parent.
+ */
+TerrainProfileController::TerrainProfileController(QObject* parent /* = nullptr */):
+  AbstractTool(parent),
+  m_threadPool(new QThreadPool(this))
+{
+  // one profile and one intervisibility matrix may be calculated at once
+  m_threadPool->setMaxThreadCount(2);
+
+  // the engine is created again from the new sampler when next needed
+  connect(LocalElevationCache::instance(), &LocalElevationCache::samplerChanged, this, [this]()
+  {
+    m_engine.reset();
+  });
+
+  ToolManager::instance().addTool(this);
+}
+
+/*!
+  \brief Destructor.
+ */
+TerrainProfileController::~TerrainProfileController()
+{
+  m_threadPool->waitForDone();
+}
+
+/*!
+  \brief Returns the name of this tool - \c "Terrain Profile".
+ */
+QString TerrainProfileController::toolName() const
+{
+  return QStringLiteral("Terrain Profile");
+}
+
+/*!
+  \brief Starts calculating the profile of the surface along the polyline \a path.
+
+  Each part of the polyline is profiled separately and the profile is broken between
+  them (see \l TerrainProfileEngine::profile). \l profileChanged is emitted when the
+  calculation completes.
+
+  Returns \c false if \a path is not a polyline or there is no local elevation.
+ */
+bool TerrainProfileController::calculateProfile(const Geometry& path)
+{
+  if (path.isEmpty() || path.geometryType() != GeometryType::Polyline)
+    return false;
+
+  if (!engine())
+    return false;
+
+  const Polyline wgs84Path = geometry_cast<Polyline>(GeometryProjectionCache::projectToWgs84(path));
+  const ImmutablePartCollection parts = wgs84Path.parts();
+  const int partCount = parts.size();
+  QVector<QVector<QPointF>> partVertices;
+  partVertices.reserve(partCount);
+  for (int p = 0; p < partCount; ++p)
+  {
+    const ImmutablePart part = parts.part(p);
+    const int pointCount = part.pointCount();
+    QVector<QPointF> vertices;
+    vertices.reserve(pointCount);
+    for (int i = 0; i < pointCount; ++i)
+    {
+      const Point point = part.point(i);
+      vertices.append(QPointF(point.x(), point.y()));
+    }
+
+    partVertices.append(vertices);
+  }
+
+  m_pendingProfileParts = partVertices;
+  ++m_profileGeneration;
+  startProfile();
+
+  return true;
+}
+
+/*!
+  \brief Calculates the profile along the selected markup line.
+
+  If no markup is selected, the most recently drawn markup is used. Returns \c false if
+  there is no markup line or there is no local elevation.
+ */
+bool TerrainProfileController::calculateMarkupProfile()
+{
+  MarkupController* markupTool = ToolManager::instance().tool<MarkupController>();
+  if (!markupTool || !markupTool->sketchOverlay())
+    return false;
+
+  GraphicsOverlay* markupOverlay = markupTool->sketchOverlay();
+  QList<Graphic*> graphics = markupOverlay->selectedGraphics();
+  if (graphics.isEmpty())
+  {
+    GraphicListModel* allGraphics = markupOverlay->graphics();
+    for (int i = allGraphics->rowCount() - 1; i >= 0; --i)
+    {
+      Graphic* graphic = allGraphics->at(i);
+      if (graphic && graphic->geometry().geometryType() == GeometryType::Polyline)
+      {
+        graphics.append(graphic);
+        break;
+      }
+    }
+  }
+
+  for (Graphic* graphic : graphics)
+  {
+    if (graphic && graphic->geometry().geometryType() == GeometryType::Polyline)
+      return calculateProfile(graphic->geometry());
+  }
+
+  return false;
+}
+
+/*!
+  \brief Clears the profile.
+ */
+void TerrainProfileController::clearProfile()
+{
+  // discard any profile which is being calculated
+  ++m_profileGeneration;
+  m_pendingProfileParts.clear();
+  m_profileRecalculatePending = false;
+
+  if (m_profile.isEmpty())
+    return;
+
+  m_profile = TerrainProfile();
+  emit profileChanged();
+}
+
+/*!
+  \brief Returns the current profile.
+ */
+const TerrainProfile& TerrainProfileController::profile() const
+{
+  return m_profile;
+}
+
+/*!
+  \property TerrainProfileController::profileDistances
+  \brief Returns the distance in meters of each sample of the profile from the start of the path.
+ */
+QVariantList TerrainProfileController::profileDistances() const
+{
+  QVariantList distances;
+  distances.reserve(m_profile.size());
+  for (double distance : m_profile.m_distances)
+    distances.append(distance);
+
+  return distances;
+}
+
+/*!
+  \property TerrainProfileController::profileElevations
+  \brief Returns the elevation in meters of each sample of the profile.
+
+  Elevations are NaN where the surface has no data.
+ */
+QVariantList TerrainProfileController::profileElevations() const
+{
+  QVariantList elevations;
+  elevations.reserve(m_profile.size());
+  for (double elevation : m_profile.m_elevations)
+    elevations.append(elevation);
+
+  return elevations;
+}
+
+/*!
+  \property TerrainProfileController::profileLength
+  \brief Returns the length of the profile in meters.
+ */
+double TerrainProfileController::profileLength() const
+{
+  return m_profile.isEmpty() ? 0.0 : m_profile.m_distances.last();
+}
+
+/*!
+  \brief Starts calculating the intervisibility of \a points, each placed \a height meters above the surface.
+
+  \l intervisibilityChanged is emitted when the calculation completes.
+
+  Returns \c false if there is no local elevation.
+ */
+bool TerrainProfileController::calculateIntervisibility(const QList<Point>& points, double height)
+{
+  if (!engine())
+    return false;
+
+  QVector<IntervisibilityPoint> wgs84Points;
+  wgs84Points.reserve(points.size());
+  for (const Point& point : points)
+  {
+    const Point wgs84Point = GeometryProjectionCache::projectToWgs84(point);
+    IntervisibilityPoint intervisibilityPoint;
+    intervisibilityPoint.m_x = wgs84Point.x();
+    intervisibilityPoint.m_y = wgs84Point.y();
+    intervisibilityPoint.m_height = height;
+    wgs84Points.append(intervisibilityPoint);
+  }
+
+  m_pendingIntervisibilityPoints = wgs84Points;
+  ++m_intervisibilityGeneration;
+  startIntervisibility();
+
+  return true;
+}
+
+/*!
+  \brief Clears the intervisibility.
+ */
+void TerrainProfileController::clearIntervisibility()
+{
+  // discard any matrix which is being calculated
+  ++m_intervisibilityGeneration;
+  m_pendingIntervisibilityPoints.clear();
+  m_intervisibilityRecalculatePending = false;
+
+  if (m_intervisibilityPointCount == 0)
+    return;
+
+  m_intervisibility.clear();
+  m_intervisibilityPointCount = 0;
+  emit intervisibilityChanged();
+}
+
+/*!
+  \brief Returns the intervisibility matrix of the last points.
+
+  \sa TerrainProfileEngine::intervisibility
+ */
+QVector<LineOfSightVisibility> TerrainProfileController::intervisibilityMatrix() const
+{
+  return m_intervisibility;
+}
+
+/*!
+  \property TerrainProfileController::intervisibilityPointCount
+  \brief Returns the number of points in the intervisibility matrix.
+ */
+int TerrainProfileController::intervisibilityPointCount() const
+{
+  return m_intervisibilityPointCount;
+}
+
+/*!
+  \brief Returns whether the point at \a toIndex is visible from the point at \a fromIndex.
+ */
+bool TerrainProfileController::isVisible(int fromIndex, int toIndex) const
+{
+  if (fromIndex < 0 || toIndex < 0 || fromIndex >= m_intervisibilityPointCount || toIndex >= m_intervisibilityPointCount)
+    return false;
+
+  return m_intervisibility.at(fromIndex * m_intervisibilityPointCount + toIndex) == LineOfSightVisibility::Visible;
+}
+
+/*!
+  \internal
+
+  Returns the engine for the local elevation of the scene, or \c nullptr if there is none.
+ */
+TerrainProfileEngine* TerrainProfileController::engine()
+{
+  if (m_engine)
+    return m_engine.data();
+
+  const QSharedPointer<const ElevationSampler> sampler = LocalElevationCache::instance()->sampler();
+  if (sampler->isEmpty())
+  {
+    emit toolErrorOccurred(QStringLiteral("Terrain profile requires local elevation"),
+                           QStringLiteral("Add DTED or GeoTIFF elevation data to calculate profiles"));
+    return nullptr;
+  }
+
+  m_engine.reset(new TerrainProfileEngine(sampler));
+  m_engine->setResultCache(AnalysisResultCache::instance());
+  return m_engine.data();
+}
+
+/*!
+  \internal
+
+  Start calculating the profile along the pending parts on a pool thread, unless a
+  profile is already being calculated.
+ */
+void TerrainProfileController::startProfile()
+{
+  if (m_profileCalculating)
+  {
+    m_profileRecalculatePending = true;
+    return;
+  }
+
+  if (m_pendingProfileParts.isEmpty() || !engine())
+    return;
+
+  // the result is applied on the thread of this object
+  auto deliver = [this](const TerrainProfileResult& calculated)
+  {
+    QMetaObject::invokeMethod(this, [this, calculated]()
+    {
+      applyProfile(calculated);
+    }, Qt::QueuedConnection);
+  };
+
+  m_profileCalculating = true;
+  m_threadPool->start(new ProfileCalculation(m_engine, m_pendingProfileParts, m_profileGeneration, deliver));
+  m_pendingProfileParts.clear();
+}
+
+/*!
+  \internal
+
+  Update the profile from a completed calculation \a result.
+
+  Results of a request which has since been replaced or cleared are discarded.
+ */
+void TerrainProfileController::applyProfile(const TerrainProfileResult& result)
+{
+  m_profileCalculating = false;
+
+  if (result.m_generation == m_profileGeneration)
+  {
+    m_profile = result.m_profile;
+    emit profileChanged();
+  }
+
+  // a new path was requested while this profile was being calculated
+  if (m_profileRecalculatePending)
+  {
+    m_profileRecalculatePending = false;
+    startProfile();
+  }
+}
+
+/*!
+  \internal
+
+  Start calculating the intervisibility of the pending points on a pool thread, unless a
+  matrix is already being calculated.
+ */
+void TerrainProfileController::startIntervisibility()
+{
+  if (m_intervisibilityCalculating)
+  {
+    m_intervisibilityRecalculatePending = true;
+    return;
+  }
+
+  if (m_pendingIntervisibilityPoints.isEmpty() || !engine())
+    return;
+
+  // the result is applied on the thread of this object
+  auto deliver = [this](const IntervisibilityResult& calculated)
+  {
+    QMetaObject::invokeMethod(this, [this, calculated]()
+    {
+      applyIntervisibility(calculated);
+    }, Qt::QueuedConnection);
+  };
+
+  m_intervisibilityCalculating = true;
+  m_threadPool->start(new IntervisibilityCalculation(m_engine, m_pendingIntervisibilityPoints, m_intervisibilityGeneration, deliver));
+  m_pendingIntervisibilityPoints.clear();
+}
+
+/*!
+  \internal
+
+  Update the intervisibility matrix from a completed calculation \a result.
+
+  Results of a request which has since been replaced or cleared are discarded.
+ */
+void TerrainProfileController::applyIntervisibility(const IntervisibilityResult& result)
+{
+  m_intervisibilityCalculating = false;
+
+  if (result.m_generation == m_intervisibilityGeneration)
+  {
+    m_intervisibility = result.m_visibilities;
+    m_intervisibilityPointCount = result.m_pointCount;
+    emit intervisibilityChanged();
+  }
+
+  // new points were requested while this matrix was being calculated
+  if (m_intervisibilityRecalculatePending)
+  {
+    m_intervisibilityRecalculatePending = false;
+    startIntervisibility();
+  }
+}
+
+} // Dsa
+
+// Signal Documentation
+/*!
+  \fn void TerrainProfileController::profileChanged();
+  \brief Signal emitted when the profile changes.
+ */
+
+/*!
+  \fn void TerrainProfileController::intervisibilityChanged();
+  \brief Signal emitted when the intervisibility matrix changes.
+ */
+
+/*!
+  \fn void TerrainProfileController::toolErrorOccurred(const QString& errorMessage, const QString& additionalMessage);
+  \brief Signal emitted when an error occurs.
+
+  An \a errorMessage and \a additionalMessage are passed through as parameters, describing
+  the error that occurred.
+ */
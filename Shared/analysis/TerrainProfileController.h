@@ -0,0 +1,105 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef TERRAINPROFILECONTROLLER_H
+#define TERRAINPROFILECONTROLLER_H
+
+// dsa app headers
+#include "TerrainProfileEngine.h"
+
+// toolkit headers
+#include "AbstractTool.h"
+
+// C++ API headers
+#include "Geometry.h"
+#include "Point.h"
+
+// Qt headers
+#include <QList>
+#include <QVariantList>
+
+class QThreadPool;
+
+namespace Dsa {
+
+struct IntervisibilityResult;
+struct TerrainProfileResult;
+
+class TerrainProfileController : public AbstractTool
+{
+  Q_OBJECT
+
+  Q_PROPERTY(QVariantList profileDistances READ profileDistances NOTIFY profileChanged)
+  Q_PROPERTY(QVariantList profileElevations READ profileElevations NOTIFY profileChanged)
+  Q_PROPERTY(double profileLength READ profileLength NOTIFY profileChanged)
+  Q_PROPERTY(int intervisibilityPointCount READ intervisibilityPointCount NOTIFY intervisibilityChanged)
+
+public:
+  explicit TerrainProfileController(QObject* parent = nullptr);
+  ~TerrainProfileController();
+
+  QString toolName() const override;
+
+  bool calculateProfile(const Esri::ArcGISRuntime::Geometry& path);
+  Q_INVOKABLE bool calculateMarkupProfile();
+  Q_INVOKABLE void clearProfile();
+
+  const TerrainProfile& profile() const;
+  QVariantList profileDistances() const;
+  QVariantList profileElevations() const;
+  double profileLength() const;
+
+  bool calculateIntervisibility(const QList<Esri::ArcGISRuntime::Point>& points, double height);
+  Q_INVOKABLE void clearIntervisibility();
+
+  QVector<LineOfSightVisibility> intervisibilityMatrix() const;
+  int intervisibilityPointCount() const;
+  Q_INVOKABLE bool isVisible(int fromIndex, int toIndex) const;
+
+signals:
+  void profileChanged();
+  void intervisibilityChanged();
+  void toolErrorOccurred(const QString& errorMessage, const QString& additionalMessage);
+
+private:
+  TerrainProfileEngine* engine();
+  void startProfile();
+  void applyProfile(const TerrainProfileResult& result);
+  void startIntervisibility();
+  void applyIntervisibility(const IntervisibilityResult& result);
+
+  QSharedPointer<TerrainProfileEngine> m_engine;
+  QThreadPool* m_threadPool = nullptr;
+
+  // the profile is calculated on a pool thread, one at a time, and the latest request is run next
+  TerrainProfile m_profile;
+  QVector<QVector<QPointF>> m_pendingProfileParts;
+  int m_profileGeneration = 0;
+  bool m_profileCalculating = false;
+  bool m_profileRecalculatePending = false;
+
+  // as is the intervisibility matrix
+  QVector<LineOfSightVisibility> m_intervisibility;
+  int m_intervisibilityPointCount = 0;
+  QVector<IntervisibilityPoint> m_pendingIntervisibilityPoints;
+  int m_intervisibilityGeneration = 0;
+  bool m_intervisibilityCalculating = false;
+  bool m_intervisibilityRecalculatePending = false;
+};
+
+} // Dsa
+
+#endif // TERRAINPROFILECONTROLLER_H
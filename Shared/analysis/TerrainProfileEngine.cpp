@@ -0,0 +1,468 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "TerrainProfileEngine.h"
+
+// dsa app headers
+#include "AnalysisResultCache.h"
+#include "ElevationSampler.h"
+#include "Geodesy.h"
+#include "ParallelRanges.h"
+
+// STL headers
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+namespace Dsa {
+
+namespace
+{
+// the number of samples along a sightline which are read from the sampler together
+constexpr int sightlineBatchSize = 256;
+
+// the fewest sightlines worth handing to a thread of their own
+constexpr int minSightlinesPerThread = 64;
+}
+
+/*!
+  \class Dsa::TerrainProfile
+  \inmodule Dsa
+  \brief The elevation sampled along a path, as computed by \l TerrainProfileEngine.
+ */
+
+/*!
+  \brief Returns whether the profile has no samples.
+ */
+bool TerrainProfile::isEmpty() const
+{
+  return m_distances.isEmpty();
+}
+
+/*!
+  \brief Returns the number of samples in the profile.
+ */
+int TerrainProfile::size() const
+{
+  return m_distances.size();
+}
+
+/*!
+  \class Dsa::TerrainProfileEngine
+  \inmodule Dsa
+  \brief Samples terrain profiles and intervisibility over local elevation on the CPU.
+
+  A profile samples the surface at a fixed \l sampleInterval along a path, such as a markup
+  polyline or a route. Intervisibility tests the sightline between every pair of a set of
+  points, each placed at a height above the surface.
+
+  Samples are read from the \l ElevationSampler in batches, using its vectorised bilinear
+  interpolation, and the sightlines of an intervisibility matrix are split across threads.
+
+  Unlike \l LineOfSightEngine, sightlines are corrected for the curvature of the earth and
+  for atmospheric refraction: the surface at distance d along a sightline of length D rises
+  by d(D - d)(1 - k) / 2R towards the sightline, where R is the radius of the earth and k the
+  \l refractionCoefficient. Over 10 km this is about 5 meters at the middle of the sightline.
+
+  When a \l resultCache is set, profiles and intervisibility matrices are looked up in it
+  before they are computed and stored in it afterwards.
+
+  \sa TerrainProfileController
+ */
+
+/*!
+  \brief Constructor taking the \a sampler for the surface.
+ */
+TerrainProfileEngine::TerrainProfileEngine(const QSharedPointer<const ElevationSampler>& sampler):
+  m_sampler(sampler)
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+TerrainProfileEngine::~TerrainProfileEngine()
+{
+}
+
+/*!
+  \brief Returns the sampler for the surface.
+ */
+QSharedPointer<const ElevationSampler> TerrainProfileEngine::sampler() const
+{
+  return m_sampler;
+}
+
+/*!
+  \brief Returns the distance in meters between samples along profiles and sightlines.
+
+  The default is \c 30 meters, which matches the spacing of DTED level 2.
+ */
+double TerrainProfileEngine::sampleInterval() const
+{
+  return m_sampleInterval;
+}
+
+/*!
+  \brief Sets the distance in meters between samples along profiles and sightlines to \a sampleInterval.
+ */
+void TerrainProfileEngine::setSampleInterval(double sampleInterval)
+{
+  if (sampleInterval <= 0.0)
+    return;
+
+  m_sampleInterval = sampleInterval;
+}
+
+/*!
+  \brief Returns whether sightlines are corrected for the curvature of the earth and refraction.
+
+  The default is \c true.
+ */
+bool TerrainProfileEngine::isCurvatureCorrected() const
+{
+  return m_curvatureCorrected;
+}
+
+/*!
+  \brief Sets whether sightlines are corrected for the curvature of the earth and refraction to \a curvatureCorrected.
+ */
+void TerrainProfileEngine::setCurvatureCorrected(bool curvatureCorrected)
+{
+  m_curvatureCorrected = curvatureCorrected;
+}
+
+/*!
+  \brief Returns the coefficient of atmospheric refraction.
+
+  The default is \c 0.13, the standard value for visible light. Use \c 0 to correct for
+  curvature only.
+ */
+double TerrainProfileEngine::refractionCoefficient() const
+{
+  return m_refractionCoefficient;
+}
+
+/*!
+  \brief Sets the coefficient of atmospheric refraction to \a refractionCoefficient.
+ */
+void TerrainProfileEngine::setRefractionCoefficient(double refractionCoefficient)
+{
+  if (refractionCoefficient < 0.0 || refractionCoefficient >= 1.0)
+    return;
+
+  m_refractionCoefficient = refractionCoefficient;
+}
+
+/*!
+  \brief Returns the maximum number of threads used for an intervisibility matrix.
+
+  The default, \c 0, uses the number of cores.
+ */
+int TerrainProfileEngine::threadCount() const
+{
+  return m_threadCount;
+}
+
+/*!
+  \brief Sets the maximum number of threads used for an intervisibility matrix to \a threadCount.
+ */
+void TerrainProfileEngine::setThreadCount(int threadCount)
+{
+  m_threadCount = std::max(0, threadCount);
+}
+
+/*!
+  \brief Returns the cache where profiles and intervisibility are stored, or \c nullptr if there is none.
+ */
+AnalysisResultCache* TerrainProfileEngine::resultCache() const
+{
+  return m_resultCache;
+}
+
+/*!
+  \brief Sets the cache where profiles and intervisibility are stored to \a resultCache.
+
+  The cache is not owned by the engine.
+ */
+void TerrainProfileEngine::setResultCache(AnalysisResultCache* resultCache)
+{
+  m_resultCache = resultCache;
+}
+
+/*!
+  \brief Returns the profile of the surface along the WGS84 vertices of \a path.
+
+  The surface is sampled every \l sampleInterval meters from the start of the path and at
+  its end. Elevations are NaN where the surface has no data.
+ */
+TerrainProfile TerrainProfileEngine::profile(const QVector<QPointF>& path) const
+{
+  TerrainProfile result;
+  if (path.isEmpty() || !m_sampler)
+    return result;
+
+  QString key;
+  if (m_resultCache)
+  {
+    QVector<double> values{m_sampleInterval};
+    values.reserve(1 + path.size() * 2);
+    for (const QPointF& point : path)
+      values << point.x() << point.y();
+
+    key = AnalysisResultCache::resultKey(QStringLiteral("profile"), values, *m_sampler);
+    if (m_resultCache->findProfile(key, result))
+      return result;
+  }
+
+  // segments are short enough to interpolate linearly in degrees between the vertices
+  double segmentStart = 0.0;
+  double nextSample = 0.0;
+  for (int i = 1; i < path.size(); ++i)
+  {
+    const QPointF& from = path.at(i - 1);
+    const QPointF& to = path.at(i);
+    const double length = Geodesy::distance(from.x(), from.y(), to.x(), to.y());
+    for (; nextSample < segmentStart + length; nextSample += m_sampleInterval)
+    {
+      const double t = (nextSample - segmentStart) / length;
+      result.m_x.append(from.x() + (to.x() - from.x()) * t);
+      result.m_y.append(from.y() + (to.y() - from.y()) * t);
+      result.m_distances.append(nextSample);
+    }
+
+    segmentStart += length;
+  }
+
+  result.m_x.append(path.last().x());
+  result.m_y.append(path.last().y());
+  result.m_distances.append(segmentStart);
+
+  result.m_elevations.resize(result.m_x.size());
+  m_sampler->elevations(result.m_x.constData(), result.m_y.constData(), result.m_x.size(), result.m_elevations.data());
+
+  if (m_resultCache)
+    m_resultCache->insertProfile(key, result);
+
+  return result;
+}
+
+/*!
+  \brief Returns the profile of the surface along each of the WGS84 \a parts of a multipart path.
+
+  Each part is profiled separately, as by the single path overload, and the profiles are
+  joined in order. The profile is broken at each part boundary by a sample at the end of
+  the previous part whose elevation is NaN, and the distances continue along the next part
+  without including the gap between the parts.
+ */
+TerrainProfile TerrainProfileEngine::profile(const QVector<QVector<QPointF>>& parts) const
+{
+  TerrainProfile result;
+  for (const QVector<QPointF>& part : parts)
+  {
+    const TerrainProfile partProfile = profile(part);
+    if (partProfile.isEmpty())
+      continue;
+
+    double offset = 0.0;
+    if (!result.isEmpty())
+    {
+      offset = result.m_distances.last();
+      result.m_x.append(result.m_x.last());
+      result.m_y.append(result.m_y.last());
+      result.m_distances.append(offset);
+      result.m_elevations.append(std::numeric_limits<double>::quiet_NaN());
+    }
+
+    result.m_x += partProfile.m_x;
+    result.m_y += partProfile.m_y;
+    result.m_elevations += partProfile.m_elevations;
+    for (double distance : partProfile.m_distances)
+      result.m_distances.append(offset + distance);
+  }
+
+  return result;
+}
+
+/*!
+  \brief Returns whether \a to is visible from \a from.
+
+  Returns \c LineOfSightVisibility::Unknown if the surface beneath either point has no elevation.
+ */
+LineOfSightVisibility TerrainProfileEngine::sightline(const IntervisibilityPoint& from, const IntervisibilityPoint& to) const
+{
+  if (!m_sampler)
+    return LineOfSightVisibility::Unknown;
+
+  const double fromGround = m_sampler->elevation(from.m_x, from.m_y);
+  const double toGround = m_sampler->elevation(to.m_x, to.m_y);
+  if (std::isnan(fromGround) || std::isnan(toGround))
+    return LineOfSightVisibility::Unknown;
+
+  SampleBuffers buffers;
+  return traceSightline(from, fromGround + from.m_height, to, toGround + to.m_height, buffers);
+}
+
+/*!
+  \brief Returns the visibility between each pair of \a points.
+
+  The result is an N x N matrix in row major order, where N is the number of points: the
+  value at row i and column j is the visibility of point j from point i. Sightlines are
+  symmetric, so each pair is traced once. Points are visible from themselves unless the
+  surface beneath them has no elevation.
+
+  The sightlines are traced in parallel and the call returns once all of them are complete.
+ */
+QVector<LineOfSightVisibility> TerrainProfileEngine::intervisibility(const QVector<IntervisibilityPoint>& points) const
+{
+  const int count = points.size();
+  QVector<LineOfSightVisibility> results(count * count, LineOfSightVisibility::Unknown);
+  if (count == 0 || !m_sampler)
+    return results;
+
+  QString key;
+  if (m_resultCache)
+  {
+    QVector<double> values{m_sampleInterval, m_curvatureCorrected ? 1.0 : 0.0, m_refractionCoefficient};
+    values.reserve(3 + count * 3);
+    for (const IntervisibilityPoint& point : points)
+      values << point.m_x << point.m_y << point.m_height;
+
+    key = AnalysisResultCache::resultKey(QStringLiteral("intervisibility"), values, *m_sampler);
+    if (m_resultCache->findIntervisibility(key, count, results))
+      return results;
+  }
+
+  // the height of each point above the datum, or NaN where the surface has no elevation
+  QVector<double> x(count);
+  QVector<double> y(count);
+  for (int i = 0; i < count; ++i)
+  {
+    x[i] = points.at(i).m_x;
+    y[i] = points.at(i).m_y;
+  }
+
+  QVector<double> z(count);
+  m_sampler->elevations(x.constData(), y.constData(), count, z.data());
+  for (int i = 0; i < count; ++i)
+  {
+    z[i] += points.at(i).m_height;
+    if (!std::isnan(z[i]))
+      results[i * count + i] = LineOfSightVisibility::Visible;
+  }
+
+  // threads take rows of the upper triangle in turn, since the rows become shorter
+  LineOfSightVisibility* data = results.data();
+  const double* heights = z.constData();
+  std::atomic<int> nextRow(0);
+  auto traceRows = [this, &points, &nextRow, count, heights, data](int)
+  {
+    SampleBuffers buffers;
+    for (int i = nextRow++; i < count; i = nextRow++)
+    {
+      if (std::isnan(heights[i]))
+        continue;
+
+      for (int j = i + 1; j < count; ++j)
+      {
+        if (std::isnan(heights[j]))
+          continue;
+
+        const LineOfSightVisibility visibility = traceSightline(points.at(i), heights[i], points.at(j), heights[j], buffers);
+        data[i * count + j] = visibility;
+        data[j * count + i] = visibility;
+      }
+    }
+  };
+
+  const int sightlines = count * (count - 1) / 2;
+  ParallelRanges::run(ParallelRanges::threadCount(sightlines, minSightlinesPerThread, m_threadCount), traceRows);
+
+  if (m_resultCache)
+    m_resultCache->insertIntervisibility(key, results);
+
+  return results;
+}
+
+/*!
+  \internal
+
+  Returns the drop of the surface per square meter of distance along a sightline, due to
+  the curvature of the earth less refraction.
+ */
+double TerrainProfileEngine::curvatureFactor() const
+{
+  return m_curvatureCorrected ? (1.0 - m_refractionCoefficient) / (2.0 * Geodesy::earthRadius) : 0.0;
+}
+
+/*!
+  \internal
+
+  Trace the sightline between \a from at height \a fromZ and \a to at height \a toZ, above
+  the datum, reading the samples into \a buffers.
+ */
+LineOfSightVisibility TerrainProfileEngine::traceSightline(const IntervisibilityPoint& from, double fromZ,
+                                                           const IntervisibilityPoint& to, double toZ,
+                                                           SampleBuffers& buffers) const
+{
+  const double length = Geodesy::distance(from.m_x, from.m_y, to.m_x, to.m_y);
+  const int steps = static_cast<int>(std::ceil(length / m_sampleInterval));
+  if (steps < 2)
+    return LineOfSightVisibility::Visible;
+
+  buffers.m_x.resize(sightlineBatchSize);
+  buffers.m_y.resize(sightlineBatchSize);
+  buffers.m_elevations.resize(sightlineBatchSize);
+  double* sampleX = buffers.m_x.data();
+  double* sampleY = buffers.m_y.data();
+  double* elevations = buffers.m_elevations.data();
+
+  const double factor = curvatureFactor();
+  const double dx = to.m_x - from.m_x;
+  const double dy = to.m_y - from.m_y;
+  const double dz = toZ - fromZ;
+
+  // samples with no elevation are skipped, as they are by LineOfSightEngine
+  for (int firstStep = 1; firstStep < steps; firstStep += sightlineBatchSize)
+  {
+    const int batchCount = std::min(sightlineBatchSize, steps - firstStep);
+    for (int i = 0; i < batchCount; ++i)
+    {
+      const double t = static_cast<double>(firstStep + i) / steps;
+      sampleX[i] = from.m_x + dx * t;
+      sampleY[i] = from.m_y + dy * t;
+    }
+
+    m_sampler->elevations(sampleX, sampleY, batchCount, elevations);
+
+    for (int i = 0; i < batchCount; ++i)
+    {
+      const double t = static_cast<double>(firstStep + i) / steps;
+      const double distance = t * length;
+      const double surface = elevations[i] + distance * (length - distance) * factor;
+      if (surface > fromZ + dz * t)
+        return LineOfSightVisibility::Obstructed;
+    }
+  }
+
+  return LineOfSightVisibility::Visible;
+}
+
+} // Dsa
@@ -0,0 +1,105 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef TERRAINPROFILEENGINE_H
+#define TERRAINPROFILEENGINE_H
+
+// dsa app headers
+#include "LineOfSightEngine.h"
+
+// Qt headers
+#include <QPointF>
+#include <QSharedPointer>
+#include <QVector>
+
+namespace Dsa {
+
+class AnalysisResultCache;
+class ElevationSampler;
+
+struct TerrainProfile
+{
+  bool isEmpty() const;
+  int size() const;
+
+  // the WGS84 location of each sample, its distance along the path and the elevation, in meters
+  QVector<double> m_x;
+  QVector<double> m_y;
+  QVector<double> m_distances;
+  QVector<double> m_elevations;
+};
+
+struct IntervisibilityPoint
+{
+  // a WGS84 location, with a height in meters above the surface
+  double m_x = 0.0;
+  double m_y = 0.0;
+  double m_height = 0.0;
+};
+
+class TerrainProfileEngine
+{
+public:
+  explicit TerrainProfileEngine(const QSharedPointer<const ElevationSampler>& sampler);
+  ~TerrainProfileEngine();
+
+  QSharedPointer<const ElevationSampler> sampler() const;
+
+  double sampleInterval() const;
+  void setSampleInterval(double sampleInterval);
+
+  bool isCurvatureCorrected() const;
+  void setCurvatureCorrected(bool curvatureCorrected);
+
+  double refractionCoefficient() const;
+  void setRefractionCoefficient(double refractionCoefficient);
+
+  int threadCount() const;
+  void setThreadCount(int threadCount);
+
+  AnalysisResultCache* resultCache() const;
+  void setResultCache(AnalysisResultCache* resultCache);
+
+  TerrainProfile profile(const QVector<QPointF>& path) const;
+  TerrainProfile profile(const QVector<QVector<QPointF>>& parts) const;
+
+  LineOfSightVisibility sightline(const IntervisibilityPoint& from, const IntervisibilityPoint& to) const;
+  QVector<LineOfSightVisibility> intervisibility(const QVector<IntervisibilityPoint>& points) const;
+
+private:
+  struct SampleBuffers
+  {
+    QVector<double> m_x;
+    QVector<double> m_y;
+    QVector<double> m_elevations;
+  };
+
+  double curvatureFactor() const;
+  LineOfSightVisibility traceSightline(const IntervisibilityPoint& from, double fromZ,
+                                       const IntervisibilityPoint& to, double toZ,
+                                       SampleBuffers& buffers) const;
+
+  QSharedPointer<const ElevationSampler> m_sampler;
+  double m_sampleInterval = 30.0;
+  bool m_curvatureCorrected = true;
+  double m_refractionCoefficient = 0.13;
+  int m_threadCount = 0;
+  AnalysisResultCache* m_resultCache = nullptr;
+};
+
+} // Dsa
+
+#endif // TERRAINPROFILEENGINE_H
@@ -21,9 +21,15 @@
 #include "ViewshedController.h"
 
 // dsa app headers
+#include "AnalysisResultCache.h"
+#include "AnalysisUpdateThrottle.h"
+#include "CumulativeViewshed.h"
 #include "DsaUtility.h"
+#include "ElevationSampler.h"
 #include "GeoElementViewshed360.h"
+#include "GeometryProjectionCache.h"
 #include "GraphicsOverlaysResultsManager.h"
+#include "LocalElevationCache.h"
 #include "LocationController.h"
 #include "LocationDisplay3d.h"
 #include "LocationViewshed360.h"
@@ -43,8 +49,16 @@
 #include "SimpleMarkerSceneSymbol.h"
 #include "SimpleRenderer.h"
 
+// Qt headers
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QTimer>
+
 // STL headers
+#include <algorithm>
 #include <cmath>
+#include <functional>
 
 using namespace Esri::ArcGISRuntime;
 
@@ -52,12 +66,71 @@ namespace Dsa {
 
 const QString ViewshedController::VIEWSHED_HEADING_ATTRIBUTE = QStringLiteral("heading");
 const QString ViewshedController::VIEWSHED_PITCH_ATTRIBUTE = QStringLiteral("pitch");
+const QString ViewshedController::UPDATE_RATE_PROPERTYNAME = QStringLiteral("ViewshedUpdateRate");
 
 static int s_viewshedCount = 0;
 
 constexpr double c_defaultOffsetZ = 5.0;
 constexpr double c_defaultIdentifyTolerance = 5.0;
 
+// the number of times per second the active viewshed is updated while dragging
+#if defined(Q_OS_ANDROID) || defined(Q_OS_IOS)
+constexpr int c_defaultUpdateRate = 10;
+#else
+constexpr int c_defaultUpdateRate = 20;
+#endif
+
+/*!
+  \internal
+
+  The viewsheds of the observers of a cumulative viewshed computed together.
+ */
+struct CumulativeViewshedResult
+{
+  int m_generation = 0;
+  QVector<int> m_ids;
+  QVector<ViewshedParameters> m_parameters;
+  QVector<ViewshedEngine::ResultCaching> m_caching;
+  QVector<ViewshedRaster> m_rasters;
+};
+
+namespace
+{
+/*!
+  \internal
+
+  Computes the viewsheds of a cumulative viewshed on a pool thread, passing the result
+  to \c m_deliver.
+ */
+class CumulativeCompute : public QRunnable
+{
+public:
+  CumulativeCompute(const ViewshedEngine& engine,
+                    const CumulativeViewshedResult& result,
+                    const std::function<void(const CumulativeViewshedResult&)>& deliver):
+    m_engine(engine),
+    m_result(result),
+    m_deliver(deliver)
+  {
+  }
+
+  void run() override
+  {
+    const int count = m_result.m_parameters.size();
+    m_result.m_rasters.reserve(count);
+    for (int i = 0; i < count; ++i)
+      m_result.m_rasters.append(m_engine.compute(m_result.m_parameters.at(i), m_result.m_caching.at(i)));
+
+    m_deliver(m_result);
+  }
+
+private:
+  ViewshedEngine m_engine;
+  CumulativeViewshedResult m_result;
+  std::function<void(const CumulativeViewshedResult&)> m_deliver;
+};
+}
+
 /*!
   \class Dsa::ViewshedController
   \inmodule Dsa
@@ -74,6 +147,15 @@ constexpr double c_defaultIdentifyTolerance = 5.0;
 
   In addition, viewsheds can be either normal (up to 120 degrees of arc)
   or 360 degree mode.
+
+  When \l cumulativeViewshedEnabled is set, the viewsheds are also combined on the CPU into a
+  \l CumulativeViewshed, counting how many of them can see each cell of the local raster
+  elevation. When a viewshed moves or changes, only its own contribution is recomputed, on a
+  background thread. Changes made while a computation runs are combined into the next one.
+
+  While \l interacting is set (or the active location viewshed follows the mouse), changes to the
+  active viewshed are applied at most \l updateRate times per second and intermediate values
+  are skipped. The latest values are applied as soon as the interaction ends.
  */
 
 /*!
@@ -82,8 +164,13 @@ constexpr double c_defaultIdentifyTolerance = 5.0;
 ViewshedController::ViewshedController(QObject* parent) :
   AbstractTool(parent),
   m_analysisOverlay(new AnalysisOverlay(this)),
-  m_viewsheds(new ViewshedListModel(this))
+  m_viewsheds(new ViewshedListModel(this)),
+  m_updateThrottle(new AnalysisUpdateThrottle(this)),
+  m_cumulativeThreadPool(new QThreadPool(this))
 {
+  m_updateThrottle->setUpdateRate(c_defaultUpdateRate);
+  m_cumulativeThreadPool->setMaxThreadCount(1);
+
   connect(ToolResourceProvider::instance(), &ToolResourceProvider::geoViewChanged, this, [this]
   {
     setSceneView(dynamic_cast<SceneView*>(ToolResourceProvider::instance()->geoView()));
@@ -91,8 +178,15 @@ ViewshedController::ViewshedController(QObject* parent) :
 
   connectMouseSignals();
 
+  connect(m_viewsheds, &ViewshedListModel::viewshedAdded, this, [this](int index)
+  {
+    addCumulativeObserver(m_viewsheds->at(index));
+  });
+
   connect(m_viewsheds, &ViewshedListModel::viewshedRemoved, this, [this](Viewshed360* viewshed)
   {
+    removeCumulativeObserver(viewshed);
+
     std::unique_ptr<Viewshed360> viewshedPtr(viewshed);
 
     // remove viewshed from analysis overlay and delete object
@@ -121,6 +215,8 @@ ViewshedController::ViewshedController(QObject* parent) :
  */
 ViewshedController::~ViewshedController()
 {
+  // a running computation delivers its result to this object
+  m_cumulativeThreadPool->waitForDone();
 }
 
 /*!
@@ -144,6 +240,12 @@ void ViewshedController::connectMouseSignals()
 {
   connect(ToolResourceProvider::instance(), &ToolResourceProvider::mouseClicked, this, &ViewshedController::onMouseClicked);
   connect(ToolResourceProvider::instance(), &ToolResourceProvider::mouseMoved, this, &ViewshedController::onMouseMoved);
+
+  // the last position of a drag is applied as soon as the mouse is released
+  connect(ToolResourceProvider::instance(), &ToolResourceProvider::mouseReleased, this, [this]
+  {
+    setInteracting(false);
+  });
 }
 
 /*!
@@ -214,6 +316,8 @@ void ViewshedController::onMouseClicked(QMouseEvent& event)
   This event will only be handled if the active mode is \c AddLocationViewshed360 mode.
   In this mode, when there is already an existing location viewshed, it's position will
   be updated to follow the current mouse position.
+
+  The position is updated at most \l updateRate times per second until the mouse is released.
  */
 void ViewshedController::onMouseMoved(QMouseEvent& event)
 {
@@ -226,12 +330,18 @@ void ViewshedController::onMouseMoved(QMouseEvent& event)
   if (!m_activeViewshed)
     return;
 
-  auto locViewshed = dynamic_cast<LocationViewshed360*>(m_activeViewshed);
+  QPointer<LocationViewshed360> locViewshed = dynamic_cast<LocationViewshed360*>(m_activeViewshed);
   if (!locViewshed)
     return;
 
+  setInteracting(true);
+
   const Point point = m_sceneView->screenToBaseSurface(event.x(), event.y());
-  locViewshed->setPoint(point);
+  m_updateThrottle->schedule(PointUpdate, [locViewshed, point]()
+  {
+    if (locViewshed)
+      locViewshed->setPoint(point);
+  });
 
   event.accept();
 }
@@ -417,6 +527,75 @@ QString ViewshedController::toolName() const
   return QStringLiteral("viewshed");
 }
 
+/*!
+  \brief Sets any values in \a properties which are relevant for the viewshed controller.
+
+  This tool will use the following key/value pairs in the \a properties map if they are set:
+
+  \list
+    \li ViewshedUpdateRate. The number of times per second the active viewshed is updated while dragging.
+  \endlist
+ */
+void ViewshedController::setProperties(const QVariantMap& properties)
+{
+  const auto it = properties.constFind(UPDATE_RATE_PROPERTYNAME);
+  if (it == properties.constEnd())
+    return;
+
+  bool ok = false;
+  const int updatesPerSecond = it.value().toInt(&ok);
+  if (ok)
+    setUpdateRate(updatesPerSecond);
+}
+
+/*!
+  \property ViewshedController::interacting
+  \brief Returns whether the user is dragging the active viewshed or one of its controls.
+ */
+bool ViewshedController::isInteracting() const
+{
+  return m_updateThrottle->isInteractive();
+}
+
+/*!
+  \brief Sets whether the user is dragging the active viewshed or one of its controls to \a interacting.
+
+  While interacting, changes are applied at most \l updateRate times per second. When
+  \a interacting is \c false, the latest changes are applied immediately.
+ */
+void ViewshedController::setInteracting(bool interacting)
+{
+  if (m_updateThrottle->isInteractive() == interacting)
+    return;
+
+  m_updateThrottle->setInteractive(interacting);
+  emit interactingChanged();
+}
+
+/*!
+  \brief Returns the number of times per second the active viewshed is updated while interacting.
+
+  The default is \c 10 on mobile platforms and \c 20 elsewhere.
+ */
+int ViewshedController::updateRate() const
+{
+  return m_updateThrottle->updateRate();
+}
+
+/*!
+  \brief Sets the number of times per second the active viewshed is updated while interacting to \a updatesPerSecond.
+
+  A value of \c 0 or less applies every change immediately.
+ */
+void ViewshedController::setUpdateRate(int updatesPerSecond)
+{
+  if (m_updateThrottle->updateRate() == updatesPerSecond)
+    return;
+
+  m_updateThrottle->setUpdateRate(updatesPerSecond);
+  emit propertyChanged(UPDATE_RATE_PROPERTYNAME, updatesPerSecond);
+}
+
 /*!
   \brief Returns the active viewshed.
  */
@@ -433,6 +612,9 @@ void ViewshedController::removeActiveViewshed()
   if (!m_activeViewshed)
     return;
 
+  m_updateThrottle->cancel();
+  m_pendingActiveValues.clear();
+
   m_viewsheds->removeOne(m_activeViewshed);
   m_activeViewshed = nullptr;
 
@@ -446,6 +628,7 @@ void ViewshedController::removeActiveViewshed()
  */
 void ViewshedController::finishActiveViewshed()
 {
+  m_updateThrottle->flush();
   m_activeViewshed = nullptr;
 }
 
@@ -466,7 +649,7 @@ bool ViewshedController::isActiveViewshedEnabled() const
  */
 double ViewshedController::activeViewshedMinDistance() const
 {
-  return m_activeViewshed ? m_activeViewshed->minDistance() : NAN;
+  return m_activeViewshed ? pendingActiveValue(MinDistanceUpdate, m_activeViewshed->minDistance()) : NAN;
 }
 
 /*!
@@ -479,7 +662,7 @@ void ViewshedController::setActiveViewshedMinDistance(double minDistance)
   if (!m_activeViewshed)
     return;
 
-  m_activeViewshed->setMinDistance(minDistance);
+  scheduleActiveViewshedUpdate(MinDistanceUpdate, minDistance);
 }
 
 /*!
@@ -490,7 +673,7 @@ void ViewshedController::setActiveViewshedMinDistance(double minDistance)
  */
 double ViewshedController::activeViewshedMaxDistance() const
 {
-  return m_activeViewshed ? m_activeViewshed->maxDistance() : NAN;
+  return m_activeViewshed ? pendingActiveValue(MaxDistanceUpdate, m_activeViewshed->maxDistance()) : NAN;
 }
 
 /*!
@@ -503,7 +686,7 @@ void ViewshedController::setActiveViewshedMaxDistance(double maxDistance)
   if (!m_activeViewshed)
     return;
 
-  m_activeViewshed->setMaxDistance(maxDistance);
+  scheduleActiveViewshedUpdate(MaxDistanceUpdate, maxDistance);
 }
 
 /*!
@@ -514,7 +697,7 @@ void ViewshedController::setActiveViewshedMaxDistance(double maxDistance)
  */
 double ViewshedController::activeViewshedHorizontalAngle() const
 {
-  return m_activeViewshed ? m_activeViewshed->horizontalAngle() : NAN;
+  return m_activeViewshed ? pendingActiveValue(HorizontalAngleUpdate, m_activeViewshed->horizontalAngle()) : NAN;
 }
 
 /*!
@@ -527,10 +710,10 @@ void ViewshedController::setActiveViewshedHorizontalAngle(double horizontalAngle
   if (!m_activeViewshed)
     return;
 
-  if (m_activeViewshed->horizontalAngle() == horizontalAngle)
+  if (activeViewshedHorizontalAngle() == horizontalAngle)
     return;
 
-  m_activeViewshed->setHorizontalAngle(horizontalAngle);
+  scheduleActiveViewshedUpdate(HorizontalAngleUpdate, horizontalAngle);
 }
 
 /*!
@@ -541,7 +724,7 @@ void ViewshedController::setActiveViewshedHorizontalAngle(double horizontalAngle
  */
 double ViewshedController::activeViewshedVerticalAngle() const
 {
-  return m_activeViewshed ? m_activeViewshed->verticalAngle() : NAN;
+  return m_activeViewshed ? pendingActiveValue(VerticalAngleUpdate, m_activeViewshed->verticalAngle()) : NAN;
 }
 
 /*!
@@ -554,10 +737,10 @@ void ViewshedController::setActiveViewshedVerticalAngle(double verticalAngle)
   if (!m_activeViewshed)
     return;
 
-  if (m_activeViewshed->verticalAngle() == verticalAngle)
+  if (activeViewshedVerticalAngle() == verticalAngle)
     return;
 
-  m_activeViewshed->setVerticalAngle(verticalAngle);
+  scheduleActiveViewshedUpdate(VerticalAngleUpdate, verticalAngle);
 }
 
 /*!
@@ -568,7 +751,7 @@ void ViewshedController::setActiveViewshedVerticalAngle(double verticalAngle)
  */
 double ViewshedController::activeViewshedHeading() const
 {
-  return m_activeViewshed ? m_activeViewshed->heading() : NAN;
+  return m_activeViewshed ? pendingActiveValue(HeadingUpdate, m_activeViewshed->heading()) : NAN;
 }
 
 /*!
@@ -581,10 +764,10 @@ void ViewshedController::setActiveViewshedHeading(double heading)
   if (!m_activeViewshed)
     return;
 
-  if (m_activeViewshed->heading() == heading)
+  if (activeViewshedHeading() == heading)
     return;
 
-  m_activeViewshed->setHeading(heading);
+  scheduleActiveViewshedUpdate(HeadingUpdate, heading);
 }
 
 /*!
@@ -595,7 +778,7 @@ void ViewshedController::setActiveViewshedHeading(double heading)
  */
 double ViewshedController::activeViewshedPitch() const
 {
-  return m_activeViewshed ? m_activeViewshed->pitch() : NAN;
+  return m_activeViewshed ? pendingActiveValue(PitchUpdate, m_activeViewshed->pitch()) : NAN;
 }
 
 /*!
@@ -608,10 +791,10 @@ void ViewshedController::setActiveViewshedPitch(double pitch)
   if (!m_activeViewshed)
     return;
 
-  if (m_activeViewshed->pitch() == pitch)
+  if (activeViewshedPitch() == pitch)
     return;
 
-  m_activeViewshed->setPitch(pitch);
+  scheduleActiveViewshedUpdate(PitchUpdate, pitch);
 }
 
 /*!
@@ -663,7 +846,7 @@ double ViewshedController::activeViewshedMaxPitch() const
 double ViewshedController::activeViewshedOffsetZ() const
 {
   constexpr double offsetZDefault = 0.0;
-  return m_activeViewshed ? m_activeViewshed->offsetZ() : offsetZDefault;
+  return m_activeViewshed ? pendingActiveValue(OffsetZUpdate, m_activeViewshed->offsetZ()) : offsetZDefault;
 }
 
 /*!
@@ -676,7 +859,7 @@ void ViewshedController::setActiveViewshedOffsetZ(double offsetZ)
   if (!m_activeViewshed)
     return;
 
-  m_activeViewshed->setOffsetZ(offsetZ);
+  scheduleActiveViewshedUpdate(OffsetZUpdate, offsetZ);
 }
 
 /*!
@@ -764,6 +947,9 @@ void ViewshedController::updateActiveViewshedSignals()
  */
 void ViewshedController::updateActiveViewshed()
 {
+  // apply any changes waiting for the previous active viewshed
+  m_updateThrottle->flush();
+
   if (!m_activeViewshed)
   {
     disconnectActiveViewshedSignals();
@@ -812,9 +998,456 @@ void ViewshedController::emitActiveViewshedSignals()
   emit activeViewshed360ModeChanged();
 }
 
+/*!
+  \internal
+
+  Schedules \a value to be applied to the active viewshed for \a update.
+
+  While the value is waiting it is returned by the matching property, so that the UI
+  follows the user's input.
+ */
+void ViewshedController::scheduleActiveViewshedUpdate(ActiveViewshedUpdate update, double value)
+{
+  if (!m_activeViewshed)
+    return;
+
+  m_pendingActiveValues.insert(update, value);
+
+  QPointer<Viewshed360> viewshed = m_activeViewshed;
+  m_updateThrottle->schedule(update, [this, viewshed, update, value]()
+  {
+    m_pendingActiveValues.remove(update);
+    if (viewshed)
+      applyActiveViewshedUpdate(viewshed, update, value);
+  });
+
+  if (m_updateThrottle->isPending(update))
+    emitActiveViewshedUpdate(update);
+}
+
+/*!
+  \internal
+ */
+void ViewshedController::applyActiveViewshedUpdate(Viewshed360* viewshed, ActiveViewshedUpdate update, double value)
+{
+  switch (update)
+  {
+  case MinDistanceUpdate:
+    viewshed->setMinDistance(value);
+    break;
+  case MaxDistanceUpdate:
+    viewshed->setMaxDistance(value);
+    break;
+  case HorizontalAngleUpdate:
+    viewshed->setHorizontalAngle(value);
+    break;
+  case VerticalAngleUpdate:
+    viewshed->setVerticalAngle(value);
+    break;
+  case HeadingUpdate:
+    viewshed->setHeading(value);
+    break;
+  case PitchUpdate:
+    viewshed->setPitch(value);
+    break;
+  case OffsetZUpdate:
+    viewshed->setOffsetZ(value);
+    break;
+  default:
+    break;
+  }
+}
+
+/*!
+  \internal
+ */
+void ViewshedController::emitActiveViewshedUpdate(ActiveViewshedUpdate update)
+{
+  switch (update)
+  {
+  case MinDistanceUpdate:
+    emit activeViewshedMinDistanceChanged();
+    break;
+  case MaxDistanceUpdate:
+    emit activeViewshedMaxDistanceChanged();
+    break;
+  case HorizontalAngleUpdate:
+    emit activeViewshedHorizontalAngleChanged();
+    break;
+  case VerticalAngleUpdate:
+    emit activeViewshedVerticalAngleChanged();
+    break;
+  case HeadingUpdate:
+    emit activeViewshedHeadingChanged();
+    break;
+  case PitchUpdate:
+    emit activeViewshedPitchChanged();
+    break;
+  case OffsetZUpdate:
+    emit activeViewshedOffsetZChanged();
+    break;
+  default:
+    break;
+  }
+}
+
+/*!
+  \internal
+
+  Returns the value waiting to be applied for \a update, or \a value if there is none.
+ */
+double ViewshedController::pendingActiveValue(ActiveViewshedUpdate update, double value) const
+{
+  return m_pendingActiveValues.value(update, value);
+}
+
+/*!
+  \property ViewshedController::cumulativeViewshedEnabled
+  \brief Returns whether the viewsheds are combined into a cumulative viewshed.
+ */
+bool ViewshedController::isCumulativeViewshedEnabled() const
+{
+  return m_cumulativeViewshed != nullptr;
+}
+
+/*!
+  \brief Sets whether the viewsheds are combined into a cumulative viewshed to \a enabled.
+
+  The cumulative viewshed is computed from the raster elevation sources of the scene. If there
+  are none, \l toolErrorOccurred is emitted and the cumulative viewshed is not enabled.
+ */
+void ViewshedController::setCumulativeViewshedEnabled(bool enabled)
+{
+  if (isCumulativeViewshedEnabled() == enabled)
+    return;
+
+  if (enabled)
+  {
+    QSharedPointer<const ElevationSampler> sampler = LocalElevationCache::instance()->sampler();
+    if (sampler->isEmpty())
+    {
+      emit toolErrorOccurred(QStringLiteral("Cumulative viewshed requires local elevation"),
+                             QStringLiteral("Add DTED or GeoTIFF elevation data to combine viewsheds"));
+      return;
+    }
+
+    m_cumulativeViewshed.reset(new CumulativeViewshed(sampler));
+    m_cumulativeViewshed->engine().setResultCache(AnalysisResultCache::instance());
+
+    const int viewshedCount = m_viewsheds->rowCount();
+    for (int i = 0; i < viewshedCount; ++i)
+      addCumulativeObserver(m_viewsheds->at(i));
+  }
+  else
+  {
+    for (const auto& conns : qAsConst(m_cumulativeConns))
+    {
+      for (const auto& conn : conns)
+        disconnect(conn);
+    }
+
+    m_cumulativeConns.clear();
+    for (GeoElement* geoElement : qAsConst(m_cumulativeGeoElements))
+      GeometryProjectionCache::instance()->release(geoElement);
+
+    m_cumulativeGeoElements.clear();
+    m_cumulativeIds.clear();
+    m_pendingCumulative.clear();
+    m_cumulativeViewshed.reset();
+
+    // any computation which is still running is discarded
+    ++m_cumulativeGeneration;
+  }
+
+  emit cumulativeViewshedEnabledChanged();
+  emit cumulativeViewshedChanged();
+}
+
+/*!
+  \brief Returns the cumulative viewshed, or \c nullptr if it is not enabled.
+ */
+const CumulativeViewshed* ViewshedController::cumulativeViewshed() const
+{
+  return m_cumulativeViewshed.get();
+}
+
+/*!
+  \property ViewshedController::cumulativeViewshedMaxCount
+  \brief Returns the largest number of viewsheds which can see any one cell.
+ */
+int ViewshedController::cumulativeViewshedMaxCount() const
+{
+  return m_cumulativeViewshed ? m_cumulativeViewshed->maxCount() : 0;
+}
+
+/*!
+  \property ViewshedController::cumulativeViewshedSummary
+  \brief Returns the number of cells seen by exactly \c n viewsheds, at index \c n.
+ */
+QVariantList ViewshedController::cumulativeViewshedSummary() const
+{
+  QVariantList summary;
+  if (!m_cumulativeViewshed)
+    return summary;
+
+  const QVector<int> histogram = m_cumulativeViewshed->histogram();
+  for (int cellCount : histogram)
+    summary.append(cellCount);
+
+  return summary;
+}
+
+/*!
+  \brief Returns the number of viewsheds which can see the WGS84 location \a x, \a y.
+ */
+int ViewshedController::cumulativeViewshedCount(double x, double y) const
+{
+  return m_cumulativeViewshed ? m_cumulativeViewshed->countAt(x, y) : 0;
+}
+
+/*!
+  \internal
+
+  Add \a viewshed to the cumulative viewshed and recompute it whenever it moves or changes.
+ */
+void ViewshedController::addCumulativeObserver(Viewshed360* viewshed)
+{
+  if (!m_cumulativeViewshed || !viewshed || m_cumulativeIds.contains(viewshed))
+    return;
+
+  m_cumulativeIds.insert(viewshed, m_nextCumulativeId++);
+
+  auto update = [this, viewshed]()
+  {
+    scheduleCumulativeUpdate(viewshed);
+  };
+
+  QList<QMetaObject::Connection>& conns = m_cumulativeConns[viewshed];
+  conns << connect(viewshed, &Viewshed360::minDistanceChanged, this, update);
+  conns << connect(viewshed, &Viewshed360::maxDistanceChanged, this, update);
+  conns << connect(viewshed, &Viewshed360::horizontalAngleChanged, this, update);
+  conns << connect(viewshed, &Viewshed360::headingChanged, this, update);
+  conns << connect(viewshed, &Viewshed360::offsetZChanged, this, update);
+  conns << connect(viewshed, &Viewshed360::is360ModeChanged, this, update);
+
+  if (auto locationViewshed = dynamic_cast<LocationViewshed360*>(viewshed))
+  {
+    conns << connect(locationViewshed, &LocationViewshed360::pointChanged, this, update);
+  }
+  else if (auto geoElementViewshed = dynamic_cast<GeoElementViewshed360*>(viewshed))
+  {
+    if (geoElementViewshed->geoElement())
+    {
+      GeoElementSignaler* signaler = GeometryProjectionCache::instance()->signaler(geoElementViewshed->geoElement());
+      conns << connect(signaler, &GeoElementSignaler::geometryChanged, this, update);
+      m_cumulativeGeoElements.insert(viewshed, geoElementViewshed->geoElement());
+    }
+  }
+
+  scheduleCumulativeUpdate(viewshed);
+}
+
+/*!
+  \internal
+
+  Remove \a viewshed from the cumulative viewshed.
+ */
+void ViewshedController::removeCumulativeObserver(Viewshed360* viewshed)
+{
+  auto it = m_cumulativeIds.find(viewshed);
+  if (it == m_cumulativeIds.end())
+    return;
+
+  const int id = it.value();
+  m_cumulativeIds.erase(it);
+  m_pendingCumulative.remove(viewshed);
+
+  for (const auto& conn : m_cumulativeConns.take(viewshed))
+    disconnect(conn);
+
+  if (GeoElement* geoElement = m_cumulativeGeoElements.take(viewshed))
+    GeometryProjectionCache::instance()->release(geoElement);
+
+  if (m_cumulativeViewshed && m_cumulativeViewshed->removeObserver(id))
+    emit cumulativeViewshedChanged();
+}
+
+/*!
+  \internal
+
+  Request that the contribution of \a viewshed is recomputed once control returns to the
+  event loop, so that several changes are combined.
+ */
+void ViewshedController::scheduleCumulativeUpdate(Viewshed360* viewshed)
+{
+  if (m_pendingCumulative.isEmpty())
+    QTimer::singleShot(0, this, &ViewshedController::updateCumulativeViewshed);
+
+  m_pendingCumulative.insert(viewshed);
+}
+
+/*!
+  \internal
+
+  Start recomputing the contribution of each viewshed which has changed on a background thread.
+
+  If a computation is already running, the changed viewsheds are kept until it completes.
+ */
+void ViewshedController::updateCumulativeViewshed()
+{
+  if (!m_cumulativeViewshed)
+  {
+    m_pendingCumulative.clear();
+    return;
+  }
+
+  if (m_cumulativeComputing || m_pendingCumulative.isEmpty())
+    return;
+
+  const QSet<Viewshed360*> pending = m_pendingCumulative;
+  m_pendingCumulative.clear();
+
+  // viewsheds computed while dragging are not stored in the result cache, and those of moving
+  // GeoElements are not cached at all, as they are unlikely to be needed again
+  const ViewshedEngine::ResultCaching caching = isInteracting() ? ViewshedEngine::ResultCaching::FindOnly
+                                                                : ViewshedEngine::ResultCaching::FindAndStore;
+
+  CumulativeViewshedResult result;
+  result.m_generation = m_cumulativeGeneration;
+  bool removed = false;
+  for (Viewshed360* viewshed : pending)
+  {
+    auto it = m_cumulativeIds.constFind(viewshed);
+    if (it == m_cumulativeIds.constEnd())
+      continue;
+
+    ViewshedParameters parameters;
+    if (cumulativeParameters(viewshed, parameters))
+    {
+      result.m_ids.append(it.value());
+      result.m_parameters.append(parameters);
+      result.m_caching.append(dynamic_cast<GeoElementViewshed360*>(viewshed) ? ViewshedEngine::ResultCaching::None : caching);
+    }
+    else
+    {
+      removed = m_cumulativeViewshed->removeObserver(it.value()) || removed;
+    }
+  }
+
+  if (removed)
+    emit cumulativeViewshedChanged();
+
+  if (result.m_ids.isEmpty())
+    return;
+
+  // the result is applied on the thread of this object
+  auto deliver = [this](const CumulativeViewshedResult& computed)
+  {
+    QMetaObject::invokeMethod(this, [this, computed]()
+    {
+      applyCumulativeViewsheds(computed);
+    }, Qt::QueuedConnection);
+  };
+
+  m_cumulativeComputing = true;
+  m_cumulativeThreadPool->start(new CumulativeCompute(m_cumulativeViewshed->engine(), result, deliver));
+}
+
+/*!
+  \internal
+
+  Replace the contributions of the viewsheds computed in \a result.
+
+  Results for a cumulative viewshed which has since been disabled, or for viewsheds which
+  have since been removed, are discarded.
+ */
+void ViewshedController::applyCumulativeViewsheds(const CumulativeViewshedResult& result)
+{
+  m_cumulativeComputing = false;
+
+  if (m_cumulativeViewshed && result.m_generation == m_cumulativeGeneration)
+  {
+    for (int i = 0; i < result.m_ids.size(); ++i)
+    {
+      const int id = result.m_ids.at(i);
+      if (m_cumulativeIds.key(id, nullptr))
+        m_cumulativeViewshed->setObserver(id, result.m_rasters.at(i));
+    }
+
+    emit cumulativeViewshedChanged();
+  }
+
+  // the viewsheds which changed while this computation was running
+  updateCumulativeViewshed();
+}
+
+/*!
+  \internal
+
+  Fill \a parameters for the CPU viewshed from the location and settings of \a viewshed.
+
+  Returns \c false if the viewshed has no location.
+ */
+bool ViewshedController::cumulativeParameters(Viewshed360* viewshed, ViewshedParameters& parameters) const
+{
+  Geometry location;
+  if (auto locationViewshed = dynamic_cast<LocationViewshed360*>(viewshed))
+  {
+    location = GeometryProjectionCache::projectToWgs84(locationViewshed->point());
+  }
+  else if (auto geoElementViewshed = dynamic_cast<GeoElementViewshed360*>(viewshed))
+  {
+    if (geoElementViewshed->geoElement())
+      location = GeometryProjectionCache::instance()->wgs84Geometry(geoElementViewshed->geoElement());
+  }
+
+  if (location.isEmpty() || location.geometryType() != GeometryType::Point)
+    return false;
+
+  const Point point(location);
+  parameters.m_observerX = point.x();
+  parameters.m_observerY = point.y();
+  parameters.m_observerHeight = std::max(0.0, viewshed->offsetZ());
+  parameters.m_minDistance = viewshed->minDistance();
+  parameters.m_radius = viewshed->maxDistance();
+
+  // a directed viewshed without a heading is treated as 360 degrees
+  const double heading = viewshed->heading();
+  if (!viewshed->is360Mode() && !std::isnan(heading))
+  {
+    parameters.m_heading = heading;
+    parameters.m_horizontalAngle = viewshed->horizontalAngle();
+  }
+
+  return true;
+}
+
 } // Dsa
 
 // Signal Documentation
+/*!
+  \fn void ViewshedController::interactingChanged();
+  \brief Signal emitted when the interacting property changes.
+ */
+
+/*!
+  \fn void ViewshedController::cumulativeViewshedEnabledChanged();
+  \brief Signal emitted when the cumulativeViewshedEnabled property changes.
+ */
+
+/*!
+  \fn void ViewshedController::cumulativeViewshedChanged();
+  \brief Signal emitted when the counts of the cumulative viewshed change.
+ */
+
+/*!
+  \fn void ViewshedController::toolErrorOccurred(const QString& errorMessage, const QString& additionalMessage);
+  \brief Signal emitted when an error occurs.
+
+  An error \a errorMessage and \a additionalMessage are passed through as parameters, describing
+  the error that occurred.
+ */
+
 /*!
   \fn void ViewshedController::locationDisplayViewshedActiveChanged();
   \brief Signal emitted when the LocationDisplay viewshed active property changes.
@@ -25,8 +25,14 @@
 
 // Qt headers
 #include <QAbstractListModel>
+#include <QHash>
+#include <QSet>
+
+// STL headers
+#include <memory>
 
 class QMouseEvent;
+class QThreadPool;
 
 namespace Esri {
   namespace ArcGISRuntime {
@@ -41,9 +47,13 @@ namespace Esri {
 
 namespace Dsa {
 
+class AnalysisUpdateThrottle;
+class CumulativeViewshed;
 class ViewshedListModel;
 class Viewshed360;
 class GeoElementViewshed360;
+struct CumulativeViewshedResult;
+struct ViewshedParameters;
 
 class ViewshedController : public AbstractTool
 {
@@ -68,6 +78,12 @@ class ViewshedController : public AbstractTool
   Q_PROPERTY(bool activeViewshedOffsetZEnabled READ isActiveViewshedOffsetZEnabled NOTIFY activeViewshedOffsetZEnabledChanged)
   Q_PROPERTY(bool activeViewshed360Mode READ isActiveViewshed360Mode WRITE setActiveViewshed360Mode NOTIFY activeViewshed360ModeChanged)
   Q_PROPERTY(bool locationDisplayViewshedActive READ isLocationDisplayViewshedActive NOTIFY locationDisplayViewshedActiveChanged)
+  Q_PROPERTY(bool interacting READ isInteracting WRITE setInteracting NOTIFY interactingChanged)
+
+  // cumulative viewshed properties
+  Q_PROPERTY(bool cumulativeViewshedEnabled READ isCumulativeViewshedEnabled WRITE setCumulativeViewshedEnabled NOTIFY cumulativeViewshedEnabledChanged)
+  Q_PROPERTY(int cumulativeViewshedMaxCount READ cumulativeViewshedMaxCount NOTIFY cumulativeViewshedChanged)
+  Q_PROPERTY(QVariantList cumulativeViewshedSummary READ cumulativeViewshedSummary NOTIFY cumulativeViewshedChanged)
 
 signals:
   void activeModeChanged();
@@ -88,6 +104,13 @@ signals:
   void activeViewshedOffsetZEnabledChanged();
   void activeViewshed360ModeChanged();
   void locationDisplayViewshedActiveChanged();
+  void interactingChanged();
+
+  // cumulative viewshed signals
+  void cumulativeViewshedEnabledChanged();
+  void cumulativeViewshedChanged();
+
+  void toolErrorOccurred(const QString& errorMessage, const QString& additionalMessage);
 
 public:
   enum ViewshedActiveMode
@@ -102,6 +125,7 @@ public:
 
   static const QString VIEWSHED_HEADING_ATTRIBUTE;
   static const QString VIEWSHED_PITCH_ATTRIBUTE;
+  static const QString UPDATE_RATE_PROPERTYNAME;
 
   explicit ViewshedController(QObject* parent = nullptr);
   ~ViewshedController();
@@ -120,6 +144,13 @@ public:
   QAbstractListModel* viewsheds() const;
 
   QString toolName() const override;
+  void setProperties(const QVariantMap& properties) override;
+
+  bool isInteracting() const;
+  void setInteracting(bool interacting);
+
+  int updateRate() const;
+  void setUpdateRate(int updatesPerSecond);
 
   // active viewshed methods
   Viewshed360* activeViewshed() const;
@@ -159,18 +190,51 @@ public:
   bool isActiveViewshed360Mode() const;
   void setActiveViewshed360Mode(bool is360Mode);
 
+  // cumulative viewshed methods
+  bool isCumulativeViewshedEnabled() const;
+  void setCumulativeViewshedEnabled(bool enabled);
+
+  const CumulativeViewshed* cumulativeViewshed() const;
+  int cumulativeViewshedMaxCount() const;
+  QVariantList cumulativeViewshedSummary() const;
+  Q_INVOKABLE int cumulativeViewshedCount(double x, double y) const;
+
 public slots:
   void onMouseClicked(QMouseEvent& event);
   void onMouseMoved(QMouseEvent& event);
 
 private:
+  enum ActiveViewshedUpdate
+  {
+    PointUpdate = 0,
+    MinDistanceUpdate,
+    MaxDistanceUpdate,
+    HorizontalAngleUpdate,
+    VerticalAngleUpdate,
+    HeadingUpdate,
+    PitchUpdate,
+    OffsetZUpdate
+  };
+
   void connectMouseSignals();
 
+  void scheduleActiveViewshedUpdate(ActiveViewshedUpdate update, double value);
+  void applyActiveViewshedUpdate(Viewshed360* viewshed, ActiveViewshedUpdate update, double value);
+  void emitActiveViewshedUpdate(ActiveViewshedUpdate update);
+  double pendingActiveValue(ActiveViewshedUpdate update, double value) const;
+
   void updateActiveViewshed();
   void updateActiveViewshedSignals();
   void disconnectActiveViewshedSignals();
   void emitActiveViewshedSignals();
 
+  void addCumulativeObserver(Viewshed360* viewshed);
+  void removeCumulativeObserver(Viewshed360* viewshed);
+  void scheduleCumulativeUpdate(Viewshed360* viewshed);
+  void updateCumulativeViewshed();
+  void applyCumulativeViewsheds(const CumulativeViewshedResult& result);
+  bool cumulativeParameters(Viewshed360* viewshed, ViewshedParameters& parameters) const;
+
   Esri::ArcGISRuntime::SceneView* m_sceneView = nullptr;
 
   Esri::ArcGISRuntime::AnalysisOverlay* m_analysisOverlay = nullptr;
@@ -188,6 +252,21 @@ private:
   QMetaObject::Connection m_identifyConn;
 
   QList<QMetaObject::Connection> m_activeViewshedConns;
+
+  // changes to the active viewshed are applied at a limited rate while the user is dragging
+  AnalysisUpdateThrottle* m_updateThrottle = nullptr;
+  QHash<int, double> m_pendingActiveValues;
+
+  // the count of viewsheds which can see each cell, computed on the CPU
+  std::unique_ptr<CumulativeViewshed> m_cumulativeViewshed;
+  QHash<Viewshed360*, int> m_cumulativeIds;
+  QHash<Viewshed360*, QList<QMetaObject::Connection>> m_cumulativeConns;
+  QHash<Viewshed360*, Esri::ArcGISRuntime::GeoElement*> m_cumulativeGeoElements;
+  QSet<Viewshed360*> m_pendingCumulative;
+  int m_nextCumulativeId = 0;
+  QThreadPool* m_cumulativeThreadPool = nullptr;
+  int m_cumulativeGeneration = 0;
+  bool m_cumulativeComputing = false;
 };
 
 } // Dsa
@@ -0,0 +1,453 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "ViewshedEngine.h"
+
+// dsa app headers
+#include "AnalysisResultCache.h"
+#include "ElevationSampler.h"
+#include "Geodesy.h"
+#include "ParallelRanges.h"
+
+// C++ API headers
+#include "GeometryEngine.h"
+#include "PartCollection.h"
+#include "PolygonBuilder.h"
+
+// STL headers
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+namespace
+{
+// the fewest rows or rays worth handing to a thread of their own
+constexpr int minTasksPerThread = 32;
+
+// the most cells between the observer and the edge of the grid, which bounds its memory to tens of megabytes
+constexpr int maxHalfGridSize = 2000;
+}
+
+/*!
+  \class Dsa::ViewshedRaster
+  \inmodule Dsa
+  \brief The cells visible from an observer, as computed by \l ViewshedEngine.
+ */
+
+/*!
+  \brief Returns whether the raster contains any cells.
+ */
+bool ViewshedRaster::isValid() const
+{
+  return !m_values.isEmpty();
+}
+
+/*!
+  \brief Returns the value of the cell at \a column and \a row, where row \c 0 is the northernmost.
+ */
+ViewshedRaster::Value ViewshedRaster::value(int column, int row) const
+{
+  if (column < 0 || row < 0 || column >= m_columns || row >= m_rows)
+    return NoData;
+
+  return static_cast<Value>(m_values.at(row * m_columns + column));
+}
+
+/*!
+  \brief Returns the number of visible cells.
+ */
+int ViewshedRaster::visibleCount() const
+{
+  return static_cast<int>(std::count(m_values.cbegin(), m_values.cend(), static_cast<quint8>(Visible)));
+}
+
+/*!
+  \class Dsa::ViewshedEngine
+  \inmodule Dsa
+  \brief Computes viewsheds over local elevation on the CPU.
+
+  Unlike the GPU viewshed used by \l Viewshed360, the engine does not need a view, so it
+  can be used headless or in batches, and it returns a numeric \l ViewshedRaster which can
+  be counted, exported or converted to a \l visiblePolygon.
+
+  The surface is sampled from an \l ElevationSampler onto a grid of square cells centered
+  on the observer. Visibility is then found with an R2 sweep: a ray is cast from the observer
+  to every cell on the edge of the grid and each cell crossed is visible if it is not below
+  the highest slope from the observer seen so far along the ray. The rays are divided into
+  sectors which are swept on separate threads, all marking the cells they cross in one
+  shared grid.
+
+  A cell crossed by several rays is visible if any of them reaches it.
+
+  When a \l resultCache is set, viewsheds are looked up in it before they are computed and
+  stored in it afterwards.
+
+  \sa ElevationSampler
+ */
+
+/*!
+  \brief Constructor taking the \a sampler for the surface.
+ */
+ViewshedEngine::ViewshedEngine(const QSharedPointer<const ElevationSampler>& sampler):
+  m_sampler(sampler)
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+ViewshedEngine::~ViewshedEngine()
+{
+}
+
+/*!
+  \brief Returns the sampler for the surface.
+ */
+QSharedPointer<const ElevationSampler> ViewshedEngine::sampler() const
+{
+  return m_sampler;
+}
+
+/*!
+  \brief Returns the maximum number of threads used to compute a viewshed.
+
+  The default, \c 0, uses the number of cores.
+ */
+int ViewshedEngine::threadCount() const
+{
+  return m_threadCount;
+}
+
+/*!
+  \brief Sets the maximum number of threads used to compute a viewshed to \a threadCount.
+ */
+void ViewshedEngine::setThreadCount(int threadCount)
+{
+  m_threadCount = std::max(0, threadCount);
+}
+
+/*!
+  \brief Returns the cache where viewsheds are stored, or \c nullptr if there is none.
+ */
+AnalysisResultCache* ViewshedEngine::resultCache() const
+{
+  return m_resultCache;
+}
+
+/*!
+  \brief Sets the cache where viewsheds are stored to \a resultCache.
+
+  The cache is not owned by the engine.
+ */
+void ViewshedEngine::setResultCache(AnalysisResultCache* resultCache)
+{
+  m_resultCache = resultCache;
+}
+
+/*!
+  \enum Dsa::ViewshedEngine::ResultCaching
+
+  How \l compute uses the \l resultCache.
+
+  \value FindAndStore The viewshed is looked up, and stored if it has to be computed.
+  \value FindOnly The viewshed is looked up but not stored, for example while the observer
+          is being dragged and the result is unlikely to be needed again.
+  \value None The cache is not used, for example for an observer which is always moving.
+ */
+
+/*!
+  \brief Returns the viewshed described by \a parameters, using the \l resultCache as
+  set by \a caching.
+
+  Cells outside the field of view, that is closer than the minimum distance, beyond the radius
+  or outside the horizontal angle about the heading, or where the surface has no elevation,
+  are \c ViewshedRaster::NoData.
+  The raster is invalid if there is no elevation at the observer, or if the radius spans more
+  than 2,000 cells.
+ */
+ViewshedRaster ViewshedEngine::compute(const ViewshedParameters& parameters, ResultCaching caching) const
+{
+  if (!m_resultCache || !m_sampler || caching == ResultCaching::None)
+    return computeRaster(parameters);
+
+  const QString key = AnalysisResultCache::resultKey(QStringLiteral("viewshed"),
+                                                     {parameters.m_observerX, parameters.m_observerY,
+                                                      parameters.m_observerHeight, parameters.m_targetHeight,
+                                                      parameters.m_minDistance, parameters.m_radius, parameters.m_cellSize,
+                                                      parameters.m_heading, parameters.m_horizontalAngle},
+                                                     *m_sampler);
+  ViewshedRaster raster;
+  if (m_resultCache->findViewshed(key, raster))
+    return raster;
+
+  raster = computeRaster(parameters);
+  if (caching == ResultCaching::FindAndStore)
+    m_resultCache->insertViewshed(key, raster);
+
+  return raster;
+}
+
+/*!
+  \internal
+
+  Computes the viewshed described by \a parameters, without using the cache.
+ */
+ViewshedRaster ViewshedEngine::computeRaster(const ViewshedParameters& parameters) const
+{
+  ViewshedRaster raster;
+  if (!m_sampler || parameters.m_radius <= 0.0 || parameters.m_cellSize <= 0.0)
+    return raster;
+
+  const double observerGround = m_sampler->elevation(parameters.m_observerX, parameters.m_observerY);
+  if (std::isnan(observerGround))
+    return raster;
+
+  // the grid is square in meters, with the observer at the center cell
+  const double halfCells = std::ceil(parameters.m_radius / parameters.m_cellSize);
+  if (!(halfCells <= maxHalfGridSize))
+    return raster;
+
+  const int half = static_cast<int>(halfCells);
+  const int size = 2 * half + 1;
+  const double cosLatitude = std::max(std::cos(parameters.m_observerY * Geodesy::degreesToRadians), 1e-6);
+  raster.m_columns = size;
+  raster.m_rows = size;
+  raster.m_cellSizeX = parameters.m_cellSize / (Geodesy::metersPerDegree * cosLatitude);
+  raster.m_cellSizeY = parameters.m_cellSize / Geodesy::metersPerDegree;
+  raster.m_originX = parameters.m_observerX - half * raster.m_cellSizeX;
+  raster.m_originY = parameters.m_observerY + half * raster.m_cellSizeY;
+
+  // sample the surface, by rows
+  std::vector<float> heights(static_cast<size_t>(size) * size);
+  ParallelRanges::split(size, threads(size), [this, &raster, &heights, size](int, int begin, int end)
+  {
+    for (int row = begin; row < end; ++row)
+    {
+      const double y = raster.m_originY - row * raster.m_cellSizeY;
+      for (int column = 0; column < size; ++column)
+      {
+        const double x = raster.m_originX + column * raster.m_cellSizeX;
+        heights[static_cast<size_t>(row) * size + column] = static_cast<float>(m_sampler->elevation(x, y));
+      }
+    }
+  });
+
+  // trace a ray from the observer towards a cell, calling visit with each cell crossed and
+  // whether it is visible, until the cell or the radius is reached
+  const double observerZ = observerGround + parameters.m_observerHeight;
+  const double radius = parameters.m_radius;
+  const double cellSize = parameters.m_cellSize;
+  const double targetHeight = parameters.m_targetHeight;
+  auto traceRay = [&heights, half, size, observerZ, radius, cellSize, targetHeight](int endColumn, int endRow, auto&& visit)
+  {
+    const int dx = endColumn - half;
+    const int dy = endRow - half;
+    const int steps = std::max(std::abs(dx), std::abs(dy));
+    if (steps == 0)
+      return;
+
+    const double stepLength = std::sqrt(static_cast<double>(dx * dx + dy * dy)) * cellSize / steps;
+    double maxSlope = -std::numeric_limits<double>::infinity();
+    for (int step = 1; step <= steps; ++step)
+    {
+      const double distance = step * stepLength;
+      if (distance > radius)
+        break;
+
+      const int column = half + static_cast<int>(std::lround(static_cast<double>(dx) * step / steps));
+      const int row = half + static_cast<int>(std::lround(static_cast<double>(dy) * step / steps));
+      const size_t index = static_cast<size_t>(row) * size + column;
+      const double height = heights[index];
+      if (std::isnan(height))
+        continue;
+
+      visit(index, (height + targetHeight - observerZ) / distance >= maxSlope);
+      maxSlope = std::max(maxSlope, (height - observerZ) / distance);
+    }
+  };
+
+  // sweep a ray to each cell on the edge of the grid, clockwise from the north west corner
+  const int edgeCount = 4 * (size - 1);
+  auto edgeCell = [size](int edge, int& column, int& row)
+  {
+    const int side = size - 1;
+    if (edge < side)
+    {
+      column = edge;
+      row = 0;
+    }
+    else if (edge < 2 * side)
+    {
+      column = side;
+      row = edge - side;
+    }
+    else if (edge < 3 * side)
+    {
+      column = 3 * side - edge;
+      row = side;
+    }
+    else
+    {
+      column = 0;
+      row = 4 * side - edge;
+    }
+  };
+
+  // the sectors mark the crossed and visible cells in one grid; rays of different sectors meet
+  // near the observer and at the sector boundaries, so each flag is set atomically, and only
+  // when it is not set already so that cells crossed by many rays are mostly just read
+  constexpr quint8 crossed = 1;
+  constexpr quint8 visibleFlag = 2;
+  std::vector<std::atomic<quint8>> flags(heights.size());
+  ParallelRanges::split(edgeCount, threads(edgeCount), [&](int, int begin, int end)
+  {
+    for (int edge = begin; edge < end; ++edge)
+    {
+      int endColumn = 0;
+      int endRow = 0;
+      edgeCell(edge, endColumn, endRow);
+      traceRay(endColumn, endRow, [&flags](size_t index, bool visible)
+      {
+        const quint8 cellFlags = visible ? (crossed | visibleFlag) : crossed;
+        std::atomic<quint8>& cell = flags[index];
+        if ((cell.load(std::memory_order_relaxed) & cellFlags) != cellFlags)
+          cell.fetch_or(cellFlags, std::memory_order_relaxed);
+      });
+    }
+  });
+
+  // set the values from the flags, marking cells outside the field of view or without elevation as no data
+  raster.m_values.resize(size * size);
+  quint8* values = raster.m_values.data();
+  const double radiusCells = radius / cellSize;
+  const double minDistanceCells = std::max(0.0, parameters.m_minDistance) / cellSize;
+  const bool directed = parameters.m_horizontalAngle < 360.0;
+  for (int row = 0; row < size; ++row)
+  {
+    for (int column = 0; column < size; ++column)
+    {
+      const size_t index = static_cast<size_t>(row) * size + column;
+      const double dx = column - half;
+      const double dy = row - half;
+      const double distanceSquared = dx * dx + dy * dy;
+      bool inView = !std::isnan(heights[index]) && distanceSquared <= radiusCells * radiusCells &&
+                    distanceSquared >= minDistanceCells * minDistanceCells;
+
+      if (inView && directed && distanceSquared > 0.0)
+      {
+        // rows run from north to south
+        const double bearing = std::atan2(dx, -dy) / Geodesy::degreesToRadians;
+        const double offset = std::fabs(std::remainder(bearing - parameters.m_heading, 360.0));
+        inView = offset <= parameters.m_horizontalAngle * 0.5;
+      }
+
+      if (!inView)
+      {
+        values[index] = ViewshedRaster::NoData;
+        continue;
+      }
+
+      // the sweep has finished, so the flags are no longer written
+      quint8 cellFlags = flags[index].load(std::memory_order_relaxed);
+
+      // the few cells missed by the sweep are given a ray of their own
+      if (!(cellFlags & crossed))
+      {
+        traceRay(column, row, [&cellFlags, index](size_t rayIndex, bool visible)
+        {
+          if (rayIndex == index)
+            cellFlags = visible ? (crossed | visibleFlag) : crossed;
+        });
+      }
+
+      values[index] = (cellFlags & visibleFlag) ? ViewshedRaster::Visible : ViewshedRaster::NotVisible;
+    }
+  }
+
+  if (parameters.m_minDistance <= 0.0)
+    values[static_cast<size_t>(half) * size + half] = ViewshedRaster::Visible;
+
+  return raster;
+}
+
+/*!
+  \brief Returns a WGS84 polygon covering the visible cells of \a raster.
+
+  Each run of visible cells along a row becomes a rectangle and the rectangles are then
+  simplified into a single polygon.
+ */
+Polygon ViewshedEngine::visiblePolygon(const ViewshedRaster& raster)
+{
+  if (!raster.isValid())
+    return Polygon();
+
+  QObject localParent;
+  PolygonBuilder builder(SpatialReference::wgs84(), &localParent);
+  const double halfX = raster.m_cellSizeX * 0.5;
+  const double halfY = raster.m_cellSizeY * 0.5;
+
+  for (int row = 0; row < raster.m_rows; ++row)
+  {
+    const double north = raster.m_originY - row * raster.m_cellSizeY + halfY;
+    const double south = north - raster.m_cellSizeY;
+    int column = 0;
+    while (column < raster.m_columns)
+    {
+      if (raster.value(column, row) != ViewshedRaster::Visible)
+      {
+        ++column;
+        continue;
+      }
+
+      const int runStart = column;
+      while (column < raster.m_columns && raster.value(column, row) == ViewshedRaster::Visible)
+        ++column;
+
+      const double west = raster.m_originX + runStart * raster.m_cellSizeX - halfX;
+      const double east = raster.m_originX + (column - 1) * raster.m_cellSizeX + halfX;
+
+      Part* part = new Part(SpatialReference::wgs84(), &localParent);
+      part->addPoint(west, north);
+      part->addPoint(east, north);
+      part->addPoint(east, south);
+      part->addPoint(west, south);
+      builder.parts()->addPart(part);
+    }
+  }
+
+  return Polygon(GeometryEngine::simplify(builder.toGeometry()));
+}
+
+/*!
+  \internal
+
+  Returns the number of threads to use for \a tasks rows or rays.
+ */
+int ViewshedEngine::threads(int tasks) const
+{
+  return ParallelRanges::threadCount(tasks, minTasksPerThread, m_threadCount);
+}
+
+} // Dsa
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef VIEWSHEDENGINE_H
+#define VIEWSHEDENGINE_H
+
+// C++ API headers
+#include "Polygon.h"
+
+// Qt headers
+#include <QSharedPointer>
+#include <QVector>
+
+namespace Dsa {
+
+class AnalysisResultCache;
+class ElevationSampler;
+
+struct ViewshedParameters
+{
+  // the WGS84 location of the observer and the heights in meters above the surface
+  double m_observerX = 0.0;
+  double m_observerY = 0.0;
+  double m_observerHeight = 2.0;
+  double m_targetHeight = 0.0;
+
+  // the distances in meters analysed around the observer and the spacing of the result cells
+  double m_minDistance = 0.0;
+  double m_radius = 5000.0;
+  double m_cellSize = 30.0;
+
+  // the direction in degrees clockwise from north and the width of the field of view
+  double m_heading = 0.0;
+  double m_horizontalAngle = 360.0;
+};
+
+struct ViewshedRaster
+{
+  enum Value : quint8
+  {
+    NotVisible = 0,
+    Visible = 1,
+    NoData = 255
+  };
+
+  bool isValid() const;
+  Value value(int column, int row) const;
+  int visibleCount() const;
+
+  int m_columns = 0;
+  int m_rows = 0;
+
+  // the WGS84 location of the center of the north west cell and the spacing of the cells in degrees
+  double m_originX = 0.0;
+  double m_originY = 0.0;
+  double m_cellSizeX = 0.0;
+  double m_cellSizeY = 0.0;
+
+  // one value per cell, row by row from the north
+  QVector<quint8> m_values;
+};
+
+class ViewshedEngine
+{
+public:
+  enum class ResultCaching
+  {
+    FindAndStore,
+    FindOnly,
+    None
+  };
+
+  explicit ViewshedEngine(const QSharedPointer<const ElevationSampler>& sampler);
+  ~ViewshedEngine();
+
+  QSharedPointer<const ElevationSampler> sampler() const;
+
+  int threadCount() const;
+  void setThreadCount(int threadCount);
+
+  AnalysisResultCache* resultCache() const;
+  void setResultCache(AnalysisResultCache* resultCache);
+
+  ViewshedRaster compute(const ViewshedParameters& parameters, ResultCaching caching = ResultCaching::FindAndStore) const;
+
+  static Esri::ArcGISRuntime::Polygon visiblePolygon(const ViewshedRaster& raster);
+
+private:
+  ViewshedRaster computeRaster(const ViewshedParameters& parameters) const;
+  int threads(int tasks) const;
+
+  QSharedPointer<const ElevationSampler> m_sampler;
+  int m_threadCount = 0;
+  AnalysisResultCache* m_resultCache = nullptr;
+};
+
+} // Dsa
+
+#endif // VIEWSHEDENGINE_H
@@ -21,12 +21,16 @@
 
 // dsa app headers
 #include "Message.h"
+#include "TrackHistory.h"
 
 // C++ API headers
 #include "GeoView.h"
 #include "GraphicsOverlay.h"
 #include "Renderer.h"
 
+// Qt headers
+#include <QDateTime>
+
 using namespace Esri::ArcGISRuntime;
 
 namespace Dsa {
@@ -40,6 +44,9 @@ namespace Dsa {
 
   The overlay currently only supports messages containing a
   point geometry type.
+
+  The location of each graphic is also recorded in the \l TrackHistory of the overlay
+  as messages arrive.
  */
 
 /*!
@@ -60,7 +67,8 @@ MessagesOverlay::MessagesOverlay(GeoView* geoView, Renderer* renderer, const QSt
   m_geoView(geoView),
   m_renderer(renderer),
   m_surfacePlacement(surfacePlacement),
-  m_graphicsOverlay(new GraphicsOverlay(this))
+  m_graphicsOverlay(new GraphicsOverlay(this)),
+  m_trackHistory(TrackHistory::forOverlay(m_graphicsOverlay))
 {
   m_graphicsOverlay->setOverlayId(messageType);
   m_graphicsOverlay->setRenderingMode(GraphicsRenderingMode::Dynamic);
@@ -145,6 +153,14 @@ GraphicsOverlay* MessagesOverlay::graphicsOverlay() const
   return m_graphicsOverlay;
 }
 
+/*!
+  \brief Returns the \l TrackHistory of the graphics in the overlay.
+ */
+TrackHistory* MessagesOverlay::trackHistory() const
+{
+  return m_trackHistory;
+}
+
 /*!
   \brief Returns the Esri:ArcGISRuntime::GeoView for the overlay.
  */
@@ -212,6 +228,10 @@ bool MessagesOverlay::addMessage(const Message& message)
       if (geom.geometryType() != geometry.geometryType())
         return false;
 
+      // record the sample before the graphic changes, so it is in the history when conditions are tested
+      if (messageAction == Message::MessageAction::Update)
+        m_trackHistory->addSample(graphic, geometry, QDateTime::currentMSecsSinceEpoch());
+
       if (!(geom == geometry))
         graphic->setGeometry(geometry);
 
@@ -230,6 +250,7 @@ bool MessagesOverlay::addMessage(const Message& message)
     }
     case Message::MessageAction::Remove:
     {
+      m_trackHistory->removeTrack(graphic);
       m_graphicsOverlay->graphics()->removeOne(graphic);
       break;
     }
@@ -249,6 +270,7 @@ bool MessagesOverlay::addMessage(const Message& message)
 
   // add new graphic
   Graphic* graphic = new Graphic(geometry, message.attributes(), this);
+  m_trackHistory->addSample(graphic, geometry, QDateTime::currentMSecsSinceEpoch());
   m_graphicsOverlay->graphics()->append(graphic);
   m_existingGraphics.insert(messageId, graphic);
 
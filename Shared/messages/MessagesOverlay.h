@@ -36,6 +36,7 @@ namespace Esri
 namespace Dsa {
 
 class Message;
+class TrackHistory;
 
 class MessagesOverlay : public QObject
 {
@@ -59,6 +60,8 @@ public:
 
   Esri::ArcGISRuntime::GraphicsOverlay* graphicsOverlay() const;
 
+  TrackHistory* trackHistory() const;
+
   Esri::ArcGISRuntime::GeoView* geoView() const;
 
   bool addMessage(const Message& message);
@@ -78,6 +81,7 @@ private:
   Esri::ArcGISRuntime::SurfacePlacement m_surfacePlacement;
 
   Esri::ArcGISRuntime::GraphicsOverlay* m_graphicsOverlay = nullptr;
+  TrackHistory* m_trackHistory = nullptr;
   QHash<QString, Esri::ArcGISRuntime::Graphic*> m_existingGraphics;
 };
 
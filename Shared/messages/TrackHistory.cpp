@@ -0,0 +1,346 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "TrackHistory.h"
+
+// dsa app headers
+#include "Geodesy.h"
+#include "GeometryProjectionCache.h"
+
+// C++ API headers
+#include "GraphicsOverlay.h"
+
+// STL headers
+#include <algorithm>
+
+using namespace Esri::ArcGISRuntime;
+
+namespace Dsa {
+
+/*!
+  \class Dsa::TrackHistory
+  \inmodule Dsa
+  \inherits QObject
+  \brief The recent history of each track (graphic) in a message feed.
+
+  For each track, the history holds a ring buffer of the most recent WGS84 locations and the
+  times at which they were received, along with aggregates which are updated as each sample
+  is added: the time the track was last seen and its current speed.
+
+  Tracks are also kept in order of the time they were last seen, so the tracks which have not
+  been updated for a given time can be found without visiting every track.
+
+  The history is filled by \l MessagesOverlay as messages arrive and is used by
+  conditions such as \l SpeedAboveAlertCondition and \l NotUpdatedAlertCondition.
+ */
+
+/*!
+  \brief Returns the history for \a overlay, creating it if required.
+
+  The history is owned by \a overlay.
+ */
+TrackHistory* TrackHistory::forOverlay(GraphicsOverlay* overlay)
+{
+  if (!overlay)
+    return nullptr;
+
+  TrackHistory* history = overlay->findChild<TrackHistory*>(QString(), Qt::FindDirectChildrenOnly);
+  if (history)
+    return history;
+
+  return new TrackHistory(overlay);
+}
+
+/*!
+  \internal
+
+  Constructor taking the \a overlay, which will be the parent of the history.
+ */
+TrackHistory::TrackHistory(GraphicsOverlay* overlay):
+  QObject(overlay)
+{
+}
+
+/*!
+  \brief Destructor.
+ */
+TrackHistory::~TrackHistory()
+{
+}
+
+/*!
+  \brief Returns the maximum number of samples held for each track.
+ */
+int TrackHistory::capacity() const
+{
+  return m_capacity;
+}
+
+/*!
+  \brief Sets the maximum number of samples held for each track to \a capacity.
+
+  Existing tracks keep their most recent samples.
+ */
+void TrackHistory::setCapacity(int capacity)
+{
+  capacity = std::max(capacity, 2);
+  if (capacity == m_capacity)
+    return;
+
+  for (auto it = m_tracks.begin(); it != m_tracks.end(); ++it)
+  {
+    Track& entry = it.value();
+    const int keep = std::min(entry.m_count, capacity);
+    const int oldCapacity = entry.m_samples.size();
+
+    QVector<TrackSample> samples(capacity);
+    for (int i = 0; i < keep; ++i)
+      samples[i] = entry.m_samples.at((entry.m_head + entry.m_count - keep + i) % oldCapacity);
+
+    entry.m_samples = samples;
+    entry.m_head = 0;
+    entry.m_count = keep;
+  }
+
+  m_capacity = capacity;
+}
+
+/*!
+  \brief Adds a sample of the \a location of \a track at \a timestamp (in milliseconds since the epoch).
+
+  The speed and last seen time of the track are updated and it becomes the most recently
+  seen track. Samples must be added in time order: a \a timestamp earlier than the last
+  sample of the track is treated as the time of the last sample.
+
+  The \l sampleAdded signal is emitted.
+ */
+void TrackHistory::addSample(Graphic* track, const Point& location, qint64 timestamp)
+{
+  if (!track || location.isEmpty())
+    return;
+
+  auto it = m_tracks.find(track);
+  if (it == m_tracks.end())
+  {
+    it = m_tracks.insert(track, Track());
+    it->m_samples.resize(m_capacity);
+  }
+  else
+  {
+    unlink(track, it.value());
+  }
+
+  Track& entry = it.value();
+  const int trackCapacity = entry.m_samples.size();
+
+  const Point wgs84Location(GeometryProjectionCache::projectToWgs84(location));
+  TrackSample newSample;
+  newSample.m_timestamp = timestamp;
+  newSample.m_x = wgs84Location.x();
+  newSample.m_y = wgs84Location.y();
+
+  if (entry.m_count > 0)
+  {
+    const TrackSample& previous = entry.m_samples.at((entry.m_head + entry.m_count - 1) % trackCapacity);
+    newSample.m_timestamp = std::max(newSample.m_timestamp, previous.m_timestamp);
+
+    // samples received at the same time keep the previous speed
+    const qint64 elapsed = newSample.m_timestamp - previous.m_timestamp;
+    if (elapsed > 0)
+      entry.m_speed = Geodesy::distance(previous.m_x, previous.m_y, newSample.m_x, newSample.m_y) / (elapsed / 1000.0);
+  }
+
+  // overwrite the oldest sample once the buffer is full
+  if (entry.m_count < trackCapacity)
+  {
+    entry.m_samples[(entry.m_head + entry.m_count) % trackCapacity] = newSample;
+    ++entry.m_count;
+  }
+  else
+  {
+    entry.m_samples[entry.m_head] = newSample;
+    entry.m_head = (entry.m_head + 1) % trackCapacity;
+  }
+
+  appendNewest(track, entry);
+
+  emit sampleAdded(track);
+}
+
+/*!
+  \brief Removes the history of \a track.
+
+  The \l trackRemoved signal is emitted if there was a history for \a track.
+ */
+void TrackHistory::removeTrack(Graphic* track)
+{
+  auto it = m_tracks.find(track);
+  if (it == m_tracks.end())
+    return;
+
+  unlink(track, it.value());
+  m_tracks.erase(it);
+
+  emit trackRemoved(track);
+}
+
+/*!
+  \brief Returns the number of tracks with a history.
+ */
+int TrackHistory::trackCount() const
+{
+  return m_tracks.size();
+}
+
+/*!
+  \brief Returns whether there is a history for \a track.
+ */
+bool TrackHistory::contains(Graphic* track) const
+{
+  return m_tracks.contains(track);
+}
+
+/*!
+  \brief Returns the number of samples held for \a track.
+ */
+int TrackHistory::sampleCount(Graphic* track) const
+{
+  auto it = m_tracks.constFind(track);
+  if (it == m_tracks.constEnd())
+    return 0;
+
+  return it->m_count;
+}
+
+/*!
+  \brief Returns the sample at \a index for \a track, where \c 0 is the most recent sample.
+
+  Returns a default sample if \a index is out of range.
+ */
+TrackSample TrackHistory::sample(Graphic* track, int index) const
+{
+  auto it = m_tracks.constFind(track);
+  if (it == m_tracks.constEnd() || index < 0 || index >= it->m_count)
+    return TrackSample();
+
+  return it->m_samples.at((it->m_head + it->m_count - 1 - index) % it->m_samples.size());
+}
+
+/*!
+  \brief Returns the time (in milliseconds since the epoch) of the most recent sample of \a track.
+
+  Returns \c -1 if there is no history for \a track.
+ */
+qint64 TrackHistory::lastSeen(Graphic* track) const
+{
+  auto it = m_tracks.constFind(track);
+  if (it == m_tracks.constEnd() || it->m_count == 0)
+    return -1;
+
+  return it->m_samples.at((it->m_head + it->m_count - 1) % it->m_samples.size()).m_timestamp;
+}
+
+/*!
+  \brief Returns the speed of \a track (in meters per second) between its two most recent samples.
+
+  Returns \c 0 if there are fewer than two samples for \a track.
+ */
+double TrackHistory::speed(Graphic* track) const
+{
+  auto it = m_tracks.constFind(track);
+  if (it == m_tracks.constEnd())
+    return 0.0;
+
+  return it->m_speed;
+}
+
+/*!
+  \brief Returns the track whose most recent sample is the oldest, or \c nullptr if there are no tracks.
+ */
+Graphic* TrackHistory::leastRecentlySeen() const
+{
+  return m_oldest;
+}
+
+/*!
+  \brief Returns the track which was seen next after \a track, or \c nullptr if \a track is the most
+  recently seen.
+
+  Together with \l leastRecentlySeen, this visits the tracks in the order they were last seen.
+ */
+Graphic* TrackHistory::nextMoreRecentlySeen(Graphic* track) const
+{
+  auto it = m_tracks.constFind(track);
+  if (it == m_tracks.constEnd())
+    return nullptr;
+
+  return it->m_newer;
+}
+
+/*!
+  \internal
+
+  Remove \a track, with the history \a entry, from the list of tracks in the order they were last seen.
+ */
+void TrackHistory::unlink(Graphic* track, Track& entry)
+{
+  if (entry.m_older)
+    m_tracks[entry.m_older].m_newer = entry.m_newer;
+  else if (m_oldest == track)
+    m_oldest = entry.m_newer;
+
+  if (entry.m_newer)
+    m_tracks[entry.m_newer].m_older = entry.m_older;
+  else if (m_newest == track)
+    m_newest = entry.m_older;
+
+  entry.m_older = nullptr;
+  entry.m_newer = nullptr;
+}
+
+/*!
+  \internal
+
+  Add \a track, with the history \a entry, to the end of the list of tracks in the order they were last seen.
+ */
+void TrackHistory::appendNewest(Graphic* track, Track& entry)
+{
+  entry.m_older = m_newest;
+  entry.m_newer = nullptr;
+
+  if (m_newest)
+    m_tracks[m_newest].m_newer = track;
+  else
+    m_oldest = track;
+
+  m_newest = track;
+}
+
+} // Dsa
+
+// Signal Documentation
+/*!
+  \fn void TrackHistory::sampleAdded(Esri::ArcGISRuntime::Graphic* track);
+  \brief Signal emitted when a sample is added to the history of \a track.
+ */
+
+/*!
+  \fn void TrackHistory::trackRemoved(Esri::ArcGISRuntime::Graphic* track);
+  \brief Signal emitted when the history of \a track is removed.
+ */
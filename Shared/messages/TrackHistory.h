@@ -0,0 +1,104 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef TRACKHISTORY_H
+#define TRACKHISTORY_H
+
+// C++ API headers
+#include "Point.h"
+
+// Qt headers
+#include <QHash>
+#include <QObject>
+#include <QVector>
+
+namespace Esri
+{
+namespace ArcGISRuntime
+{
+class Graphic;
+class GraphicsOverlay;
+}
+}
+
+namespace Dsa {
+
+struct TrackSample
+{
+  qint64 m_timestamp = 0;
+  double m_x = 0.0;
+  double m_y = 0.0;
+};
+
+class TrackHistory : public QObject
+{
+  Q_OBJECT
+
+public:
+  static TrackHistory* forOverlay(Esri::ArcGISRuntime::GraphicsOverlay* overlay);
+
+  ~TrackHistory();
+
+  int capacity() const;
+  void setCapacity(int capacity);
+
+  void addSample(Esri::ArcGISRuntime::Graphic* track, const Esri::ArcGISRuntime::Point& location, qint64 timestamp);
+  void removeTrack(Esri::ArcGISRuntime::Graphic* track);
+
+  int trackCount() const;
+  bool contains(Esri::ArcGISRuntime::Graphic* track) const;
+
+  int sampleCount(Esri::ArcGISRuntime::Graphic* track) const;
+  TrackSample sample(Esri::ArcGISRuntime::Graphic* track, int index) const;
+
+  qint64 lastSeen(Esri::ArcGISRuntime::Graphic* track) const;
+  double speed(Esri::ArcGISRuntime::Graphic* track) const;
+
+  Esri::ArcGISRuntime::Graphic* leastRecentlySeen() const;
+  Esri::ArcGISRuntime::Graphic* nextMoreRecentlySeen(Esri::ArcGISRuntime::Graphic* track) const;
+
+signals:
+  void sampleAdded(Esri::ArcGISRuntime::Graphic* track);
+  void trackRemoved(Esri::ArcGISRuntime::Graphic* track);
+
+private:
+  explicit TrackHistory(Esri::ArcGISRuntime::GraphicsOverlay* overlay);
+
+  struct Track
+  {
+    // ring buffer of the most recent samples, oldest first from m_head
+    QVector<TrackSample> m_samples;
+    int m_head = 0;
+    int m_count = 0;
+    double m_speed = 0.0;
+
+    // neighbours in the list of tracks ordered by the time of their last sample
+    Esri::ArcGISRuntime::Graphic* m_older = nullptr;
+    Esri::ArcGISRuntime::Graphic* m_newer = nullptr;
+  };
+
+  void unlink(Esri::ArcGISRuntime::Graphic* track, Track& entry);
+  void appendNewest(Esri::ArcGISRuntime::Graphic* track, Track& entry);
+
+  int m_capacity = 32;
+  QHash<Esri::ArcGISRuntime::Graphic*, Track> m_tracks;
+  Esri::ArcGISRuntime::Graphic* m_oldest = nullptr;
+  Esri::ArcGISRuntime::Graphic* m_newest = nullptr;
+};
+
+} // Dsa
+
+#endif // TRACKHISTORY_H
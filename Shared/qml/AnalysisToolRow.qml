@@ -43,6 +43,10 @@ Row {
                 target: analysisListIcon
                 selected: false
             }
+            PropertyChanges {
+                target: terrainProfileIcon
+                selected: false
+            }
         },
         State {
             name: lineOfSightIcon.toolName
@@ -58,6 +62,29 @@ Row {
                 target: analysisListIcon
                 selected: false
             }
+            PropertyChanges {
+                target: terrainProfileIcon
+                selected: false
+            }
+        },
+        State {
+            name: terrainProfileIcon.toolName
+            PropertyChanges {
+                target: terrainProfileIcon
+                selected: true
+            }
+            PropertyChanges {
+                target: viewshedIcon
+                selected: false
+            }
+            PropertyChanges {
+                target: lineOfSightIcon
+                selected: false
+            }
+            PropertyChanges {
+                target: analysisListIcon
+                selected: false
+            }
         },
         State {
             name: analysisListIcon.toolName
@@ -73,6 +100,10 @@ Row {
                 target: lineOfSightIcon
                 selected: false
             }
+            PropertyChanges {
+                target: terrainProfileIcon
+                selected: false
+            }
         },
         State {
             name: "clear"
@@ -88,6 +119,10 @@ Row {
                 target: analysisListIcon
                 selected: false
             }
+            PropertyChanges {
+                target: terrainProfileIcon
+                selected: false
+            }
         }
     ]
 
@@ -132,6 +167,26 @@ Row {
         }
     }
 
+    // Terrain Profile Tool
+    ToolIcon {
+        id: terrainProfileIcon
+        iconSource: DsaResources.iconPolyline
+        toolName: "Terrain Profile"
+        onToolSelected: {
+            if (selected ) {
+                analysisToolRow.state = "clear"
+                selected = false;
+            }
+            else {
+                analysisToolRow.state = toolName;
+            }
+        }
+
+        onSelectedChanged: {
+            terrainProfileTool.visible = selected;
+        }
+    }
+
     // Analysis List Tool
     ToolIcon {
         id: analysisListIcon
@@ -0,0 +1,201 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+import QtQuick 2.9
+import QtQuick.Controls 2.2
+import QtQuick.Controls.Material 2.2
+import QtGraphicalEffects 1.0
+import QtQuick.Window 2.2
+import Esri.ArcGISRuntime.OpenSourceApps.DSA 1.1
+
+Item {
+    id: rootTerrainProfile
+    property real scaleFactor: (Screen.logicalPixelDensity * 25.4) / (Qt.platform.os === "windows" || Qt.platform.os === "linux" ? 96 : 72)
+    property bool profileFailed: false
+
+    TerrainProfileController {
+        id: toolController
+
+        active: rootTerrainProfile.visible
+
+        onProfileChanged: profileCanvas.requestPaint();
+    }
+
+    DropShadow {
+        anchors.fill: fill
+        horizontalOffset: -1 * scaleFactor
+        verticalOffset: 1 * scaleFactor
+        radius: 8 * scaleFactor
+        smooth: true
+        samples: 16
+        color: "#80000000"
+        source: fill
+    }
+
+    Rectangle {
+        id: fill
+        anchors {
+            top: parent.top
+            bottom: profileCanvas.visible ? profileCanvas.bottom : lengthText.bottom
+            left: parent.left
+            right: parent.right
+        }
+        color: Material.background
+    }
+
+    OverlayButton {
+        id: profileButton
+        height: 32 * scaleFactor
+        width: height
+        anchors {
+            top: parent.top
+            left: parent.left
+            margins: 5 * scaleFactor
+        }
+        iconUrl: DsaResources.iconPolyline
+        color: "transparent"
+
+        onClicked: {
+            profileFailed = !toolController.calculateMarkupProfile();
+        }
+    }
+
+    Text {
+        id: profileLabel
+        anchors {
+            verticalCenter: profileButton.verticalCenter
+            left: profileButton.right
+            right: clearButton.left
+            margins: 5 * scaleFactor
+        }
+        font {
+            family: DsaStyles.fontFamily
+            pixelSize: DsaStyles.toolFontPixelSize * scaleFactor
+        }
+        color: Material.foreground
+        elide: Text.ElideRight
+        text: "Profile the selected markup line"
+    }
+
+    OverlayButton {
+        id: clearButton
+        height: profileButton.height
+        width: height
+        anchors {
+            verticalCenter: profileButton.verticalCenter
+            right: parent.right
+            margins: 5 * scaleFactor
+        }
+        iconUrl: DsaResources.iconClose
+
+        onClicked: {
+            toolController.clearProfile();
+            profileFailed = false;
+        }
+    }
+
+    Text {
+        id: lengthText
+        height: 16 * scaleFactor
+        anchors {
+            top: profileButton.bottom
+            left: profileLabel.left
+            margins: 5 * scaleFactor
+        }
+        font {
+            family: DsaStyles.fontFamily
+            pixelSize: DsaStyles.secondaryTitleFontPixelSize * scaleFactor
+            italic: true
+        }
+        color: Material.accent
+        verticalAlignment: Text.AlignVCenter
+
+        text: {
+            if (profileFailed)
+                return "Draw a markup line over local elevation";
+
+            if (toolController.profileLength <= 0)
+                return "No profile";
+
+            return "Length <b>" + Math.round(toolController.profileLength) + "</b> m";
+        }
+    }
+
+    // the elevation along the profile, scaled to fill the canvas
+    Canvas {
+        id: profileCanvas
+        visible: !profileFailed && toolController.profileLength > 0
+        height: 120 * scaleFactor
+        anchors {
+            top: lengthText.bottom
+            left: parent.left
+            right: parent.right
+            margins: 5 * scaleFactor
+        }
+
+        onPaint: {
+            var ctx = getContext("2d");
+            ctx.clearRect(0, 0, width, height);
+
+            var distances = toolController.profileDistances;
+            var elevations = toolController.profileElevations;
+            var length = toolController.profileLength;
+            if (distances.length < 2 || length <= 0)
+                return;
+
+            var minElevation = Infinity;
+            var maxElevation = -Infinity;
+            for (var i = 0; i < elevations.length; i++) {
+                if (isNaN(elevations[i]))
+                    continue;
+
+                minElevation = Math.min(minElevation, elevations[i]);
+                maxElevation = Math.max(maxElevation, elevations[i]);
+            }
+
+            if (minElevation > maxElevation)
+                return;
+
+            var range = Math.max(maxElevation - minElevation, 1);
+            ctx.strokeStyle = Material.accent;
+            ctx.lineWidth = 2 * scaleFactor;
+            ctx.beginPath();
+
+            // points without elevation leave a gap in the line
+            var drawing = false;
+            for (var j = 0; j < distances.length; j++) {
+                if (isNaN(elevations[j])) {
+                    drawing = false;
+                    continue;
+                }
+
+                var x = distances[j] / length * width;
+                var y = height - (elevations[j] - minElevation) / range * height;
+                if (drawing)
+                    ctx.lineTo(x, y);
+                else
+                    ctx.moveTo(x, y);
+
+                drawing = true;
+            }
+
+            ctx.stroke();
+        }
+
+        onWidthChanged: requestPaint();
+        onHeightChanged: requestPaint();
+    }
+}
@@ -302,6 +302,10 @@ Item {
             if (Math.round(toolController.activeViewshedMaxDistance) !== second.value)
                 toolController.activeViewshedMaxDistance = second.value;
         }
+
+        // limit updates to the viewshed while a handle is dragged
+        first.onPressedChanged: toolController.interacting = first.pressed || second.pressed;
+        second.onPressedChanged: toolController.interacting = first.pressed || second.pressed;
     }
 
     Text {
@@ -375,6 +379,9 @@ Item {
         stepSize: 1
         snapMode: Slider.SnapAlways
 
+        // limit updates to the viewshed while the slider is dragged
+        onPressedChanged: toolController.interacting = pressed;
+
         onValueChanged: {
             if (angleSelector.currentText === "Heading") {
                 if (Math.round(toolController.activeViewshedHeading) !== value)
@@ -101,6 +101,15 @@ GeoElement* GeoElementSignaler::geoElement() const
   return m_geoElement;
 }
 
+/*!
+  \class Dsa::GeoElementCandidate
+  \brief A \l Esri::ArcGISRuntime::GeoElement returned from a spatial query, along with
+  its id in the queried structure and its cached WGS84 extent.
+
+  Spatial queries append candidates to a buffer supplied by the caller, so the buffer
+  can be cleared and re-used between queries without allocating.
+ */
+
 /*!
   \fn void Dsa::GeoElementUtils::setParent(const QList<Esri::ArcGISRuntime::GeoElement*>& geoElements, QObject* parent)
   \brief Allows the \a parent to be applied to all the \a geoElements.
@@ -46,6 +46,16 @@ private:
   Esri::ArcGISRuntime::GeoElement* m_geoElement = nullptr;
 };
 
+struct GeoElementCandidate
+{
+  Esri::ArcGISRuntime::GeoElement* geoElement = nullptr;
+  qint64 id = -1;
+  double xMin = 0.0;
+  double xMax = 0.0;
+  double yMin = 0.0;
+  double yMax = 0.0;
+};
+
 namespace GeoElementUtils
 {
   void setParent(const QList<Esri::ArcGISRuntime::GeoElement*>& geoElements, QObject* parent);
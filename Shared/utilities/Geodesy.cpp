@@ -0,0 +1,70 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "Geodesy.h"
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+
+namespace Dsa {
+
+/*!
+  \class Dsa::Geodesy
+  \inmodule Dsa
+  \brief Constants and calculations for locations on a spherical earth, in WGS84 degrees.
+
+  The analysis and alert engines work on WGS84 locations over short distances, for which
+  a sphere with the mean radius of the earth is accurate enough and much cheaper than
+  a geodesic calculation.
+ */
+
+/*!
+  \variable Geodesy::earthRadius
+  \brief The mean radius of the earth in meters.
+ */
+constexpr double Geodesy::earthRadius;
+
+/*!
+  \variable Geodesy::degreesToRadians
+  \brief The number of radians in a degree.
+ */
+constexpr double Geodesy::degreesToRadians;
+
+/*!
+  \variable Geodesy::metersPerDegree
+  \brief The length in meters of a degree of latitude (or of longitude at the equator).
+ */
+constexpr double Geodesy::metersPerDegree;
+
+/*!
+  \brief Returns the great circle distance in meters between the WGS84 locations
+  \a x1, \a y1 and \a x2, \a y2.
+ */
+double Geodesy::distance(double x1, double y1, double x2, double y2)
+{
+  const double sinHalfLatitude = std::sin((y2 - y1) * degreesToRadians * 0.5);
+  const double sinHalfLongitude = std::sin((x2 - x1) * degreesToRadians * 0.5);
+  const double a = sinHalfLatitude * sinHalfLatitude +
+                   std::cos(y1 * degreesToRadians) * std::cos(y2 * degreesToRadians) * sinHalfLongitude * sinHalfLongitude;
+
+  return 2.0 * earthRadius * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+} // Dsa
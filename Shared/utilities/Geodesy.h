@@ -0,0 +1,34 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef GEODESY_H
+#define GEODESY_H
+
+namespace Dsa {
+
+class Geodesy
+{
+public:
+  static constexpr double earthRadius = 6371008.8;
+  static constexpr double degreesToRadians = 3.14159265358979323846 / 180.0;
+  static constexpr double metersPerDegree = earthRadius * degreesToRadians;
+
+  static double distance(double x1, double y1, double x2, double y2);
+};
+
+} // Dsa
+
+#endif // GEODESY_H
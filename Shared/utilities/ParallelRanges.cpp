@@ -0,0 +1,65 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+// PCH header
+#include "pch.hpp"
+
+#include "ParallelRanges.h"
+
+// Qt headers
+#include <QThread>
+
+namespace Dsa {
+
+/*!
+  \class Dsa::ParallelRanges
+  \inmodule Dsa
+  \brief Splits work between threads for the analysis engines.
+
+  The calling thread always does a share of the work and the calls return once
+  every thread has finished, so the engines stay synchronous for their callers.
+ */
+
+/*!
+  \brief Returns the number of threads to use for \a tasks tasks, given that a thread
+  is only worth starting for at least \a minTasksPerThread tasks.
+
+  No more than \a maxThreads threads are used, or the ideal thread count of the
+  machine when \a maxThreads is \c 0. At least one thread is always returned.
+ */
+int ParallelRanges::threadCount(int tasks, int minTasksPerThread, int maxThreads)
+{
+  const int limit = maxThreads > 0 ? maxThreads : std::max(1, QThread::idealThreadCount());
+  return std::max(1, std::min(limit, tasks / std::max(1, minTasksPerThread)));
+}
+
+/*!
+  \fn template <typename Function> void ParallelRanges::run(int threads, const Function& function);
+  \brief Calls \a function with each thread index from \c 0 to \a threads - 1, each on its own
+  thread, returning once all of them are complete.
+
+  The calling thread takes index \c 0.
+ */
+
+/*!
+  \fn template <typename Function> void ParallelRanges::split(int count, int threads, const Function& function);
+  \brief Calls \a function with a thread index and consecutive ranges [begin, end) of [0, \a count),
+  on up to \a threads threads, returning once all of them are complete.
+
+  The calling thread takes the first range.
+ */
+
+} // Dsa
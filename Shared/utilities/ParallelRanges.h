@@ -0,0 +1,75 @@
+/*******************************************************************************
+ *  Copyright 2012-2018 Esri
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ******************************************************************************/
+
+#ifndef PARALLELRANGES_H
+#define PARALLELRANGES_H
+
+// STL headers
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace Dsa {
+
+class ParallelRanges
+{
+public:
+  static int threadCount(int tasks, int minTasksPerThread, int maxThreads);
+
+  template <typename Function>
+  static void run(int threads, const Function& function);
+
+  template <typename Function>
+  static void split(int count, int threads, const Function& function);
+};
+
+template <typename Function>
+void ParallelRanges::run(int threads, const Function& function)
+{
+  std::vector<std::thread> workers;
+  workers.reserve(std::max(0, threads - 1));
+  for (int thread = 1; thread < threads; ++thread)
+  {
+    workers.emplace_back([&function, thread]()
+    {
+      function(thread);
+    });
+  }
+
+  function(0);
+
+  for (auto& worker : workers)
+    worker.join();
+}
+
+template <typename Function>
+void ParallelRanges::split(int count, int threads, const Function& function)
+{
+  if (count <= 0)
+    return;
+
+  threads = std::max(1, std::min(threads, count));
+  const int chunkSize = (count + threads - 1) / threads;
+  run((count + chunkSize - 1) / chunkSize, [&function, chunkSize, count](int thread)
+  {
+    const int begin = thread * chunkSize;
+    function(thread, begin, std::min(begin + chunkSize, count));
+  });
+}
+
+} // Dsa
+
+#endif // PARALLELRANGES_H
@@ -40,6 +40,7 @@
 #include "OptionsController.h"
 #include "RuntimePermissionRequest.h"
 #include "TableOfContentsController.h"
+#include "TerrainProfileController.h"
 #include "Vehicle.h"
 #include "VehicleStyles.h"
 #include "ViewedAlertsController.h"
@@ -142,6 +143,7 @@ int main(int argc, char *argv[])
   qmlRegisterType<Dsa::LocationTextController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "LocationTextController");
   qmlRegisterType<Dsa::AlertConditionsController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "AlertConditionsController");
   qmlRegisterType<Dsa::LineOfSightController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "LineOfSightController");
+  qmlRegisterType<Dsa::TerrainProfileController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "TerrainProfileController");
   qmlRegisterType<Dsa::ContextMenuController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "ContextMenuController");
   qmlRegisterType<Dsa::AnalysisListController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "AnalysisListController");
   qmlRegisterType<Dsa::ObservationReportController>("Esri.ArcGISRuntime.OpenSourceApps.DSA", 1, 1, "ObservationReportController");
@@ -330,6 +330,16 @@ Vehicle {
             visible: false
         }
 
+        TerrainProfileTool {
+            id: terrainProfileTool
+            width: drawer.width
+            anchors {
+                right: parent.right
+                top: parent.top
+            }
+            visible: false
+        }
+
         AnalysisList {
             id: analysisListTool
             anchors {